@@ -1450,11 +1450,14 @@ import com.sun.javafx.geom.transform.BaseTransform;
         return new RectBounds(x1, y1, x2, y2);
     }
 
-    // The following three methods are used only by Prism to access
+    // The following four methods are used only by Prism to access
     // internal structures; not intended for general use!
     public final int getNumCommands() {
         return numTypes;
     }
+    public final int getNumCoords() {
+        return numCoords;
+    }
     public final byte[] getCommandsNoClone() {
         return pointTypes;
     }
@@ -100,7 +100,11 @@ public class JPEGImageLoader extends ImageLoaderImpl {
     private native int startDecompression(long structPointer,
             int outColorSpaceCode, int scaleNum, int scaleDenom);
 
-    private native boolean decompressIndirect(long structPointer, boolean reportProgress, byte[] array) throws IOException;
+    /** Decodes the image into array, reporting the progress each time
+     *  progressInterval more percent of the rows are done, or never
+     *  if it is 0.
+     */
+    private native boolean decompressIndirect(long structPointer, int progressInterval, byte[] array) throws IOException;
 
     static {
         AccessController.doPrivileged((PrivilegedAction<Object>) () -> {
@@ -243,7 +247,9 @@ public class JPEGImageLoader extends ImageLoaderImpl {
 
             byte[] array = new byte[scanlineStride*outHeight];
             buffer = ByteBuffer.wrap(array);
-            decompressIndirect(structPointer, listeners != null && !listeners.isEmpty(), buffer.array());
+            int progressInterval = (listeners != null && !listeners.isEmpty()) ?
+                    ImageTools.PROGRESS_INTERVAL : 0;
+            decompressIndirect(structPointer, progressInterval, buffer.array());
         } catch (IOException e) {
             throw e;
         } catch (Throwable t) {
@@ -371,6 +371,53 @@ public final class PiscesRenderer {
 
     private native void setLCDGammaCorrectionImpl(float gamma);
 
+    /**
+     * Sets the number of threads, the rendering one included, that fill
+     * large primitives in horizontal bands. The result is the same with any
+     * number of threads. 1, the default, renders on the calling thread only.
+     *
+     * @param count the number of threads, at most 32
+     * @return the number of threads in use, smaller than count when the
+     * threads could not be started
+     */
+    public static int setThreadCount(int count) {
+        if (count < 1) {
+            throw new IllegalArgumentException("Thread count must be at least 1");
+        }
+        return setThreadCountImpl(count);
+    }
+
+    private static native int setThreadCountImpl(int count);
+
+    /**
+     * Returns the instruction set extensions used by the blitting loops of
+     * all the renderers, one of the <code>RendererBase.SIMD_*</code>
+     * constants: the best ones the processor has, unless set with
+     * <code>setSimd</code>.
+     *
+     * @return the extensions in use
+     */
+    public static int getSimd() {
+        return getSimdImpl();
+    }
+
+    private static native int getSimdImpl();
+
+    /**
+     * Restricts the blitting loops of all the renderers to the given
+     * instruction set extensions. The results are the same with all of
+     * them, <code>RendererBase.SIMD_NONE</code> runs the scalar loops.
+     *
+     * @param simd one of the <code>RendererBase.SIMD_*</code> constants
+     * @return false, and nothing changes, when the processor or the build
+     * doesn't support the extensions
+     */
+    public static boolean setSimd(int simd) {
+        return setSimdImpl(simd);
+    }
+
+    private static native boolean setSimdImpl(int simd);
+
     public void fillLCDAlphaMask(byte[] mask, int x, int y, int width, int height, int offset, int stride)
     {
         if (mask == null) {
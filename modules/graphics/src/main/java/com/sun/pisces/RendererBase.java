@@ -70,4 +70,13 @@ public final class RendererBase {
     public static final int IMAGE_FRAC_EDGE_KEEP = 0;
     public static final int IMAGE_FRAC_EDGE_PAD  = 1;
     public static final int IMAGE_FRAC_EDGE_TRIM = 2;
+
+    /**
+     * Instruction set extensions the blitting loops can use, see
+     * PiscesRenderer.setSimd(int). The results are the same with all of them.
+     */
+    public static final int SIMD_NONE = 0;
+    public static final int SIMD_SSE2 = 1;
+    public static final int SIMD_AVX2 = 2;
+    public static final int SIMD_NEON = 3;
 }
@@ -55,6 +55,8 @@ public final class PrismSettings {
     public static final List<String> tryOrder;
     public static final int prismStatFrequency;
     public static final boolean doNativePisces;
+    public static final int swThreads;
+    public static final boolean swSimd;
     public static final String refType;
     public static final boolean forceRepaint;
     public static final boolean noFallback;
@@ -226,6 +228,17 @@ public final class PrismSettings {
             doNativePisces = Boolean.parseBoolean(npprop);
         }
 
+        /*
+         * Number of threads filling large primitives in the sw pipeline,
+         * true uses one per processor.
+         */
+        swThreads = Math.max(1, getInt(systemProperties, "prism.sw.threads",
+                1, Runtime.getRuntime().availableProcessors(),
+                "Try -Dprism.sw.threads=[true|<number>]"));
+
+        // Use the SIMD blitting loops of the sw pipeline when the CPU can
+        swSimd = getBoolean(systemProperties, "prism.sw.simd", true);
+
         String primtex = systemProperties.getProperty("prism.primtextures");
         if (primtex == null) {
             primTextureSize = PlatformUtil.isEmbedded() ? -1 : 0;
@@ -262,6 +275,12 @@ public final class PrismSettings {
             System.out.println("");
             String piscestype = (doNativePisces ? "native" : "java");
             System.out.println("Using " + piscestype + "-based Pisces rasterizer");
+            if (swThreads > 1) {
+                System.out.println("Using " + swThreads + " threads for sw rendering");
+            }
+            if (!swSimd) {
+                System.out.println("Not using SIMD for sw rendering");
+            }
             printBooleanOption(dirtyOptsEnabled, "Using dirty region optimizations");
             if (primTextureSize == 0) {
                 System.out.println("Not using texture mask for primitives");
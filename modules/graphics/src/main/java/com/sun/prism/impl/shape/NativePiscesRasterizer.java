@@ -35,6 +35,7 @@ import com.sun.javafx.util.Logging;
 import com.sun.prism.BasicStroke;
 import com.sun.prism.impl.PrismSettings;
 import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.security.AccessController;
 import java.security.PrivilegedAction;
 
@@ -47,6 +48,14 @@ public class NativePiscesRasterizer implements ShapeRasterizer {
     private static final byte SEG_CUBICTO = PathIterator.SEG_CUBICTO;
     private static final byte SEG_CLOSE   = PathIterator.SEG_CLOSE;
 
+    // The kinds of the paths of a Batch
+    static final int BATCH_FILL_EVEN_ODD = 0;
+    static final int BATCH_FILL_NON_ZERO = 1;
+    static final int BATCH_STROKE        = 2;
+
+    // atlasX, atlasY, originX, originY, width and height of each path
+    static final int BATCH_RESULT_SIZE   = 6;
+
     private byte cachedMask[];
     private ByteBuffer cachedBuffer;
     private MaskData cachedData;
@@ -66,6 +75,9 @@ public class NativePiscesRasterizer implements ShapeRasterizer {
                                            double mxx, double mxy, double mxt,
                                            double myx, double myy, double myt,
                                            int bounds[], byte mask[]);
+    native static int produceAlphasBatch(ByteBuffer paths, int offset, int numPaths,
+                                         ByteBuffer atlas, int atlasWidth, int atlasHeight,
+                                         int results[]);
 
     static {
         AccessController.doPrivileged((PrivilegedAction<Void>) () -> {
@@ -82,18 +94,22 @@ public class NativePiscesRasterizer implements ShapeRasterizer {
         });
     }
 
-    @Override
-    public MaskData getMaskData(Shape shape, BasicStroke stroke,
-                                RectBounds xformBounds, BaseTransform xform,
-                                boolean close, boolean antialiasedShape)
-    {
-
+    private void setAntialiasing(boolean antialiasedShape) {
         if (firstTimeAASetting || (lastAntialiasedShape != antialiasedShape)) {
             int subpixelLgPositions = antialiasedShape ? 3 : 0;
             NativePiscesRasterizer.init(subpixelLgPositions, subpixelLgPositions);
             firstTimeAASetting = false;
             lastAntialiasedShape = antialiasedShape;
         }
+    }
+
+    @Override
+    public MaskData getMaskData(Shape shape, BasicStroke stroke,
+                                RectBounds xformBounds, BaseTransform xform,
+                                boolean close, boolean antialiasedShape)
+    {
+
+        setAntialiasing(antialiasedShape);
 
         if (stroke != null && stroke.getType() != BasicStroke.TYPE_CENTERED) {
             // RT-27427
@@ -189,4 +205,207 @@ public class NativePiscesRasterizer implements ShapeRasterizer {
         cachedData.update(cachedBuffer, x, y, w, h);
         return cachedData;
     }
+
+    /**
+     * Rasterizes the paths of the batch that are not rasterized yet into its
+     * atlas, in a single native call, until they are all done or the atlas
+     * is full. The atlas is overwritten by each call.
+     *
+     * @return the index following the last path rasterized
+     */
+    public int rasterize(Batch batch, boolean antialiasedShape) {
+        setAntialiasing(antialiasedShape);
+        int first = batch.numRasterized;
+        if (first < batch.numPaths) {
+            int n = produceAlphasBatch(batch.paths, batch.offsets[first], batch.numPaths - first,
+                                       batch.atlas, batch.atlasWidth, batch.atlasHeight,
+                                       batch.results);
+            batch.first = first;
+            batch.numRasterized = first + n;
+        }
+        return batch.numRasterized;
+    }
+
+    /**
+     * Shapes whose masks are produced together by
+     * {@link #rasterize(Batch, boolean)}, which saves the JNI call and the
+     * setup of the rasterizer for each of them. The paths are kept in a
+     * direct buffer and their masks are packed in the rows of an atlas.
+     * A mask that is larger than the atlas is left to
+     * {@link #getMaskData getMaskData()}.
+     */
+    public static final class Batch {
+        // The layout of BatchPath in NativePiscesRasterizer.c
+        private static final int KIND         = 0;
+        private static final int NUM_COMMANDS = 4;
+        private static final int NUM_COORDS   = 8;
+        private static final int NUM_DASHES   = 12;
+        private static final int BOUNDS       = 16;
+        private static final int CAP          = 32;
+        private static final int JOIN         = 36;
+        private static final int LINE_WIDTH   = 40;
+        private static final int MITER_LIMIT  = 44;
+        private static final int DASH_PHASE   = 48;
+        private static final int TRANSFORM    = 56;
+        private static final int HEADER_SIZE  = 104;
+
+        private final ByteBuffer atlas;
+        private final int atlasWidth;
+        private final int atlasHeight;
+        private ByteBuffer paths;
+        private int offsets[] = new int[64];
+        private int results[] = new int[64 * BATCH_RESULT_SIZE];
+        private int size;
+        private int numPaths;
+        private int first;
+        private int numRasterized;
+
+        public Batch(int atlasWidth, int atlasHeight) {
+            this.atlasWidth = atlasWidth;
+            this.atlasHeight = atlasHeight;
+            atlas = ByteBuffer.allocateDirect(atlasWidth * atlasHeight);
+            paths = ByteBuffer.allocateDirect(0x4000).order(ByteOrder.nativeOrder());
+        }
+
+        public ByteBuffer getAtlas() {
+            return atlas;
+        }
+
+        public int getAtlasWidth() {
+            return atlasWidth;
+        }
+
+        public int getNumPaths() {
+            return numPaths;
+        }
+
+        public void clear() {
+            size = numPaths = first = numRasterized = 0;
+        }
+
+        /**
+         * Adds a shape, with the same arguments as getMaskData().
+         *
+         * @return the index of its path
+         */
+        public int add(Shape shape, BasicStroke stroke,
+                       RectBounds xformBounds, BaseTransform xform)
+        {
+            if (stroke != null && stroke.getType() != BasicStroke.TYPE_CENTERED) {
+                shape = stroke.createStrokedShape(shape);
+                stroke = null;
+            }
+            if (xformBounds == null) {
+                if (stroke != null) {
+                    shape = stroke.createStrokedShape(shape);
+                    stroke = null;
+                }
+                xformBounds = (RectBounds) xform.transform(shape.getBounds(), new RectBounds());
+            }
+            Path2D p2d = (shape instanceof Path2D) ? (Path2D) shape : new Path2D(shape);
+            float dashes[] = (stroke == null) ? null : stroke.getDashArray();
+            int numCommands = p2d.getNumCommands();
+            int numCoords = p2d.getNumCoords();
+            int numDashes = (dashes == null) ? 0 : dashes.length;
+            int pathSize = (HEADER_SIZE + (numCoords + numDashes) * 4 + numCommands + 7) & ~7;
+
+            if (numPaths == offsets.length) {
+                int newPaths = numPaths * 2;
+                int newOffsets[] = new int[newPaths];
+                System.arraycopy(offsets, 0, newOffsets, 0, numPaths);
+                offsets = newOffsets;
+                // Keeps the results of the last rasterize() readable
+                int newResults[] = new int[newPaths * BATCH_RESULT_SIZE];
+                System.arraycopy(results, 0, newResults, 0,
+                                 (numRasterized - first) * BATCH_RESULT_SIZE);
+                results = newResults;
+            }
+            if (size + pathSize > paths.capacity()) {
+                ByteBuffer newPaths =
+                    ByteBuffer.allocateDirect(Math.max(paths.capacity() * 2, size + pathSize))
+                              .order(ByteOrder.nativeOrder());
+                paths.clear().limit(size);
+                newPaths.put(paths);
+                paths = newPaths;
+            }
+
+            int off = size;
+            int kind = (stroke != null) ? BATCH_STROKE :
+                       (p2d.getWindingRule() == Path2D.WIND_NON_ZERO) ? BATCH_FILL_NON_ZERO
+                                                                      : BATCH_FILL_EVEN_ODD;
+            paths.putInt(off + KIND, kind);
+            paths.putInt(off + NUM_COMMANDS, numCommands);
+            paths.putInt(off + NUM_COORDS, numCoords);
+            paths.putInt(off + NUM_DASHES, (dashes == null) ? -1 : numDashes);
+            paths.putInt(off + BOUNDS, (int) Math.floor(xformBounds.getMinX()));
+            paths.putInt(off + BOUNDS + 4, (int) Math.floor(xformBounds.getMinY()));
+            paths.putInt(off + BOUNDS + 8, (int) Math.ceil(xformBounds.getMaxX()));
+            paths.putInt(off + BOUNDS + 12, (int) Math.ceil(xformBounds.getMaxY()));
+            if (stroke != null) {
+                paths.putInt(off + CAP, stroke.getEndCap());
+                paths.putInt(off + JOIN, stroke.getLineJoin());
+                paths.putFloat(off + LINE_WIDTH, stroke.getLineWidth());
+                paths.putFloat(off + MITER_LIMIT, stroke.getMiterLimit());
+                paths.putFloat(off + DASH_PHASE, stroke.getDashPhase());
+            }
+            boolean identity = (xform == null || xform.isIdentity());
+            paths.putDouble(off + TRANSFORM,      identity ? 1.0 : xform.getMxx());
+            paths.putDouble(off + TRANSFORM + 8,  identity ? 0.0 : xform.getMxy());
+            paths.putDouble(off + TRANSFORM + 16, identity ? 0.0 : xform.getMxt());
+            paths.putDouble(off + TRANSFORM + 24, identity ? 0.0 : xform.getMyx());
+            paths.putDouble(off + TRANSFORM + 32, identity ? 1.0 : xform.getMyy());
+            paths.putDouble(off + TRANSFORM + 40, identity ? 0.0 : xform.getMyt());
+            paths.position(off + HEADER_SIZE);
+            paths.asFloatBuffer().put(p2d.getFloatCoordsNoClone(), 0, numCoords);
+            if (numDashes > 0) {
+                paths.position(off + HEADER_SIZE + numCoords * 4);
+                paths.asFloatBuffer().put(dashes, 0, numDashes);
+            }
+            paths.position(off + HEADER_SIZE + (numCoords + numDashes) * 4);
+            paths.put(p2d.getCommandsNoClone(), 0, numCommands);
+            paths.clear();
+
+            offsets[numPaths] = off;
+            size += pathSize;
+            return numPaths++;
+        }
+
+        private int result(int path, int field) {
+            if (path < first || path >= numRasterized) {
+                throw new IndexOutOfBoundsException("path " + path + " is not in the atlas");
+            }
+            return results[(path - first) * BATCH_RESULT_SIZE + field];
+        }
+
+        /**
+         * Returns false for the masks that are larger than the atlas.
+         */
+        public boolean isInAtlas(int path) {
+            return result(path, 0) >= 0;
+        }
+
+        public int getAtlasX(int path) {
+            return result(path, 0);
+        }
+
+        public int getAtlasY(int path) {
+            return result(path, 1);
+        }
+
+        public int getOriginX(int path) {
+            return result(path, 2);
+        }
+
+        public int getOriginY(int path) {
+            return result(path, 3);
+        }
+
+        public int getWidth(int path) {
+            return result(path, 4);
+        }
+
+        public int getHeight(int path) {
+            return result(path, 5);
+        }
+    }
 }
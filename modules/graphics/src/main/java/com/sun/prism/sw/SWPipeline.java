@@ -27,8 +27,11 @@ package com.sun.prism.sw;
 
 import com.sun.glass.ui.Screen;
 import com.sun.glass.utils.NativeLibLoader;
+import com.sun.pisces.PiscesRenderer;
+import com.sun.pisces.RendererBase;
 import com.sun.prism.GraphicsPipeline;
 import com.sun.prism.ResourceFactory;
+import com.sun.prism.impl.PrismSettings;
 
 import java.security.AccessController;
 import java.security.PrivilegedAction;
@@ -42,6 +45,12 @@ public final class SWPipeline extends GraphicsPipeline {
             NativeLibLoader.loadLibrary("prism_sw");
             return null;
         });
+        if (PrismSettings.swThreads > 1) {
+            PiscesRenderer.setThreadCount(PrismSettings.swThreads);
+        }
+        if (!PrismSettings.swSimd) {
+            PiscesRenderer.setSimd(RendererBase.SIMD_NONE);
+        }
     }
 
     @Override public boolean init() {
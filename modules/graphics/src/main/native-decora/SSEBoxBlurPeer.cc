@@ -30,8 +30,12 @@
 
 #include <jni.h>
 #include "SSEUtils.h"
+#include "SSEVector.h"
 #include "com_sun_scenario_effect_impl_sw_sse_SSEBoxBlurPeer.h"
 
+// Columns filtered together by the vertical passes.
+#define VERTICAL_BAND 256
+
 JNIEXPORT void JNICALL
 Java_com_sun_scenario_effect_impl_sw_sse_SSEBoxBlurPeer_filterHorizontal
     (JNIEnv *env, jclass klass,
@@ -47,33 +51,23 @@ Java_com_sun_scenario_effect_impl_sw_sse_SSEBoxBlurPeer_filterHorizontal
     }
 
     jint hsize = dstw - srcw + 1;
-    jint kscale = 0x7fffffff / (hsize * 255);
+    vint4 kscale = vint4_set1(0x7fffffff / (hsize * 255));
     jint srcoff = 0;
     jint dstoff = 0;
     for (jint y = 0; y < dsth; y++) {
-        jint suma = 0;
-        jint sumr = 0;
-        jint sumg = 0;
-        jint sumb = 0;
+        // The sums of the 4 components, in the lanes [B, G, R, A].
+        vint4 sum = vint4_zero();
         for (jint x = 0; x < dstw; x++) {
-            jint rgb;
             // Un-accumulate the data for col-hsize location into the sums.
-            rgb = (x >= hsize) ? srcPixels[srcoff + x - hsize] : 0;
-            suma -= (rgb >> 24) & 0xff;
-            sumr -= (rgb >> 16) & 0xff;
-            sumg -= (rgb >>  8) & 0xff;
-            sumb -= (rgb      ) & 0xff;
+            if (x >= hsize) {
+                sum = vint4_sub(sum, vint4_unpack(srcPixels[srcoff + x - hsize]));
+            }
             // Accumulate the data for this col location into the sums.
-            rgb = (x < srcw) ? srcPixels[srcoff + x] : 0;
-            suma += (rgb >> 24) & 0xff;
-            sumr += (rgb >> 16) & 0xff;
-            sumg += (rgb >>  8) & 0xff;
-            sumb += (rgb      ) & 0xff;
+            if (x < srcw) {
+                sum = vint4_add(sum, vint4_unpack(srcPixels[srcoff + x]));
+            }
             dstPixels[dstoff + x] =
-                (((suma * kscale) >> 23) << 24) +
-                (((sumr * kscale) >> 23) << 16) +
-                (((sumg * kscale) >> 23) <<  8) +
-                (((sumb * kscale) >> 23)      );
+                vint4_pack(vint4_sra(vint4_mullo(sum, kscale), 23));
         }
         srcoff += srcscan;
         dstoff += dstscan;
@@ -98,34 +92,34 @@ Java_com_sun_scenario_effect_impl_sw_sse_SSEBoxBlurPeer_filterVertical
     }
 
     jint vsize = dsth - srch + 1;
-    jint kscale = 0x7fffffff / (vsize * 255);
-    jint voff = vsize * srcscan;
-    for (jint x = 0; x < dstw; x++) {
-        jint suma = 0;
-        jint sumr = 0;
-        jint sumg = 0;
-        jint sumb = 0;
-        jint srcoff = x;
-        jint dstoff = x;
+    vint4 kscale = vint4_set1(0x7fffffff / (vsize * 255));
+    // Walks the rows in order (rather than the columns) with the sums of
+    // a band of columns, in the lanes [B, G, R, A] of each column.
+    jint sums[VERTICAL_BAND * 4];
+    for (jint x0 = 0; x0 < dstw; x0 += VERTICAL_BAND) {
+        jint bandw = (dstw - x0 < VERTICAL_BAND) ? dstw - x0 : VERTICAL_BAND;
+        for (jint i = 0; i < bandw * 4; i++) {
+            sums[i] = 0;
+        }
+        jint srcoff = x0;
+        jint dstoff = x0;
         for (jint y = 0; y < dsth; y++) {
-            jint rgb;
             // Un-accumulate the data for row-vsize location into the sums.
-            rgb = (srcoff >= voff) ? srcPixels[srcoff - voff] : 0;
-            suma -= (rgb >> 24) & 0xff;
-            sumr -= (rgb >> 16) & 0xff;
-            sumg -= (rgb >>  8) & 0xff;
-            sumb -= (rgb      ) & 0xff;
-            // Accumulate the data for this col location into the sums.
-            rgb = (y < srch) ? srcPixels[srcoff] : 0;
-            suma += (rgb >> 24) & 0xff;
-            sumr += (rgb >> 16) & 0xff;
-            sumg += (rgb >>  8) & 0xff;
-            sumb += (rgb      ) & 0xff;
-            dstPixels[dstoff] =
-                (((suma * kscale) >> 23) << 24) +
-                (((sumr * kscale) >> 23) << 16) +
-                (((sumg * kscale) >> 23) <<  8) +
-                (((sumb * kscale) >> 23)      );
+            jint *outrow = (y >= vsize) ? srcPixels + srcoff - vsize * srcscan : NULL;
+            // Accumulate the data for this row location into the sums.
+            jint *inrow = (y < srch) ? srcPixels + srcoff : NULL;
+            for (jint x = 0; x < bandw; x++) {
+                vint4 sum = vint4_load(sums + x * 4);
+                if (outrow != NULL) {
+                    sum = vint4_sub(sum, vint4_unpack(outrow[x]));
+                }
+                if (inrow != NULL) {
+                    sum = vint4_add(sum, vint4_unpack(inrow[x]));
+                }
+                vint4_store(sums + x * 4, sum);
+                dstPixels[dstoff + x] =
+                    vint4_pack(vint4_sra(vint4_mullo(sum, kscale), 23));
+            }
             srcoff += srcscan;
             dstoff += dstscan;
         }
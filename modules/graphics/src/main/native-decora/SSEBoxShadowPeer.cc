@@ -30,8 +30,44 @@
 
 #include <jni.h>
 #include "SSEUtils.h"
+#include "SSEVector.h"
 #include "com_sun_scenario_effect_impl_sw_sse_SSEBoxShadowPeer.h"
 
+// Columns filtered together by the vertical passes.
+#define VERTICAL_BAND 256
+
+// The alphas of pixels[x..x+3], 0 outside of [0, w).
+static inline vint4 alphas4(jint *pixels, jint x, jint w) {
+    if (x >= 0 && x + 4 <= w) {
+        return vint4_srl(vint4_load(pixels + x), 24);
+    }
+    jint a[4];
+    for (jint i = 0; i < 4; i++) {
+        a[i] = (x + i >= 0 && x + i < w) ? ((pixels[x + i] >> 24) & 0xff) : 0;
+    }
+    return vint4_load(a);
+}
+
+// Stores the first n (up to 4) lanes of v at pixels[0..n-1].
+static inline void store4(jint *pixels, vint4 v, jint n) {
+    if (n >= 4) {
+        vint4_store(pixels, v);
+        return;
+    }
+    jint p[4];
+    vint4_store(p, v);
+    for (jint i = 0; i < n; i++) {
+        pixels[i] = p[i];
+    }
+}
+
+// Clamp, scale and convert 4 alpha sums into black pixels.
+static inline vint4 blackPixels(vint4 suma, vint4 amin, vint4 amax, vint4 kscale) {
+    vint4 pixels = vint4_sll(vint4_sra(vint4_mullo(suma, kscale), 23), 24);
+    pixels = vint4_select(vint4_cmplt(suma, amax), pixels, vint4_set1((jint) 0xff000000));
+    return vint4_select(vint4_cmplt(suma, amin), vint4_zero(), pixels);
+}
+
 JNIEXPORT void JNICALL
 Java_com_sun_scenario_effect_impl_sw_sse_SSEBoxShadowPeer_filterHorizontalBlack
     (JNIEnv *env, jclass klass,
@@ -53,23 +89,23 @@ Java_com_sun_scenario_effect_impl_sw_sse_SSEBoxShadowPeer_filterHorizontalBlack
     amax += (jint) ((255 - amax) * spread);
     jint kscale = 0x7fffffff / amax;
     jint amin = (amax / 255);
+    vint4 vamin = vint4_set1(amin);
+    vint4 vamax = vint4_set1(amax);
+    vint4 vkscale = vint4_set1(kscale);
     jint srcoff = 0;
     jint dstoff = 0;
     for (jint y = 0; y < dsth; y++) {
-        jint suma = 0;
-        for (jint x = 0; x < dstw; x++) {
-            jint rgb;
-            // Un-accumulate the data for col-hsize location into the sums.
-            rgb = (x >= hsize) ? srcPixels[srcoff + x - hsize] : 0;
-            suma -= (rgb >> 24) & 0xff;
-            // Accumulate the data for this col location into the sums.
-            rgb = (x < srcw) ? srcPixels[srcoff + x] : 0;
-            suma += (rgb >> 24) & 0xff;
-            // Clamp, scale and convert the sum into a color.
-            dstPixels[dstoff + x] =
-                ((suma < amin) ? 0
-                 : ((suma >= amax) ? 0xff000000
-                    : (((suma * kscale) >> 23) << 24)));
+        jint *src = srcPixels + srcoff;
+        // The sum for the pixel before x, in all the lanes.
+        vint4 suma = vint4_zero();
+        for (jint x = 0; x < dstw; x += 4) {
+            // Accumulate the data for the col locations x..x+3 and
+            // un-accumulate the data for the col-hsize locations, then
+            // turn the differences into running sums.
+            vint4 delta = vint4_sub(alphas4(src, x, srcw), alphas4(src, x - hsize, srcw));
+            vint4 sums = vint4_add(suma, vint4_prefixsum(delta));
+            suma = vint4_broadcast3(sums);
+            store4(dstPixels + dstoff + x, blackPixels(sums, vamin, vamax, vkscale), dstw - x);
         }
         srcoff += srcscan;
         dstoff += dstscan;
@@ -100,24 +136,35 @@ Java_com_sun_scenario_effect_impl_sw_sse_SSEBoxShadowPeer_filterVerticalBlack
     amax += (jint) ((255 - amax) * spread);
     jint kscale = 0x7fffffff / amax;
     jint amin = (amax / 255);
-    jint voff = vsize * srcscan;
-    for (jint x = 0; x < dstw; x++) {
-        jint suma = 0;
-        jint srcoff = x;
-        jint dstoff = x;
+    vint4 vamin = vint4_set1(amin);
+    vint4 vamax = vint4_set1(amax);
+    vint4 vkscale = vint4_set1(kscale);
+    // Walks the rows in order (rather than the columns) with the alpha
+    // sums of a band of columns.
+    jint sums[VERTICAL_BAND];
+    for (jint x0 = 0; x0 < dstw; x0 += VERTICAL_BAND) {
+        jint bandw = (dstw - x0 < VERTICAL_BAND) ? dstw - x0 : VERTICAL_BAND;
+        for (jint i = 0; i < VERTICAL_BAND; i++) {
+            sums[i] = 0;
+        }
+        jint srcoff = x0;
+        jint dstoff = x0;
         for (jint y = 0; y < dsth; y++) {
-            jint rgb;
             // Un-accumulate the data for row-vsize location into the sums.
-            rgb = (srcoff >= voff) ? srcPixels[srcoff - voff] : 0;
-            suma -= (rgb >> 24) & 0xff;
+            jint *outrow = (y >= vsize) ? srcPixels + srcoff - vsize * srcscan : NULL;
             // Accumulate the data for this row location into the sums.
-            rgb = (y < srch) ? srcPixels[srcoff] : 0;
-            suma += (rgb >> 24) & 0xff;
-            // Clamp, scale and convert the sum into a color.
-            dstPixels[dstoff] =
-                ((suma < amin) ? 0
-                 : ((suma >= amax) ? 0xff000000
-                    : (((suma * kscale) >> 23) << 24)));
+            jint *inrow = (y < srch) ? srcPixels + srcoff : NULL;
+            for (jint x = 0; x < bandw; x += 4) {
+                vint4 suma = vint4_load(sums + x);
+                if (outrow != NULL) {
+                    suma = vint4_sub(suma, alphas4(outrow, x, bandw));
+                }
+                if (inrow != NULL) {
+                    suma = vint4_add(suma, alphas4(inrow, x, bandw));
+                }
+                vint4_store(sums + x, suma);
+                store4(dstPixels + dstoff + x, blackPixels(suma, vamin, vamax, vkscale), bandw - x);
+            }
             srcoff += srcscan;
             dstoff += dstscan;
         }
@@ -155,32 +202,52 @@ Java_com_sun_scenario_effect_impl_sw_sse_SSEBoxShadowPeer_filterVertical
     jint kscaleb = (jint) (kscalea * shadowColor[2]);
     kscalea = (jint) (kscalea * shadowColor[3]);
     jint amin = (amax / 255);
-    jint voff = vsize * srcscan;
     jint shadowRGB =
         (((jint) (shadowColor[0] * 255)) << 16) |
         (((jint) (shadowColor[1] * 255)) <<  8) |
         (((jint) (shadowColor[2] * 255))      ) |
         (((jint) (shadowColor[3] * 255)) << 24);
-    for (jint x = 0; x < dstw; x++) {
-        jint suma = 0;
-        jint srcoff = x;
-        jint dstoff = x;
+    vint4 vamin = vint4_set1(amin);
+    vint4 vamax = vint4_set1(amax);
+    vint4 vshadowRGB = vint4_set1(shadowRGB);
+    vint4 vkscalea = vint4_set1(kscalea);
+    vint4 vkscaler = vint4_set1(kscaler);
+    vint4 vkscaleg = vint4_set1(kscaleg);
+    vint4 vkscaleb = vint4_set1(kscaleb);
+    // Walks the rows in order (rather than the columns) with the alpha
+    // sums of a band of columns.
+    jint sums[VERTICAL_BAND];
+    for (jint x0 = 0; x0 < dstw; x0 += VERTICAL_BAND) {
+        jint bandw = (dstw - x0 < VERTICAL_BAND) ? dstw - x0 : VERTICAL_BAND;
+        for (jint i = 0; i < VERTICAL_BAND; i++) {
+            sums[i] = 0;
+        }
+        jint srcoff = x0;
+        jint dstoff = x0;
         for (jint y = 0; y < dsth; y++) {
-            jint rgb;
             // Un-accumulate the data for row-vsize location into the sums.
-            rgb = (srcoff >= voff) ? srcPixels[srcoff - voff] : 0;
-            suma -= (rgb >> 24) & 0xff;
+            jint *outrow = (y >= vsize) ? srcPixels + srcoff - vsize * srcscan : NULL;
             // Accumulate the data for this row location into the sums.
-            rgb = (y < srch) ? srcPixels[srcoff] : 0;
-            suma += (rgb >> 24) & 0xff;
-            // Clamp, scale and convert the sum into a color.
-            dstPixels[dstoff] =
-                ((suma < amin) ? 0
-                 : ((suma >= amax) ? shadowRGB
-                    : ((((suma * kscalea) >> 23) << 24) |
-                       (((suma * kscaler) >> 23) << 16) |
-                       (((suma * kscaleg) >> 23) <<  8) |
-                       (((suma * kscaleb) >> 23)      ))));
+            jint *inrow = (y < srch) ? srcPixels + srcoff : NULL;
+            for (jint x = 0; x < bandw; x += 4) {
+                vint4 suma = vint4_load(sums + x);
+                if (outrow != NULL) {
+                    suma = vint4_sub(suma, alphas4(outrow, x, bandw));
+                }
+                if (inrow != NULL) {
+                    suma = vint4_add(suma, alphas4(inrow, x, bandw));
+                }
+                vint4_store(sums + x, suma);
+                // Clamp, scale and convert the sums into colors.
+                vint4 pixels =
+                    vint4_or(vint4_or(vint4_sll(vint4_sra(vint4_mullo(suma, vkscalea), 23), 24),
+                                      vint4_sll(vint4_sra(vint4_mullo(suma, vkscaler), 23), 16)),
+                             vint4_or(vint4_sll(vint4_sra(vint4_mullo(suma, vkscaleg), 23),  8),
+                                      vint4_sra(vint4_mullo(suma, vkscaleb), 23)));
+                pixels = vint4_select(vint4_cmplt(suma, vamax), pixels, vshadowRGB);
+                pixels = vint4_select(vint4_cmplt(suma, vamin), vint4_zero(), pixels);
+                store4(dstPixels + dstoff + x, pixels, bandw - x);
+            }
             srcoff += srcscan;
             dstoff += dstscan;
         }
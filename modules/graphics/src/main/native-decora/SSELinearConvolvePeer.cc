@@ -31,6 +31,7 @@
 #include <jni.h>
 #include <math.h>
 #include "SSEUtils.h"
+#include "SSEVector.h"
 #include "com_sun_scenario_effect_impl_sw_sse_SSELinearConvolvePeer.h"
 
 #define cmin 1.0f
@@ -115,6 +116,14 @@ Java_com_sun_scenario_effect_impl_sw_sse_SSELinearConvolvePeer_filterHV
     jfloat kvals[256];
     env->GetFloatArrayRegion(kvals_arr, 0, kernelSize * 2, kvals);
 
+    // The kernel values, in all the lanes.
+    vfloat4 kvecs[256];
+    for (jint i = 0; i < kernelSize * 2; i++) {
+        kvecs[i] = vfloat4_set1(kvals[i]);
+    }
+    vfloat4 vcmin = vfloat4_set1(cmin);
+    vfloat4 vcmax = vfloat4_set1(cmax);
+
     jint *srcPixels = (jint *)env->GetPrimitiveArrayCritical(srcPixels_arr, 0);
     if (srcPixels == NULL) return;
     jint *dstPixels = (jint *)env->GetPrimitiveArrayCritical(dstPixels_arr, 0);
@@ -124,8 +133,8 @@ Java_com_sun_scenario_effect_impl_sw_sse_SSELinearConvolvePeer_filterHV
     }
 
     // cvals stores the component values from the surrounding K pixels
-    // from x-r to x+r
-    jfloat cvals[128*4];
+    // from x-r to x+r, in the lanes [B, G, R, A]
+    vfloat4 cvals[128];
     jint dstrow = 0;
     jint srcrow = 0;
     for (jint r = 0; r < dstrows; r++) {
@@ -134,38 +143,25 @@ Java_com_sun_scenario_effect_impl_sw_sse_SSELinearConvolvePeer_filterHV
         // Must clear out the array at the start of every line
         // Might be able to rely on the fact that the previous line must
         // have run out of data towards the end of the scan line, though.
-        for (jint i = 0; i < kernelSize*4; i++) {
-            cvals[i] = 0.0f;
+        for (jint i = 0; i < kernelSize; i++) {
+            cvals[i] = vfloat4_zero();
         }
         jint koff = kernelSize;
         for (jint c = 0; c < dstcols; c++) {
             // Load the data for this x location into the array.
-            jint i = (kernelSize - koff) * 4;
             jint rgb = (c < srccols) ? srcPixels[srcoff] : 0;
-            cvals[i+0] = (jfloat) ((rgb >> 24) & 0xff);
-            cvals[i+1] = (jfloat) ((rgb >> 16) & 0xff);
-            cvals[i+2] = (jfloat) ((rgb >>  8) & 0xff);
-            cvals[i+3] = (jfloat) ((rgb      ) & 0xff);
+            cvals[kernelSize - koff] = vfloat4_from_vint4(vint4_unpack(rgb));
             // Bump the koff to the next spot to align the coefficients.
             if (--koff <= 0) {
                 koff += kernelSize;
             }
-            jfloat suma = 0.0f;
-            jfloat sumr = 0.0f;
-            jfloat sumg = 0.0f;
-            jfloat sumb = 0.0f;
-            for (i = 0; i < kernelSize*4; i += 4) {
-                jfloat factor = kvals[koff + (i>>2)];
-                suma += cvals[i+0] * factor;
-                sumr += cvals[i+1] * factor;
-                sumg += cvals[i+2] * factor;
-                sumb += cvals[i+3] * factor;
+            // The 4 components are summed in the order of the original
+            // scalar loop, so the results do not change.
+            vfloat4 sum = vfloat4_zero();
+            for (jint i = 0; i < kernelSize; i++) {
+                sum = vfloat4_add(sum, vfloat4_mul(cvals[i], kvecs[koff + i]));
             }
-            dstPixels[dstoff] =
-                (((suma < cmin) ? 0 : ((suma > cmax) ? 255 : ((jint) suma))) << 24) +
-                (((sumr < cmin) ? 0 : ((sumr > cmax) ? 255 : ((jint) sumr))) << 16) +
-                (((sumg < cmin) ? 0 : ((sumg > cmax) ? 255 : ((jint) sumg))) <<  8) +
-                (((sumb < cmin) ? 0 : ((sumb > cmax) ? 255 : ((jint) sumb)))      );
+            dstPixels[dstoff] = vint4_pack(vfloat4_tobyte(sum, vcmin, vcmax));
             dstoff += dcolinc;
             srcoff += scolinc;
         }
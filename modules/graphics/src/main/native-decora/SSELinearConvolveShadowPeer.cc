@@ -31,11 +31,15 @@
 #include <jni.h>
 #include <math.h>
 #include "SSEUtils.h"
+#include "SSEVector.h"
 #include "com_sun_scenario_effect_impl_sw_sse_SSELinearConvolveShadowPeer.h"
 
 #define cmin 1.0f
 #define cmax (255.0f - 1.0f/32.0f)
 
+// Columns filtered together by filterHV.
+#define HV_BAND 256
+
 JNIEXPORT void JNICALL
 Java_com_sun_scenario_effect_impl_sw_sse_SSELinearConvolveShadowPeer_filterVector
     (JNIEnv *env, jclass klass,
@@ -140,39 +144,48 @@ Java_com_sun_scenario_effect_impl_sw_sse_SSELinearConvolveShadowPeer_filterHV
         return;
     }
 
-    // avals stores the alpha values from the surrounding K pixels
-    // from x-r to x+r
-    jfloat avals[128];
+    // The weights (the 2nd half of kvals), in all the lanes.
+    vfloat4 weights[128];
+    for (jint i = 0; i < kernelSize; i++) {
+        weights[i] = vfloat4_set1(kvals[kernelSize + i]);
+    }
+
+    // avals stores the alpha values of the source columns from
+    // c0-(K-1) to c0+HV_BAND-1, so that dest column c is the sum
+    // of avals[c-c0 .. c-c0+K-1] times the weights, and 4 dest columns
+    // are summed together.
+    jfloat avals[HV_BAND + 128 + 4];
     jint dstrow = 0;
     jint srcrow = 0;
     for (jint r = 0; r < dstrows; r++) {
-        jint dstoff = dstrow;
-        jint srcoff = srcrow;
-        // Must clear out the array at the start of every line
-        // Might be able to rely on the fact that the previous line must
-        // have run out of data towards the end of the scan line, though.
-        for (jint i = 0; i < kernelSize; i++) {
-            avals[i] = 0.0f;
-        }
-        jint koff = kernelSize;
-        for (jint c = 0; c < dstcols; c++) {
-            // Load the data for this x location into the array.
-            jint rgb = (c < srccols) ? srcPixels[srcoff] : 0;
-            avals[kernelSize - koff] = (jfloat) ((rgb >> 24) & 0xff);
-            // Bump the koff to the next spot to align the coefficients.
-            if (--koff <= 0) {
-                koff += kernelSize;
+        for (jint c0 = 0; c0 < dstcols; c0 += HV_BAND) {
+            jint bandcols = (dstcols - c0 < HV_BAND) ? dstcols - c0 : HV_BAND;
+            jint first = c0 - (kernelSize - 1);
+            jint count = bandcols + kernelSize - 1;
+            for (jint i = 0; i < count + 4; i++) {
+                jint c = first + i;
+                jint rgb = (i < count && c >= 0 && c < srccols)
+                    ? srcPixels[srcrow + c * scolinc] : 0;
+                avals[i] = (jfloat) ((rgb >> 24) & 0xff);
             }
-            jfloat sum = -0.5f;
-            for (jint i = 0; i < kernelSize; i++) {
-                sum += avals[i] * kvals[koff + i];
+            jint dstoff = dstrow + c0 * dcolinc;
+            for (jint c = 0; c < bandcols; c += 4) {
+                vfloat4 vsum = vfloat4_set1(-0.5f);
+                for (jint i = 0; i < kernelSize; i++) {
+                    vsum = vfloat4_add(vsum, vfloat4_mul(vfloat4_load(avals + c + i), weights[i]));
+                }
+                jfloat sums[4];
+                vfloat4_store(sums, vsum);
+                jint n = (bandcols - c < 4) ? bandcols - c : 4;
+                for (jint i = 0; i < n; i++) {
+                    jfloat sum = sums[i];
+                    dstPixels[dstoff] =
+                        ((sum < 0.0f) ? 0
+                         : ((sum >= 254.0f) ? shadowRGBs[255]
+                            : shadowRGBs[((jint) sum) + 1]));
+                    dstoff += dcolinc;
+                }
             }
-            dstPixels[dstoff] =
-                ((sum < 0.0f) ? 0
-                 : ((sum >= 254.0f) ? shadowRGBs[255]
-                    : shadowRGBs[((jint) sum) + 1]));
-            dstoff += dcolinc;
-            srcoff += scolinc;
         }
         dstrow += drowinc;
         srcrow += srowinc;
@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef _Included_SSEVector
+#define _Included_SSEVector
+
+/*
+ * Four lane integer and float vectors for the filter loops, mapped on SSE2
+ * (the requirement of this library on x86, see SSERendererDelegate) or
+ * NEON, and on plain arrays elsewhere.
+ *
+ * An ARGB pixel unpacks into the lanes [B, G, R, A], which is the order of
+ * its bytes in memory, so that packing it back needs no shuffle.
+ *
+ * All the operations give the same results as the scalar code they
+ * replace: integer multiplications keep the low 32 bits, float ones are
+ * never fused with the following addition.
+ */
+
+#include <jni.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DECORA_VECTOR_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define DECORA_VECTOR_NEON
+#include <arm_neon.h>
+#endif
+
+#ifdef DECORA_VECTOR_SSE2
+
+typedef __m128i vint4;
+typedef __m128 vfloat4;
+
+static inline vint4 vint4_zero() { return _mm_setzero_si128(); }
+static inline vint4 vint4_set1(jint v) { return _mm_set1_epi32(v); }
+static inline vint4 vint4_set(jint l0, jint l1, jint l2, jint l3) {
+    return _mm_setr_epi32(l0, l1, l2, l3);
+}
+static inline vint4 vint4_load(const jint *p) {
+    return _mm_loadu_si128((const __m128i *) p);
+}
+static inline void vint4_store(jint *p, vint4 v) {
+    _mm_storeu_si128((__m128i *) p, v);
+}
+static inline vint4 vint4_add(vint4 a, vint4 b) { return _mm_add_epi32(a, b); }
+static inline vint4 vint4_sub(vint4 a, vint4 b) { return _mm_sub_epi32(a, b); }
+static inline vint4 vint4_and(vint4 a, vint4 b) { return _mm_and_si128(a, b); }
+static inline vint4 vint4_or(vint4 a, vint4 b) { return _mm_or_si128(a, b); }
+// (mask & a) | (~mask & b)
+static inline vint4 vint4_select(vint4 mask, vint4 a, vint4 b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+static inline vint4 vint4_mullo(vint4 a, vint4 b) {
+    // SSE2 only multiplies the even lanes.
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+#define vint4_sra(v, n) _mm_srai_epi32((v), (n))
+#define vint4_srl(v, n) _mm_srli_epi32((v), (n))
+#define vint4_sll(v, n) _mm_slli_epi32((v), (n))
+static inline vint4 vint4_cmplt(vint4 a, vint4 b) { return _mm_cmplt_epi32(a, b); }
+// Running sums of the lanes: [l0, l0+l1, l0+l1+l2, l0+l1+l2+l3].
+static inline vint4 vint4_prefixsum(vint4 v) {
+    v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+    return _mm_add_epi32(v, _mm_slli_si128(v, 8));
+}
+static inline vint4 vint4_broadcast3(vint4 v) {
+    return _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+// One pixel in the lanes [B, G, R, A].
+static inline vint4 vint4_unpack(jint pixel) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i v = _mm_cvtsi32_si128(pixel);
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(v, zero), zero);
+}
+// Lanes [B, G, R, A] in 0..255 back into one pixel.
+static inline jint vint4_pack(vint4 v) {
+    v = _mm_packs_epi32(v, v);
+    return _mm_cvtsi128_si32(_mm_packus_epi16(v, v));
+}
+
+static inline vfloat4 vfloat4_zero() { return _mm_setzero_ps(); }
+static inline vfloat4 vfloat4_set1(jfloat v) { return _mm_set1_ps(v); }
+static inline vfloat4 vfloat4_load(const jfloat *p) { return _mm_loadu_ps(p); }
+static inline void vfloat4_store(jfloat *p, vfloat4 v) { _mm_storeu_ps(p, v); }
+static inline vfloat4 vfloat4_add(vfloat4 a, vfloat4 b) { return _mm_add_ps(a, b); }
+static inline vfloat4 vfloat4_mul(vfloat4 a, vfloat4 b) { return _mm_mul_ps(a, b); }
+static inline vfloat4 vfloat4_from_vint4(vint4 v) { return _mm_cvtepi32_ps(v); }
+static inline jfloat vfloat4_sum(vfloat4 v) {
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(v);
+}
+// (f < lo) ? 0 : ((f > hi) ? 255 : (jint) f), per lane.
+static inline vint4 vfloat4_tobyte(vfloat4 f, vfloat4 lo, vfloat4 hi) {
+    __m128i v = _mm_cvttps_epi32(f);
+    v = _mm_andnot_si128(_mm_castps_si128(_mm_cmplt_ps(f, lo)), v);
+    __m128i over = _mm_castps_si128(_mm_cmpgt_ps(f, hi));
+    return vint4_select(over, _mm_set1_epi32(255), v);
+}
+
+#elif defined(DECORA_VECTOR_NEON)
+
+typedef int32x4_t vint4;
+typedef float32x4_t vfloat4;
+
+static inline vint4 vint4_zero() { return vdupq_n_s32(0); }
+static inline vint4 vint4_set1(jint v) { return vdupq_n_s32(v); }
+static inline vint4 vint4_set(jint l0, jint l1, jint l2, jint l3) {
+    jint l[4] = { l0, l1, l2, l3 };
+    return vld1q_s32(l);
+}
+static inline vint4 vint4_load(const jint *p) { return vld1q_s32(p); }
+static inline void vint4_store(jint *p, vint4 v) { vst1q_s32(p, v); }
+static inline vint4 vint4_add(vint4 a, vint4 b) { return vaddq_s32(a, b); }
+static inline vint4 vint4_sub(vint4 a, vint4 b) { return vsubq_s32(a, b); }
+static inline vint4 vint4_and(vint4 a, vint4 b) { return vandq_s32(a, b); }
+static inline vint4 vint4_or(vint4 a, vint4 b) { return vorrq_s32(a, b); }
+static inline vint4 vint4_select(vint4 mask, vint4 a, vint4 b) {
+    return vbslq_s32(vreinterpretq_u32_s32(mask), a, b);
+}
+static inline vint4 vint4_mullo(vint4 a, vint4 b) { return vmulq_s32(a, b); }
+#define vint4_sra(v, n) vshrq_n_s32((v), (n))
+#define vint4_srl(v, n) vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(v), (n)))
+#define vint4_sll(v, n) vshlq_n_s32((v), (n))
+static inline vint4 vint4_cmplt(vint4 a, vint4 b) {
+    return vreinterpretq_s32_u32(vcltq_s32(a, b));
+}
+static inline vint4 vint4_prefixsum(vint4 v) {
+    vint4 zero = vdupq_n_s32(0);
+    v = vaddq_s32(v, vextq_s32(zero, v, 3));
+    return vaddq_s32(v, vextq_s32(zero, v, 2));
+}
+static inline vint4 vint4_broadcast3(vint4 v) { return vdupq_n_s32(vgetq_lane_s32(v, 3)); }
+
+static inline vint4 vint4_unpack(jint pixel) {
+    uint8x8_t b = vreinterpret_u8_u32(vdup_n_u32((uint32_t) pixel));
+    return vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vmovl_u8(b))));
+}
+static inline jint vint4_pack(vint4 v) {
+    uint16x4_t h = vmovn_u32(vreinterpretq_u32_s32(v));
+    uint8x8_t b = vmovn_u16(vcombine_u16(h, h));
+    return (jint) vget_lane_u32(vreinterpret_u32_u8(b), 0);
+}
+
+static inline vfloat4 vfloat4_zero() { return vdupq_n_f32(0.0f); }
+static inline vfloat4 vfloat4_set1(jfloat v) { return vdupq_n_f32(v); }
+static inline vfloat4 vfloat4_load(const jfloat *p) { return vld1q_f32(p); }
+static inline void vfloat4_store(jfloat *p, vfloat4 v) { vst1q_f32(p, v); }
+static inline vfloat4 vfloat4_add(vfloat4 a, vfloat4 b) { return vaddq_f32(a, b); }
+static inline vfloat4 vfloat4_mul(vfloat4 a, vfloat4 b) { return vmulq_f32(a, b); }
+static inline vfloat4 vfloat4_from_vint4(vint4 v) { return vcvtq_f32_s32(v); }
+static inline jfloat vfloat4_sum(vfloat4 v) {
+    float32x2_t s = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(s, 0) + vget_lane_f32(s, 1);
+}
+static inline vint4 vfloat4_tobyte(vfloat4 f, vfloat4 lo, vfloat4 hi) {
+    // vcvtq saturates instead of being undefined, the lanes out of
+    // range are replaced anyway.
+    vint4 v = vcvtq_s32_f32(f);
+    v = vbicq_s32(v, vreinterpretq_s32_u32(vcltq_f32(f, lo)));
+    return vbslq_s32(vcgtq_f32(f, hi), vdupq_n_s32(255), v);
+}
+
+#else
+
+struct vint4 { jint l[4]; };
+struct vfloat4 { jfloat l[4]; };
+
+static inline vint4 vint4_set(jint l0, jint l1, jint l2, jint l3) {
+    vint4 r = {{ l0, l1, l2, l3 }};
+    return r;
+}
+static inline vint4 vint4_zero() { return vint4_set(0, 0, 0, 0); }
+static inline vint4 vint4_set1(jint v) { return vint4_set(v, v, v, v); }
+static inline vint4 vint4_load(const jint *p) { return vint4_set(p[0], p[1], p[2], p[3]); }
+static inline void vint4_store(jint *p, vint4 v) {
+    for (int i = 0; i < 4; i++) p[i] = v.l[i];
+}
+#define DECORA_VINT4_OP(name, expr)                     \
+    static inline vint4 name(vint4 a, vint4 b) {        \
+        vint4 r;                                        \
+        for (int i = 0; i < 4; i++) r.l[i] = (expr);    \
+        return r;                                       \
+    }
+DECORA_VINT4_OP(vint4_add, (jint) ((unsigned int) a.l[i] + (unsigned int) b.l[i]))
+DECORA_VINT4_OP(vint4_sub, (jint) ((unsigned int) a.l[i] - (unsigned int) b.l[i]))
+DECORA_VINT4_OP(vint4_and, a.l[i] & b.l[i])
+DECORA_VINT4_OP(vint4_or, a.l[i] | b.l[i])
+DECORA_VINT4_OP(vint4_mullo, (jint) ((unsigned int) a.l[i] * (unsigned int) b.l[i]))
+DECORA_VINT4_OP(vint4_cmplt, (a.l[i] < b.l[i]) ? -1 : 0)
+#undef DECORA_VINT4_OP
+static inline vint4 vint4_select(vint4 mask, vint4 a, vint4 b) {
+    return vint4_or(vint4_and(mask, a), vint4_set(~mask.l[0] & b.l[0], ~mask.l[1] & b.l[1],
+                                                  ~mask.l[2] & b.l[2], ~mask.l[3] & b.l[3]));
+}
+static inline vint4 vint4_sra(vint4 v, int n) {
+    return vint4_set(v.l[0] >> n, v.l[1] >> n, v.l[2] >> n, v.l[3] >> n);
+}
+static inline vint4 vint4_srl(vint4 v, int n) {
+    return vint4_set((unsigned int) v.l[0] >> n, (unsigned int) v.l[1] >> n,
+                     (unsigned int) v.l[2] >> n, (unsigned int) v.l[3] >> n);
+}
+static inline vint4 vint4_sll(vint4 v, int n) {
+    return vint4_set((unsigned int) v.l[0] << n, (unsigned int) v.l[1] << n,
+                     (unsigned int) v.l[2] << n, (unsigned int) v.l[3] << n);
+}
+static inline vint4 vint4_prefixsum(vint4 v) {
+    return vint4_set(v.l[0], v.l[0] + v.l[1], v.l[0] + v.l[1] + v.l[2],
+                     v.l[0] + v.l[1] + v.l[2] + v.l[3]);
+}
+static inline vint4 vint4_broadcast3(vint4 v) { return vint4_set1(v.l[3]); }
+
+static inline vint4 vint4_unpack(jint pixel) {
+    return vint4_set((pixel      ) & 0xff, (pixel >>  8) & 0xff,
+                     (pixel >> 16) & 0xff, (pixel >> 24) & 0xff);
+}
+static inline jint vint4_pack(vint4 v) {
+    return (v.l[3] << 24) | (v.l[2] << 16) | (v.l[1] << 8) | v.l[0];
+}
+
+static inline vfloat4 vfloat4_set1(jfloat v) {
+    vfloat4 r = {{ v, v, v, v }};
+    return r;
+}
+static inline vfloat4 vfloat4_zero() { return vfloat4_set1(0.0f); }
+static inline vfloat4 vfloat4_load(const jfloat *p) {
+    vfloat4 r = {{ p[0], p[1], p[2], p[3] }};
+    return r;
+}
+static inline void vfloat4_store(jfloat *p, vfloat4 v) {
+    for (int i = 0; i < 4; i++) p[i] = v.l[i];
+}
+static inline vfloat4 vfloat4_add(vfloat4 a, vfloat4 b) {
+    vfloat4 r;
+    for (int i = 0; i < 4; i++) r.l[i] = a.l[i] + b.l[i];
+    return r;
+}
+static inline vfloat4 vfloat4_mul(vfloat4 a, vfloat4 b) {
+    vfloat4 r;
+    for (int i = 0; i < 4; i++) r.l[i] = a.l[i] * b.l[i];
+    return r;
+}
+static inline vfloat4 vfloat4_from_vint4(vint4 v) {
+    vfloat4 r;
+    for (int i = 0; i < 4; i++) r.l[i] = (jfloat) v.l[i];
+    return r;
+}
+static inline jfloat vfloat4_sum(vfloat4 v) {
+    return (v.l[0] + v.l[2]) + (v.l[1] + v.l[3]);
+}
+static inline vint4 vfloat4_tobyte(vfloat4 f, vfloat4 lo, vfloat4 hi) {
+    vint4 r;
+    for (int i = 0; i < 4; i++) {
+        r.l[i] = (f.l[i] < lo.l[i]) ? 0 : ((f.l[i] > hi.l[i]) ? 255 : (jint) f.l[i]);
+    }
+    return r;
+}
+
+#endif
+
+#endif /* _Included_SSEVector */
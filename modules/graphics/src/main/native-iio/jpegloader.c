@@ -1612,15 +1612,53 @@ JNIEXPORT jint JNICALL Java_com_sun_javafx_iio_jpeg_JPEGImageLoader_startDecompr
 
 #define SAFE_TO_MULT(a, b) (((a) > 0) && ((b) >= 0) && ((0x7fffffff / (a)) > (b)))
 
+/*
+ * Rows are decoded into a strip of about this many bytes, which is copied
+ * to the Java array at once. The array can't be the output buffer itself:
+ * it must not stay pinned while the source manager calls Java for more data.
+ */
+#define STRIP_SIZE (64 * 1024)
+
+/*
+ * The first row past row at which the percentage done reaches the next
+ * multiple of interval, or height if there is none.
+ */
+static JDIMENSION next_progress_row(JDIMENSION row, JDIMENSION height, int interval) {
+    jlong percent = ((jlong) row * 100 / height / interval + 1) * interval;
+    jlong next = (percent * height + 99) / 100;
+
+    return (next < (jlong) height) ? (JDIMENSION) next : height;
+}
+
+static boolean report_progress(JNIEnv *env, jobject this, imageIODataPtr data,
+        j_decompress_ptr cinfo, JDIMENSION row) {
+    RELEASE_ARRAYS(env, data, cinfo->src->next_input_byte);
+    (*env)->CallVoidMethod(env, this,
+            JPEGImageLoader_updateImageProgressID,
+            row);
+    if ((*env)->ExceptionCheck(env)) {
+        return FALSE;
+    }
+    if (GET_ARRAYS(env, data, &cinfo->src->next_input_byte) == NOT_OK) {
+        ThrowByName(env,
+                "java/io/IOException",
+                "Array pin failed");
+        return FALSE;
+    }
+    return TRUE;
+}
+
 JNIEXPORT jboolean JNICALL Java_com_sun_javafx_iio_jpeg_JPEGImageLoader_decompressIndirect
-(JNIEnv *env, jobject this, jlong ptr, jboolean report_progress, jbyteArray barray) {
+(JNIEnv *env, jobject this, jlong ptr, jint progress_interval, jbyteArray barray) {
     imageIODataPtr data = (imageIODataPtr) jlong_to_ptr(ptr);
     j_decompress_ptr cinfo = (j_decompress_ptr) data->jpegObj;
-    struct jpeg_source_mgr *src = cinfo->src;
     sun_jpeg_error_ptr jerr;
     int bytes_per_row = cinfo->output_width * cinfo->output_components;
     int offset = 0;
-    JSAMPROW scanline_ptr = NULL;
+    int strip_rows, i;
+    JDIMENSION progress_row;
+    JSAMPLE *strip;
+    JSAMPARRAY rows;
 
     if (!SAFE_TO_MULT(cinfo->output_width, cinfo->output_components) ||
         !SAFE_TO_MULT(bytes_per_row, cinfo->output_height) ||
@@ -1633,7 +1671,34 @@ JNIEXPORT jboolean JNICALL Java_com_sun_javafx_iio_jpeg_JPEGImageLoader_decompre
         return JNI_FALSE;
     }
 
+    /* Whole groups of rec_outbuf_height rows, so that none goes through
+       the library's own buffer. */
+    strip_rows = STRIP_SIZE / bytes_per_row;
+    strip_rows -= strip_rows % cinfo->rec_outbuf_height;
+    if (strip_rows < cinfo->rec_outbuf_height) {
+        strip_rows = cinfo->rec_outbuf_height;
+    }
+    if (strip_rows > (int) cinfo->output_height) {
+        strip_rows = cinfo->output_height;
+    }
+
+    strip = (JSAMPLE *) malloc((size_t) strip_rows * bytes_per_row * sizeof(JSAMPLE));
+    rows = (JSAMPARRAY) malloc(strip_rows * sizeof(JSAMPROW));
+    if (strip == NULL || rows == NULL) {
+        free(strip);
+        free(rows);
+        ThrowByName(env,
+                "java/lang/OutOfMemoryError",
+                "Reading JPEG Stream");
+        return JNI_FALSE;
+    }
+    for (i = 0; i < strip_rows; i++) {
+        rows[i] = strip + i * bytes_per_row;
+    }
+
     if (GET_ARRAYS(env, data, &cinfo->src->next_input_byte) == NOT_OK) {
+        free(strip);
+        free(rows);
         ThrowByName(env,
                 "java/io/IOException",
                 "Array pin failed");
@@ -1652,67 +1717,55 @@ JNIEXPORT jboolean JNICALL Java_com_sun_javafx_iio_jpeg_JPEGImageLoader_decompre
                     buffer);
             ThrowByName(env, "java/io/IOException", buffer);
         }
+        free(strip);
+        free(rows);
         RELEASE_ARRAYS(env, data, cinfo->src->next_input_byte);
         return JNI_FALSE;
     }
 
-    scanline_ptr = (JSAMPROW) malloc(bytes_per_row * sizeof(JSAMPLE));
-    if (scanline_ptr == NULL) {
-        ThrowByName(env,
-                "java/lang/OutOfMemoryError",
-                "Reading JPEG Stream");
-        return JNI_FALSE;
-    }
-
+    progress_row = 0;
     while (cinfo->output_scanline < cinfo->output_height) {
-        int num_scanlines;
-        if (report_progress == JNI_TRUE) {
-            RELEASE_ARRAYS(env, data, cinfo->src->next_input_byte);
-            (*env)->CallVoidMethod(env, this,
-                    JPEGImageLoader_updateImageProgressID,
-                    cinfo->output_scanline);
-            if ((*env)->ExceptionCheck(env)) {
-                free(scanline_ptr);
-                return JNI_FALSE;
+        JDIMENSION max_lines = strip_rows;
+        JDIMENSION num_scanlines;
+        jbyte *body;
+
+        if (progress_interval > 0) {
+            if (cinfo->output_scanline == progress_row) {
+                if (!report_progress(env, this, data, cinfo, progress_row)) {
+                    free(strip);
+                    free(rows);
+                    return JNI_FALSE;
+                }
+                progress_row = next_progress_row(progress_row,
+                        cinfo->output_height, progress_interval);
             }
-            if (GET_ARRAYS(env, data, &cinfo->src->next_input_byte) == NOT_OK) {
-                free(scanline_ptr);
-                ThrowByName(env,
-                          "java/io/IOException",
-                          "Array pin failed");
-                return JNI_FALSE;
+            /* Stop at the next report. */
+            if (progress_row - cinfo->output_scanline < max_lines) {
+                max_lines = progress_row - cinfo->output_scanline;
             }
         }
 
-        num_scanlines = jpeg_read_scanlines(cinfo, &scanline_ptr, 1);
-        if (num_scanlines == 1) {
-            jbyte *body = (*env)->GetPrimitiveArrayCritical(env, barray, NULL);
+        num_scanlines = jpeg_read_scanlines(cinfo, rows, max_lines);
+        if (num_scanlines > 0) {
+            body = (*env)->GetPrimitiveArrayCritical(env, barray, NULL);
             if (body == NULL) {
                 fprintf(stderr, "decompressIndirect: GetPrimitiveArrayCritical returns NULL: out of memory\n");
-                free(scanline_ptr);
+                free(strip);
+                free(rows);
+                RELEASE_ARRAYS(env, data, cinfo->src->next_input_byte);
                 return JNI_FALSE;
             }
-            memcpy(body+offset,scanline_ptr, bytes_per_row);
-            (*env)->ReleasePrimitiveArrayCritical(env, barray, body, JNI_ABORT);
-            offset += bytes_per_row;
+            memcpy(body + offset, strip, (size_t) num_scanlines * bytes_per_row);
+            (*env)->ReleasePrimitiveArrayCritical(env, barray, body, 0);
+            offset += num_scanlines * bytes_per_row;
         }
     }
-    free(scanline_ptr);
+    free(strip);
+    free(rows);
 
-    if (report_progress == JNI_TRUE) {
-        RELEASE_ARRAYS(env, data, cinfo->src->next_input_byte);
-        (*env)->CallVoidMethod(env, this,
-                JPEGImageLoader_updateImageProgressID,
-                cinfo->output_height);
-        if ((*env)->ExceptionCheck(env)) {
-            return JNI_FALSE;
-        }
-        if (GET_ARRAYS(env, data, &cinfo->src->next_input_byte) == NOT_OK) {
-            ThrowByName(env,
-                "java/io/IOException",
-                "Array pin failed");
-            return JNI_FALSE;
-        }
+    if (progress_interval > 0 &&
+            !report_progress(env, this, data, cinfo, cinfo->output_height)) {
+        return JNI_FALSE;
     }
 
     jpeg_finish_decompress(cinfo);
@@ -13,6 +13,13 @@
 #include "jinclude.h"
 #include "jpeglib.h"
 
+#ifdef JSIMD_AVX2_SUPPORTED
+#include <immintrin.h>
+#endif
+#ifdef JSIMD_NEON_SUPPORTED
+#include <arm_neon.h>
+#endif
+
 
 #if RANGE_BITS < 2
   /* Deliberate syntax err */
@@ -238,6 +245,204 @@ ycc_rgb_convert (j_decompress_ptr cinfo,
 }
 
 
+/*
+ * Vector versions of ycc_rgb_convert for sYCC, computing the table entries
+ * of build_ycc_rgb_table instead of looking them up.  With x = Cb or Cr
+ * minus CENTERJSAMPLE, the entries split into multiples of x and products
+ * that fit in 16 bits:
+ *   Cr_r_tab[cr] = x + ((26345 * x + ONE_HALF) >> SCALEBITS)
+ *   Cb_b_tab[cb] = 2 * x + ((-14942 * x + ONE_HALF) >> SCALEBITS)
+ *   (Cb_g_tab[cb] + Cr_g_tab[cr]) >> SCALEBITS =
+ *     ((-22553 * x_cb + 18734 * x_cr + ONE_HALF) >> SCALEBITS) - x_cr
+ * so the results are the same.
+ */
+
+#define FIX_R_FRAC    26345    /* FIX(1.402) - ONE */
+#define FIX_B_FRAC    (-14942)    /* FIX(1.772) - 2 * ONE */
+#define FIX_G_CB    (-22553)    /* - FIX(0.344136286) */
+#define FIX_G_CR_FRAC    18734    /* ONE - FIX(0.714136286) */
+
+/* The vector loops store R, G, B samples in this order. */
+#if RGB_PIXELSIZE != 3 || RGB_RED != 0 || RGB_GREEN != 1 || RGB_BLUE != 2
+#undef JSIMD_AVX2_SUPPORTED
+#undef JSIMD_NEON_SUPPORTED
+#endif
+
+#if defined(JSIMD_AVX2_SUPPORTED) || defined(JSIMD_NEON_SUPPORTED)
+
+/* Convert the columns from col on, like ycc_rgb_convert does. */
+
+LOCAL(void)
+ycc_rgb_convert_cols (my_cconvert_ptr cconvert, JSAMPLE * range_limit,
+              JSAMPROW inptr0, JSAMPROW inptr1, JSAMPROW inptr2,
+              JSAMPROW outptr, JDIMENSION col, JDIMENSION num_cols)
+{
+  register int y, cb, cr;
+  SHIFT_TEMPS
+
+  for (outptr += col * RGB_PIXELSIZE; col < num_cols; col++) {
+    y  = GETJSAMPLE(inptr0[col]);
+    cb = GETJSAMPLE(inptr1[col]);
+    cr = GETJSAMPLE(inptr2[col]);
+    outptr[RGB_RED]   = range_limit[y + cconvert->Cr_r_tab[cr]];
+    outptr[RGB_GREEN] = range_limit[y +
+                ((int) RIGHT_SHIFT(cconvert->Cb_g_tab[cb] +
+                                   cconvert->Cr_g_tab[cr],
+                       SCALEBITS))];
+    outptr[RGB_BLUE]  = range_limit[y + cconvert->Cb_b_tab[cb]];
+    outptr += RGB_PIXELSIZE;
+  }
+}
+
+#endif
+
+#ifdef JSIMD_AVX2_SUPPORTED
+
+/* Byte shuffles interleaving 16 R, G and B samples into three vectors */
+
+static const signed char interleave_rgb[3][3][16] = {
+  { { 0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128, -128, 5 },
+    { -128, 0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128, -128 },
+    { -128, -128, 0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128 } },
+  { { -128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128, 10, -128 },
+    { 5, -128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128, 10 },
+    { -128, 5, -128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128 } },
+  { { -128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15, -128, -128 },
+    { -128, -128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15, -128 },
+    { 10, -128, -128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15 } }
+};
+
+/* (x * c + ONE_HALF) >> SCALEBITS in 16-bit lanes */
+
+LOCAL(INLINE __m256i) JSIMD_TARGET_AVX2
+descale_mul_avx2 (__m256i x, short c)
+{
+  __m256i k = _mm256_set1_epi16(c);
+
+  return _mm256_add_epi16(_mm256_mulhi_epi16(x, k),
+              _mm256_srli_epi16(_mm256_mullo_epi16(x, k), 15));
+}
+
+METHODDEF(void) JSIMD_TARGET_AVX2
+ycc_rgb_convert_avx2 (j_decompress_ptr cinfo,
+              JSAMPIMAGE input_buf, JDIMENSION input_row,
+              JSAMPARRAY output_buf, int num_rows)
+{
+  my_cconvert_ptr cconvert = (my_cconvert_ptr) cinfo->cconvert;
+  JSAMPROW outptr;
+  JSAMPROW inptr0, inptr1, inptr2;
+  JDIMENSION col;
+  JDIMENSION num_cols = cinfo->output_width;
+  __m256i center = _mm256_set1_epi16(CENTERJSAMPLE);
+  __m256i g_coefs = _mm256_set1_epi32(((INT32) FIX_G_CR_FRAC << 16) |
+                                      (FIX_G_CB & 0xFFFF));
+  __m256i half = _mm256_set1_epi32(ONE_HALF);
+  __m256i y, cb, cr, r, g, b, glo, ghi;
+  __m128i r8, g8, b8;
+  int i;
+
+  while (--num_rows >= 0) {
+    inptr0 = input_buf[0][input_row];
+    inptr1 = input_buf[1][input_row];
+    inptr2 = input_buf[2][input_row];
+    input_row++;
+    outptr = *output_buf++;
+    for (col = 0; col + 16 <= num_cols; col += 16) {
+      y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (inptr0 + col)));
+      cb = _mm256_sub_epi16(_mm256_cvtepu8_epi16(
+        _mm_loadu_si128((const __m128i *) (inptr1 + col))), center);
+      cr = _mm256_sub_epi16(_mm256_cvtepu8_epi16(
+        _mm_loadu_si128((const __m128i *) (inptr2 + col))), center);
+
+      r = _mm256_add_epi16(_mm256_add_epi16(y, cr),
+               descale_mul_avx2(cr, FIX_R_FRAC));
+      b = _mm256_add_epi16(_mm256_add_epi16(y, _mm256_add_epi16(cb, cb)),
+               descale_mul_avx2(cb, FIX_B_FRAC));
+      glo = _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(
+        _mm256_unpacklo_epi16(cb, cr), g_coefs), half), SCALEBITS);
+      ghi = _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(
+        _mm256_unpackhi_epi16(cb, cr), g_coefs), half), SCALEBITS);
+      g = _mm256_sub_epi16(_mm256_add_epi16(y, _mm256_packs_epi32(glo, ghi)),
+               cr);
+
+      /* Range-limit by saturation, the samples in order in r8, g8, b8 */
+      r = _mm256_permute4x64_epi64(_mm256_packus_epi16(r, g), 0xD8);
+      b = _mm256_permute4x64_epi64(_mm256_packus_epi16(b, b), 0xD8);
+      r8 = _mm256_castsi256_si128(r);
+      g8 = _mm256_extracti128_si256(r, 1);
+      b8 = _mm256_castsi256_si128(b);
+
+      for (i = 0; i < 3; i++) {
+        __m128i px = _mm_or_si128(
+          _mm_or_si128(
+            _mm_shuffle_epi8(r8, _mm_loadu_si128((const __m128i *) interleave_rgb[i][0])),
+            _mm_shuffle_epi8(g8, _mm_loadu_si128((const __m128i *) interleave_rgb[i][1]))),
+          _mm_shuffle_epi8(b8, _mm_loadu_si128((const __m128i *) interleave_rgb[i][2])));
+
+        _mm_storeu_si128((__m128i *) (outptr + col * RGB_PIXELSIZE + i * 16), px);
+      }
+    }
+    ycc_rgb_convert_cols(cconvert, cinfo->sample_range_limit,
+             inptr0, inptr1, inptr2, outptr, col, num_cols);
+  }
+}
+
+#endif /* JSIMD_AVX2_SUPPORTED */
+
+
+#ifdef JSIMD_NEON_SUPPORTED
+
+METHODDEF(void)
+ycc_rgb_convert_neon (j_decompress_ptr cinfo,
+              JSAMPIMAGE input_buf, JDIMENSION input_row,
+              JSAMPARRAY output_buf, int num_rows)
+{
+  my_cconvert_ptr cconvert = (my_cconvert_ptr) cinfo->cconvert;
+  JSAMPROW outptr;
+  JSAMPROW inptr0, inptr1, inptr2;
+  JDIMENSION col;
+  JDIMENSION num_cols = cinfo->output_width;
+  uint8x8_t center = vdup_n_u8(CENTERJSAMPLE);
+  int16x8_t y, cb, cr, r, g, b;
+  uint8x8x3_t px;
+
+  while (--num_rows >= 0) {
+    inptr0 = input_buf[0][input_row];
+    inptr1 = input_buf[1][input_row];
+    inptr2 = input_buf[2][input_row];
+    input_row++;
+    outptr = *output_buf++;
+    for (col = 0; col + 8 <= num_cols; col += 8) {
+      y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(inptr0 + col)));
+      cb = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(inptr1 + col), center));
+      cr = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(inptr2 + col), center));
+
+      r = vcombine_s16(
+        vrshrn_n_s32(vmull_n_s16(vget_low_s16(cr), FIX_R_FRAC), SCALEBITS),
+        vrshrn_n_s32(vmull_n_s16(vget_high_s16(cr), FIX_R_FRAC), SCALEBITS));
+      g = vcombine_s16(
+        vrshrn_n_s32(vmlal_n_s16(vmull_n_s16(vget_low_s16(cb), FIX_G_CB),
+                                 vget_low_s16(cr), FIX_G_CR_FRAC), SCALEBITS),
+        vrshrn_n_s32(vmlal_n_s16(vmull_n_s16(vget_high_s16(cb), FIX_G_CB),
+                                 vget_high_s16(cr), FIX_G_CR_FRAC), SCALEBITS));
+      b = vcombine_s16(
+        vrshrn_n_s32(vmull_n_s16(vget_low_s16(cb), FIX_B_FRAC), SCALEBITS),
+        vrshrn_n_s32(vmull_n_s16(vget_high_s16(cb), FIX_B_FRAC), SCALEBITS));
+
+      /* Range-limit by saturation */
+      px.val[0] = vqmovun_s16(vaddq_s16(vaddq_s16(y, cr), r));
+      px.val[1] = vqmovun_s16(vsubq_s16(vaddq_s16(y, g), cr));
+      px.val[2] = vqmovun_s16(vaddq_s16(vaddq_s16(y, vshlq_n_s16(cb, 1)), b));
+      vst3_u8(outptr + col * RGB_PIXELSIZE, px);
+    }
+    ycc_rgb_convert_cols(cconvert, cinfo->sample_range_limit,
+             inptr0, inptr1, inptr2, outptr, col, num_cols);
+  }
+}
+
+#endif /* JSIMD_NEON_SUPPORTED */
+
+
 /**************** Cases other than YCC -> RGB ****************/
 
 
@@ -762,6 +967,13 @@ jinit_color_deconverter (j_decompress_ptr cinfo)
       break;
     case JCS_YCbCr:
       cconvert->pub.color_convert = ycc_rgb_convert;
+#ifdef JSIMD_AVX2_SUPPORTED
+      if (jsimd_avx2_supported())
+    cconvert->pub.color_convert = ycc_rgb_convert_avx2;
+#endif
+#ifdef JSIMD_NEON_SUPPORTED
+      cconvert->pub.color_convert = ycc_rgb_convert_neon;
+#endif
       build_ycc_rgb_table(cinfo);
       break;
     case JCS_BG_YCC:
@@ -231,6 +231,13 @@ start_pass (j_decompress_ptr cinfo)
 #ifdef DCT_ISLOW_SUPPORTED
       case JDCT_ISLOW:
     method_ptr = jpeg_idct_islow;
+#ifdef JSIMD_AVX2_SUPPORTED
+    if (jsimd_avx2_supported())
+      method_ptr = jpeg_idct_islow_avx2;
+#endif
+#ifdef JSIMD_NEON_SUPPORTED
+    method_ptr = jpeg_idct_islow_neon;
+#endif
     method = JDCT_ISLOW;
     break;
 #endif
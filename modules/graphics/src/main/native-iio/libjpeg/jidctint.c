@@ -53,6 +53,13 @@
 #include "jpeglib.h"
 #include "jdct.h"        /* Private declarations for DCT subsystem */
 
+#ifdef JSIMD_AVX2_SUPPORTED
+#include <immintrin.h>
+#endif
+#ifdef JSIMD_NEON_SUPPORTED
+#include <arm_neon.h>
+#endif
+
 #ifdef DCT_ISLOW_SUPPORTED
 
 
@@ -424,6 +431,333 @@ jpeg_idct_islow (j_decompress_ptr cinfo, jpeg_component_info * compptr,
   }
 }
 
+#ifdef JSIMD_AVX2_SUPPORTED
+
+/*
+ * The 1-D kernel of jpeg_idct_islow, on the eight columns or rows of a
+ * block at once in 32-bit lanes.  The products are the same as the ones
+ * of the portable code as long as they fit in 32 bits, as they do for
+ * the coefficients of valid 8-bit data.  round is the fudge factor for
+ * the final descale, shifted left by CONST_BITS.
+ */
+
+#define MUL_AVX2(x,c)  _mm256_mullo_epi32(x, _mm256_set1_epi32(c))
+
+LOCAL(INLINE void) JSIMD_TARGET_AVX2
+idct_1d_avx2 (__m256i * v, __m256i round, int shift)
+{
+  __m256i tmp0, tmp1, tmp2, tmp3;
+  __m256i tmp10, tmp11, tmp12, tmp13;
+  __m256i z1, z2, z3;
+
+  /* Even part */
+
+  tmp0 = _mm256_add_epi32(_mm256_slli_epi32(_mm256_add_epi32(v[0], v[4]),
+                                            CONST_BITS), round);
+  tmp1 = _mm256_add_epi32(_mm256_slli_epi32(_mm256_sub_epi32(v[0], v[4]),
+                                            CONST_BITS), round);
+
+  z1 = MUL_AVX2(_mm256_add_epi32(v[2], v[6]), FIX_0_541196100);
+  tmp2 = _mm256_add_epi32(z1, MUL_AVX2(v[2], FIX_0_765366865));
+  tmp3 = _mm256_sub_epi32(z1, MUL_AVX2(v[6], FIX_1_847759065));
+
+  tmp10 = _mm256_add_epi32(tmp0, tmp2);
+  tmp13 = _mm256_sub_epi32(tmp0, tmp2);
+  tmp11 = _mm256_add_epi32(tmp1, tmp3);
+  tmp12 = _mm256_sub_epi32(tmp1, tmp3);
+
+  /* Odd part */
+
+  tmp0 = v[7];
+  tmp1 = v[5];
+  tmp2 = v[3];
+  tmp3 = v[1];
+
+  z2 = _mm256_add_epi32(tmp0, tmp2);
+  z3 = _mm256_add_epi32(tmp1, tmp3);
+
+  z1 = MUL_AVX2(_mm256_add_epi32(z2, z3), FIX_1_175875602);
+  z2 = _mm256_add_epi32(MUL_AVX2(z2, - FIX_1_961570560), z1);
+  z3 = _mm256_add_epi32(MUL_AVX2(z3, - FIX_0_390180644), z1);
+
+  z1 = MUL_AVX2(_mm256_add_epi32(tmp0, tmp3), - FIX_0_899976223);
+  tmp0 = _mm256_add_epi32(MUL_AVX2(tmp0, FIX_0_298631336),
+                          _mm256_add_epi32(z1, z2));
+  tmp3 = _mm256_add_epi32(MUL_AVX2(tmp3, FIX_1_501321110),
+                          _mm256_add_epi32(z1, z3));
+
+  z1 = MUL_AVX2(_mm256_add_epi32(tmp1, tmp2), - FIX_2_562915447);
+  tmp1 = _mm256_add_epi32(MUL_AVX2(tmp1, FIX_2_053119869),
+                          _mm256_add_epi32(z1, z3));
+  tmp2 = _mm256_add_epi32(MUL_AVX2(tmp2, FIX_3_072711026),
+                          _mm256_add_epi32(z1, z2));
+
+  /* Final output stage */
+
+  v[0] = _mm256_srai_epi32(_mm256_add_epi32(tmp10, tmp3), shift);
+  v[7] = _mm256_srai_epi32(_mm256_sub_epi32(tmp10, tmp3), shift);
+  v[1] = _mm256_srai_epi32(_mm256_add_epi32(tmp11, tmp2), shift);
+  v[6] = _mm256_srai_epi32(_mm256_sub_epi32(tmp11, tmp2), shift);
+  v[2] = _mm256_srai_epi32(_mm256_add_epi32(tmp12, tmp1), shift);
+  v[5] = _mm256_srai_epi32(_mm256_sub_epi32(tmp12, tmp1), shift);
+  v[3] = _mm256_srai_epi32(_mm256_add_epi32(tmp13, tmp0), shift);
+  v[4] = _mm256_srai_epi32(_mm256_sub_epi32(tmp13, tmp0), shift);
+}
+
+
+/* Transpose the 8x8 block in v, one row per vector. */
+
+LOCAL(INLINE void) JSIMD_TARGET_AVX2
+transpose_avx2 (__m256i * v)
+{
+  __m256i t0, t1, t2, t3, t4, t5, t6, t7;
+  __m256i u0, u1, u2, u3, u4, u5, u6, u7;
+
+  t0 = _mm256_unpacklo_epi32(v[0], v[1]);
+  t1 = _mm256_unpackhi_epi32(v[0], v[1]);
+  t2 = _mm256_unpacklo_epi32(v[2], v[3]);
+  t3 = _mm256_unpackhi_epi32(v[2], v[3]);
+  t4 = _mm256_unpacklo_epi32(v[4], v[5]);
+  t5 = _mm256_unpackhi_epi32(v[4], v[5]);
+  t6 = _mm256_unpacklo_epi32(v[6], v[7]);
+  t7 = _mm256_unpackhi_epi32(v[6], v[7]);
+
+  u0 = _mm256_unpacklo_epi64(t0, t2);
+  u1 = _mm256_unpackhi_epi64(t0, t2);
+  u2 = _mm256_unpacklo_epi64(t1, t3);
+  u3 = _mm256_unpackhi_epi64(t1, t3);
+  u4 = _mm256_unpacklo_epi64(t4, t6);
+  u5 = _mm256_unpackhi_epi64(t4, t6);
+  u6 = _mm256_unpacklo_epi64(t5, t7);
+  u7 = _mm256_unpackhi_epi64(t5, t7);
+
+  v[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+  v[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+  v[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+  v[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+  v[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+  v[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+  v[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+  v[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+
+/*
+ * Perform dequantization and inverse DCT on one block of coefficients,
+ * like jpeg_idct_islow does.  The passes don't skip the columns and rows
+ * of zero AC terms, whose results are the same with the full kernel.
+ */
+
+GLOBAL(void) JSIMD_TARGET_AVX2
+jpeg_idct_islow_avx2 (j_decompress_ptr cinfo, jpeg_component_info * compptr,
+              JCOEFPTR coef_block,
+              JSAMPARRAY output_buf, JDIMENSION output_col)
+{
+  ISLOW_MULT_TYPE * quantptr = (ISLOW_MULT_TYPE *) compptr->dct_table;
+  __m256i v[DCTSIZE];
+  __m128i out;
+  int ctr;
+
+  /* Pass 1: process columns from input, in the lanes of the rows. */
+
+  for (ctr = 0; ctr < DCTSIZE; ctr++) {
+    v[ctr] = _mm256_mullo_epi32(
+      _mm256_cvtepi16_epi32(
+        _mm_loadu_si128((const __m128i *) (coef_block + ctr * DCTSIZE))),
+      _mm256_loadu_si256((const __m256i *) (quantptr + ctr * DCTSIZE)));
+  }
+  idct_1d_avx2(v, _mm256_set1_epi32(ONE << (CONST_BITS-PASS1_BITS-1)),
+           CONST_BITS-PASS1_BITS);
+
+  /* Pass 2: process rows, with the range center and fudge factor
+   * added to the DC term.
+   */
+
+  transpose_avx2(v);
+  idct_1d_avx2(v, _mm256_set1_epi32((((INT32) RANGE_CENTER << (PASS1_BITS+3)) +
+                                     (ONE << (PASS1_BITS+2))) << CONST_BITS),
+           CONST_BITS+PASS1_BITS+3);
+  transpose_avx2(v);
+
+  /* Range-limit like range_limit[x & RANGE_MASK] does, and store the rows. */
+
+  for (ctr = 0; ctr < DCTSIZE; ctr += 2) {
+    __m256i mask = _mm256_set1_epi32(RANGE_MASK);
+    __m256i subset = _mm256_set1_epi32(RANGE_SUBSET);
+    __m256i row0 = _mm256_sub_epi32(_mm256_and_si256(v[ctr], mask), subset);
+    __m256i row1 = _mm256_sub_epi32(_mm256_and_si256(v[ctr+1], mask), subset);
+
+    /* Rows 0 and 1 in the low and high halves, as 16-bit lanes */
+    out = _mm_packs_epi32(_mm256_castsi256_si128(row0),
+                          _mm256_extracti128_si256(row0, 1));
+    out = _mm_packus_epi16(out, _mm_packs_epi32(
+                                  _mm256_castsi256_si128(row1),
+                                  _mm256_extracti128_si256(row1, 1)));
+    _mm_storel_epi64((__m128i *) (output_buf[ctr] + output_col), out);
+    _mm_storel_epi64((__m128i *) (output_buf[ctr+1] + output_col),
+                     _mm_unpackhi_epi64(out, out));
+  }
+}
+
+#endif /* JSIMD_AVX2_SUPPORTED */
+
+
+#ifdef JSIMD_NEON_SUPPORTED
+
+/*
+ * The 1-D kernel of jpeg_idct_islow, on four columns or rows of a block
+ * at once, in 32-bit lanes like the AVX2 version.
+ */
+
+LOCAL(INLINE void)
+idct_1d_neon (int32x4_t * v, int32x4_t round, int shift)
+{
+  int32x4_t tmp0, tmp1, tmp2, tmp3;
+  int32x4_t tmp10, tmp11, tmp12, tmp13;
+  int32x4_t z1, z2, z3;
+  int32x4_t nshift = vdupq_n_s32(- shift);
+
+  /* Even part */
+
+  tmp0 = vaddq_s32(vshlq_n_s32(vaddq_s32(v[0], v[4]), CONST_BITS), round);
+  tmp1 = vaddq_s32(vshlq_n_s32(vsubq_s32(v[0], v[4]), CONST_BITS), round);
+
+  z1 = vmulq_n_s32(vaddq_s32(v[2], v[6]), FIX_0_541196100);
+  tmp2 = vmlaq_n_s32(z1, v[2], FIX_0_765366865);
+  tmp3 = vmlsq_n_s32(z1, v[6], FIX_1_847759065);
+
+  tmp10 = vaddq_s32(tmp0, tmp2);
+  tmp13 = vsubq_s32(tmp0, tmp2);
+  tmp11 = vaddq_s32(tmp1, tmp3);
+  tmp12 = vsubq_s32(tmp1, tmp3);
+
+  /* Odd part */
+
+  tmp0 = v[7];
+  tmp1 = v[5];
+  tmp2 = v[3];
+  tmp3 = v[1];
+
+  z2 = vaddq_s32(tmp0, tmp2);
+  z3 = vaddq_s32(tmp1, tmp3);
+
+  z1 = vmulq_n_s32(vaddq_s32(z2, z3), FIX_1_175875602);
+  z2 = vmlsq_n_s32(z1, z2, FIX_1_961570560);
+  z3 = vmlsq_n_s32(z1, z3, FIX_0_390180644);
+
+  z1 = vmulq_n_s32(vaddq_s32(tmp0, tmp3), - FIX_0_899976223);
+  tmp0 = vmlaq_n_s32(vaddq_s32(z1, z2), tmp0, FIX_0_298631336);
+  tmp3 = vmlaq_n_s32(vaddq_s32(z1, z3), tmp3, FIX_1_501321110);
+
+  z1 = vmulq_n_s32(vaddq_s32(tmp1, tmp2), - FIX_2_562915447);
+  tmp1 = vmlaq_n_s32(vaddq_s32(z1, z3), tmp1, FIX_2_053119869);
+  tmp2 = vmlaq_n_s32(vaddq_s32(z1, z2), tmp2, FIX_3_072711026);
+
+  /* Final output stage */
+
+  v[0] = vshlq_s32(vaddq_s32(tmp10, tmp3), nshift);
+  v[7] = vshlq_s32(vsubq_s32(tmp10, tmp3), nshift);
+  v[1] = vshlq_s32(vaddq_s32(tmp11, tmp2), nshift);
+  v[6] = vshlq_s32(vsubq_s32(tmp11, tmp2), nshift);
+  v[2] = vshlq_s32(vaddq_s32(tmp12, tmp1), nshift);
+  v[5] = vshlq_s32(vsubq_s32(tmp12, tmp1), nshift);
+  v[3] = vshlq_s32(vaddq_s32(tmp13, tmp0), nshift);
+  v[4] = vshlq_s32(vsubq_s32(tmp13, tmp0), nshift);
+}
+
+
+/* Transpose the 4x4 block in a..d, one row per vector. */
+
+LOCAL(INLINE void)
+transpose4_neon (int32x4_t * a, int32x4_t * b, int32x4_t * c, int32x4_t * d)
+{
+  int32x4x2_t ab = vtrnq_s32(*a, *b);
+  int32x4x2_t cd = vtrnq_s32(*c, *d);
+
+  *a = vcombine_s32(vget_low_s32(ab.val[0]), vget_low_s32(cd.val[0]));
+  *b = vcombine_s32(vget_low_s32(ab.val[1]), vget_low_s32(cd.val[1]));
+  *c = vcombine_s32(vget_high_s32(ab.val[0]), vget_high_s32(cd.val[0]));
+  *d = vcombine_s32(vget_high_s32(ab.val[1]), vget_high_s32(cd.val[1]));
+}
+
+
+/* Transpose the 8x8 block in lo and hi, the left and right halves of the
+ * rows.
+ */
+
+LOCAL(INLINE void)
+transpose_neon (int32x4_t * lo, int32x4_t * hi)
+{
+  int ctr;
+  int32x4_t tmp;
+
+  transpose4_neon(&lo[0], &lo[1], &lo[2], &lo[3]);
+  transpose4_neon(&hi[0], &hi[1], &hi[2], &hi[3]);
+  transpose4_neon(&lo[4], &lo[5], &lo[6], &lo[7]);
+  transpose4_neon(&hi[4], &hi[5], &hi[6], &hi[7]);
+  for (ctr = 0; ctr < 4; ctr++) {
+    tmp = hi[ctr];
+    hi[ctr] = lo[ctr+4];
+    lo[ctr+4] = tmp;
+  }
+}
+
+
+/*
+ * Perform dequantization and inverse DCT on one block of coefficients,
+ * like jpeg_idct_islow does.
+ */
+
+GLOBAL(void)
+jpeg_idct_islow_neon (j_decompress_ptr cinfo, jpeg_component_info * compptr,
+              JCOEFPTR coef_block,
+              JSAMPARRAY output_buf, JDIMENSION output_col)
+{
+  ISLOW_MULT_TYPE * quantptr = (ISLOW_MULT_TYPE *) compptr->dct_table;
+  int32x4_t lo[DCTSIZE], hi[DCTSIZE];
+  int32x4_t round;
+  int ctr;
+
+  /* Pass 1: process columns from input, in the lanes of the rows. */
+
+  for (ctr = 0; ctr < DCTSIZE; ctr++) {
+    int16x8_t coef = vld1q_s16(coef_block + ctr * DCTSIZE);
+
+    lo[ctr] = vmulq_s32(vmovl_s16(vget_low_s16(coef)),
+                        vld1q_s32(quantptr + ctr * DCTSIZE));
+    hi[ctr] = vmulq_s32(vmovl_s16(vget_high_s16(coef)),
+                        vld1q_s32(quantptr + ctr * DCTSIZE + 4));
+  }
+  round = vdupq_n_s32(ONE << (CONST_BITS-PASS1_BITS-1));
+  idct_1d_neon(lo, round, CONST_BITS-PASS1_BITS);
+  idct_1d_neon(hi, round, CONST_BITS-PASS1_BITS);
+
+  /* Pass 2: process rows, with the range center and fudge factor
+   * added to the DC term.
+   */
+
+  transpose_neon(lo, hi);
+  round = vdupq_n_s32((((INT32) RANGE_CENTER << (PASS1_BITS+3)) +
+                       (ONE << (PASS1_BITS+2))) << CONST_BITS);
+  idct_1d_neon(lo, round, CONST_BITS+PASS1_BITS+3);
+  idct_1d_neon(hi, round, CONST_BITS+PASS1_BITS+3);
+  transpose_neon(lo, hi);
+
+  /* Range-limit like range_limit[x & RANGE_MASK] does, and store the rows. */
+
+  for (ctr = 0; ctr < DCTSIZE; ctr++) {
+    int32x4_t mask = vdupq_n_s32(RANGE_MASK);
+    int32x4_t subset = vdupq_n_s32(RANGE_SUBSET);
+    int16x8_t row = vcombine_s16(
+      vmovn_s32(vsubq_s32(vandq_s32(lo[ctr], mask), subset)),
+      vmovn_s32(vsubq_s32(vandq_s32(hi[ctr], mask), subset)));
+
+    vst1_u8(output_buf[ctr] + output_col, vqmovun_s16(row));
+  }
+}
+
+#endif /* JSIMD_NEON_SUPPORTED */
+
 #ifdef IDCT_SCALING_SUPPORTED
 
 
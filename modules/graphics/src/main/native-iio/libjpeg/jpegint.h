@@ -273,6 +273,32 @@ struct jpeg_color_quantizer {
 #define RANGE_CENTER    (CENTERJSAMPLE << RANGE_BITS)
 
 
+/* Vector versions of the busiest decompression loops (FX addition).
+ * They give the same results as the portable code, and rely on its
+ * 8-bit samples and range limit table.  The AVX2 code is compiled for
+ * its own functions only, and used when jsimd_avx2_supported() says the
+ * CPU has it.  NEON is part of the targets that define __ARM_NEON.
+ */
+
+#if BITS_IN_JSAMPLE == 8 && RANGE_BITS == 2 && !defined(NO_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#if defined(_MSC_VER) || defined(__clang__) || \
+    (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define JSIMD_AVX2_SUPPORTED
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define JSIMD_NEON_SUPPORTED
+#endif
+#endif
+
+#if defined(JSIMD_AVX2_SUPPORTED) && defined(__GNUC__)
+#define JSIMD_TARGET_AVX2  __attribute__((target("avx2")))
+#else
+#define JSIMD_TARGET_AVX2
+#endif
+
+
 /* Miscellaneous useful macros */
 
 #undef MAX
@@ -344,6 +370,7 @@ struct jpeg_color_quantizer {
 #define jzero_far        jZeroFar
 #define jcopy_sample_rows    jCopySamples
 #define jcopy_block_row        jCopyBlocks
+#define jsimd_avx2_supported    jSimdAVX2
 #define jpeg_zigzag_order    jZIGTable
 #define jpeg_natural_order    jZAGTable
 #define jpeg_natural_order7    jZAG7Table
@@ -421,6 +448,10 @@ EXTERN(void) jcopy_sample_rows JPP((JSAMPARRAY input_array, int source_row,
                     int num_rows, JDIMENSION num_cols));
 EXTERN(void) jcopy_block_row JPP((JBLOCKROW input_row, JBLOCKROW output_row,
                   JDIMENSION num_blocks));
+/* Processor check in jsimd.c (FX addition) */
+#ifdef JSIMD_AVX2_SUPPORTED
+EXTERN(boolean) jsimd_avx2_supported JPP((void));
+#endif
 /* Constant tables in jutils.c */
 #if 0                /* This table is not actually needed in v6a */
 extern const int jpeg_zigzag_order[]; /* natural coef order to zigzag order */
@@ -0,0 +1,94 @@
+/*
+ * jsimd.c
+ *
+ * This file was added to the JavaFX copy of the library, see item 4.6 of
+ * UPDATING.txt.
+ * For conditions of distribution and use, see the accompanying README file.
+ *
+ * This file contains the run-time check for the processor extensions used
+ * by the vector versions of the decompression loops.  Only AVX2 needs one:
+ * SSE2 and NEON are part of the targets that build the other versions.
+ */
+
+#define JPEG_INTERNALS
+#include "jinclude.h"
+#include "jpeglib.h"
+
+#ifdef JSIMD_AVX2_SUPPORTED
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+
+/* Bits of the CPUID and XCR0 registers we look at */
+
+#define CPUID1_ECX_OSXSAVE      (1U << 27)
+#define CPUID1_ECX_AVX          (1U << 28)
+#define CPUID7_EBX_AVX2         (1U << 5)
+#define XCR0_SSE_AVX_STATE      0x6U    /* XMM and YMM registers */
+
+
+LOCAL(void)
+get_cpuid (unsigned int leaf, unsigned int regs[4])
+/* Fill regs with EAX, EBX, ECX and EDX of the given CPUID leaf, subleaf 0 */
+{
+#ifdef _MSC_VER
+  int info[4];
+
+  __cpuidex(info, (int) leaf, 0);
+  regs[0] = (unsigned int) info[0];
+  regs[1] = (unsigned int) info[1];
+  regs[2] = (unsigned int) info[2];
+  regs[3] = (unsigned int) info[3];
+#else
+  __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+
+LOCAL(unsigned int)
+get_xcr0 (void)
+/* The register states the OS saves; only valid when OSXSAVE is set */
+{
+#ifdef _MSC_VER
+  return (unsigned int) _xgetbv(0);
+#else
+  unsigned int eax, edx;
+
+  __asm__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+  return eax;
+#endif
+}
+
+
+GLOBAL(boolean)
+jsimd_avx2_supported (void)
+/* Tell whether the AVX2 versions of the decoder loops can run here.
+ * Like the rest of the library this keeps no global state: the check is
+ * made each time the decoder modules are set up, which costs little next
+ * to decompressing an image.
+ */
+{
+  unsigned int regs[4];
+
+  get_cpuid(0, regs);
+  if (regs[0] < 7)              /* highest leaf */
+    return FALSE;
+
+  /* The 256-bit registers must be known to the CPU and saved by the OS */
+  get_cpuid(1, regs);
+  if ((regs[2] & (CPUID1_ECX_OSXSAVE | CPUID1_ECX_AVX)) !=
+      (CPUID1_ECX_OSXSAVE | CPUID1_ECX_AVX))
+    return FALSE;
+  if ((get_xcr0() & XCR0_SSE_AVX_STATE) != XCR0_SSE_AVX_STATE)
+    return FALSE;
+
+  get_cpuid(7, regs);
+  return (regs[1] & CPUID7_EBX_AVX2) ? TRUE : FALSE;
+}
+
+#endif /* JSIMD_AVX2_SUPPORTED */
@@ -30,6 +30,7 @@
 #include <JTransform.h>
 
 #include <PiscesBlit.h>
+#include <PiscesSimd.h>
 #include <PiscesSysutils.h>
 
 #include <PiscesRenderer.inl>
@@ -397,170 +398,15 @@ fillRect(JNIEnv *env, jobject this, Renderer* rdr,
 {
     Surface* surface;
     jobject surfaceHandle;
-    jint x_from, x_to, y_from, y_to;
-    jint lfrac, rfrac, tfrac, bfrac;
-    jint rows_to_render_by_loop, rows_being_rendered;
-
-    lfrac = (0x10000 - (x & 0xFFFF)) & 0xFFFF;
-    rfrac = (x + w) & 0xFFFF;
-    tfrac = (0x10000 - (y & 0xFFFF)) & 0xFFFF;
-    bfrac = (y + h) & 0xFFFF;
-
-    x_from = x >> 16;
-    x_to = x + w;
-    x_to = (rfrac) ? x_to >> 16 : (x_to >> 16) - 1;
-    y_from = y >> 16;
-    y_to = y + h;
-    y_to = (bfrac) ? y_to >> 16 : (y_to >> 16) - 1;
-
-    rdr->_rectX = x_from;
-    rdr->_rectY = y_from;
-
-    switch (lEdge) {
-    case IMAGE_FRAC_EDGE_PAD:
-        lfrac = 0;
-        break;
-    case IMAGE_FRAC_EDGE_TRIM:
-        if (lfrac) { x_from++; }
-        lfrac = 0;
-        break;
-    }
-
-    switch (rEdge) {
-    case IMAGE_FRAC_EDGE_PAD:
-        rfrac = 0;
-        break;
-    case IMAGE_FRAC_EDGE_TRIM:
-        if (rfrac) { x_to--; }
-        rfrac = 0;
-        break;
-    }
-
-    switch (tEdge) {
-    case IMAGE_FRAC_EDGE_PAD:
-        tfrac = 0;
-        break;
-    case IMAGE_FRAC_EDGE_TRIM:
-        if (tfrac) { y_from++; }
-        tfrac = 0;
-        break;
-    }
-
-    switch (bEdge) {
-    case IMAGE_FRAC_EDGE_PAD:
-        bfrac = 0;
-        break;
-    case IMAGE_FRAC_EDGE_TRIM:
-        if (bfrac) { y_to--; }
-        bfrac = 0;
-        break;
-    }
-
-    // apply clip
-    if (x_from < rdr->_clip_bbMinX) {
-        x_from = rdr->_clip_bbMinX;
-        lfrac = 0;
-    }
-    if (y_from < rdr->_clip_bbMinY) {
-        y_from = rdr->_clip_bbMinY;
-        tfrac = 0;
-    }
-    if (x_to > rdr->_clip_bbMaxX) {
-        x_to = rdr->_clip_bbMaxX;
-        rfrac = 0;
-    }
-    if (y_to > rdr->_clip_bbMaxY) {
-        y_to = rdr->_clip_bbMaxY;
-        bfrac = 0;
-    }
-
-    if ((x_from <= x_to) && (y_from <= y_to)) {
-        rows_to_render_by_loop = y_to - y_from + 1;
 
-        SURFACE_FROM_RENDERER(surface, env, surfaceHandle, this);
-        ACQUIRE_SURFACE(surface, env, surfaceHandle);
-        INVALIDATE_RENDERER_SURFACE(rdr);
-        VALIDATE_BLITTING(rdr);
-
-        rdr->_minTouched = x_from;
-        rdr->_maxTouched = x_to;
-        rdr->_currX = x_from;
-        rdr->_currY = y_from;
-
-        rdr->_alphaWidth = x_to - x_from + 1;
-
-        rdr->_currImageOffset = y_from * surface->width;
-        rdr->_imageScanlineStride = surface->width;
-        rdr->_imagePixelStride = 1;
-        rdr->_rowNum = 0;
-
-        if (y_from == y_to && (tfrac | bfrac)) {
-            // rendering single horizontal fractional line bfrac > (y & 0xFFFF)
-            tfrac = (bfrac - 0x10000 + tfrac) & 0xFFFF;
-            bfrac = 0;
-        }
-        if (x_from == x_to && (lfrac | rfrac)) {
-            // rendering single vertival fractional line rfrac > (x & 0xFFFF)
-            lfrac = (rfrac - 0x10000 + lfrac) & 0xFFFF;
-            rfrac = 0;
-        }
-
-        rdr->_el_lfrac = lfrac;
-        rdr->_el_rfrac = rfrac;
-
-        if (bfrac) {
-            // one "full" line less -> will be rendered at the end
-            rows_to_render_by_loop--;
-        }
-
-        // emit fractional top line
-        if (tfrac) {
-            if (rdr->_genPaint) {
-                size_t l = (x_to - x_from + 1);
-                ALLOC3(rdr->_paint, jint, l);
-                rdr->_genPaint(rdr, 1);
-            }
-            rdr->_emitLine(rdr, 1, tfrac);
-            rows_to_render_by_loop--;
-            rdr->_currX = x_from;
-            rdr->_currY++;
-            rdr->_currImageOffset = rdr->_currY * surface->width;
-            rdr->_rowNum++;
-        }
-
-        // emit "full" lines that are in the middle
-        while (rows_to_render_by_loop > 0) {
-            rows_being_rendered = MIN(rows_to_render_by_loop, NUM_ALPHA_ROWS);
-
-            if (rdr->_genPaint) {
-                size_t l = (x_to - x_from + 1) * rows_being_rendered;
-                ALLOC3(rdr->_paint, jint, l);
-                rdr->_genPaint(rdr, rows_being_rendered);
-            }
-            rdr->_emitLine(rdr, rows_being_rendered, 0x10000);
-
-            rows_to_render_by_loop -= rows_being_rendered;
-            rdr->_currX = x_from;
-            rdr->_currY += rows_being_rendered;
-            rdr->_currImageOffset = rdr->_currY * surface->width;
-            rdr->_rowNum += rows_being_rendered;
-        }
-
-        // emit fractional bottom line
-        if (bfrac) {
-            if (rdr->_genPaint) {
-                size_t l = (x_to - x_from + 1);
-                ALLOC3(rdr->_paint, jint, l);
-                rdr->_genPaint(rdr, 1);
-            }
-            rdr->_emitLine(rdr, 1, bfrac);
-        }
-        RELEASE_SURFACE(surface, env, surfaceHandle);
+    SURFACE_FROM_RENDERER(surface, env, surfaceHandle, this);
+    ACQUIRE_SURFACE(surface, env, surfaceHandle);
+    renderer_fillRect(rdr, x, y, w, h, lEdge, rEdge, tEdge, bEdge);
+    RELEASE_SURFACE(surface, env, surfaceHandle);
 
-        if (JNI_TRUE == readAndClearMemErrorFlag()) {
-            JNI_ThrowNew(env, "java/lang/OutOfMemoryError",
-                "Allocation of internal renderer buffer failed.");
-        }
+    if (JNI_TRUE == readAndClearMemErrorFlag()) {
+        JNI_ThrowNew(env, "java/lang/OutOfMemoryError",
+            "Allocation of internal renderer buffer failed.");
     }
 }
 
@@ -757,6 +603,39 @@ JNIEXPORT void JNICALL Java_com_sun_pisces_PiscesRenderer_setLCDGammaCorrectionI
     initGammaArrays(gamma);
 }
 
+/*
+ * Class:     com_sun_pisces_PiscesRenderer
+ * Method:    setThreadCountImpl
+ * Signature: (I)I
+ */
+JNIEXPORT jint JNICALL Java_com_sun_pisces_PiscesRenderer_setThreadCountImpl
+(JNIEnv *env, jclass cls, jint count)
+{
+    return pisces_bands_setThreadCount(count);
+}
+
+/*
+ * Class:     com_sun_pisces_PiscesRenderer
+ * Method:    getSimdImpl
+ * Signature: ()I
+ */
+JNIEXPORT jint JNICALL Java_com_sun_pisces_PiscesRenderer_getSimdImpl
+(JNIEnv *env, jclass cls)
+{
+    return pisces_simd_get();
+}
+
+/*
+ * Class:     com_sun_pisces_PiscesRenderer
+ * Method:    setSimdImpl
+ * Signature: (I)Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_sun_pisces_PiscesRenderer_setSimdImpl
+(JNIEnv *env, jclass cls, jint simd)
+{
+    return pisces_simd_set(simd);
+}
+
 /*
  * Class:     com_sun_pisces_PiscesRenderer
  * Method:    fillLCDAlphaMaskImpl
@@ -811,8 +690,6 @@ static void fillAlphaMask(Renderer* rdr, jint minX, jint minY, jint maxX, jint m
     JNIEnv *env, jobject this, jint maskType, jbyteArray jmask,
     jint x, jint y, jint maskWidth, jint maskHeight, jint offset, jint stride)
 {
-    jint rowsToBeRendered, rowsBeingRendered;
-
     Surface* surface;
     jobject surfaceHandle;
 
@@ -825,47 +702,8 @@ static void fillAlphaMask(Renderer* rdr, jint minX, jint minY, jint maxX, jint m
 
         mask = (jbyte*)(*env)->GetPrimitiveArrayCritical(env, jmask, NULL);
         if (mask != NULL) {
-            jint width = maxX - minX + 1;
-            jint height = maxY - minY + 1;
-
-            renderer_setMask(rdr, maskType, mask, maskWidth, maskHeight, JNI_FALSE);
-
-            INVALIDATE_RENDERER_SURFACE(rdr);
-            VALIDATE_BLITTING(rdr);
-
-            rdr->_minTouched = minX;
-            rdr->_maxTouched = maxX;
-            rdr->_currX = minX;
-            rdr->_currY = minY;
-
-            rdr->_alphaWidth = width;
-
-            rdr->_imageScanlineStride = surface->width;
-            rdr->_imagePixelStride = 1;
-            rdr->_rowNum = 0;
-            rdr->_maskOffset = offset;
-
-            rowsToBeRendered = height;
-
-            while (rowsToBeRendered > 0) {
-                rowsBeingRendered = 1; //MIN(rowsToBeRendered, NUM_ALPHA_ROWS);
-
-                rdr->_currImageOffset = rdr->_currY * surface->width;
-                if (rdr->_genPaint) {
-                    size_t l = (width * rowsBeingRendered);
-                    ALLOC3(rdr->_paint, jint, l);
-                    rdr->_genPaint(rdr, rowsBeingRendered);
-                }
-                rdr->_emitRows(rdr, rowsBeingRendered);
-
-                rdr->_maskOffset += maskWidth;
-                rdr->_rowNum += rowsBeingRendered;
-                rowsToBeRendered -= rowsBeingRendered;
-                rdr->_currX = x;
-                rdr->_currY += rowsBeingRendered;
-            }
-
-            renderer_removeMask(rdr);
+            renderer_fillAlphaMask(rdr, minX, minY, maxX, maxY, maskType, mask,
+                x, y, maskWidth, maskHeight, offset);
             (*env)->ReleasePrimitiveArrayCritical(env, jmask, mask, 0);
         } else {
             setMemErrorFlag();
@@ -879,4 +717,3 @@ static void fillAlphaMask(Renderer* rdr, jint minX, jint minY, jint maxX, jint m
         }
     }
 }
-
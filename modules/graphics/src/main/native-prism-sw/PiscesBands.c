@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include <PiscesBands.h>
+
+#include <PiscesUtil.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#endif
+
+#ifdef _WIN32
+static SRWLOCK bandsLock = SRWLOCK_INIT;
+static CONDITION_VARIABLE workCond = CONDITION_VARIABLE_INIT;
+static CONDITION_VARIABLE doneCond = CONDITION_VARIABLE_INIT;
+
+#define BANDS_LOCK() AcquireSRWLockExclusive(&bandsLock)
+#define BANDS_UNLOCK() ReleaseSRWLockExclusive(&bandsLock)
+#define BANDS_WAIT(cond) SleepConditionVariableSRW(&(cond), &bandsLock, INFINITE, 0)
+#define BANDS_BROADCAST(cond) WakeAllConditionVariable(&(cond))
+#else
+static pthread_mutex_t bandsLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t workCond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t doneCond = PTHREAD_COND_INITIALIZER;
+
+#define BANDS_LOCK() pthread_mutex_lock(&bandsLock)
+#define BANDS_UNLOCK() pthread_mutex_unlock(&bandsLock)
+#define BANDS_WAIT(cond) pthread_cond_wait(&(cond), &bandsLock)
+#define BANDS_BROADCAST(cond) pthread_cond_broadcast(&(cond))
+#endif
+
+static jint threadCount = 1;
+static jint workerCount = 0;
+
+// The primitive being rendered, guarded by bandsLock.
+static jboolean running = XNI_FALSE;
+static BandFunc* jobFunc;
+static void* jobData;
+static jint jobMinY, jobRows;
+static jint jobBands = 0;
+static jint nextBand = 0;
+static jint pendingBands = 0;
+
+static jint
+bandMinY(jint band) {
+    return jobMinY + (jint)(((jlong)jobRows * band) / jobBands);
+}
+
+static jint
+bandMaxY(jint band) {
+    return bandMinY(band + 1) - 1;
+}
+
+/*
+ * Renders the bands nobody took yet. Called, and returns, with bandsLock
+ * held.
+ */
+static void
+runPendingBands() {
+    while (nextBand < jobBands) {
+        jint band = nextBand++;
+        BandFunc* func = jobFunc;
+        void* data = jobData;
+        jint minY = bandMinY(band);
+        jint maxY = bandMaxY(band);
+
+        BANDS_UNLOCK();
+        func(data, band, minY, maxY);
+        BANDS_LOCK();
+
+        if (--pendingBands == 0) {
+            BANDS_BROADCAST(doneCond);
+        }
+    }
+}
+
+static void
+workerLoop() {
+    BANDS_LOCK();
+    for (;;) {
+        while (nextBand >= jobBands) {
+            BANDS_WAIT(workCond);
+        }
+        runPendingBands();
+    }
+}
+
+#ifdef _WIN32
+static unsigned __stdcall
+bandsWorker(void* arg) {
+    workerLoop();
+    return 0;
+}
+
+static jboolean
+startWorker() {
+    HANDLE thread = (HANDLE)_beginthreadex(NULL, 0, bandsWorker, NULL, 0, NULL);
+    if (thread == 0) {
+        return XNI_FALSE;
+    }
+    CloseHandle(thread);
+    return XNI_TRUE;
+}
+#else
+static void*
+bandsWorker(void* arg) {
+    workerLoop();
+    return NULL;
+}
+
+static jboolean
+startWorker() {
+    pthread_t thread;
+    pthread_attr_t attr;
+    jboolean started;
+
+    if (pthread_attr_init(&attr) != 0) {
+        return XNI_FALSE;
+    }
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    started = (pthread_create(&thread, &attr, bandsWorker, NULL) == 0);
+    pthread_attr_destroy(&attr);
+    return started;
+}
+#endif
+
+jint
+pisces_bands_setThreadCount(jint count) {
+    count = MAX(1, MIN(count, MAX_BAND_THREADS));
+
+    BANDS_LOCK();
+    // Workers are never stopped, extra ones just find no band to render.
+    while (workerCount < count - 1 && startWorker()) {
+        workerCount++;
+    }
+    threadCount = MIN(count, workerCount + 1);
+    count = threadCount;
+    BANDS_UNLOCK();
+
+    return count;
+}
+
+jint
+pisces_bands_getThreadCount() {
+    jint count;
+
+    BANDS_LOCK();
+    count = threadCount;
+    BANDS_UNLOCK();
+
+    return count;
+}
+
+void
+pisces_bands_run(BandFunc* func, void* data, jint minY, jint maxY,
+                 jint width)
+{
+    jint rows = maxY - minY + 1;
+    jint bands = rows / MIN_BAND_ROWS;
+
+    if (bands > 1) {
+        bands = MIN(bands, (jint)MIN(((jlong)rows * width) / MIN_BAND_PIXELS,
+                                     MAX_BAND_THREADS));
+    }
+
+    if (bands > 1) {
+        BANDS_LOCK();
+        bands = MIN(bands, threadCount);
+        // Renderers on other threads use the workers one at a time.
+        if (bands > 1 && !running) {
+            jint firstMaxY;
+
+            running = XNI_TRUE;
+            jobFunc = func;
+            jobData = data;
+            jobMinY = minY;
+            jobRows = rows;
+            jobBands = bands;
+            nextBand = 1;
+            pendingBands = bands;
+            firstMaxY = bandMaxY(0);
+            BANDS_BROADCAST(workCond);
+            BANDS_UNLOCK();
+
+            func(data, 0, minY, firstMaxY);
+
+            BANDS_LOCK();
+            pendingBands--;
+            runPendingBands();
+            while (pendingBands > 0) {
+                BANDS_WAIT(doneCond);
+            }
+            running = XNI_FALSE;
+            BANDS_UNLOCK();
+            return;
+        }
+        BANDS_UNLOCK();
+    }
+
+    func(data, 0, minY, maxY);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/**
+ * @file PiscesBands.h
+ * Worker pool rendering the rows of a primitive in horizontal bands.
+ */
+
+#ifndef PISCES_BANDS_H
+#define PISCES_BANDS_H
+
+#include <PiscesDefs.h>
+
+#define MAX_BAND_THREADS 32
+
+/*
+ * Smallest band, in rows and in pixels. Smaller primitives, which are most of
+ * them, are rendered on the calling thread as waking up workers costs more
+ * than what they would save.
+ */
+#define MIN_BAND_ROWS 16
+#define MIN_BAND_PIXELS (32 * 1024)
+
+/**
+ * Renders the rows minY..maxY of band number band. Band 0 is always
+ * rendered by the thread which called pisces_bands_run().
+ */
+typedef void BandFunc(void* data, jint band, jint minY, jint maxY);
+
+/**
+ * Sets the number of threads, the calling one included, that render the
+ * bands of a primitive. 1 renders all the rows on the calling thread.
+ * Returns the number of threads in use, which is smaller when the workers
+ * could not be started.
+ */
+jint pisces_bands_setThreadCount(jint count);
+
+jint pisces_bands_getThreadCount();
+
+/**
+ * Calls func for the rows minY..maxY, split into bands that are rendered
+ * in parallel when there are enough of them, width pixels wide, to make it
+ * worth it. Returns when all the bands are done. Rows are never shared
+ * between bands, so the result doesn't depend on the split.
+ */
+void pisces_bands_run(BandFunc* func, void* data, jint minY, jint maxY,
+                      jint width);
+
+#endif
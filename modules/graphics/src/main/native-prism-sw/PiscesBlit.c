@@ -30,9 +30,19 @@
 
 #include <PiscesSysutils.h>
 #include <PiscesMath.h>
+#include <PiscesSimd.h>
 
 #include <limits.h>
 
+#if ENABLE_SIMD_AVX2
+#include <immintrin.h>
+#elif ENABLE_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+#if ENABLE_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
 #define HALF_ALPHA (MAX_ALPHA >> 1)
 #define ALPHA_SHIFT 8
 #define HALF_1_SHIFT_23 (jint)(1L << 23)
@@ -75,6 +85,641 @@ static INLINE jint B(jint x) {
     return x & 0xFF;
 }
 
+/* SIMD SPANS routines BEGIN */
+
+/*
+ * Blending loops over contiguous pixels, which the routines below use for
+ * the rows of the 8888 surfaces when the CPU has SIMD extensions. They give
+ * the same results as the scalar loops, and return the number of pixels
+ * they blended, from the start of the row. The routines do the rest.
+ */
+typedef struct _BlitSpans {
+    jint (*fill)(jint* d, jint n, jint pixel);
+    jint (*srcOverColor)(jint* d, const jbyte* mask, jint n,
+                         jint alpha, jint red, jint green, jint blue);
+    jint (*srcColor)(jint* d, const jbyte* mask, jint n,
+                     jint alpha, jint red, jint green, jint blue);
+    jint (*srcOverPaint)(jint* d, const jbyte* mask, const jint* paint,
+                         jint n, jint frac, jboolean skip);
+    jint (*srcPaint)(jint* d, const jbyte* mask, const jint* paint, jint n);
+    // NULL when table lookups can't be vectorized
+    jint (*srcOverLCD)(jint* d, const jbyte* mask, jint n,
+                       jint alpha, jint red, jint green, jint blue);
+} BlitSpans;
+
+#if ENABLE_SIMD_SSE2
+static INLINE __m128i
+loadMask_sse2(const jbyte* mask) {
+    __m128i zero = _mm_setzero_si128();
+    int m;
+
+    memcpy(&m, mask, sizeof(m));
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(m), zero), zero);
+}
+
+#define SIMD_FUNC(name) name##_sse2
+#define SIMD_TARGET
+#define V __m128i
+#define V_PIXELS 4
+#define V_ZERO _mm_setzero_si128()
+#define V_LOAD(p) _mm_loadu_si128((const __m128i*)(p))
+#define V_STORE(p, v) _mm_storeu_si128((__m128i*)(p), v)
+#define V_LOAD_MASK(p) loadMask_sse2(p)
+#define V_SET1_16(x) _mm_set1_epi16((short)(x))
+#define V_SET1_32(x) _mm_set1_epi32(x)
+#define V_SET4_16(a, r, g, b) _mm_set_epi16(a, r, g, b, a, r, g, b)
+#define V_UNPACKLO8(a, b) _mm_unpacklo_epi8(a, b)
+#define V_UNPACKHI8(a, b) _mm_unpackhi_epi8(a, b)
+#define V_UNPACKLO32(a, b) _mm_unpacklo_epi32(a, b)
+#define V_UNPACKHI32(a, b) _mm_unpackhi_epi32(a, b)
+#define V_PACKUS16(a, b) _mm_packus_epi16(a, b)
+#define V_PACKS16(a, b) _mm_packs_epi16(a, b)
+#define V_SHUFFLELO16(a, i) _mm_shufflelo_epi16(a, i)
+#define V_SHUFFLEHI16(a, i) _mm_shufflehi_epi16(a, i)
+#define V_ADD16(a, b) _mm_add_epi16(a, b)
+#define V_SUB16(a, b) _mm_sub_epi16(a, b)
+#define V_MULLO16(a, b) _mm_mullo_epi16(a, b)
+#define V_MULHI16U(a, b) _mm_mulhi_epu16(a, b)
+#define V_SRLI16(a, i) _mm_srli_epi16(a, i)
+#define V_CMPEQ16(a, b) _mm_cmpeq_epi16(a, b)
+#define V_CMPGT16(a, b) _mm_cmpgt_epi16(a, b)
+#define V_ADD32(a, b) _mm_add_epi32(a, b)
+#define V_SUB32(a, b) _mm_sub_epi32(a, b)
+#define V_SLLI32(a, i) _mm_slli_epi32(a, i)
+#define V_SRLI32(a, i) _mm_srli_epi32(a, i)
+#define V_CMPEQ32(a, b) _mm_cmpeq_epi32(a, b)
+#define V_AND(a, b) _mm_and_si128(a, b)
+#define V_ANDNOT(a, b) _mm_andnot_si128(a, b)
+#define V_OR(a, b) _mm_or_si128(a, b)
+#define V_MOVEMASK8(a) _mm_movemask_epi8(a)
+#define V_SRLI64(a, i) _mm_srli_epi64(a, i)
+#define V_SHUFFLE32(a, i) _mm_shuffle_epi32(a, i)
+#define V_UNPACKLO64(a, b) _mm_unpacklo_epi64(a, b)
+
+#include <PiscesBlitSpans.inl>
+
+#undef SIMD_FUNC
+#undef SIMD_TARGET
+#undef V
+#undef V_PIXELS
+#undef V_ZERO
+#undef V_LOAD
+#undef V_STORE
+#undef V_LOAD_MASK
+#undef V_SET1_16
+#undef V_SET1_32
+#undef V_SET4_16
+#undef V_UNPACKLO8
+#undef V_UNPACKHI8
+#undef V_UNPACKLO32
+#undef V_UNPACKHI32
+#undef V_PACKUS16
+#undef V_PACKS16
+#undef V_SHUFFLELO16
+#undef V_SHUFFLEHI16
+#undef V_ADD16
+#undef V_SUB16
+#undef V_MULLO16
+#undef V_MULHI16U
+#undef V_SRLI16
+#undef V_CMPEQ16
+#undef V_CMPGT16
+#undef V_ADD32
+#undef V_SUB32
+#undef V_SLLI32
+#undef V_SRLI32
+#undef V_CMPEQ32
+#undef V_AND
+#undef V_ANDNOT
+#undef V_OR
+#undef V_MOVEMASK8
+#undef V_SRLI64
+#undef V_SHUFFLE32
+#undef V_UNPACKLO64
+
+static const BlitSpans spans_sse2 = {
+    fillSpan_sse2,
+    srcOverColorSpan_sse2,
+    srcColorSpan_sse2,
+    srcOverPaintSpan_sse2,
+    srcPaintSpan_sse2,
+    NULL
+};
+#endif // ENABLE_SIMD_SSE2
+
+#if ENABLE_SIMD_AVX2
+static INLINE TARGET_AVX2 __m256i
+loadMask_avx2(const jbyte* mask) {
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)mask));
+}
+
+#define SIMD_FUNC(name) name##_avx2
+#define SIMD_TARGET TARGET_AVX2
+#define V __m256i
+#define V_PIXELS 8
+#define V_ZERO _mm256_setzero_si256()
+#define V_LOAD(p) _mm256_loadu_si256((const __m256i*)(p))
+#define V_STORE(p, v) _mm256_storeu_si256((__m256i*)(p), v)
+#define V_LOAD_MASK(p) loadMask_avx2(p)
+#define V_SET1_16(x) _mm256_set1_epi16((short)(x))
+#define V_SET1_32(x) _mm256_set1_epi32(x)
+#define V_SET4_16(a, r, g, b) _mm256_set_epi16(a, r, g, b, a, r, g, b, \
+                                               a, r, g, b, a, r, g, b)
+#define V_UNPACKLO8(a, b) _mm256_unpacklo_epi8(a, b)
+#define V_UNPACKHI8(a, b) _mm256_unpackhi_epi8(a, b)
+#define V_UNPACKLO32(a, b) _mm256_unpacklo_epi32(a, b)
+#define V_UNPACKHI32(a, b) _mm256_unpackhi_epi32(a, b)
+#define V_PACKUS16(a, b) _mm256_packus_epi16(a, b)
+#define V_PACKS16(a, b) _mm256_packs_epi16(a, b)
+#define V_SHUFFLELO16(a, i) _mm256_shufflelo_epi16(a, i)
+#define V_SHUFFLEHI16(a, i) _mm256_shufflehi_epi16(a, i)
+#define V_ADD16(a, b) _mm256_add_epi16(a, b)
+#define V_SUB16(a, b) _mm256_sub_epi16(a, b)
+#define V_MULLO16(a, b) _mm256_mullo_epi16(a, b)
+#define V_MULHI16U(a, b) _mm256_mulhi_epu16(a, b)
+#define V_SRLI16(a, i) _mm256_srli_epi16(a, i)
+#define V_CMPEQ16(a, b) _mm256_cmpeq_epi16(a, b)
+#define V_CMPGT16(a, b) _mm256_cmpgt_epi16(a, b)
+#define V_ADD32(a, b) _mm256_add_epi32(a, b)
+#define V_SUB32(a, b) _mm256_sub_epi32(a, b)
+#define V_SLLI32(a, i) _mm256_slli_epi32(a, i)
+#define V_SRLI32(a, i) _mm256_srli_epi32(a, i)
+#define V_CMPEQ32(a, b) _mm256_cmpeq_epi32(a, b)
+#define V_AND(a, b) _mm256_and_si256(a, b)
+#define V_ANDNOT(a, b) _mm256_andnot_si256(a, b)
+#define V_OR(a, b) _mm256_or_si256(a, b)
+#define V_MOVEMASK8(a) _mm256_movemask_epi8(a)
+#define V_SRLI64(a, i) _mm256_srli_epi64(a, i)
+#define V_SHUFFLE32(a, i) _mm256_shuffle_epi32(a, i)
+#define V_UNPACKLO64(a, b) _mm256_unpacklo_epi64(a, b)
+
+#include <PiscesBlitSpans.inl>
+
+#undef SIMD_FUNC
+#undef SIMD_TARGET
+#undef V
+#undef V_PIXELS
+#undef V_ZERO
+#undef V_LOAD
+#undef V_STORE
+#undef V_LOAD_MASK
+#undef V_SET1_16
+#undef V_SET1_32
+#undef V_SET4_16
+#undef V_UNPACKLO8
+#undef V_UNPACKHI8
+#undef V_UNPACKLO32
+#undef V_UNPACKHI32
+#undef V_PACKUS16
+#undef V_PACKS16
+#undef V_SHUFFLELO16
+#undef V_SHUFFLEHI16
+#undef V_ADD16
+#undef V_SUB16
+#undef V_MULLO16
+#undef V_MULHI16U
+#undef V_SRLI16
+#undef V_CMPEQ16
+#undef V_CMPGT16
+#undef V_ADD32
+#undef V_SUB32
+#undef V_SLLI32
+#undef V_SRLI32
+#undef V_CMPEQ32
+#undef V_AND
+#undef V_ANDNOT
+#undef V_OR
+#undef V_MOVEMASK8
+#undef V_SRLI64
+#undef V_SHUFFLE32
+#undef V_UNPACKLO64
+
+// blendLCDSrcOver8888_pre() 8 pixels at a time, with gathers for the gamma
+// lookups. The color is gamma corrected.
+static TARGET_AVX2 jint
+srcOverLCDSpan_avx2(jint* d, const jbyte* mask, jint n,
+                    jint alpha, jint red, jint green, jint blue)
+{
+    const __m128i redLo = _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1,
+                                        -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i redHi = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5,
+                                        -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i greenLo = _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1,
+                                          -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i greenHi = _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6,
+                                          -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i blueLo = _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1,
+                                         -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i blueHi = _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7,
+                                         -1, -1, -1, -1, -1, -1, -1, -1);
+    __m256i one = _mm256_set1_epi32(1);
+    __m256i v255 = _mm256_set1_epi32(255);
+    __m256i s[3];
+    __m256i solid = _mm256_set1_epi32(0xff000000 | (red << 16) | (green << 8) | blue);
+    jint i, c;
+
+    s[0] = _mm256_set1_epi32(red);
+    s[1] = _mm256_set1_epi32(green);
+    s[2] = _mm256_set1_epi32(blue);
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        // 24 bytes of the 8 pixels of the mask, split into components
+        __m128i lo = _mm_loadu_si128((const __m128i*)(mask + 3 * i));
+        __m128i hi = _mm_loadl_epi64((const __m128i*)(mask + 3 * i + 16));
+        __m256i dv = _mm256_loadu_si256((const __m256i*)(d + i));
+        __m256i a[3], opaque, res;
+
+        a[0] = _mm256_cvtepu8_epi32(_mm_or_si128(_mm_shuffle_epi8(lo, redLo),
+                                                 _mm_shuffle_epi8(hi, redHi)));
+        a[1] = _mm256_cvtepu8_epi32(_mm_or_si128(_mm_shuffle_epi8(lo, greenLo),
+                                                 _mm_shuffle_epi8(hi, greenHi)));
+        a[2] = _mm256_cvtepu8_epi32(_mm_or_si128(_mm_shuffle_epi8(lo, blueLo),
+                                                 _mm_shuffle_epi8(hi, blueHi)));
+        res = _mm256_set1_epi32(0xff000000);
+        for (c = 0; c < 3; c++) {
+            __m256i dc = _mm256_and_si256(_mm256_srli_epi32(dv, 16 - 8 * c), v255);
+            __m256i x;
+
+            if (alpha < MAX_ALPHA) {
+                a[c] = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_add_epi32(a[c], one),
+                                                            _mm256_set1_epi32(alpha)), 8);
+            }
+            dc = _mm256_i32gather_epi32((const int*)invGammaArray, dc, 4);
+            x = _mm256_add_epi32(_mm256_mullo_epi32(a[c], s[c]),
+                                 _mm256_mullo_epi32(_mm256_sub_epi32(v255, a[c]), dc));
+            // div255(x)
+            x = _mm256_add_epi32(x, one);
+            x = _mm256_srli_epi32(_mm256_add_epi32(x, _mm256_slli_epi32(x, 8)), 16);
+            x = _mm256_i32gather_epi32((const int*)gammaArray, x, 4);
+            res = _mm256_or_si256(res, _mm256_slli_epi32(x, 16 - 8 * c));
+        }
+        // Opaque where all the components of the mask are
+        opaque = _mm256_and_si256(_mm256_and_si256(a[0], a[1]), a[2]);
+        opaque = _mm256_cmpeq_epi32(opaque, v255);
+        res = _mm256_or_si256(_mm256_and_si256(opaque, solid),
+                              _mm256_andnot_si256(opaque, res));
+        _mm256_storeu_si256((__m256i*)(d + i), res);
+    }
+    return i;
+}
+
+static const BlitSpans spans_avx2 = {
+    fillSpan_avx2,
+    srcOverColorSpan_avx2,
+    srcColorSpan_avx2,
+    srcOverPaintSpan_avx2,
+    srcPaintSpan_avx2,
+    srcOverLCDSpan_avx2
+};
+#endif // ENABLE_SIMD_AVX2
+
+#if ENABLE_SIMD_NEON
+/*
+ * The NEON spans load 8 pixels split into their components, and blend the
+ * components of the 8 pixels together.
+ */
+
+// div255(x) for x <= 65535 - 1, as ((x + 1) + ((x + 1) >> 8)) >> 8
+static INLINE uint16x8_t
+div255_neon(uint16x8_t x) {
+    x = vaddq_u16(x, vdupq_n_u16(1));
+    return vshrq_n_u16(vsraq_n_u16(x, x, 8), 8);
+}
+
+// ((m + 1) * alpha) >> 8
+static INLINE uint8x8_t
+scaleAlpha_neon(uint8x8_t m, jint alpha) {
+    return vshrn_n_u16(vmlal_u8(vdupq_n_u16(alpha), m, vdup_n_u8(alpha)), 8);
+}
+
+static INLINE jboolean
+anySet_neon(uint8x8_t x) {
+    return vget_lane_u64(vreinterpret_u64_u8(x), 0) != 0;
+}
+
+// Stores the pixels set in over again, with their components of up to 9 bits
+// OR-ed together as in the scalar loops, where they carry into the next one.
+static void
+storeOverflow_neon(jint* d, const uint16x8_t o[4], uint8x8_t over) {
+    uint16_t c[4][8];
+    uint8_t m[8];
+    jint k;
+
+    for (k = 0; k < 4; k++) {
+        vst1q_u16(c[k], o[k]);
+    }
+    vst1_u8(m, over);
+    for (k = 0; k < 8; k++) {
+        if (m[k] != 0) {
+            d[k] = (c[3][k] << 24) | (c[2][k] << 16) | (c[1][k] << 8) | c[0][k];
+        }
+    }
+}
+
+static jint
+fillSpan_neon(jint* d, jint n, jint pixel) {
+    uint32x4_t p = vdupq_n_u32(pixel);
+    jint i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        vst1q_u32((uint32_t*)(d + i), p);
+    }
+    return i;
+}
+
+static jint
+srcOverColorSpan_neon(jint* d, const jbyte* mask, jint n,
+                      jint alpha, jint red, jint green, jint blue)
+{
+    uint8x8_t s[4];
+    uint8x8_t aval = vdup_n_u8(alpha);
+    jint i, c;
+
+    s[0] = vdup_n_u8(blue);
+    s[1] = vdup_n_u8(green);
+    s[2] = vdup_n_u8(red);
+    s[3] = vdup_n_u8(255);
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        uint8x8x4_t dv = vld4_u8((const uint8_t*)(d + i));
+        uint8x8_t raval;
+
+        if (mask != NULL) {
+            aval = scaleAlpha_neon(vld1_u8((const uint8_t*)(mask + i)), alpha);
+        }
+        raval = vmvn_u8(aval);
+        for (c = 0; c < 4; c++) {
+            dv.val[c] = vmovn_u16(div255_neon(
+                vmlal_u8(vmull_u8(s[c], aval), raval, dv.val[c])));
+        }
+        vst4_u8((uint8_t*)(d + i), dv);
+    }
+    return i;
+}
+
+static jint
+srcColorSpan_neon(jint* d, const jbyte* mask, jint n,
+                  jint alpha, jint red, jint green, jint blue)
+{
+    uint8x8_t s[4], solid[4];
+    jint i, c;
+
+    s[0] = solid[0] = vdup_n_u8(blue);
+    s[1] = solid[1] = vdup_n_u8(green);
+    s[2] = solid[2] = vdup_n_u8(red);
+    s[3] = vdup_n_u8(255);
+    solid[3] = vdup_n_u8(alpha);
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        uint8x8x4_t dv = vld4_u8((const uint8_t*)(d + i));
+        uint8x8_t m = vld1_u8((const uint8_t*)(mask + i));
+        uint8x8_t aval = scaleAlpha_neon(m, alpha);
+        uint8x8_t raaval = vmvn_u8(m);
+        uint8x8_t opaque = vceq_u8(m, vdup_n_u8(MAX_ALPHA));
+        uint8x8_t clear = vceq_u8(m, vdup_n_u8(0));
+        uint16x8_t x[4];
+        uint8x8_t zero;
+
+        for (c = 0; c < 4; c++) {
+            x[c] = vmlal_u8(vmull_u8(aval, s[c]), raaval, dv.val[c]);
+        }
+        // The denominator, 0 gives transparent black
+        zero = vmovn_u16(vceqq_u16(x[3], vdupq_n_u16(0)));
+        for (c = 0; c < 4; c++) {
+            uint8x8_t o = vbic_u8(vmovn_u16(div255_neon(x[c])), zero);
+            o = vbsl_u8(opaque, solid[c], o);
+            dv.val[c] = vbsl_u8(clear, dv.val[c], o);
+        }
+        vst4_u8((uint8_t*)(d + i), dv);
+    }
+    return i;
+}
+
+static jint
+srcOverPaintSpan_neon(jint* d, const jbyte* mask, const jint* paint,
+                      jint n, jint frac, jboolean skip)
+{
+    uint16x8_t f = vdupq_n_u16(frac);
+    uint16x8_t v255 = vdupq_n_u16(255);
+    jint i, c;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        uint8x8x4_t dv = vld4_u8((const uint8_t*)(d + i));
+        uint8x8x4_t pv = vld4_u8((const uint8_t*)(paint + i));
+        uint16x8_t sf[4], o[4], aval2;
+        uint8x8_t raval, over = vdup_n_u8(0);
+        uint8x8_t opaque, clear;
+        uint8x8x4_t res;
+
+        if (mask != NULL) {
+            f = vaddw_u8(vdupq_n_u16(1), vld1_u8((const uint8_t*)(mask + i)));
+        }
+        // (s * frac) >> 8, aval2 for the alpha
+        for (c = 0; c < 4; c++) {
+            sf[c] = vshrq_n_u16(vmulq_u16(vmovl_u8(pv.val[c]), f), 8);
+        }
+        aval2 = sf[3];
+        raval = vmovn_u16(vsubq_u16(v255, aval2));
+        for (c = 0; c < 4; c++) {
+            o[c] = vaddq_u16(sf[c], div255_neon(vmull_u8(raval, dv.val[c])));
+            over = vorr_u8(over, vmovn_u16(vcgtq_u16(o[c], v255)));
+            res.val[c] = vmovn_u16(o[c]);
+        }
+        if (skip) {
+            opaque = vmovn_u16(vceqq_u16(aval2, v255));
+            clear = vmovn_u16(vceqq_u16(aval2, vdupq_n_u16(0)));
+            for (c = 0; c < 4; c++) {
+                res.val[c] = vbsl_u8(opaque, pv.val[c], res.val[c]);
+                res.val[c] = vbsl_u8(clear, dv.val[c], res.val[c]);
+            }
+            over = vbic_u8(over, vorr_u8(opaque, clear));
+        }
+        vst4_u8((uint8_t*)(d + i), res);
+        if (anySet_neon(over)) {
+            storeOverflow_neon(d + i, o, over);
+        }
+    }
+    return i;
+}
+
+static jint
+srcPaintSpan_neon(jint* d, const jbyte* mask, const jint* paint, jint n) {
+    uint16x8_t v255 = vdupq_n_u16(255);
+    jint i, c;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        uint8x8x4_t dv = vld4_u8((const uint8_t*)(d + i));
+        uint8x8x4_t pv = vld4_u8((const uint8_t*)(paint + i));
+        uint8x8_t m = vld1_u8((const uint8_t*)(mask + i));
+        uint8x8_t aval = vshrn_n_u16(vmulq_u16(vaddw_u8(vdupq_n_u16(1), m),
+                                               vmovl_u8(pv.val[3])), 8);
+        uint8x8_t raaval = vmvn_u8(m);
+        uint8x8_t opaque = vceq_u8(m, vdup_n_u8(MAX_ALPHA));
+        uint8x8_t clear = vceq_u8(m, vdup_n_u8(0));
+        uint8x8_t zero, over = vdup_n_u8(0);
+        uint16x8_t o[4];
+        uint8x8x4_t res;
+
+        // The denominator, 0 gives transparent black
+        o[3] = vmlal_u8(vmull_u8(raaval, dv.val[3]), aval, vdup_n_u8(255));
+        zero = vmovn_u16(vceqq_u16(o[3], vdupq_n_u16(0)));
+        o[3] = div255_neon(o[3]);
+        res.val[3] = vmovn_u16(o[3]);
+        for (c = 0; c < 3; c++) {
+            o[c] = vaddw_u8(div255_neon(vmull_u8(raaval, dv.val[c])), pv.val[c]);
+            over = vorr_u8(over, vmovn_u16(vcgtq_u16(o[c], v255)));
+            res.val[c] = vmovn_u16(o[c]);
+        }
+        over = vbic_u8(over, vorr_u8(vorr_u8(opaque, clear), zero));
+        for (c = 0; c < 4; c++) {
+            res.val[c] = vbic_u8(res.val[c], zero);
+            res.val[c] = vbsl_u8(opaque, pv.val[c], res.val[c]);
+            res.val[c] = vbsl_u8(clear, dv.val[c], res.val[c]);
+        }
+        vst4_u8((uint8_t*)(d + i), res);
+        if (anySet_neon(over)) {
+            storeOverflow_neon(d + i, o, over);
+        }
+    }
+    return i;
+}
+
+static const BlitSpans spans_neon = {
+    fillSpan_neon,
+    srcOverColorSpan_neon,
+    srcColorSpan_neon,
+    srcOverPaintSpan_neon,
+    srcPaintSpan_neon,
+    NULL
+};
+#endif // ENABLE_SIMD_NEON
+
+// The spans for rows of pixels, NULL when they have gaps or there are no
+// SIMD extensions.
+static const BlitSpans*
+getBlitSpans(jint pixelStride) {
+    if (pixelStride != 1) {
+        return NULL;
+    }
+    switch (pisces_simd_get()) {
+#if ENABLE_SIMD_AVX2
+    case SIMD_AVX2:
+        return &spans_avx2;
+#endif
+#if ENABLE_SIMD_SSE2
+    case SIMD_SSE2:
+        return &spans_sse2;
+#endif
+#if ENABLE_SIMD_NEON
+    case SIMD_NEON:
+        return &spans_neon;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+#define COVERAGE_CHUNK 256
+
+/*
+ * Coverages of the next n pixels of an alpha row, whose deltas are cleared.
+ * With skipZero, pixels whose sum is 0 get no coverage, whatever the alpha
+ * map says. Returns the running sum.
+ */
+static jint
+rowCoverage(jbyte* coverage, jint* alpha, jint n, jint aval_relative,
+            jbyte* alphaMap, jboolean skipZero)
+{
+    jint i;
+
+    for (i = 0; i < n; i++) {
+        aval_relative += alpha[i];
+        alpha[i] = 0;
+        coverage[i] = (skipZero && aval_relative == 0) ? 0 : alphaMap[aval_relative];
+    }
+    return aval_relative;
+}
+
+/*
+ * Rows through a mask, with the spans then the scalar loops of the Mask
+ * routines for the pixels they leave.
+ */
+static void
+srcOverColorRow(const BlitSpans* spans, jint* d, const jbyte* mask, jint n,
+                jint calpha, jint cred, jint cgreen, jint cblue)
+{
+    jint i = spans->srcOverColor(d, mask, n, calpha, cred, cgreen, cblue);
+
+    for (; i < n; i++) {
+        if (mask[i]) {
+            jint aval = mask[i] & 0xff;
+            aval = ((aval+1) * calpha) >> 8;
+            if (aval == MAX_ALPHA) {
+                d[i] = 0xff000000 | (cred << 16) | (cgreen << 8) | cblue;
+            } else if (aval > 0) {
+                blendSrcOver8888_pre(&d[i], aval, cred, cgreen, cblue);
+            }
+        }
+    }
+}
+
+static void
+srcColorRow(const BlitSpans* spans, jint* d, const jbyte* mask, jint n,
+            jint calpha, jint cred, jint cgreen, jint cblue)
+{
+    jint i = spans->srcColor(d, mask, n, calpha, cred, cgreen, cblue);
+
+    for (; i < n; i++) {
+        jint acoverage = mask[i] & 0xff;
+        if (acoverage == MAX_ALPHA) {
+            d[i] = (calpha << 24) | (cred << 16) | (cgreen << 8) | cblue;
+        } else if (acoverage > 0) {
+            jint aval = ((acoverage+1) * calpha) >> 8;
+            blendSrc8888_pre(&d[i], aval, 255 - acoverage, cred, cgreen, cblue);
+        }
+    }
+}
+
+static void
+srcOverPaintRow(const BlitSpans* spans, jint* d, const jbyte* mask,
+                const jint* paint, jint n)
+{
+    jint i = spans->srcOverPaint(d, mask, paint, n, 0, XNI_TRUE);
+
+    for (; i < n; i++) {
+        if (mask[i]) {
+            jint cval = paint[i];
+            jint palpha = A(cval);
+            jint malpha = mask[i] & 0xff;
+            jint aval = ((malpha+1) * palpha) >> 8;
+            if (aval == MAX_ALPHA) {
+                d[i] = cval;
+            } else if (aval > 0) {
+                blendSrcOver8888_pre_pre(&d[i], malpha+1, palpha, R(cval), G(cval), B(cval));
+            }
+        }
+    }
+}
+
+static void
+srcPaintRow(const BlitSpans* spans, jint* d, const jbyte* mask,
+            const jint* paint, jint n)
+{
+    jint i = spans->srcPaint(d, mask, paint, n);
+
+    for (; i < n; i++) {
+        jint cval = paint[i];
+        jint acoverage = mask[i] & 0xff;
+        if (acoverage == MAX_ALPHA) {
+            d[i] = cval;
+        } else if (acoverage > 0) {
+            jint aval = ((acoverage+1) * A(cval)) >> 8;
+            blendSrc8888_pre_pre(&d[i], aval, 255 - acoverage, R(cval), G(cval), B(cval));
+        }
+    }
+}
+/* SIMD SPANS routines END */
+
 void
 emitLineSource8888_pre(Renderer *rdr, jint height, jint frac) {
     jint j, minX, maxX, w, iidx;
@@ -83,6 +728,7 @@ emitLineSource8888_pre(Renderer *rdr, jint height, jint frac) {
     jint imageOffset = rdr->_currImageOffset;
     jint imageScanlineStride = rdr->_imageScanlineStride;
     jint imagePixelStride = rdr->_imagePixelStride;
+    const BlitSpans* spans = getBlitSpans(imagePixelStride);
 
     jint *a, *am;
 
@@ -114,6 +760,9 @@ emitLineSource8888_pre(Renderer *rdr, jint height, jint frac) {
                 a += imagePixelStride;
             }
             am = a + w;
+            if (spans != NULL) {
+                a += spans->fill(a, w, pixel);
+            }
             while (a < am) {
                 *a = pixel;
                 a += imagePixelStride;
@@ -158,6 +807,7 @@ emitLinePTSource8888_pre(Renderer *rdr, jint height, jint frac) {
     jint imageOffset = rdr->_currImageOffset;
     jint imageScanlineStride = rdr->_imageScanlineStride;
     jint imagePixelStride = rdr->_imagePixelStride;
+    const BlitSpans* spans = getBlitSpans(imagePixelStride);
 
     jint* paint = rdr->_paint;
     jint cval, paint_stride;
@@ -187,6 +837,11 @@ emitLinePTSource8888_pre(Renderer *rdr, jint height, jint frac) {
         }
         am = a + w;
         if (frac == 0x10000) { // full coverage
+            if (spans != NULL && w > 0) {
+                memcpy(a, paint + aidx, w * sizeof(jint));
+                a += w;
+                aidx += w;
+            }
             while (a < am) {
                 *a = paint[aidx];
                 a += imagePixelStride;
@@ -217,6 +872,7 @@ emitLineSourceOver8888_pre(Renderer *rdr, jint height, jint frac) {
     jint imageOffset = rdr->_currImageOffset;
     jint imageScanlineStride = rdr->_imageScanlineStride;
     jint imagePixelStride = rdr->_imagePixelStride;
+    const BlitSpans* spans = getBlitSpans(imagePixelStride);
 
     jint *a, *am;
 
@@ -245,6 +901,9 @@ emitLineSourceOver8888_pre(Renderer *rdr, jint height, jint frac) {
                 a += imagePixelStride;
             }
             am = a + w;
+            if (spans != NULL) {
+                a += spans->fill(a, w, solid_pixel);
+            }
             while (a < am) {
                 *a = solid_pixel;
                 a += imagePixelStride;
@@ -265,6 +924,9 @@ emitLineSourceOver8888_pre(Renderer *rdr, jint height, jint frac) {
                 a += imagePixelStride;
             }
             am = a + w;
+            if (spans != NULL) {
+                a += spans->srcOverColor(a, NULL, w, alpha, cred, cgreen, cblue);
+            }
             while (a < am) {
                 blendSrcOver8888_pre(a, alpha, cred, cgreen, cblue);
                 a += imagePixelStride;
@@ -286,6 +948,7 @@ emitLinePTSourceOver8888_pre(Renderer *rdr, jint height, jint frac) {
     jint imageOffset = rdr->_currImageOffset;
     jint imageScanlineStride = rdr->_imageScanlineStride;
     jint imagePixelStride = rdr->_imagePixelStride;
+    const BlitSpans* spans = getBlitSpans(imagePixelStride);
 
     jint* paint = rdr->_paint;
     jint cval, palpha, paint_stride;
@@ -314,6 +977,12 @@ emitLinePTSourceOver8888_pre(Renderer *rdr, jint height, jint frac) {
         }
         am = a + w;
         if (frac == 0x10000) { // full coverage
+            if (spans != NULL) {
+                // frac of 0x100 with skip is the switch below
+                jint done = spans->srcOverPaint(a, NULL, paint + aidx, w, 0x100, XNI_TRUE);
+                a += done;
+                aidx += done;
+            }
             while (a < am) {
                 cval = paint[aidx];
                 palpha = A(cval);
@@ -331,6 +1000,11 @@ emitLinePTSourceOver8888_pre(Renderer *rdr, jint height, jint frac) {
                 aidx++;
             }
         } else {
+            if (spans != NULL) {
+                jint done = spans->srcOverPaint(a, NULL, paint + aidx, w, frac >> 8, XNI_FALSE);
+                a += done;
+                aidx += done;
+            }
             while (a < am) {
                 cval = paint[aidx];
                 blendSrcOver8888_pre_pre(a, frac >> 8, A(cval), R(cval), G(cval), B(cval));
@@ -359,6 +1033,7 @@ blitSrc8888_pre(Renderer *rdr, jint height) {
     jint imageOffset = rdr->_currImageOffset;
     jint imageScanlineStride = rdr->_imageScanlineStride;
     jint imagePixelStride = rdr->_imagePixelStride;
+    const BlitSpans* spans = getBlitSpans(imagePixelStride);
     jint *alpha = rdr->_rowAAInt;
     jint alphaOffset = 0;
     jint alphaStride = rdr->_alphaWidth;
@@ -381,6 +1056,14 @@ blitSrc8888_pre(Renderer *rdr, jint height) {
         aval_relative = 0;
         a = alpha;
         am = a + w;
+        while (spans != NULL && a < am) {
+            jbyte coverage[COVERAGE_CHUNK];
+            jint n = (jint)MIN(am - a, COVERAGE_CHUNK);
+            aval_relative = rowCoverage(coverage, a, n, aval_relative, alphaMap, XNI_FALSE);
+            srcColorRow(spans, intData + iidx, coverage, n, calpha, cred, cgreen, cblue);
+            a += n;
+            iidx += n;
+        }
         while (a < am) {
             aval_relative += *a;
             *a++ = 0;
@@ -410,6 +1093,7 @@ blitSrcMask8888_pre(Renderer *rdr, jint height) {
     jint imageOffset = rdr->_currImageOffset;
     jint imageScanlineStride = rdr->_imageScanlineStride;
     jint imagePixelStride = rdr->_imagePixelStride;
+    const BlitSpans* spans = getBlitSpans(imagePixelStride);
     jbyte *alpha = rdr->_mask_byteData;
     jint alphaOffset = rdr->_maskOffset;
     jint alphaStride = rdr->_alphaWidth;
@@ -430,6 +1114,10 @@ blitSrcMask8888_pre(Renderer *rdr, jint height) {
 
         a = alpha + alphaOffset;
         am = a + w;
+        if (spans != NULL) {
+            srcColorRow(spans, intData + iidx, a, w, calpha, cred, cgreen, cblue);
+            a = am;
+        }
         while (a < am) {
             acoverage = *a++ & 0xff;
             // run in integers otherwise it overflows
@@ -459,6 +1147,7 @@ blitPTSrc8888_pre(Renderer *rdr, jint height) {
     jint imageOffset = rdr->_currImageOffset;
     jint imageScanlineStride = rdr->_imageScanlineStride;
     jint imagePixelStride = rdr->_imagePixelStride;
+    const BlitSpans* spans = getBlitSpans(imagePixelStride);
     jint *alpha = rdr->_rowAAInt;
 
     jint *a, *am;
@@ -479,6 +1168,15 @@ blitPTSrc8888_pre(Renderer *rdr, jint height) {
         aval_relative = 0;
         a = alpha;
         am = a + w;
+        while (spans != NULL && a < am) {
+            jbyte coverage[COVERAGE_CHUNK];
+            jint n = (jint)MIN(am - a, COVERAGE_CHUNK);
+            aval_relative = rowCoverage(coverage, a, n, aval_relative, alphaMap, XNI_FALSE);
+            srcPaintRow(spans, intData + iidx, coverage, paint + aidx, n);
+            a += n;
+            iidx += n;
+            aidx += n;
+        }
         while (a < am) {
             assert(aidx >= 0);
             assert(aidx < rdr->_paint_length);
@@ -514,6 +1212,7 @@ blitPTSrcMask8888_pre(Renderer *rdr, jint height) {
     jint imageOffset = rdr->_currImageOffset;
     jint imageScanlineStride = rdr->_imageScanlineStride;
     jint imagePixelStride = rdr->_imagePixelStride;
+    const BlitSpans* spans = getBlitSpans(imagePixelStride);
     jbyte *alpha = rdr->_mask_byteData;
     jint alphaOffset = rdr->_maskOffset;
 
@@ -532,6 +1231,10 @@ blitPTSrcMask8888_pre(Renderer *rdr, jint height) {
 
         a = alpha + alphaOffset;
         am = a + w;
+        if (spans != NULL) {
+            srcPaintRow(spans, intData + iidx, a, paint, w);
+            a = am;
+        }
         while (a < am) {
             cval = paint[aidx];
             palpha = A(cval);
@@ -563,6 +1266,7 @@ blitSrcOver8888_pre(Renderer *rdr, jint height) {
     jint imageOffset = rdr->_currImageOffset;
     jint imageScanlineStride = rdr->_imageScanlineStride;
     jint imagePixelStride = rdr->_imagePixelStride;
+    const BlitSpans* spans = getBlitSpans(imagePixelStride);
     jint *alpha = rdr->_rowAAInt;
     jint alphaOffset = 0;
     jint alphaStride = rdr->_alphaWidth;
@@ -585,6 +1289,14 @@ blitSrcOver8888_pre(Renderer *rdr, jint height) {
         aval_relative = 0;
         a = alpha;
         am = a + w;
+        while (spans != NULL && a < am) {
+            jbyte coverage[COVERAGE_CHUNK];
+            jint n = (jint)MIN(am - a, COVERAGE_CHUNK);
+            aval_relative = rowCoverage(coverage, a, n, aval_relative, alphaMap, XNI_TRUE);
+            srcOverColorRow(spans, intData + iidx, coverage, n, calpha, cred, cgreen, cblue);
+            a += n;
+            iidx += n;
+        }
         while (a < am) {
             aval_relative += *a;
             *a++ = 0;
@@ -615,6 +1327,7 @@ blitSrcOverMask8888_pre(Renderer *rdr, jint height) {
     jint imageOffset = rdr->_currImageOffset;
     jint imageScanlineStride = rdr->_imageScanlineStride;
     jint imagePixelStride = rdr->_imagePixelStride;
+    const BlitSpans* spans = getBlitSpans(imagePixelStride);
     jbyte *alpha = rdr->_mask_byteData;
     jint alphaOffset = rdr->_maskOffset;
     jint alphaStride = rdr->_alphaWidth;
@@ -635,6 +1348,10 @@ blitSrcOverMask8888_pre(Renderer *rdr, jint height) {
 
         a = alpha + alphaOffset;
         am = a + w;
+        if (spans != NULL) {
+            srcOverColorRow(spans, intData + iidx, a, w, calpha, cred, cgreen, cblue);
+            a = am;
+        }
         while (a < am) {
             if (*a) {
                 aval = *a & 0xff;
@@ -665,6 +1382,7 @@ blitSrcOverLCDMask8888_pre(Renderer *rdr, jint height) {
     jint imageOffset = rdr->_currImageOffset;
     jint imageScanlineStride = rdr->_imageScanlineStride;
     jint imagePixelStride = rdr->_imagePixelStride;
+    const BlitSpans* spans = getBlitSpans(imagePixelStride);
     jbyte *alpha = rdr->_mask_byteData;
     jint alphaOffset = rdr->_maskOffset;
     jint alphaStride = rdr->_alphaWidth;
@@ -685,6 +1403,11 @@ blitSrcOverLCDMask8888_pre(Renderer *rdr, jint height) {
 
         a = alpha + alphaOffset;
         am = a + 3*w;
+        if (spans != NULL && spans->srcOverLCD != NULL) {
+            jint done = spans->srcOverLCD(intData + iidx, a, w, calpha, cred, cgreen, cblue);
+            a += 3 * done;
+            iidx += done;
+        }
         while (a < am) {
             ared = *a++ & 0xff;
             agreen = *a++ & 0xff;
@@ -720,6 +1443,7 @@ blitPTSrcOver8888_pre(Renderer *rdr, jint height) {
     jint imageOffset = rdr->_currImageOffset;
     jint imageScanlineStride = rdr->_imageScanlineStride;
     jint imagePixelStride = rdr->_imagePixelStride;
+    const BlitSpans* spans = getBlitSpans(imagePixelStride);
     jint *alpha = rdr->_rowAAInt;
 
     jint *a, *am;
@@ -740,6 +1464,15 @@ blitPTSrcOver8888_pre(Renderer *rdr, jint height) {
         aval_relative = 0;
         a = alpha;
         am = a + w;
+        while (spans != NULL && a < am) {
+            jbyte coverage[COVERAGE_CHUNK];
+            jint n = (jint)MIN(am - a, COVERAGE_CHUNK);
+            aval_relative = rowCoverage(coverage, a, n, aval_relative, alphaMap, XNI_TRUE);
+            srcOverPaintRow(spans, intData + iidx, coverage, paint + aidx, n);
+            a += n;
+            iidx += n;
+            aidx += n;
+        }
         while (a < am) {
             assert(aidx >= 0);
             assert(aidx < rdr->_paint_length);
@@ -777,6 +1510,7 @@ blitPTSrcOverMask8888_pre(Renderer *rdr, jint height) {
     jint imageOffset = rdr->_currImageOffset;
     jint imageScanlineStride = rdr->_imageScanlineStride;
     jint imagePixelStride = rdr->_imagePixelStride;
+    const BlitSpans* spans = getBlitSpans(imagePixelStride);
     jbyte *alpha = rdr->_mask_byteData;
     jint alphaOffset = rdr->_maskOffset;
 
@@ -795,6 +1529,10 @@ blitPTSrcOverMask8888_pre(Renderer *rdr, jint height) {
 
         a = alpha + alphaOffset;
         am = a + w;
+        if (spans != NULL) {
+            srcOverPaintRow(spans, intData + iidx, a, paint, w);
+            a = am;
+        }
         while (a < am) {
             if (*a) {
                 cval = paint[aidx];
@@ -823,6 +1561,7 @@ clearRect8888_any(Renderer *rdr, jint x, jint y, jint w, jint h) {
     jint cval = (rdr->_calpha << 24) | (rdr->_cred << 16) |
                 (rdr->_cgreen << 8) | rdr->_cblue;
     jint pixelStride = rdr->_imagePixelStride;
+    const BlitSpans* spans = getBlitSpans(pixelStride);
     //jint scanlineSkip = rdr->_imageScanlineStride - w * pixelStride;
     jint* intData = (jint*)rdr->_data + rdr->_imageOffset +
                     y * rdr->_imageScanlineStride + x * pixelStride;
@@ -845,6 +1584,9 @@ clearRect8888_any(Renderer *rdr, jint x, jint y, jint w, jint h) {
         //printf("clear 8888, x: %d, y: %d, w: %d, h: %d\n", x, y, w, h);
         int size = sizeof(jint) * w;
         //set first scanline to cval
+        if (spans != NULL) {
+            intData2 += spans->fill(intData2, w, cval);
+        }
         while(intData2 < intData2End) {
             *intData2++ = cval;
         }
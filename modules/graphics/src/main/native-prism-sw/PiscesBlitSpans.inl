@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * Blitting spans for x86, included by PiscesBlit.c once for SSE2 and once
+ * for AVX2 with the V_* macros set to the intrinsics of each.
+ *
+ * A vector holds V_PIXELS pixels. Their components are blended in 16 bit
+ * lanes, in the low and high halves given by V_UNPACKLO8/V_UNPACKHI8, and
+ * packed back with V_PACKUS16. Values of a whole pixel, like a coverage,
+ * are spread over its 4 lanes. All the spans give the same results as the
+ * loops of PiscesBlit.c, see there for the formulas, overflows included.
+ */
+
+// 257 * (x + 1) >> 16, which is div255(x) for x <= 65535 - 1
+static INLINE SIMD_TARGET V
+SIMD_FUNC(div255)(V x) {
+    return V_MULHI16U(V_ADD16(x, V_SET1_16(1)), V_SET1_16(257));
+}
+
+// The alpha lane of every pixel, in its 4 lanes
+static INLINE SIMD_TARGET V
+SIMD_FUNC(spreadAlpha)(V x) {
+    return V_SHUFFLEHI16(V_SHUFFLELO16(x, 0xFF), 0xFF);
+}
+
+// Values of 16 bits or less, one per pixel, in the 4 lanes of the pixel
+static INLINE SIMD_TARGET V
+SIMD_FUNC(spreadLo)(V x) {
+    x = V_OR(x, V_SLLI32(x, 16));
+    return V_UNPACKLO32(x, x);
+}
+
+static INLINE SIMD_TARGET V
+SIMD_FUNC(spreadHi)(V x) {
+    x = V_OR(x, V_SLLI32(x, 16));
+    return V_UNPACKHI32(x, x);
+}
+
+// V_PACKUS16 for components of up to 9 bits, which carry into the next
+// component, as in the scalar loops when the paint is added unscaled or is
+// not premultiplied.
+static INLINE SIMD_TARGET V
+SIMD_FUNC(packOverflow)(V lo, V hi) {
+    V low = V_SET1_32(0xFFFF);
+    V high = V_SET1_32(0x1FF00);
+
+    // b | (g << 8) and r | (a << 8) in every 32 bit lane
+    lo = V_OR(V_AND(lo, low), V_AND(V_SRLI32(lo, 8), high));
+    hi = V_OR(V_AND(hi, low), V_AND(V_SRLI32(hi, 8), high));
+    // then OR-ed into the pixel, in the even lanes
+    lo = V_OR(lo, V_SRLI64(V_SLLI32(lo, 16), 32));
+    hi = V_OR(hi, V_SRLI64(V_SLLI32(hi, 16), 32));
+    return V_UNPACKLO64(V_SHUFFLE32(lo, 0x08), V_SHUFFLE32(hi, 0x08));
+}
+
+// The pixels of a where mask is set, the ones of b elsewhere
+static INLINE SIMD_TARGET V
+SIMD_FUNC(select)(V mask, V a, V b) {
+    return V_OR(V_AND(mask, a), V_ANDNOT(mask, b));
+}
+
+static SIMD_TARGET jint
+SIMD_FUNC(fillSpan)(jint* d, jint n, jint pixel) {
+    V p = V_SET1_32(pixel);
+    jint i;
+
+    for (i = 0; i + V_PIXELS <= n; i += V_PIXELS) {
+        V_STORE(d + i, p);
+    }
+    return i;
+}
+
+// blendSrcOver8888_pre() with aval = ((mask + 1) * alpha) >> 8, or alpha
+// when there is no mask.
+static SIMD_TARGET jint
+SIMD_FUNC(srcOverColorSpan)(jint* d, const jbyte* mask, jint n,
+                            jint alpha, jint red, jint green, jint blue)
+{
+    V zero = V_ZERO;
+    V v255 = V_SET1_16(255);
+    V s = V_SET4_16(255, red, green, blue);
+    V alo = V_SET1_16(alpha);
+    V ahi = alo;
+    jint i;
+
+    for (i = 0; i + V_PIXELS <= n; i += V_PIXELS) {
+        V dv = V_LOAD(d + i);
+        V dlo = V_UNPACKLO8(dv, zero);
+        V dhi = V_UNPACKHI8(dv, zero);
+
+        if (mask != NULL) {
+            V aval = V_LOAD_MASK(mask + i);
+            aval = V_ADD32(aval, V_SET1_32(1));
+            aval = V_SRLI32(V_MULLO16(aval, V_SET1_32(alpha)), 8);
+            alo = SIMD_FUNC(spreadLo)(aval);
+            ahi = SIMD_FUNC(spreadHi)(aval);
+        }
+        dlo = V_ADD16(V_MULLO16(s, alo), V_MULLO16(V_SUB16(v255, alo), dlo));
+        dhi = V_ADD16(V_MULLO16(s, ahi), V_MULLO16(V_SUB16(v255, ahi), dhi));
+        V_STORE(d + i, V_PACKUS16(SIMD_FUNC(div255)(dlo), SIMD_FUNC(div255)(dhi)));
+    }
+    return i;
+}
+
+// The Source loops of a color through a mask, with blendSrc8888_pre()
+static SIMD_TARGET jint
+SIMD_FUNC(srcColorSpan)(jint* d, const jbyte* mask, jint n,
+                        jint alpha, jint red, jint green, jint blue)
+{
+    V zero = V_ZERO;
+    V s = V_SET4_16(255, red, green, blue);
+    V solid = V_SET1_32((alpha << 24) | (red << 16) | (green << 8) | blue);
+    jint i;
+
+    for (i = 0; i + V_PIXELS <= n; i += V_PIXELS) {
+        V dv = V_LOAD(d + i);
+        V dlo = V_UNPACKLO8(dv, zero);
+        V dhi = V_UNPACKHI8(dv, zero);
+        V m = V_LOAD_MASK(mask + i);
+        V aval = V_SRLI32(V_MULLO16(V_ADD32(m, V_SET1_32(1)), V_SET1_32(alpha)), 8);
+        V raaval = V_SUB32(V_SET1_32(255), m);
+        V res;
+
+        // The alpha lanes hold the denominator, 0 gives transparent black
+        dlo = V_ADD16(V_MULLO16(s, SIMD_FUNC(spreadLo)(aval)),
+                      V_MULLO16(SIMD_FUNC(spreadLo)(raaval), dlo));
+        dhi = V_ADD16(V_MULLO16(s, SIMD_FUNC(spreadHi)(aval)),
+                      V_MULLO16(SIMD_FUNC(spreadHi)(raaval), dhi));
+        dlo = V_ANDNOT(SIMD_FUNC(spreadAlpha)(V_CMPEQ16(dlo, zero)), SIMD_FUNC(div255)(dlo));
+        dhi = V_ANDNOT(SIMD_FUNC(spreadAlpha)(V_CMPEQ16(dhi, zero)), SIMD_FUNC(div255)(dhi));
+        res = V_PACKUS16(dlo, dhi);
+
+        res = SIMD_FUNC(select)(V_CMPEQ32(m, V_SET1_32(MAX_ALPHA)), solid, res);
+        res = SIMD_FUNC(select)(V_CMPEQ32(m, zero), dv, res);
+        V_STORE(d + i, res);
+    }
+    return i;
+}
+
+// blendSrcOver8888_pre_pre() of the paint with frac = mask + 1, or frac when
+// there is no mask. With skip, the pixels where the paint ends up opaque are
+// copied and the ones where it ends up transparent are left alone.
+static SIMD_TARGET jint
+SIMD_FUNC(srcOverPaintSpan)(jint* d, const jbyte* mask, const jint* paint,
+                            jint n, jint frac, jboolean skip)
+{
+    V zero = V_ZERO;
+    V v255 = V_SET1_16(255);
+    V flo = V_SET1_16(frac);
+    V fhi = flo;
+    jint i;
+
+    for (i = 0; i + V_PIXELS <= n; i += V_PIXELS) {
+        V dv = V_LOAD(d + i);
+        V pv = V_LOAD(paint + i);
+        V dlo = V_UNPACKLO8(dv, zero);
+        V dhi = V_UNPACKHI8(dv, zero);
+        V slo, shi, alo, ahi, res;
+
+        if (mask != NULL) {
+            V f = V_ADD32(V_LOAD_MASK(mask + i), V_SET1_32(1));
+            flo = SIMD_FUNC(spreadLo)(f);
+            fhi = SIMD_FUNC(spreadHi)(f);
+        }
+        // (s * frac) >> 8, aval2 in the alpha lanes
+        slo = V_SRLI16(V_MULLO16(V_UNPACKLO8(pv, zero), flo), 8);
+        shi = V_SRLI16(V_MULLO16(V_UNPACKHI8(pv, zero), fhi), 8);
+        alo = SIMD_FUNC(spreadAlpha)(slo);
+        ahi = SIMD_FUNC(spreadAlpha)(shi);
+        dlo = V_ADD16(slo, SIMD_FUNC(div255)(V_MULLO16(V_SUB16(v255, alo), dlo)));
+        dhi = V_ADD16(shi, SIMD_FUNC(div255)(V_MULLO16(V_SUB16(v255, ahi), dhi)));
+        if (V_MOVEMASK8(V_OR(V_CMPGT16(dlo, v255), V_CMPGT16(dhi, v255))) != 0) {
+            res = SIMD_FUNC(packOverflow)(dlo, dhi);
+        } else {
+            res = V_PACKUS16(dlo, dhi);
+        }
+
+        if (skip) {
+            V opaque = V_PACKS16(V_CMPEQ16(alo, v255), V_CMPEQ16(ahi, v255));
+            V clear = V_PACKS16(V_CMPEQ16(alo, zero), V_CMPEQ16(ahi, zero));
+            res = SIMD_FUNC(select)(opaque, pv, res);
+            res = SIMD_FUNC(select)(clear, dv, res);
+        }
+        V_STORE(d + i, res);
+    }
+    return i;
+}
+
+// The Source loops of the paint through a mask, with blendSrc8888_pre_pre(),
+// which adds the paint unscaled. The components overflow where the coverage
+// is partial and the destination isn't clear.
+static SIMD_TARGET jint
+SIMD_FUNC(srcPaintSpan)(jint* d, const jbyte* mask, const jint* paint, jint n) {
+    V zero = V_ZERO;
+    V v255 = V_SET1_16(255);
+    V alphaLanes = V_SET4_16(-1, 0, 0, 0);
+    jint i;
+
+    for (i = 0; i + V_PIXELS <= n; i += V_PIXELS) {
+        V dv = V_LOAD(d + i);
+        V pv = V_LOAD(paint + i);
+        V m = V_LOAD_MASK(mask + i);
+        V f = V_ADD32(m, V_SET1_32(1));
+        V raaval = V_SUB32(V_SET1_32(255), m);
+        V plo = V_UNPACKLO8(pv, zero);
+        V phi = V_UNPACKHI8(pv, zero);
+        V dlo = V_UNPACKLO8(dv, zero);
+        V dhi = V_UNPACKHI8(dv, zero);
+        V avlo = V_SRLI16(V_MULLO16(SIMD_FUNC(spreadLo)(f), SIMD_FUNC(spreadAlpha)(plo)), 8);
+        V avhi = V_SRLI16(V_MULLO16(SIMD_FUNC(spreadHi)(f), SIMD_FUNC(spreadAlpha)(phi)), 8);
+        V res;
+
+        // raaval * d, plus 255 * aval in the alpha lanes for the denominator
+        dlo = V_ADD16(V_MULLO16(SIMD_FUNC(spreadLo)(raaval), dlo),
+                      V_AND(alphaLanes, V_MULLO16(avlo, v255)));
+        dhi = V_ADD16(V_MULLO16(SIMD_FUNC(spreadHi)(raaval), dhi),
+                      V_AND(alphaLanes, V_MULLO16(avhi, v255)));
+        plo = V_ANDNOT(SIMD_FUNC(spreadAlpha)(V_CMPEQ16(dlo, zero)),
+                       V_ADD16(SIMD_FUNC(div255)(dlo), V_ANDNOT(alphaLanes, plo)));
+        phi = V_ANDNOT(SIMD_FUNC(spreadAlpha)(V_CMPEQ16(dhi, zero)),
+                       V_ADD16(SIMD_FUNC(div255)(dhi), V_ANDNOT(alphaLanes, phi)));
+        if (V_MOVEMASK8(V_OR(V_CMPGT16(plo, v255), V_CMPGT16(phi, v255))) != 0) {
+            res = SIMD_FUNC(packOverflow)(plo, phi);
+        } else {
+            res = V_PACKUS16(plo, phi);
+        }
+
+        res = SIMD_FUNC(select)(V_CMPEQ32(m, V_SET1_32(MAX_ALPHA)), pv, res);
+        res = SIMD_FUNC(select)(V_CMPEQ32(m, zero), dv, res);
+        V_STORE(d + i, res);
+    }
+    return i;
+}
@@ -28,9 +28,19 @@
 
 #include <PiscesSysutils.h>
 #include <PiscesMath.h>
+#include <PiscesSimd.h>
 
 #include <limits.h>
 
+#if ENABLE_SIMD_AVX2
+#include <immintrin.h>
+#elif ENABLE_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+#if ENABLE_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
 #define NO_REPEAT_NO_INTERPOLATE        0
 #define REPEAT_NO_INTERPOLATE           1
 #define NO_REPEAT_INTERPOLATE_NO_ALPHA  2
@@ -91,6 +101,400 @@ pad(jint ifrac, jint cycleMethod) {
     return ifrac;
 }
 
+/* SIMD SPANS routines BEGIN */
+
+/*
+ * Paint generation loops over contiguous pixels, which the routines below
+ * use when the CPU has SIMD extensions. They give the same results as the
+ * scalar loops, and return the number of pixels they generated, from the
+ * start of the row. The routines do the rest.
+ */
+typedef struct _PaintSpans {
+    jint (*linearGradient)(jint* paint, jint n, jlong lfrac, jlong lstep,
+                           const jint* colors, jint cycleMethod);
+    // NULL when there is no double precision square root
+    jint (*radialGradient)(jint* paint, const jfloat* u, const jfloat* v,
+                           jint n, const jint* colors, jint cycleMethod);
+    jint (*textureRow)(jint* paint, const jint* row0, const jint* row1,
+                       jint n, jint hfrac, jint vfrac, jboolean opaque);
+    // NULL when texels can't be gathered
+    jint (*scaledTextureRow)(jint* paint, const jint* row0, const jint* row1,
+                             jint n, jint ltx, jint dx, jint vfrac,
+                             jboolean noAlpha);
+} PaintSpans;
+
+#if ENABLE_SIMD_SSE2
+static INLINE __m128i
+gather_sse2(const jint* base, __m128i idx) {
+    jint i[4];
+
+    _mm_storeu_si128((__m128i*)i, idx);
+    return _mm_set_epi32(base[i[3]], base[i[2]], base[i[1]], base[i[0]]);
+}
+
+#define SIMD_FUNC(name) name##_sse2
+#define SIMD_TARGET
+#define V __m128i
+#define V_PIXELS 4
+#define V_ZERO _mm_setzero_si128()
+#define V_LOAD(p) _mm_loadu_si128((const __m128i*)(p))
+#define V_STORE(p, v) _mm_storeu_si128((__m128i*)(p), v)
+#define V_GATHER32(base, idx) gather_sse2(base, idx)
+#define V_SET1_16(x) _mm_set1_epi16((short)(x))
+#define V_SET1_32(x) _mm_set1_epi32(x)
+#define V_UNPACKLO8(a, b) _mm_unpacklo_epi8(a, b)
+#define V_UNPACKHI8(a, b) _mm_unpackhi_epi8(a, b)
+#define V_UNPACKLO32(a, b) _mm_unpacklo_epi32(a, b)
+#define V_UNPACKHI32(a, b) _mm_unpackhi_epi32(a, b)
+#define V_PACKUS16(a, b) _mm_packus_epi16(a, b)
+#define V_ADD16(a, b) _mm_add_epi16(a, b)
+#define V_SUB16(a, b) _mm_sub_epi16(a, b)
+#define V_MULLO16(a, b) _mm_mullo_epi16(a, b)
+#define V_MULHI16(a, b) _mm_mulhi_epi16(a, b)
+#define V_SRLI16(a, i) _mm_srli_epi16(a, i)
+#define V_CMPGT16(a, b) _mm_cmpgt_epi16(a, b)
+#define V_ADD32(a, b) _mm_add_epi32(a, b)
+#define V_SUB32(a, b) _mm_sub_epi32(a, b)
+#define V_SLLI32(a, i) _mm_slli_epi32(a, i)
+#define V_SRLI32(a, i) _mm_srli_epi32(a, i)
+#define V_SRAI32(a, i) _mm_srai_epi32(a, i)
+#define V_CMPEQ32(a, b) _mm_cmpeq_epi32(a, b)
+#define V_CMPGT32(a, b) _mm_cmpgt_epi32(a, b)
+#define V_AND(a, b) _mm_and_si128(a, b)
+#define V_ANDNOT(a, b) _mm_andnot_si128(a, b)
+#define V_OR(a, b) _mm_or_si128(a, b)
+#define V_XOR(a, b) _mm_xor_si128(a, b)
+#define VF __m128
+#define VF_LOAD(p) _mm_loadu_ps(p)
+#define VD __m128d
+#define VD_CVTLO(a) _mm_cvtps_pd(a)
+#define VD_CVTHI(a) _mm_cvtps_pd(_mm_movehl_ps(a, a))
+#define VD_ADD(a, b) _mm_add_pd(a, b)
+#define VD_SQRT(a) _mm_sqrt_pd(a)
+#define V_CVTTPD(lo, hi) _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi))
+
+#include <PiscesPaintSpans.inl>
+
+#undef SIMD_FUNC
+#undef SIMD_TARGET
+#undef V
+#undef V_PIXELS
+#undef V_ZERO
+#undef V_LOAD
+#undef V_STORE
+#undef V_GATHER32
+#undef V_SET1_16
+#undef V_SET1_32
+#undef V_UNPACKLO8
+#undef V_UNPACKHI8
+#undef V_UNPACKLO32
+#undef V_UNPACKHI32
+#undef V_PACKUS16
+#undef V_ADD16
+#undef V_SUB16
+#undef V_MULLO16
+#undef V_MULHI16
+#undef V_SRLI16
+#undef V_CMPGT16
+#undef V_ADD32
+#undef V_SUB32
+#undef V_SLLI32
+#undef V_SRLI32
+#undef V_SRAI32
+#undef V_CMPEQ32
+#undef V_CMPGT32
+#undef V_AND
+#undef V_ANDNOT
+#undef V_OR
+#undef V_XOR
+#undef VF
+#undef VF_LOAD
+#undef VD
+#undef VD_CVTLO
+#undef VD_CVTHI
+#undef VD_ADD
+#undef VD_SQRT
+#undef V_CVTTPD
+
+static const PaintSpans spans_sse2 = {
+    linearGradientSpan_sse2,
+    radialGradientSpan_sse2,
+    textureRowSpan_sse2,
+    scaledTextureRowSpan_sse2
+};
+#endif // ENABLE_SIMD_SSE2
+
+#if ENABLE_SIMD_AVX2
+#define SIMD_FUNC(name) name##_avx2
+#define SIMD_TARGET TARGET_AVX2
+#define V __m256i
+#define V_PIXELS 8
+#define V_ZERO _mm256_setzero_si256()
+#define V_LOAD(p) _mm256_loadu_si256((const __m256i*)(p))
+#define V_STORE(p, v) _mm256_storeu_si256((__m256i*)(p), v)
+#define V_GATHER32(base, idx) _mm256_i32gather_epi32((const int*)(base), idx, 4)
+#define V_SET1_16(x) _mm256_set1_epi16((short)(x))
+#define V_SET1_32(x) _mm256_set1_epi32(x)
+#define V_UNPACKLO8(a, b) _mm256_unpacklo_epi8(a, b)
+#define V_UNPACKHI8(a, b) _mm256_unpackhi_epi8(a, b)
+#define V_UNPACKLO32(a, b) _mm256_unpacklo_epi32(a, b)
+#define V_UNPACKHI32(a, b) _mm256_unpackhi_epi32(a, b)
+#define V_PACKUS16(a, b) _mm256_packus_epi16(a, b)
+#define V_ADD16(a, b) _mm256_add_epi16(a, b)
+#define V_SUB16(a, b) _mm256_sub_epi16(a, b)
+#define V_MULLO16(a, b) _mm256_mullo_epi16(a, b)
+#define V_MULHI16(a, b) _mm256_mulhi_epi16(a, b)
+#define V_SRLI16(a, i) _mm256_srli_epi16(a, i)
+#define V_CMPGT16(a, b) _mm256_cmpgt_epi16(a, b)
+#define V_ADD32(a, b) _mm256_add_epi32(a, b)
+#define V_SUB32(a, b) _mm256_sub_epi32(a, b)
+#define V_SLLI32(a, i) _mm256_slli_epi32(a, i)
+#define V_SRLI32(a, i) _mm256_srli_epi32(a, i)
+#define V_SRAI32(a, i) _mm256_srai_epi32(a, i)
+#define V_CMPEQ32(a, b) _mm256_cmpeq_epi32(a, b)
+#define V_CMPGT32(a, b) _mm256_cmpgt_epi32(a, b)
+#define V_AND(a, b) _mm256_and_si256(a, b)
+#define V_ANDNOT(a, b) _mm256_andnot_si256(a, b)
+#define V_OR(a, b) _mm256_or_si256(a, b)
+#define V_XOR(a, b) _mm256_xor_si256(a, b)
+#define VF __m256
+#define VF_LOAD(p) _mm256_loadu_ps(p)
+#define VD __m256d
+#define VD_CVTLO(a) _mm256_cvtps_pd(_mm256_castps256_ps128(a))
+#define VD_CVTHI(a) _mm256_cvtps_pd(_mm256_extractf128_ps(a, 1))
+#define VD_ADD(a, b) _mm256_add_pd(a, b)
+#define VD_SQRT(a) _mm256_sqrt_pd(a)
+#define V_CVTTPD(lo, hi) _mm256_inserti128_si256( \
+    _mm256_castsi128_si256(_mm256_cvttpd_epi32(lo)), _mm256_cvttpd_epi32(hi), 1)
+
+#include <PiscesPaintSpans.inl>
+
+#undef SIMD_FUNC
+#undef SIMD_TARGET
+#undef V
+#undef V_PIXELS
+#undef V_ZERO
+#undef V_LOAD
+#undef V_STORE
+#undef V_GATHER32
+#undef V_SET1_16
+#undef V_SET1_32
+#undef V_UNPACKLO8
+#undef V_UNPACKHI8
+#undef V_UNPACKLO32
+#undef V_UNPACKHI32
+#undef V_PACKUS16
+#undef V_ADD16
+#undef V_SUB16
+#undef V_MULLO16
+#undef V_MULHI16
+#undef V_SRLI16
+#undef V_CMPGT16
+#undef V_ADD32
+#undef V_SUB32
+#undef V_SLLI32
+#undef V_SRLI32
+#undef V_SRAI32
+#undef V_CMPEQ32
+#undef V_CMPGT32
+#undef V_AND
+#undef V_ANDNOT
+#undef V_OR
+#undef V_XOR
+#undef VF
+#undef VF_LOAD
+#undef VD
+#undef VD_CVTLO
+#undef VD_CVTHI
+#undef VD_ADD
+#undef VD_SQRT
+#undef V_CVTTPD
+
+static const PaintSpans spans_avx2 = {
+    linearGradientSpan_avx2,
+    radialGradientSpan_avx2,
+    textureRowSpan_avx2,
+    scaledTextureRowSpan_avx2
+};
+#endif // ENABLE_SIMD_AVX2
+
+#if ENABLE_SIMD_NEON
+/*
+ * The NEON spans compute one value per pixel in 32 bit lanes, and the
+ * texels split into their components, 8 pixels at a time.
+ */
+
+static INLINE int32x4_t
+pad_neon(int32x4_t ifrac, jint cycleMethod) {
+    switch (cycleMethod) {
+    case CYCLE_NONE:
+        return vminq_s32(vmaxq_s32(ifrac, vdupq_n_s32(0)), vdupq_n_s32(0xffff));
+    case CYCLE_REPEAT:
+        return vandq_s32(ifrac, vdupq_n_s32(0xffff));
+    case CYCLE_REFLECT:
+        // vabsq_s32() keeps INT_MIN, like the scalar negation
+        ifrac = vandq_s32(vabsq_s32(ifrac), vdupq_n_s32(0x1ffff));
+        return vminq_s32(ifrac, vsubq_s32(vdupq_n_s32(0x1ffff), ifrac));
+    }
+    return ifrac;
+}
+
+static jint
+linearGradientSpan_neon(jint* paint, jint n, jlong lfrac, jlong lstep,
+                        const jint* colors, jint cycleMethod)
+{
+    jint ints[4], fracs[4], idx[4];
+    jlong lgroup = lstep * 4;
+    int32x4_t istep = vdupq_n_s32((jint)(lgroup >> 16));
+    int32x4_t fstep = vdupq_n_s32((jint)(lgroup & 0xffff));
+    int32x4_t mask = vdupq_n_s32(0xffff);
+    int32x4_t ifrac, ffrac;
+    jint i, k;
+
+    for (i = 0; i < 4; i++, lfrac += lstep) {
+        ints[i] = (jint)(lfrac >> 16);
+        fracs[i] = (jint)(lfrac & 0xffff);
+    }
+    ifrac = vld1q_s32(ints);
+    ffrac = vld1q_s32(fracs);
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        vst1q_s32(idx, vshrq_n_s32(pad_neon(ifrac, cycleMethod), 16 - LG_GRADIENT_MAP_SIZE));
+        for (k = 0; k < 4; k++) {
+            paint[i + k] = colors[idx[k]];
+        }
+        ffrac = vaddq_s32(ffrac, fstep);
+        ifrac = vaddq_s32(vaddq_s32(ifrac, istep), vshrq_n_s32(ffrac, 16));
+        ffrac = vandq_s32(ffrac, mask);
+    }
+    return i;
+}
+
+// interp() of 8 components, in 32 bit lanes
+static INLINE uint16x8_t
+interp_neon(uint16x8_t x0, uint16x8_t x1, jint frac) {
+    int32x4_t bias = vdupq_n_s32(0x8000);
+    int16x8_t d = vreinterpretq_s16_u16(vsubq_u16(x1, x0));
+    int32x4_t lo = vmlaq_n_s32(bias, vmovl_s16(vget_low_s16(d)), frac);
+    int32x4_t hi = vmlaq_n_s32(bias, vmovl_s16(vget_high_s16(d)), frac);
+    int16x8_t r = vcombine_s16(vshrn_n_s32(lo, 16), vshrn_n_s32(hi, 16));
+
+    return vaddq_u16(x0, vreinterpretq_u16_s16(r));
+}
+
+static jint
+textureRowSpan_neon(jint* paint, const jint* row0, const jint* row1,
+                    jint n, jint hfrac, jint vfrac, jboolean opaque)
+{
+    jint i, c;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        uint8x8x4_t p00 = vld4_u8((const uint8_t*)(row0 + i));
+        uint8x8x4_t p01 = vld4_u8((const uint8_t*)(row0 + i + 1));
+        uint8x8x4_t p10 = vld4_u8((const uint8_t*)(row1 + i));
+        uint8x8x4_t p11 = vld4_u8((const uint8_t*)(row1 + i + 1));
+
+        for (c = 0; c < 4; c++) {
+            uint16x8_t x0 = interp_neon(vmovl_u8(p00.val[c]), vmovl_u8(p01.val[c]), hfrac);
+            uint16x8_t x1 = interp_neon(vmovl_u8(p10.val[c]), vmovl_u8(p11.val[c]), hfrac);
+            p00.val[c] = vmovn_u16(interp_neon(x0, x1, vfrac));
+        }
+        if (opaque) {
+            p00.val[3] = vdup_n_u8(0xff);
+        }
+        vst4_u8((uint8_t*)(paint + i), p00);
+    }
+    return i;
+}
+
+static const PaintSpans spans_neon = {
+    linearGradientSpan_neon,
+    NULL,
+    textureRowSpan_neon,
+    NULL
+};
+#endif // ENABLE_SIMD_NEON
+
+// The spans, NULL when there are no SIMD extensions
+static const PaintSpans*
+getPaintSpans() {
+    switch (pisces_simd_get()) {
+#if ENABLE_SIMD_AVX2
+    case SIMD_AVX2:
+        return &spans_avx2;
+#endif
+#if ENABLE_SIMD_SSE2
+    case SIMD_SSE2:
+        return &spans_sse2;
+#endif
+#if ENABLE_SIMD_NEON
+    case SIMD_NEON:
+        return &spans_neon;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+// Bound of the fractions of a linear gradient row in 16.16 fixed point, 2^46,
+// which keeps their integer parts in a jint
+#define MAX_FIXED_FRAC 70368744177664.0
+
+#define RADIAL_CHUNK 64
+
+/*
+ * The interpolated texels of a TRANSLATE or SCALE_TRANSLATE row from ltx,
+ * stepping by dx, while they don't need the bounds checks: the texel to
+ * the right of each one is in the texture and none is clamped or wrapped.
+ * Returns the number of pixels done, 0 when the scalar loops must do the
+ * one at ltx.
+ */
+static jint
+textureSpan(Renderer* rdr, const PaintSpans* spans, jint* paint, jint n,
+            jlong ltx, jint dx, jint ty, jint vfrac)
+{
+    jint* txtData = rdr->_texture_intData;
+    jint txtStride = rdr->_texture_stride;
+    jint lo = MAX(0, rdr->_texture_txMin - 1);
+    jint hi = MIN(rdr->_texture_txMax, rdr->_texture_imageWidth - 2);
+    jint tx = (jint)(ltx >> 16);
+    jint *row0, *row1;
+    jboolean noAlpha = !rdr->_texture_hasAlpha;
+    jlong run;
+
+    if (spans == NULL || tx < lo || tx > hi || hi >= 0x7fff ||
+        (dx != 0x10000 && spans->scaledTextureRow == NULL))
+    {
+        return 0;
+    }
+
+    // The pixels up to the last one in [lo, hi]
+    if (dx > 0) {
+        run = ((((jlong)hi + 1) << 16) - 1 - ltx) / dx + 1;
+    } else if (dx < 0) {
+        run = (ltx - ((jlong)lo << 16)) / -dx + 1;
+    } else {
+        run = n;
+    }
+    run = MIN(run, n);
+
+    row0 = txtData + MAX(0, ty) * txtStride;
+    if (ty < rdr->_texture_imageHeight - 1) {
+        row1 = row0 + txtStride;
+    } else {
+        row1 = rdr->_texture_repeat ? txtData : row0;
+    }
+
+    if (dx == 0x10000) {
+        jint hfrac = (jint)(ltx & 0xffff);
+        return spans->textureRow(paint, row0 + tx, row1 + tx, (jint)run,
+            hfrac, vfrac, noAlpha && (hfrac || vfrac));
+    }
+    return spans->scaledTextureRow(paint, row0, row1, (jint)run,
+        (jint)ltx, dx, vfrac, noAlpha);
+}
+/* SIMD SPANS routines END */
+
 void
 genLinearGradientPaint(Renderer *rdr, jint height) {
     jint paintOffset = 0;
@@ -110,6 +514,7 @@ genLinearGradientPaint(Renderer *rdr, jint height) {
 
     jint* paint = rdr->_paint;
     jint* colors = rdr->_gradient_colors;
+    const PaintSpans* spans = getPaintSpans();
 
     minX = rdr->_minTouched;
     maxX = rdr->_maxTouched;
@@ -120,12 +525,33 @@ genLinearGradientPaint(Renderer *rdr, jint height) {
         pidx = paintOffset;
 
         frac = x * mx + y * my + b;
-        for (i = 0; i < width; i++, pidx++) {
-            jint ifrac = pad((jint)frac, cycleMethod);
-            ifrac >>= 16 - LG_GRADIENT_MAP_SIZE;
-            paint[pidx] = colors[ifrac];
+        // Stepped in 16.16 fixed point, which doesn't accumulate the float
+        // rounding errors and is exact in SIMD lanes, unless out of range.
+        if (fabs(frac * 65536.0) < MAX_FIXED_FRAC &&
+            fabs((frac + (jdouble)mx * width) * 65536.0) < MAX_FIXED_FRAC)
+        {
+            jlong lfrac = (jlong)(frac * 65536.0);
+            jlong lstep = (jlong)(mx * 65536.0);
+
+            i = (spans != NULL) ?
+                spans->linearGradient(paint + pidx, width, lfrac, lstep, colors, cycleMethod) : 0;
+            pidx += i;
+            lfrac += lstep * i;
+            for (; i < width; i++, pidx++) {
+                jint ifrac = pad((jint)(lfrac >> 16), cycleMethod);
+                ifrac >>= 16 - LG_GRADIENT_MAP_SIZE;
+                paint[pidx] = colors[ifrac];
+
+                lfrac += lstep;
+            }
+        } else {
+            for (i = 0; i < width; i++, pidx++) {
+                jint ifrac = pad((jint)frac, cycleMethod);
+                ifrac >>= 16 - LG_GRADIENT_MAP_SIZE;
+                paint[pidx] = colors[ifrac];
 
-            frac += mx;
+                frac += mx;
+            }
         }
 
         paintOffset += width;
@@ -154,10 +580,16 @@ genRadialGradientPaint(Renderer *rdr, jint height) {
 
     jint* paint = rdr->_paint;
     jint* colors = rdr->_gradient_colors;
+    const PaintSpans* spans = getPaintSpans();
+    jfloat us[RADIAL_CHUNK], vs[RADIAL_CHUNK];
 
     minX = rdr->_minTouched;
     maxX = rdr->_maxTouched;
 
+    if (spans != NULL && spans->radialGradient == NULL) {
+        spans = NULL;
+    }
+
     a00 = rdr->_rg_a00;
     a01 = rdr->_rg_a01;
     a02 = rdr->_rg_a02;
@@ -213,20 +645,50 @@ genRadialGradientPaint(Renderer *rdr, jint height) {
         dU  = (65536.0f * dU);
         dV  = (65536.0f * 65536.0f * dV);
         ddV = (65536.0f * 65536.0f * ddV);
-        for (i = 0; i < width; i++, pidx++) {
-            if (V < 0) {
-                V = 0;
+        if (spans != NULL) {
+            // The recurrence of U and V in chunks, then their square roots
+            // and colors with the spans
+            for (i = 0; i < width; ) {
+                jint n = MIN(width - i, RADIAL_CHUNK);
+                jint k;
+
+                for (k = 0; k < n; k++) {
+                    if (V < 0) {
+                        V = 0;
+                    }
+                    us[k] = U;
+                    vs[k] = V;
+
+                    U += dU;
+                    V += dV;
+                    dV += ddV;
+                }
+                k = spans->radialGradient(paint + pidx, us, vs, n, colors, cycleMethod);
+                for (; k < n; k++) {
+                    ifrac = (jint)(us[k] + PISCESsqrt(vs[k]));
+                    ifrac = pad(ifrac, cycleMethod);
+                    ifrac >>= (16 - LG_GRADIENT_MAP_SIZE);
+                    paint[pidx + k] = colors[ifrac];
+                }
+                i += n;
+                pidx += n;
             }
+        } else {
+            for (i = 0; i < width; i++, pidx++) {
+                if (V < 0) {
+                    V = 0;
+                }
 
-            ifrac = (jint)(U + PISCESsqrt(V));
+                ifrac = (jint)(U + PISCESsqrt(V));
 
-            U += dU;
-            V += dV ;
-            dV += ddV;
+                U += dU;
+                V += dV ;
+                dV += ddV;
 
-            ifrac = pad(ifrac, cycleMethod);
-            ifrac >>= (16 - LG_GRADIENT_MAP_SIZE);
-            paint[pidx] = colors[ifrac];
+                ifrac = pad(ifrac, cycleMethod);
+                ifrac >>= (16 - LG_GRADIENT_MAP_SIZE);
+                paint[pidx] = colors[ifrac];
+            }
         }
 
         paintOffset += width;
@@ -420,6 +882,7 @@ genTexturePaintTarget(Renderer *rdr, jint *paint, jint height) {
     jint txMax = rdr->_texture_txMax;
     jint tyMax = rdr->_texture_tyMax;
     jint repeatInterpolateMode;
+    const PaintSpans* spans = getPaintSpans();
 
     if (rdr->_texture_interpolate) {
         if (rdr->_texture_hasAlpha) {
@@ -450,7 +913,7 @@ genTexturePaintTarget(Renderer *rdr, jint *paint, jint height) {
     // just TRANSLATION
     case TEXTURE_TRANSFORM_TRANSLATE:
         {
-        jint cval, pidx;
+        jint cval, pidx, done;
         jint *a, *am;
         jlong ltx, lty;
         jint tx, ty, vfrac, hfrac;
@@ -509,6 +972,15 @@ genTexturePaintTarget(Renderer *rdr, jint *paint, jint height) {
                 while (a < am) {
                     tx = (jint)(ltx >> 16);
                     checkBoundsRepeat(&tx, &ltx, txMin-1, txMax);
+                    // The texels up to the end of the texture, which wraps
+                    if (tx >= 0) {
+                        done = MIN((jint)(am - a), txMax - tx + 1);
+                        memcpy(a, txtData + MAX(0, ty) * txtStride + tx, sizeof(jint) * done);
+                        a += done;
+                        pidx += done;
+                        ltx += (jlong)done << 16;
+                        continue;
+                    }
                     PISCES_DEBUG("[%d, %d, h:%d, v:%d] ", tx, ty, hfrac, vfrac);
                     sidx = MAX(0, ty) * txtStride + MAX(0, tx);
                     assert(pidx >= 0);
@@ -523,6 +995,13 @@ genTexturePaintTarget(Renderer *rdr, jint *paint, jint height) {
                 while (a < am) {
                     tx = (jint)(ltx >> 16);
                     checkBoundsNoRepeat(&tx, &ltx, txMin-1, txMax);
+                    done = textureSpan(rdr, spans, a, (jint)(am - a), ltx, 0x10000, ty, vfrac);
+                    if (done > 0) {
+                        a += done;
+                        pidx += done;
+                        ltx += (jlong)done << 16;
+                        continue;
+                    }
                     PISCES_DEBUG("[%d, %d, h:%d, v:%d] ", tx, ty, hfrac, vfrac);
                     sidx = MAX(0, ty) * txtStride + MAX(0, tx);
                     p00 = txtData[sidx];
@@ -550,6 +1029,13 @@ genTexturePaintTarget(Renderer *rdr, jint *paint, jint height) {
                 while (a < am) {
                     tx = (jint)(ltx >> 16);
                     checkBoundsRepeat(&tx, &ltx, txMin-1, txMax);
+                    done = textureSpan(rdr, spans, a, (jint)(am - a), ltx, 0x10000, ty, vfrac);
+                    if (done > 0) {
+                        a += done;
+                        pidx += done;
+                        ltx += (jlong)done << 16;
+                        continue;
+                    }
                     PISCES_DEBUG("[%d, %d, h:%d, v:%d] ", tx, ty, hfrac, vfrac);
                     sidx = MAX(0, ty) * txtStride + MAX(0, tx);
                     p00 = txtData[sidx];
@@ -577,6 +1063,13 @@ genTexturePaintTarget(Renderer *rdr, jint *paint, jint height) {
                 while (a < am) {
                     tx = (jint)(ltx >> 16);
                     checkBoundsNoRepeat(&tx, &ltx, txMin-1, txMax);
+                    done = textureSpan(rdr, spans, a, (jint)(am - a), ltx, 0x10000, ty, vfrac);
+                    if (done > 0) {
+                        a += done;
+                        pidx += done;
+                        ltx += (jlong)done << 16;
+                        continue;
+                    }
                     PISCES_DEBUG("[%d, %d, h:%d, v:%d] ", tx, ty, hfrac, vfrac);
                     sidx = MAX(0, ty) * txtStride + MAX(0, tx);
                     p00 = txtData[sidx];
@@ -604,6 +1097,13 @@ genTexturePaintTarget(Renderer *rdr, jint *paint, jint height) {
                 while (a < am) {
                     tx = (jint)(ltx >> 16);
                     checkBoundsRepeat(&tx, &ltx, txMin-1, txMax);
+                    done = textureSpan(rdr, spans, a, (jint)(am - a), ltx, 0x10000, ty, vfrac);
+                    if (done > 0) {
+                        a += done;
+                        pidx += done;
+                        ltx += (jlong)done << 16;
+                        continue;
+                    }
                     PISCES_DEBUG("[%d, %d, h:%d, v:%d] ", tx, ty, hfrac, vfrac);
                     sidx = MAX(0, ty) * txtStride + MAX(0, tx);
                     p00 = txtData[sidx];
@@ -637,7 +1137,7 @@ genTexturePaintTarget(Renderer *rdr, jint *paint, jint height) {
     // scale transform
     case TEXTURE_TRANSFORM_SCALE_TRANSLATE:
         {
-        jint cval, pidx;
+        jint cval, pidx, done;
         jint *a, *am;
         jlong ltx, lty;
         jint tx, ty, vfrac, hfrac;
@@ -707,6 +1207,13 @@ genTexturePaintTarget(Renderer *rdr, jint *paint, jint height) {
                     vfrac = (jint)(lty & 0xffff);
                     checkBoundsNoRepeat(&tx, &ltx, txMin-1, txMax);
                     checkBoundsNoRepeat(&ty, &lty, tyMin-1, tyMax);
+                    done = textureSpan(rdr, spans, a, (jint)(am - a), ltx, rdr->_texture_m00, ty, vfrac);
+                    if (done > 0) {
+                        a += done;
+                        pidx += done;
+                        ltx += (jlong)done * rdr->_texture_m00;
+                        continue;
+                    }
                     PISCES_DEBUG("[%d, %d, h:%d, v:%d] ", tx, ty, hfrac, vfrac);
                     sidx = MAX(0, ty) * txtStride + MAX(0, tx);
                     p00 = txtData[sidx];
@@ -740,6 +1247,13 @@ genTexturePaintTarget(Renderer *rdr, jint *paint, jint height) {
                     vfrac = (jint)(lty & 0xffff);
                     checkBoundsRepeat(&tx, &ltx, txMin-1, txMax);
                     checkBoundsRepeat(&ty, &lty, tyMin-1, tyMax);
+                    done = textureSpan(rdr, spans, a, (jint)(am - a), ltx, rdr->_texture_m00, ty, vfrac);
+                    if (done > 0) {
+                        a += done;
+                        pidx += done;
+                        ltx += (jlong)done * rdr->_texture_m00;
+                        continue;
+                    }
                     PISCES_DEBUG("[%d, %d, h:%d, v:%d] ", tx, ty, hfrac, vfrac);
                     sidx = MAX(0, ty) * txtStride + MAX(0, tx);
                     p00 = txtData[sidx];
@@ -773,6 +1287,13 @@ genTexturePaintTarget(Renderer *rdr, jint *paint, jint height) {
                     vfrac = (jint)(lty & 0xffff);
                     checkBoundsNoRepeat(&tx, &ltx, txMin-1, txMax);
                     checkBoundsNoRepeat(&ty, &lty, tyMin-1, tyMax);
+                    done = textureSpan(rdr, spans, a, (jint)(am - a), ltx, rdr->_texture_m00, ty, vfrac);
+                    if (done > 0) {
+                        a += done;
+                        pidx += done;
+                        ltx += (jlong)done * rdr->_texture_m00;
+                        continue;
+                    }
                     PISCES_DEBUG("[%d, %d, h:%d, v:%d] ", tx, ty, hfrac, vfrac);
                     sidx = MAX(0, ty) * txtStride + MAX(0, tx);
                     p00 = txtData[sidx];
@@ -806,6 +1327,13 @@ genTexturePaintTarget(Renderer *rdr, jint *paint, jint height) {
                     vfrac = (jint)(lty & 0xffff);
                     checkBoundsRepeat(&tx, &ltx, txMin-1, txMax);
                     checkBoundsRepeat(&ty, &lty, tyMin-1, tyMax);
+                    done = textureSpan(rdr, spans, a, (jint)(am - a), ltx, rdr->_texture_m00, ty, vfrac);
+                    if (done > 0) {
+                        a += done;
+                        pidx += done;
+                        ltx += (jlong)done * rdr->_texture_m00;
+                        continue;
+                    }
                     PISCES_DEBUG("[%d, %d, h:%d, v:%d] ", tx, ty, hfrac, vfrac);
                     sidx = MAX(0, ty) * txtStride + MAX(0, tx);
                     p00 = txtData[sidx];
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * Paint spans for x86, included by PiscesPaint.c once for SSE2 and once for
+ * AVX2 with the V_* macros set to the intrinsics of each.
+ *
+ * A vector holds V_PIXELS pixels, or one 32 bit value per pixel. Texels are
+ * interpolated in 16 bit lanes, in the low and high halves given by
+ * V_UNPACKLO8/V_UNPACKHI8. All the spans give the same results as the loops
+ * of PiscesPaint.c.
+ */
+
+// pad() of one fraction per lane
+static INLINE SIMD_TARGET V
+SIMD_FUNC(pad)(V ifrac, jint cycleMethod) {
+    V max = V_SET1_32(0xffff);
+    V over;
+
+    switch (cycleMethod) {
+    case CYCLE_NONE:
+        ifrac = V_ANDNOT(V_CMPGT32(V_ZERO, ifrac), ifrac);
+        over = V_CMPGT32(ifrac, max);
+        return V_OR(V_AND(over, max), V_ANDNOT(over, ifrac));
+    case CYCLE_REPEAT:
+        return V_AND(ifrac, max);
+    case CYCLE_REFLECT:
+        over = V_SRAI32(ifrac, 31);
+        ifrac = V_AND(V_SUB32(V_XOR(ifrac, over), over), V_SET1_32(0x1ffff));
+        over = V_CMPGT32(ifrac, max);
+        return V_OR(V_AND(over, V_SUB32(V_SET1_32(0x1ffff), ifrac)),
+                    V_ANDNOT(over, ifrac));
+    }
+    return ifrac;
+}
+
+static INLINE SIMD_TARGET V
+SIMD_FUNC(gradientColors)(V ifrac, const jint* colors, jint cycleMethod) {
+    V idx = V_SRLI32(SIMD_FUNC(pad)(ifrac, cycleMethod), 16 - LG_GRADIENT_MAP_SIZE);
+    return V_GATHER32(colors, idx);
+}
+
+// The linear gradient from lfrac, the fraction in 16.16 fixed point,
+// stepping by lstep
+static SIMD_TARGET jint
+SIMD_FUNC(linearGradientSpan)(jint* paint, jint n, jlong lfrac, jlong lstep,
+                              const jint* colors, jint cycleMethod)
+{
+    jint ints[V_PIXELS], fracs[V_PIXELS];
+    jlong lgroup = lstep * V_PIXELS;
+    V istep = V_SET1_32((jint)(lgroup >> 16));
+    V fstep = V_SET1_32((jint)(lgroup & 0xffff));
+    V mask = V_SET1_32(0xffff);
+    V ifrac, ffrac;
+    jint i;
+
+    // The integer and fractional parts of the fraction of each pixel
+    for (i = 0; i < V_PIXELS; i++, lfrac += lstep) {
+        ints[i] = (jint)(lfrac >> 16);
+        fracs[i] = (jint)(lfrac & 0xffff);
+    }
+    ifrac = V_LOAD(ints);
+    ffrac = V_LOAD(fracs);
+
+    for (i = 0; i + V_PIXELS <= n; i += V_PIXELS) {
+        V_STORE(paint + i, SIMD_FUNC(gradientColors)(ifrac, colors, cycleMethod));
+        ffrac = V_ADD32(ffrac, fstep);
+        ifrac = V_ADD32(V_ADD32(ifrac, istep), V_SRLI32(ffrac, 16));
+        ffrac = V_AND(ffrac, mask);
+    }
+    return i;
+}
+
+// The radial gradient from the terms of (jint)(u + PISCESsqrt(v)), which
+// are computed in double precision like the scalar loop does
+static SIMD_TARGET jint
+SIMD_FUNC(radialGradientSpan)(jint* paint, const jfloat* u, const jfloat* v,
+                              jint n, const jint* colors, jint cycleMethod)
+{
+    jint i;
+
+    for (i = 0; i + V_PIXELS <= n; i += V_PIXELS) {
+        VF uf = VF_LOAD(u + i);
+        VF vf = VF_LOAD(v + i);
+        VD lo = VD_ADD(VD_CVTLO(uf), VD_SQRT(VD_CVTLO(vf)));
+        VD hi = VD_ADD(VD_CVTHI(uf), VD_SQRT(VD_CVTHI(vf)));
+        V ifrac = V_CVTTPD(lo, hi);
+
+        V_STORE(paint + i, SIMD_FUNC(gradientColors)(ifrac, colors, cycleMethod));
+    }
+    return i;
+}
+
+// interp() of the components, for 16 bit fractions: x0 plus the rounded
+// product of the difference with f, f >= 0x8000 being negative in the
+// signed multiplications
+static INLINE SIMD_TARGET V
+SIMD_FUNC(interp)(V x0, V x1, V f) {
+    V d = V_SUB16(x1, x0);
+    V r = V_ADD16(V_MULHI16(d, f), V_SRLI16(V_MULLO16(d, f), 15));
+    return V_ADD16(V_ADD16(x0, r), V_AND(d, V_CMPGT16(V_ZERO, f)));
+}
+
+// interpolate4points() of the pixels, with the horizontal fractions in the
+// 4 lanes of each pixel
+static INLINE SIMD_TARGET V
+SIMD_FUNC(bilinear)(V p00, V p01, V p10, V p11, V hlo, V hhi, V vfrac) {
+    V zero = V_ZERO;
+    V lo = SIMD_FUNC(interp)(
+        SIMD_FUNC(interp)(V_UNPACKLO8(p00, zero), V_UNPACKLO8(p01, zero), hlo),
+        SIMD_FUNC(interp)(V_UNPACKLO8(p10, zero), V_UNPACKLO8(p11, zero), hlo),
+        vfrac);
+    V hi = SIMD_FUNC(interp)(
+        SIMD_FUNC(interp)(V_UNPACKHI8(p00, zero), V_UNPACKHI8(p01, zero), hhi),
+        SIMD_FUNC(interp)(V_UNPACKHI8(p10, zero), V_UNPACKHI8(p11, zero), hhi),
+        vfrac);
+    return V_PACKUS16(lo, hi);
+}
+
+// Pixels interpolated between the texels from row0 and row1, and the ones
+// to their right, at the same fractions
+static SIMD_TARGET jint
+SIMD_FUNC(textureRowSpan)(jint* paint, const jint* row0, const jint* row1,
+                          jint n, jint hfrac, jint vfrac, jboolean opaque)
+{
+    V h = V_SET1_16(hfrac);
+    V v = V_SET1_16(vfrac);
+    V alpha = V_SET1_32(opaque ? 0xff000000 : 0);
+    jint i;
+
+    for (i = 0; i + V_PIXELS <= n; i += V_PIXELS) {
+        V p = SIMD_FUNC(bilinear)(V_LOAD(row0 + i), V_LOAD(row0 + i + 1),
+                                  V_LOAD(row1 + i), V_LOAD(row1 + i + 1),
+                                  h, h, v);
+        V_STORE(paint + i, V_OR(p, alpha));
+    }
+    return i;
+}
+
+// The same for the texels at ltx, in 16.16 fixed point, stepping by dx.
+// Expects ltx to stay in [0, 0x7fffffff] over the n pixels.
+static SIMD_TARGET jint
+SIMD_FUNC(scaledTextureRowSpan)(jint* paint, const jint* row0, const jint* row1,
+                                jint n, jint ltx, jint dx, jint vfrac,
+                                jboolean noAlpha)
+{
+    jint lanes[V_PIXELS];
+    V v = V_SET1_16(vfrac);
+    V step = V_SET1_32((jint)((jlong)dx * V_PIXELS));
+    V alpha = V_SET1_32(0xff000000);
+    V mask = V_SET1_32(0xffff);
+    V x;
+    jint i;
+
+    for (i = 0; i < V_PIXELS; i++) {
+        lanes[i] = (jint)(ltx + (jlong)dx * i);
+    }
+    x = V_LOAD(lanes);
+
+    for (i = 0; i + V_PIXELS <= n; i += V_PIXELS, x = V_ADD32(x, step)) {
+        V tx = V_SRLI32(x, 16);
+        V hfrac = V_AND(x, mask);
+        V h = V_OR(hfrac, V_SLLI32(hfrac, 16));
+        V p = SIMD_FUNC(bilinear)(V_GATHER32(row0, tx), V_GATHER32(row0 + 1, tx),
+                                  V_GATHER32(row1, tx), V_GATHER32(row1 + 1, tx),
+                                  V_UNPACKLO32(h, h), V_UNPACKHI32(h, h), v);
+
+        // Texels that are copied keep their alpha
+        if (noAlpha) {
+            p = V_OR(p, vfrac ? alpha : V_ANDNOT(V_CMPEQ32(hfrac, V_ZERO), alpha));
+        }
+        V_STORE(paint + i, p);
+    }
+    return i;
+}
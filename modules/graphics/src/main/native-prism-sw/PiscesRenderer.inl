@@ -32,6 +32,7 @@
 #include <PiscesRenderer.h>
 
 #include <PiscesUtil.h>
+#include <PiscesBands.h>
 #include <PiscesBlit.h>
 #include <PiscesPaint.h>
 #include <PiscesTransform.h>
@@ -102,6 +103,18 @@ static INLINE void renderer_dispose(Renderer* rdr);
 static INLINE void renderer_setClip(Renderer* rdr, jint minX, jint minY,
                                     jint width, jint height);
 
+static INLINE void renderer_clearRect(Renderer* rdr, jint x, jint y,
+                                      jint w, jint h);
+static INLINE void renderer_fillRect(Renderer* rdr, jint x, jint y,
+                                     jint w, jint h,
+                                     jint lEdge, jint rEdge,
+                                     jint tEdge, jint bEdge);
+static INLINE void renderer_fillAlphaMask(Renderer* rdr, jint minX, jint minY,
+                                          jint maxX, jint maxY,
+                                          jint maskType, jbyte* mask,
+                                          jint x, jint y, jint maskWidth,
+                                          jint maskHeight, jint offset);
+
 static INLINE void renderer_setCompositeRule(Renderer *rdr, jint compositeRule);
 static INLINE void renderer_setColor(Renderer* rdr, jint red, jint green,
                                      jint blue, jint alpha);
@@ -113,6 +126,28 @@ static INLINE void renderer_setRadialGradient(Renderer* rdr, jint cx, jint cy,
         jint* colors,
         Transform6 *transform);
 
+// Rows of a rectangle, the rest is in the renderer.
+typedef struct _RectRows {
+    jint x_from;
+    jint y_from, y_to;
+    jint tfrac, bfrac;
+} RectRows;
+
+// Rows of an alpha mask, the rest is in the renderer.
+typedef struct _MaskRows {
+    jint minX, minY;
+    jint x;
+    jint maskWidth;
+    jint maskOffset;
+} MaskRows;
+
+typedef void RowsFunc(Renderer* rdr, const void* rows, jint minY, jint maxY);
+
+static void emitBands(Renderer* rdr, RowsFunc* func, const void* rows,
+                      jint minY, jint maxY);
+static void emitRectRows(Renderer* rdr, const void* rows, jint minY, jint maxY);
+static void emitMaskRows(Renderer* rdr, const void* rows, jint minY, jint maxY);
+
 static Renderer* createCommon(Surface* surface);
 static void setPaintMode(Renderer* rdr, jint newPaintMode);
 static void setAntialiasing(Renderer* rdr, jint subpixelLgPositionsX,
@@ -440,6 +475,304 @@ renderer_clearRect(Renderer* rdr, jint x, jint y, jint w, jint h) {
     }
 }
 
+/**
+ * Fills the rectangle (x, y, w, h), in S15.16 surface coordinates, with the
+ * current paint. The edges with a fractional coverage are kept, padded or
+ * trimmed as lEdge, rEdge, tEdge and bEdge say. The surface data must be
+ * acquired.
+ */
+static INLINE void
+renderer_fillRect(Renderer* rdr, jint x, jint y, jint w, jint h,
+                  jint lEdge, jint rEdge, jint tEdge, jint bEdge)
+{
+    RectRows rect;
+    jint x_from, x_to, y_from, y_to;
+    jint lfrac, rfrac, tfrac, bfrac;
+
+    lfrac = (0x10000 - (x & 0xFFFF)) & 0xFFFF;
+    rfrac = (x + w) & 0xFFFF;
+    tfrac = (0x10000 - (y & 0xFFFF)) & 0xFFFF;
+    bfrac = (y + h) & 0xFFFF;
+
+    x_from = x >> 16;
+    x_to = x + w;
+    x_to = (rfrac) ? x_to >> 16 : (x_to >> 16) - 1;
+    y_from = y >> 16;
+    y_to = y + h;
+    y_to = (bfrac) ? y_to >> 16 : (y_to >> 16) - 1;
+
+    rdr->_rectX = x_from;
+    rdr->_rectY = y_from;
+
+    switch (lEdge) {
+    case IMAGE_FRAC_EDGE_PAD:
+        lfrac = 0;
+        break;
+    case IMAGE_FRAC_EDGE_TRIM:
+        if (lfrac) { x_from++; }
+        lfrac = 0;
+        break;
+    }
+
+    switch (rEdge) {
+    case IMAGE_FRAC_EDGE_PAD:
+        rfrac = 0;
+        break;
+    case IMAGE_FRAC_EDGE_TRIM:
+        if (rfrac) { x_to--; }
+        rfrac = 0;
+        break;
+    }
+
+    switch (tEdge) {
+    case IMAGE_FRAC_EDGE_PAD:
+        tfrac = 0;
+        break;
+    case IMAGE_FRAC_EDGE_TRIM:
+        if (tfrac) { y_from++; }
+        tfrac = 0;
+        break;
+    }
+
+    switch (bEdge) {
+    case IMAGE_FRAC_EDGE_PAD:
+        bfrac = 0;
+        break;
+    case IMAGE_FRAC_EDGE_TRIM:
+        if (bfrac) { y_to--; }
+        bfrac = 0;
+        break;
+    }
+
+    // apply clip
+    if (x_from < rdr->_clip_bbMinX) {
+        x_from = rdr->_clip_bbMinX;
+        lfrac = 0;
+    }
+    if (y_from < rdr->_clip_bbMinY) {
+        y_from = rdr->_clip_bbMinY;
+        tfrac = 0;
+    }
+    if (x_to > rdr->_clip_bbMaxX) {
+        x_to = rdr->_clip_bbMaxX;
+        rfrac = 0;
+    }
+    if (y_to > rdr->_clip_bbMaxY) {
+        y_to = rdr->_clip_bbMaxY;
+        bfrac = 0;
+    }
+
+    if ((x_from <= x_to) && (y_from <= y_to)) {
+        INVALIDATE_RENDERER_SURFACE(rdr);
+        VALIDATE_BLITTING(rdr);
+
+        rdr->_minTouched = x_from;
+        rdr->_maxTouched = x_to;
+
+        rdr->_alphaWidth = x_to - x_from + 1;
+
+        rdr->_imageScanlineStride = rdr->_surface->width;
+        rdr->_imagePixelStride = 1;
+
+        if (y_from == y_to && (tfrac | bfrac)) {
+            // rendering single horizontal fractional line bfrac > (y & 0xFFFF)
+            tfrac = (bfrac - 0x10000 + tfrac) & 0xFFFF;
+            bfrac = 0;
+        }
+        if (x_from == x_to && (lfrac | rfrac)) {
+            // rendering single vertival fractional line rfrac > (x & 0xFFFF)
+            lfrac = (rfrac - 0x10000 + lfrac) & 0xFFFF;
+            rfrac = 0;
+        }
+
+        rdr->_el_lfrac = lfrac;
+        rdr->_el_rfrac = rfrac;
+
+        rect.x_from = x_from;
+        rect.y_from = y_from;
+        rect.y_to = y_to;
+        rect.tfrac = tfrac;
+        rect.bfrac = bfrac;
+        emitBands(rdr, emitRectRows, &rect, y_from, y_to);
+    }
+}
+
+/**
+ * Fills the pixels (minX, minY) - (maxX, maxY) with the current paint,
+ * through the alpha or LCD mask of maskWidth x maskHeight pixels placed at
+ * (x, y). offset is the index of the mask value of (minX, minY). The
+ * surface data must be acquired.
+ */
+static INLINE void
+renderer_fillAlphaMask(Renderer* rdr, jint minX, jint minY, jint maxX, jint maxY,
+                       jint maskType, jbyte* mask, jint x, jint y,
+                       jint maskWidth, jint maskHeight, jint offset)
+{
+    MaskRows rows;
+
+    if (maxX >= minX && maxY >= minY) {
+        renderer_setMask(rdr, maskType, mask, maskWidth, maskHeight, JNI_FALSE);
+
+        INVALIDATE_RENDERER_SURFACE(rdr);
+        VALIDATE_BLITTING(rdr);
+
+        rdr->_minTouched = minX;
+        rdr->_maxTouched = maxX;
+
+        rdr->_alphaWidth = maxX - minX + 1;
+
+        rdr->_imageScanlineStride = rdr->_surface->width;
+        rdr->_imagePixelStride = 1;
+
+        rows.minX = minX;
+        rows.minY = minY;
+        rows.x = x;
+        rows.maskWidth = maskWidth;
+        rows.maskOffset = offset;
+        emitBands(rdr, emitMaskRows, &rows, minY, maxY);
+
+        renderer_removeMask(rdr);
+    }
+}
+
+typedef struct _BandsJob {
+    Renderer* rdr;
+    const Renderer* state;
+    RowsFunc* func;
+    const void* rows;
+} BandsJob;
+
+static void
+emitBand(void* data, jint band, jint minY, jint maxY) {
+    BandsJob* job = (BandsJob*)data;
+
+    if (band == 0) {
+        job->func(job->rdr, job->rows, minY, maxY);
+    } else {
+        // The other bands are rendered with a copy of the renderer, which
+        // has a paint buffer of its own. It is copied from the state saved
+        // before the bands started, as band 0 changes the row fields.
+        Renderer rdr = *job->state;
+
+        rdr._paint = NULL;
+        rdr._paint_length = 0;
+        job->func(&rdr, job->rows, minY, maxY);
+        my_free(rdr._paint);
+    }
+}
+
+/*
+ * Renders the rows minY..maxY of a primitive with func, in bands when the
+ * renderer has several threads. The blitting routines must be validated.
+ */
+static void
+emitBands(Renderer* rdr, RowsFunc* func, const void* rows, jint minY, jint maxY) {
+    BandsJob job;
+    Renderer state;
+
+    job.rdr = rdr;
+    job.state = rdr;
+    job.func = func;
+    job.rows = rows;
+    if (maxY - minY + 1 >= 2 * MIN_BAND_ROWS &&
+        (jlong)(maxY - minY + 1) * rdr->_alphaWidth >= 2 * MIN_BAND_PIXELS)
+    {
+        // Large enough to be split
+        state = *rdr;
+        job.state = &state;
+    }
+    pisces_bands_run(emitBand, &job, minY, maxY, rdr->_alphaWidth);
+}
+
+static void
+emitRectRows(Renderer* rdr, const void* rows, jint minY, jint maxY) {
+    const RectRows* rect = (const RectRows*)rows;
+    jint rows_to_render_by_loop, rows_being_rendered;
+    jboolean bottom = (maxY == rect->y_to) && rect->bfrac;
+    jint x_from = rdr->_minTouched;
+
+    rdr->_currX = x_from;
+    rdr->_currY = minY;
+    rdr->_currImageOffset = minY * rdr->_imageScanlineStride;
+    rdr->_rowNum = minY - rect->y_from;
+
+    // emit fractional top line
+    if (minY == rect->y_from && rect->tfrac) {
+        if (rdr->_genPaint) {
+            size_t l = rdr->_alphaWidth;
+            ALLOC3(rdr->_paint, jint, l);
+            rdr->_genPaint(rdr, 1);
+        }
+        rdr->_emitLine(rdr, 1, rect->tfrac);
+        minY++;
+        rdr->_currX = x_from;
+        rdr->_currY++;
+        rdr->_currImageOffset = rdr->_currY * rdr->_imageScanlineStride;
+        rdr->_rowNum++;
+    }
+
+    rows_to_render_by_loop = maxY - minY + 1;
+    if (bottom) {
+        // one "full" line less -> will be rendered at the end
+        rows_to_render_by_loop--;
+    }
+
+    // emit "full" lines that are in the middle
+    while (rows_to_render_by_loop > 0) {
+        rows_being_rendered = MIN(rows_to_render_by_loop, NUM_ALPHA_ROWS);
+
+        if (rdr->_genPaint) {
+            size_t l = rdr->_alphaWidth * rows_being_rendered;
+            ALLOC3(rdr->_paint, jint, l);
+            rdr->_genPaint(rdr, rows_being_rendered);
+        }
+        rdr->_emitLine(rdr, rows_being_rendered, 0x10000);
+
+        rows_to_render_by_loop -= rows_being_rendered;
+        rdr->_currX = x_from;
+        rdr->_currY += rows_being_rendered;
+        rdr->_currImageOffset = rdr->_currY * rdr->_imageScanlineStride;
+        rdr->_rowNum += rows_being_rendered;
+    }
+
+    // emit fractional bottom line
+    if (bottom) {
+        if (rdr->_genPaint) {
+            size_t l = rdr->_alphaWidth;
+            ALLOC3(rdr->_paint, jint, l);
+            rdr->_genPaint(rdr, 1);
+        }
+        rdr->_emitLine(rdr, 1, rect->bfrac);
+    }
+}
+
+static void
+emitMaskRows(Renderer* rdr, const void* rows, jint minY, jint maxY) {
+    const MaskRows* mask = (const MaskRows*)rows;
+    jint y;
+
+    // The first row of the mask starts at minX, the following ones at the
+    // x of the mask.
+    rdr->_currX = (minY == mask->minY) ? mask->minX : mask->x;
+    rdr->_rowNum = minY - mask->minY;
+    rdr->_maskOffset = mask->maskOffset + (minY - mask->minY) * mask->maskWidth;
+
+    for (y = minY; y <= maxY; y++) {
+        rdr->_currY = y;
+        rdr->_currImageOffset = y * rdr->_imageScanlineStride;
+        if (rdr->_genPaint) {
+            size_t l = rdr->_alphaWidth;
+            ALLOC3(rdr->_paint, jint, l);
+            rdr->_genPaint(rdr, 1);
+        }
+        rdr->_emitRows(rdr, 1);
+
+        rdr->_maskOffset += mask->maskWidth;
+        rdr->_rowNum++;
+        rdr->_currX = mask->x;
+    }
+}
+
 static Renderer*
 createCommon(Surface* surface) {
     Renderer* rdr = (Renderer*)my_malloc(Renderer, 1);
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include <PiscesSimd.h>
+
+#if ENABLE_SIMD_AVX2 && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#elif ENABLE_SIMD_AVX2
+#include <cpuid.h>
+#endif
+
+// Picked by the first blit, then only read, except by pisces_simd_set().
+static jint simdLevel = -1;
+
+#if ENABLE_SIMD_AVX2
+static jboolean
+cpuHasAVX2() {
+#if defined(_MSC_VER)
+    int regs[4];
+
+    __cpuid(regs, 0);
+    if (regs[0] < 7) {
+        return XNI_FALSE;
+    }
+    // The YMM registers need AVX and OSXSAVE, and XCR0 bits 1 and 2 set by
+    // an OS that saves them on context switches.
+    __cpuid(regs, 1);
+    if ((regs[2] & 0x18000000) != 0x18000000 || (_xgetbv(0) & 6) != 6) {
+        return XNI_FALSE;
+    }
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & 0x20) ? XNI_TRUE : XNI_FALSE;
+#else
+    unsigned int eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx) || eax < 7) {
+        return XNI_FALSE;
+    }
+    // The YMM registers need AVX and OSXSAVE, and XCR0 bits 1 and 2 set by
+    // an OS that saves them on context switches.
+    __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+    if ((ecx & 0x18000000) != 0x18000000) {
+        return XNI_FALSE;
+    }
+    __asm__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+    if ((eax & 6) != 6) {
+        return XNI_FALSE;
+    }
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx & 0x20) ? XNI_TRUE : XNI_FALSE;
+#endif
+}
+#endif
+
+static jboolean
+simdSupported(jint simd) {
+    switch (simd) {
+    case SIMD_NONE:
+        return XNI_TRUE;
+    case SIMD_SSE2:
+        return ENABLE_SIMD_SSE2 ? XNI_TRUE : XNI_FALSE;
+#if ENABLE_SIMD_AVX2
+    case SIMD_AVX2:
+        return cpuHasAVX2();
+#endif
+    case SIMD_NEON:
+        return ENABLE_SIMD_NEON ? XNI_TRUE : XNI_FALSE;
+    default:
+        return XNI_FALSE;
+    }
+}
+
+jint
+pisces_simd_get() {
+    // No lock: the band threads of a large fill may get here together
+    // before the level is known. Each of them then probes the same CPU and
+    // writes the same level to the aligned jint, so whichever write lands
+    // last, every blit sees -1 or that level.
+    if (simdLevel < 0) {
+        if (simdSupported(SIMD_AVX2)) {
+            simdLevel = SIMD_AVX2;
+        } else if (simdSupported(SIMD_SSE2)) {
+            simdLevel = SIMD_SSE2;
+        } else if (simdSupported(SIMD_NEON)) {
+            simdLevel = SIMD_NEON;
+        } else {
+            simdLevel = SIMD_NONE;
+        }
+    }
+    return simdLevel;
+}
+
+jboolean
+pisces_simd_set(jint simd) {
+    if (!simdSupported(simd)) {
+        return XNI_FALSE;
+    }
+    simdLevel = simd;
+    return XNI_TRUE;
+}
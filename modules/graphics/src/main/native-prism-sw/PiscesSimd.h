@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/**
+ * @file PiscesSimd.h
+ * Instruction set extensions the blitting loops can use.
+ */
+
+#ifndef PISCES_SIMD_H
+#define PISCES_SIMD_H
+
+#include <PiscesDefs.h>
+
+#include "com_sun_pisces_RendererBase.h"
+
+#define SIMD_NONE com_sun_pisces_RendererBase_SIMD_NONE
+#define SIMD_SSE2 com_sun_pisces_RendererBase_SIMD_SSE2
+#define SIMD_AVX2 com_sun_pisces_RendererBase_SIMD_AVX2
+#define SIMD_NEON com_sun_pisces_RendererBase_SIMD_NEON
+
+// SSE2 is part of x64, 32 bit x86 builds need to target it.
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ENABLE_SIMD_SSE2 1
+#else
+#define ENABLE_SIMD_SSE2 0
+#endif
+
+// AVX2 code is compiled for functions, and only used when the CPU has it.
+#if ENABLE_SIMD_SSE2 && (defined(_MSC_VER) || defined(__clang__) || \
+    (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define ENABLE_SIMD_AVX2 1
+#else
+#define ENABLE_SIMD_AVX2 0
+#endif
+
+#if ENABLE_SIMD_AVX2 && defined(__GNUC__)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+// Part of ARMv8, 32 bit ARM builds need to target it.
+#if !ENABLE_SIMD_SSE2 && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define ENABLE_SIMD_NEON 1
+#else
+#define ENABLE_SIMD_NEON 0
+#endif
+
+/**
+ * Returns the extensions in use, one of SIMD_*: the best ones the CPU has,
+ * unless set with pisces_simd_set(). The results are the same with all of
+ * them.
+ */
+jint pisces_simd_get();
+
+/**
+ * Restricts the blitting loops to the given extensions, for tests and
+ * benchmarks. Returns XNI_FALSE, and changes nothing, when the CPU or the
+ * build doesn't support them.
+ */
+jboolean pisces_simd_set(jint simd);
+
+#endif
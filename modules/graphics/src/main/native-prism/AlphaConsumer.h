@@ -36,6 +36,8 @@ typedef struct {
     jint width;
     jint height;
     jbyte *alphas;
+    // distance between the rows of alphas, at least width
+    jint stride;
 //    public void setMaxAlpha(jint maxalpha);
 //    public void setAndClearRelativeAlphas(jint alphaDeltas[], jint pix_y,
 //                                          jint firstdelta, jint lastdelta);
@@ -34,6 +34,7 @@
 #include "Dasher.h"
 #include "Transformer.h"
 #include "AlphaConsumer.h"
+#include "Helpers.h"
 
 #define SEG(T) com_sun_prism_impl_shape_NativePiscesRasterizer_SEG_ ## T
 
@@ -43,6 +44,33 @@
 #define SEG_CUBICTO  SEG(CUBICTO)
 #define SEG_CLOSE    SEG(CLOSE)
 
+#define BATCH(T) com_sun_prism_impl_shape_NativePiscesRasterizer_BATCH_ ## T
+
+#define BATCH_FILL_EVEN_ODD  BATCH(FILL_EVEN_ODD)
+#define BATCH_FILL_NON_ZERO  BATCH(FILL_NON_ZERO)
+#define BATCH_STROKE         BATCH(STROKE)
+#define BATCH_RESULT_SIZE    BATCH(RESULT_SIZE)
+
+/*
+ * A path of produceAlphasBatch, in the native byte order. It is followed by
+ * its numCoords coordinates, numDashes dashes and numCommands commands, and
+ * the next path starts at the following multiple of 8 bytes.
+ */
+typedef struct {
+    jint kind;          // BATCH_FILL_EVEN_ODD, BATCH_FILL_NON_ZERO or BATCH_STROKE
+    jint numCommands;
+    jint numCoords;
+    jint numDashes;     // -1 when the stroke is not dashed
+    jint bounds[4];     // x0, y0, x1, y1 of the transformed shape
+    jint cap;
+    jint join;
+    jfloat lineWidth;
+    jfloat miterLimit;
+    jfloat dashPhase;
+    jint pad;
+    jdouble mxx, mxy, mxt, myx, myy, myt;
+} BatchPath;
+
 #define NPException    "java/lang/NullPointerException"
 #define AIOOBException "java/lang/ArrayIndexOutOfBoundsException"
 #define OOMError       "java/lang/OutOfMemoryError"
@@ -85,6 +113,82 @@ static char * errorToString(jint errorCode) {
     }
 }
 
+static char * feedPath
+    (PathConsumer *consumer,
+     jfloat *coords, jint coordSize,
+     jbyte *commands, jint numCommands)
+{
+    jint status = ERROR_NONE;
+    char *failure = NULL;
+    jint cmdoff, coordoff = 0;
+
+    for (cmdoff = 0; cmdoff < numCommands && failure == NULL; cmdoff++) {
+        switch (commands[cmdoff]) {
+            case SEG_MOVETO:
+                if (coordoff + 2 > coordSize) {
+                    failure = "[not enough coordinates for moveTo";
+                } else {
+                    status = consumer->moveTo(consumer,
+                                     coords[coordoff+0], coords[coordoff+1]);
+                    if (status != ERROR_NONE) {
+                        failure = errorToString(status);
+                    }
+                    coordoff += 2;
+                }
+                break;
+            case SEG_LINETO:
+                if (coordoff + 2 > coordSize) {
+                    failure = "[not enough coordinates for lineTo";
+                } else {
+                    status = consumer->lineTo(consumer,
+                                     coords[coordoff+0], coords[coordoff+1]);
+                    if (status != ERROR_NONE) {
+                        failure = errorToString(status);
+                    }
+                    coordoff += 2;
+                }
+                break;
+            case SEG_QUADTO:
+                if (coordoff + 4 > coordSize) {
+                    failure = "[not enough coordinates for quadTo";
+                } else {
+                    status = consumer->quadTo(consumer,
+                                     coords[coordoff+0], coords[coordoff+1],
+                                     coords[coordoff+2], coords[coordoff+3]);
+                    if (status != ERROR_NONE) {
+                        failure = errorToString(status);
+                    }
+                    coordoff += 4;
+                }
+                break;
+            case SEG_CUBICTO:
+                if (coordoff + 6 > coordSize) {
+                    failure = "[not enough coordinates for curveTo";
+                } else {
+                    status = consumer->curveTo(consumer,
+                                      coords[coordoff+0], coords[coordoff+1],
+                                      coords[coordoff+2], coords[coordoff+3],
+                                      coords[coordoff+4], coords[coordoff+5]);
+                    if (status != ERROR_NONE) {
+                        failure = errorToString(status);
+                    }
+                    coordoff += 6;
+                }
+                break;
+            case SEG_CLOSE:
+                status = consumer->closePath(consumer);
+                if (status != ERROR_NONE) {
+                    failure = errorToString(status);
+                }
+                break;
+            default:
+                failure = "unrecognized Path segment";
+                break;
+        }
+    }
+    return failure;
+}
+
 static char * feedConsumer
     (JNIEnv *env, PathConsumer *consumer,
      jfloatArray coordsArray, jint coordSize,
@@ -102,71 +206,7 @@ static char * feedConsumer
         if (commands == NULL) {
             failure = "";
         } else {
-            jint cmdoff, coordoff = 0;
-            for (cmdoff = 0; cmdoff < numCommands && failure == NULL; cmdoff++) {
-                switch (commands[cmdoff]) {
-                    case SEG_MOVETO:
-                        if (coordoff + 2 > coordSize) {
-                            failure = "[not enough coordinates for moveTo";
-                        } else {
-                            status = consumer->moveTo(consumer,
-                                             coords[coordoff+0], coords[coordoff+1]);
-                            if (status != ERROR_NONE) {
-                                failure = errorToString(status);
-                            }
-                            coordoff += 2;
-                        }
-                        break;
-                    case SEG_LINETO:
-                        if (coordoff + 2 > coordSize) {
-                            failure = "[not enough coordinates for lineTo";
-                        } else {
-                            status = consumer->lineTo(consumer,
-                                             coords[coordoff+0], coords[coordoff+1]);
-                            if (status != ERROR_NONE) {
-                                failure = errorToString(status);
-                            }
-                            coordoff += 2;
-                        }
-                        break;
-                    case SEG_QUADTO:
-                        if (coordoff + 4 > coordSize) {
-                            failure = "[not enough coordinates for quadTo";
-                        } else {
-                            status = consumer->quadTo(consumer,
-                                             coords[coordoff+0], coords[coordoff+1],
-                                             coords[coordoff+2], coords[coordoff+3]);
-                            if (status != ERROR_NONE) {
-                                failure = errorToString(status);
-                            }
-                            coordoff += 4;
-                        }
-                        break;
-                    case SEG_CUBICTO:
-                        if (coordoff + 6 > coordSize) {
-                            failure = "[not enough coordinates for curveTo";
-                        } else {
-                            status = consumer->curveTo(consumer,
-                                              coords[coordoff+0], coords[coordoff+1],
-                                              coords[coordoff+2], coords[coordoff+3],
-                                              coords[coordoff+4], coords[coordoff+5]);
-                            if (status != ERROR_NONE) {
-                                failure = errorToString(status);
-                            }
-                            coordoff += 6;
-                        }
-                        break;
-                    case SEG_CLOSE:
-                        status = consumer->closePath(consumer);
-                        if (status != ERROR_NONE) {
-                            failure = errorToString(status);
-                        }
-                        break;
-                    default:
-                        failure = "unrecognized Path segment";
-                        break;
-                }
-            }
+            failure = feedPath(consumer, coords, coordSize, commands, numCommands);
             (*env)->ReleasePrimitiveArrayCritical(env, commandsArray, commands, JNI_ABORT);
         }
         (*env)->ReleasePrimitiveArrayCritical(env, coordsArray, coords, JNI_ABORT);
@@ -238,6 +278,8 @@ Java_com_sun_prism_impl_shape_NativePiscesRasterizer_produceFillAlphas
                 bounds[1],
                 bounds[2] - bounds[0],
                 bounds[3] - bounds[1],
+                NULL,
+                bounds[2] - bounds[0],
             };
             if ((*env)->GetArrayLength(env, maskArray) / ac.width < ac.height) {
                 Throw(env, AIOOBException, "maskArray");
@@ -334,6 +376,8 @@ Java_com_sun_prism_impl_shape_NativePiscesRasterizer_produceStrokeAlphas
                 bounds[1],
                 bounds[2] - bounds[0],
                 bounds[3] - bounds[1],
+                NULL,
+                bounds[2] - bounds[0],
             };
             if ((*env)->GetArrayLength(env, maskArray) / ac.width < ac.height) {
                 Throw(env, AIOOBException, "Mask");
@@ -361,3 +405,197 @@ Java_com_sun_prism_impl_shape_NativePiscesRasterizer_produceStrokeAlphas
     }
     Renderer_destroy(&renderer);
 }
+
+/*
+ * Class:     com_sun_prism_impl_shape_NativePiscesRasterizer
+ * Method:    produceAlphasBatch
+ * Signature: (Ljava/nio/ByteBuffer;IILjava/nio/ByteBuffer;II[I)I
+ */
+JNIEXPORT jint JNICALL
+Java_com_sun_prism_impl_shape_NativePiscesRasterizer_produceAlphasBatch
+    (JNIEnv *env, jclass klass,
+     jobject pathsBuffer, jint offset, jint numPaths,
+     jobject atlasBuffer, jint atlasWidth, jint atlasHeight,
+     jintArray resultsArray)
+{
+    jbyte *paths, *atlas;
+    jlong pathsSize;
+    jint *results;
+    Renderer renderer;
+    Transformer transformer;
+    Stroker stroker;
+    Dasher dasher;
+    jboolean haveStroker = JNI_FALSE;
+    jboolean haveDasher = JNI_FALSE;
+    jint shelfX = 0, shelfY = 0, shelfHeight = 0;
+    jint status = ERROR_NONE;
+    char *failure = NULL;
+    jint i;
+
+    if (pathsBuffer == NULL || atlasBuffer == NULL || resultsArray == NULL) {
+        Throw(env, NPException, pathsBuffer == NULL ? "paths" :
+                                atlasBuffer == NULL ? "atlas" : "results");
+        return 0;
+    }
+    paths = (*env)->GetDirectBufferAddress(env, pathsBuffer);
+    atlas = (*env)->GetDirectBufferAddress(env, atlasBuffer);
+    if (paths == NULL || atlas == NULL) {
+        Throw(env, IError, "paths and atlas must be direct buffers");
+        return 0;
+    }
+    pathsSize = (*env)->GetDirectBufferCapacity(env, pathsBuffer);
+    if (numPaths < 0 || atlasWidth < 0 || atlasHeight < 0 ||
+        (*env)->GetDirectBufferCapacity(env, atlasBuffer) < (jlong) atlasWidth * atlasHeight ||
+        (*env)->GetArrayLength(env, resultsArray) / BATCH_RESULT_SIZE < numPaths)
+    {
+        Throw(env, AIOOBException, "produceAlphasBatch");
+        return 0;
+    }
+    results = (*env)->GetPrimitiveArrayCritical(env, resultsArray, 0);
+    if (results == NULL) {
+        return 0;
+    }
+
+    // The Renderer, Stroker and Dasher keep their memory from one path to
+    // the next, and the masks are packed in shelves of the atlas.
+    Renderer_init(&renderer);
+    for (i = 0; i < numPaths; i++) {
+        BatchPath *path;
+        jfloat *coords, *dashes;
+        jbyte *commands;
+        jint *result = results + i * BATCH_RESULT_SIZE;
+        jint bounds[4];
+        jint numDashes;
+        jlong size;
+        PathConsumer *consumer;
+
+        if (offset < 0 || pathsSize - offset < (jlong) sizeof(BatchPath)) {
+            failure = "[paths";
+            break;
+        }
+        path = (BatchPath *) (paths + offset);
+        numDashes = Math_max(path->numDashes, 0);
+        size = (jlong) sizeof(BatchPath) +
+               ((jlong) path->numCoords + numDashes) * sizeof(jfloat) + path->numCommands;
+        if (path->numCommands < 0 || path->numCoords < 0 || path->numDashes < -1 ||
+            pathsSize - offset < size)
+        {
+            failure = "[paths";
+            break;
+        }
+        coords = (jfloat *) (path + 1);
+        dashes = coords + path->numCoords;
+        commands = (jbyte *) (dashes + numDashes);
+
+        bounds[0] = path->bounds[0];
+        bounds[1] = path->bounds[1];
+        bounds[2] = path->bounds[2];
+        bounds[3] = path->bounds[3];
+        if (bounds[0] < bounds[2] && bounds[1] < bounds[3]) {
+            Renderer_reset(&renderer,
+                           bounds[0], bounds[1], bounds[2] - bounds[0], bounds[3] - bounds[1],
+                           path->kind == BATCH_FILL_EVEN_ODD ? WIND_EVEN_ODD : WIND_NON_ZERO);
+            consumer = Transformer_init(&transformer, &renderer.consumer,
+                                        path->mxx, path->mxy, path->mxt,
+                                        path->myx, path->myy, path->myt);
+            if (path->kind == BATCH_STROKE) {
+                if (haveStroker) {
+                    Stroker_reset(&stroker, path->lineWidth, path->cap, path->join,
+                                  path->miterLimit);
+                    stroker.out = consumer;
+                } else {
+                    Stroker_init(&stroker, consumer, path->lineWidth, path->cap, path->join,
+                                 path->miterLimit);
+                    haveStroker = JNI_TRUE;
+                }
+                consumer = &stroker.consumer;
+                if (path->numDashes >= 0) {
+                    if (haveDasher) {
+                        Dasher_reset(&dasher, dashes, path->numDashes, path->dashPhase);
+                    } else {
+                        Dasher_init(&dasher, consumer, dashes, path->numDashes, path->dashPhase);
+                        haveDasher = JNI_TRUE;
+                    }
+                    consumer = &dasher.consumer;
+                }
+            } else if (path->kind != BATCH_FILL_EVEN_ODD && path->kind != BATCH_FILL_NON_ZERO) {
+                failure = "unrecognized path kind";
+                break;
+            }
+            failure = feedPath(consumer, coords, path->numCoords, commands, path->numCommands);
+            if (failure == NULL) {
+                status = consumer->pathDone(consumer);
+                if (status != ERROR_NONE) {
+                    failure = errorToString(status);
+                }
+            }
+            if (failure != NULL) {
+                break;
+            }
+            Renderer_getOutputBounds(&renderer, bounds);
+        }
+
+        result[2] = bounds[0];
+        result[3] = bounds[1];
+        result[4] = Math_max(bounds[2] - bounds[0], 0);
+        result[5] = Math_max(bounds[3] - bounds[1], 0);
+        if (result[4] == 0 || result[5] == 0) {
+            result[0] = result[1] = 0;
+            result[4] = result[5] = 0;
+        } else if (result[4] > atlasWidth || result[5] > atlasHeight) {
+            // Left for the caller to rasterize on its own
+            result[0] = result[1] = -1;
+        } else {
+            if (shelfX + result[4] > atlasWidth) {
+                shelfX = 0;
+                shelfY += shelfHeight;
+                shelfHeight = 0;
+            }
+            if (shelfY + result[5] > atlasHeight) {
+                // The atlas is full, the path is the first of the next call
+                break;
+            }
+            {
+                AlphaConsumer ac = {
+                    result[2],
+                    result[3],
+                    result[4],
+                    result[5],
+                    atlas + (jlong) shelfY * atlasWidth + shelfX,
+                    atlasWidth,
+                };
+                if ((status = Renderer_produceAlphas(&renderer, &ac)) != ERROR_NONE) {
+                    break;
+                }
+            }
+            result[0] = shelfX;
+            result[1] = shelfY;
+            shelfX += result[4];
+            shelfHeight = Math_max(shelfHeight, result[5]);
+        }
+        offset += (jint) ((size + 7) & ~7);
+    }
+    (*env)->ReleasePrimitiveArrayCritical(env, resultsArray, results, 0);
+
+    if (status != ERROR_NONE && failure == NULL) {
+        if (status == ERROR_OOM) {
+            Throw(env, OOMError, "produceAlphas");
+        } else {
+            Throw(env, AIOOBException, "produceAlphas");
+        }
+    } else if (failure != NULL && *failure != 0) {
+        if (*failure == '[') {
+            Throw(env, AIOOBException, failure + 1);
+        } else {
+            Throw(env, IError, failure);
+        }
+    }
+    if (haveDasher) {
+        Dasher_destroy(&dasher);
+    }
+    if (haveStroker) {
+        Stroker_destroy(&stroker);
+    }
+    Renderer_destroy(&renderer);
+    return i;
+}
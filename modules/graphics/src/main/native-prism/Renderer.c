@@ -441,6 +441,7 @@ void Renderer_reset(Renderer *pRenderer,
         // The last 2 entries are ignored and only used to store unused
         // values for segments ending on the last line of the bounds
         // so we can avoid having to check the bounds on this array.
+        free(this.edgeBuckets);
         this.edgeBuckets = new_int(numBuckets*2 + 2);
         this.edgeBucketsSIZE = numBuckets*2 + 2;
     } else {
@@ -457,6 +458,7 @@ void Renderer_reset(Renderer *pRenderer,
 }
 
 void Renderer_destroy(Renderer *pRenderer) {
+    ScanlineIterator_destroy(&pRenderer->iterator);
     free(pRenderer->edgeBuckets);
     pRenderer->edgeBuckets = NULL;
     pRenderer->edgeBucketsSIZE = 0;
@@ -564,7 +566,7 @@ jint Renderer_produceAlphas(Renderer *pRenderer, AlphaConsumer *pAC) {
     jint bboxx0, bboxx1;
     jint pix_minX, pix_maxX;
     jint y;
-    ScanlineIterator it;
+    ScanlineIterator *it = &this.iterator;
 
     // add 2 to better deal with the last pixel in a pixel row.
     jint width = pAC->width;
@@ -593,20 +595,32 @@ jint Renderer_produceAlphas(Renderer *pRenderer, AlphaConsumer *pAC) {
     pix_minX = bboxx0 >> SUBPIXEL_LG_POSITIONS_Y;
 
     y = this.boundsMinY; // needs to be declared here so we emit the last row properly.
-    ScanlineIterator_init(&it, pRenderer);
-    for ( ; ScanlineIterator_hasNext(&it, pRenderer); ) {
-        jint numCrossings = ScanlineIterator_next(&it, pRenderer);
-        jint *crossings = it.crossings;
+    // The iterator keeps its arrays from one shape to the next when the
+    // Renderer is reused, and frees them in Renderer_destroy.
+    if (it->crossings == NULL || it->edgePtrs == NULL) {
+        ScanlineIterator_destroy(it);
+        ScanlineIterator_init(it, pRenderer);
+        if (it->crossings == NULL || it->edgePtrs == NULL) {
+            if (alpha != savedAlpha) free (alpha);
+            return ERROR_OOM;
+        }
+    } else {
+        ScanlineIterator_reset(it, pRenderer);
+    }
+    for ( ; ScanlineIterator_hasNext(it, pRenderer); ) {
+        jint numCrossings = ScanlineIterator_next(it, pRenderer);
+        jint *crossings = it->crossings;
         jint sum, prev;
         jint i;
 
         if (numCrossings < 0) {
-            ScanlineIterator_destroy(&it);
+            // The arrays may be gone, they are allocated again next time
+            ScanlineIterator_destroy(it);
             if (alpha != savedAlpha) free (alpha);
             return ERROR_OOM;
         }
 
-        y = ScanlineIterator_curY(&it);
+        y = ScanlineIterator_curY(it);
 
         if (numCrossings > 0) {
             jint lowx = crossings[0] >> 1;
@@ -670,7 +684,6 @@ jint Renderer_produceAlphas(Renderer *pRenderer, AlphaConsumer *pAC) {
         setAndClearRelativeAlphas(pAC, alpha, y >> SUBPIXEL_LG_POSITIONS_Y,
                                   pix_minX, pix_maxX);
     }
-    ScanlineIterator_destroy(&it);
     if (alpha != savedAlpha) free (alpha);
 
     return ERROR_NONE;
@@ -723,7 +736,7 @@ static void setAndClearRelativeAlphas(AlphaConsumer *pAC,
 //    System.out.println("setting row "+(pix_y - y)+
 //                       " out of "+width+" x "+height);
     jint w = pAC->width;
-    jint off = (pix_y - pAC->originY) * w;
+    jint off = (pix_y - pAC->originY) * pAC->stride;
     jbyte *out = pAC->alphas;
     jint a = 0;
     jint i;
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package com.sun.pisces;
+
+import com.sun.glass.utils.NativeLibLoader;
+import java.util.Random;
+import org.junit.After;
+import org.junit.BeforeClass;
+import org.junit.Test;
+
+import static org.junit.Assert.assertArrayEquals;
+
+/**
+ * Checks that the SIMD blitting loops give the same pixels as the scalar
+ * ones, for every extension the processor has.
+ */
+public class PiscesBlitTest {
+    static final int WIDTH = 131;
+    static final int HEIGHT = 37;
+    static final int PAINTS = 6;
+
+    static final int[] COMPOSITES = {
+        RendererBase.COMPOSITE_SRC_OVER,
+        RendererBase.COMPOSITE_SRC,
+        RendererBase.COMPOSITE_CLEAR,
+    };
+
+    static int defaultSimd;
+
+    interface Scene {
+        void render(PiscesRenderer pr, Random random);
+    }
+
+    @BeforeClass
+    public static void loadLibrary() {
+        NativeLibLoader.loadLibrary("prism_sw");
+        defaultSimd = PiscesRenderer.getSimd();
+    }
+
+    @After
+    public void restoreSimd() {
+        PiscesRenderer.setSimd(defaultSimd);
+    }
+
+    static int[] background(long seed) {
+        Random random = new Random(seed);
+        int[] data = new int[WIDTH * HEIGHT];
+        for (int i = 0; i < data.length; i++) {
+            int a = (i % 7 == 0) ? 0 : (i % 5 == 0) ? 255 : random.nextInt(256);
+            int r = random.nextInt(a + 1);
+            int g = random.nextInt(a + 1);
+            int b = random.nextInt(a + 1);
+            data[i] = (a << 24) | (r << 16) | (g << 8) | b;
+        }
+        return data;
+    }
+
+    static byte[] mask(Random random, int size) {
+        byte[] mask = new byte[size];
+        for (int i = 0; i < size; i++) {
+            switch (random.nextInt(4)) {
+                case 0: mask[i] = 0; break;
+                case 1: mask[i] = (byte) 0xff; break;
+                default: mask[i] = (byte) random.nextInt(256);
+            }
+        }
+        return mask;
+    }
+
+    static void setPaint(PiscesRenderer pr, Random random, int paint) {
+        switch (paint) {
+            case 0:
+                pr.setColor(random.nextInt(256), random.nextInt(256), random.nextInt(256), 255);
+                break;
+            case 1:
+                pr.setColor(random.nextInt(256), random.nextInt(256), random.nextInt(256),
+                            random.nextInt(256));
+                break;
+            case 2:
+                pr.setLinearGradient(0, 0, 0x60000 + random.nextInt(0x200000), 0x30000,
+                                     new int[] { 0, 0x8000, 0x10000 },
+                                     new int[] { 0xff2040c0, 0x80c08020, 0x00000000 },
+                                     GradientColorMap.CYCLE_REFLECT, null);
+                break;
+            case 3:
+                pr.setRadialGradient(0x200000 + random.nextInt(0x600000), 0x100000,
+                                     0x180000, 0x100000 + random.nextInt(0x80000),
+                                     0x80000 + random.nextInt(0x400000),
+                                     new int[] { 0, 0x8000, 0x10000 },
+                                     new int[] { 0xff2040c0, 0x80c08020, 0x00000000 },
+                                     GradientColorMap.CYCLE_REPEAT, null);
+                break;
+            case 4:
+                // Translated by a fraction, with interpolated opaque texels
+                pr.setTexture(RendererBase.TYPE_INT_ARGB_PRE, texture(random, false), 16, 16, 16,
+                              new Transform6(0x10000, 0, 0, 0x10000,
+                                             random.nextInt(0x100000), random.nextInt(0x100000)),
+                              false, true, false);
+                break;
+            default:
+                pr.setTexture(RendererBase.TYPE_INT_ARGB_PRE, texture(random, true), 16, 16, 16,
+                              new Transform6(0x28000, 0, 0, 0x18000, 0x3000, 0x7000),
+                              true, true, true);
+                break;
+        }
+    }
+
+    static int[] texture(Random random, boolean hasAlpha) {
+        int[] texture = new int[16 * 16];
+        for (int i = 0; i < texture.length; i++) {
+            int a = hasAlpha ? random.nextInt(256) : 255;
+            texture[i] = (a << 24) | (random.nextInt(a + 1) << 16) |
+                         (random.nextInt(a + 1) << 8) | random.nextInt(a + 1);
+        }
+        return texture;
+    }
+
+    static final Scene RECTS = (pr, random) -> {
+        for (int i = 0; i < 12; i++) {
+            setPaint(pr, random, i % PAINTS);
+            pr.fillRect(random.nextInt(WIDTH << 16), random.nextInt(HEIGHT << 16),
+                        random.nextInt(WIDTH << 16), random.nextInt(HEIGHT << 16));
+        }
+    };
+
+    static final Scene MASKS = (pr, random) -> {
+        for (int i = 0; i < 8; i++) {
+            int w = 1 + random.nextInt(WIDTH);
+            int h = 1 + random.nextInt(HEIGHT);
+            setPaint(pr, random, i % PAINTS);
+            pr.fillAlphaMask(mask(random, w * h), random.nextInt(WIDTH) - w / 2,
+                             random.nextInt(HEIGHT) - h / 2, w, h, 0, w);
+        }
+    };
+
+    static final Scene LCD_MASKS = (pr, random) -> {
+        pr.setLCDGammaCorrection(1.4f);
+        for (int i = 0; i < 8; i++) {
+            int w = 1 + random.nextInt(WIDTH);
+            int h = 1 + random.nextInt(HEIGHT);
+            setPaint(pr, random, i % 2);
+            // 3 coverages per pixel
+            pr.fillLCDAlphaMask(mask(random, 3 * w * h), random.nextInt(WIDTH) - w / 2,
+                                random.nextInt(HEIGHT) - h / 2, 3 * w, h, 0, 3 * w);
+        }
+    };
+
+    static final Scene ALPHA_ROWS = (pr, random) -> {
+        byte[] alphaMap = new byte[17];
+        for (int i = 0; i < alphaMap.length; i++) {
+            alphaMap[i] = (byte) ((i * 255 + 8) / 16);
+        }
+        int[] deltas = new int[WIDTH + 1];
+        for (int y = 0; y < HEIGHT; y++) {
+            int from = random.nextInt(WIDTH);
+            int to = from + random.nextInt(WIDTH - from);
+            // Relative coverages whose running sums stay in the alpha map
+            int sum = 0;
+            for (int x = from; x <= to; x++) {
+                int next = (random.nextInt(3) == 0) ? sum : random.nextInt(alphaMap.length);
+                deltas[x - from] = next - sum;
+                sum = next;
+            }
+            deltas[to - from + 1] = -sum;
+            setPaint(pr, random, y % PAINTS);
+            pr.emitAndClearAlphaRow(alphaMap, deltas, y, from, to, y);
+        }
+    };
+
+    static final Scene CLEARS = (pr, random) -> {
+        for (int i = 0; i < 6; i++) {
+            pr.clearRect(random.nextInt(WIDTH), random.nextInt(HEIGHT),
+                         random.nextInt(WIDTH), random.nextInt(HEIGHT));
+        }
+    };
+
+    static int[] render(int simd, int composite, Scene scene) {
+        int[] data = background(composite);
+        PiscesRenderer.setSimd(simd);
+        PiscesRenderer pr = new PiscesRenderer(
+            new JavaSurface(data, RendererBase.TYPE_INT_ARGB_PRE, WIDTH, HEIGHT));
+        pr.setCompositeRule(composite);
+        pr.setClip(2, 1, WIDTH - 5, HEIGHT - 3);
+        scene.render(pr, new Random(composite * 31 + 7));
+        return data;
+    }
+
+    static void checkScene(Scene scene) {
+        for (int composite : COMPOSITES) {
+            int[] expected = render(RendererBase.SIMD_NONE, composite, scene);
+            for (int simd = RendererBase.SIMD_SSE2; simd <= RendererBase.SIMD_NEON; simd++) {
+                if (PiscesRenderer.setSimd(simd)) {
+                    assertArrayEquals("SIMD " + simd + ", composite " + composite,
+                                      expected, render(simd, composite, scene));
+                }
+            }
+        }
+    }
+
+    @Test
+    public void testFillRect() {
+        checkScene(RECTS);
+    }
+
+    @Test
+    public void testFillAlphaMask() {
+        checkScene(MASKS);
+    }
+
+    @Test
+    public void testFillLCDAlphaMask() {
+        checkScene(LCD_MASKS);
+    }
+
+    @Test
+    public void testEmitAndClearAlphaRow() {
+        checkScene(ALPHA_ROWS);
+    }
+
+    @Test
+    public void testClearRect() {
+        checkScene(CLEARS);
+    }
+}
@@ -25,10 +25,18 @@
 
 package com.sun.prism.impl.shape;
 
+import com.sun.javafx.geom.Ellipse2D;
 import com.sun.javafx.geom.PathIterator;
+import com.sun.javafx.geom.RectBounds;
+import com.sun.javafx.geom.RoundRectangle2D;
+import com.sun.javafx.geom.Shape;
+import com.sun.javafx.geom.transform.BaseTransform;
 import com.sun.prism.BasicStroke;
+import java.nio.ByteBuffer;
 import org.junit.Test;
 
+import static org.junit.Assert.assertEquals;
+
 public class NativePiscesRasterizerTest {
     static final int JOIN_BEVEL = BasicStroke.JOIN_BEVEL;
     static final int JOIN_MITER = BasicStroke.JOIN_MITER;
@@ -258,4 +266,117 @@ public class NativePiscesRasterizerTest {
                                                    1, 0, 0, 0, 1, 0,
                                                    bounds10, mask1k);
     }
+
+    @Test(expected=java.lang.NullPointerException.class)
+    public void BatchNullPaths() {
+        NativePiscesRasterizer.produceAlphasBatch(null, 0, 1,
+                                                  ByteBuffer.allocateDirect(100), 10, 10,
+                                                  new int[NativePiscesRasterizer.BATCH_RESULT_SIZE]);
+    }
+
+    @Test(expected=java.lang.ArrayIndexOutOfBoundsException.class)
+    public void BatchShortResults() {
+        NativePiscesRasterizer.produceAlphasBatch(ByteBuffer.allocateDirect(100), 0, 2,
+                                                  ByteBuffer.allocateDirect(100), 10, 10,
+                                                  new int[NativePiscesRasterizer.BATCH_RESULT_SIZE]);
+    }
+
+    @Test
+    public void BatchMatchesMaskData() {
+        Shape shapes[] = {
+            new Ellipse2D(2.5f, 3.25f, 20, 11),
+            new RoundRectangle2D(-4, 1, 30, 17, 6, 6),
+            new Ellipse2D(0, 0, 90, 40),    // larger than the atlas
+        };
+        BasicStroke strokes[] = {
+            null,
+            new BasicStroke(3, CAP_ROUND, JOIN_ROUND, 10),
+            new BasicStroke(2, CAP_BUTT, JOIN_MITER, 10, new float[] { 4, 3 }, 1),
+        };
+        BaseTransform xforms[] = {
+            BaseTransform.IDENTITY_TRANSFORM,
+            BaseTransform.getTranslateInstance(10.5, -3.75),
+            BaseTransform.getScaleInstance(1.5, 0.75),
+        };
+        NativePiscesRasterizer rasterizer = new NativePiscesRasterizer();
+        NativePiscesRasterizer.Batch batch = new NativePiscesRasterizer.Batch(64, 32);
+        int numPaths = 0;
+        for (int i = 0; i < 24; i++) {
+            Shape shape = shapes[i % shapes.length];
+            BasicStroke stroke = strokes[i % strokes.length];
+            BaseTransform xform = xforms[(i / 2) % xforms.length];
+            batch.add(shape, stroke, bounds(shape, xform), xform);
+            numPaths++;
+        }
+        assertEquals(numPaths, batch.getNumPaths());
+
+        for (int from = 0; from < numPaths; ) {
+            int to = rasterizer.rasterize(batch, true);
+            for (int p = from; p < to; p++) {
+                Shape shape = shapes[p % shapes.length];
+                BaseTransform xform = xforms[(p / 2) % xforms.length];
+                MaskData data = rasterizer.getMaskData(shape, strokes[p % strokes.length],
+                                                       bounds(shape, xform), xform, true, true);
+                int w = data.getWidth();
+                int h = data.getHeight();
+                assertEquals(data.getOriginX(), batch.getOriginX(p));
+                assertEquals(data.getOriginY(), batch.getOriginY(p));
+                assertEquals(w, batch.getWidth(p));
+                assertEquals(h, batch.getHeight(p));
+                if (!batch.isInAtlas(p)) {
+                    continue;
+                }
+                ByteBuffer atlas = batch.getAtlas();
+                for (int y = 0; y < h; y++) {
+                    for (int x = 0; x < w; x++) {
+                        assertEquals("path " + p + " at " + x + ", " + y,
+                                     data.getMaskBuffer().get(y * w + x),
+                                     atlas.get((batch.getAtlasY(p) + y) * batch.getAtlasWidth() +
+                                               batch.getAtlasX(p) + x));
+                    }
+                }
+            }
+            from = to;
+        }
+    }
+
+    @Test
+    public void BatchGrowsAfterRasterize() {
+        Shape shape = new Ellipse2D(1, 1, 3, 3);
+        BaseTransform xform = BaseTransform.IDENTITY_TRANSFORM;
+        NativePiscesRasterizer rasterizer = new NativePiscesRasterizer();
+        NativePiscesRasterizer.Batch batch = new NativePiscesRasterizer.Batch(1024, 64);
+        for (int i = 0; i < 48; i++) {
+            BaseTransform translate = BaseTransform.getTranslateInstance(i, 0);
+            batch.add(shape, null, bounds(shape, translate), translate);
+        }
+        int rasterized = rasterizer.rasterize(batch, true);
+        assertEquals(48, rasterized);
+        int expected[] = new int[rasterized * 4];
+        for (int p = 0; p < rasterized; p++) {
+            expected[p * 4] = batch.getAtlasX(p);
+            expected[p * 4 + 1] = batch.getAtlasY(p);
+            expected[p * 4 + 2] = batch.getOriginX(p);
+            expected[p * 4 + 3] = batch.getWidth(p);
+        }
+
+        // More paths than the initial capacity of the batch
+        for (int i = 0; i < 200; i++) {
+            batch.add(shape, null, bounds(shape, xform), xform);
+        }
+        for (int p = 0; p < rasterized; p++) {
+            assertEquals("path " + p, expected[p * 4], batch.getAtlasX(p));
+            assertEquals("path " + p, expected[p * 4 + 1], batch.getAtlasY(p));
+            assertEquals("path " + p, expected[p * 4 + 2], batch.getOriginX(p));
+            assertEquals("path " + p, expected[p * 4 + 3], batch.getWidth(p));
+        }
+
+        assertEquals(248, rasterizer.rasterize(batch, true));
+        assertEquals(expected[3], batch.getWidth(247));
+    }
+
+    static RectBounds bounds(Shape shape, BaseTransform xform) {
+        RectBounds b = (RectBounds) xform.transform(shape.getBounds(), new RectBounds());
+        return new RectBounds(b.getMinX() - 4, b.getMinY() - 4, b.getMaxX() + 4, b.getMaxY() + 4);
+    }
 }
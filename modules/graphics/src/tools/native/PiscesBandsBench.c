@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * Renders the same scenes with the native-prism-sw renderer on 1 to N
+ * threads, checks that the results are identical to the ones of a single
+ * thread and prints the speedups.
+ *
+ * Build from this directory, with the JDK and the javafx.graphics JNI
+ * headers (com_sun_pisces_RendererBase.h) on the include path:
+ *   cc -O2 -DINLINE=inline -I../../main/native-prism-sw -I<jni headers> \
+ *       PiscesBandsBench.c ../../main/native-prism-sw/PiscesBands.c \
+ *       ../../main/native-prism-sw/PiscesBlit.c \
+ *       ../../main/native-prism-sw/PiscesPaint.c \
+ *       ../../main/native-prism-sw/PiscesTransform.c \
+ *       ../../main/native-prism-sw/PiscesSysutils.c \
+ *       ../../main/native-prism-sw/PiscesSimd.c \
+ *       -lpthread -lm -o PiscesBandsBench
+ *
+ * Usage: PiscesBandsBench [threads [width height [iterations]]], all the
+ * processors and 1920x1080 by default.
+ */
+
+#include <PiscesRenderer.inl>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#define TEXTURE_SIZE 256
+#define MASK_SIZE 512
+
+typedef void Scene(Renderer* rdr, jint width, jint height);
+
+static jint gradientColors[GRADIENT_MAP_SIZE];
+static jint textureData[TEXTURE_SIZE * TEXTURE_SIZE];
+static jbyte maskData[MASK_SIZE * MASK_SIZE];
+
+static double now_ms() {
+#if defined(_WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart * 1000.0 / (double)freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+#endif
+}
+
+static int processor_count() {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0) ? (int)count : 1;
+#endif
+}
+
+static void init_data() {
+    int i, x, y;
+    unsigned int seed = 12345;
+
+    for (i = 0; i < GRADIENT_MAP_SIZE; i++) {
+        jint a = 128 + i / 2;
+        jint r = i * a / 255;
+        jint g = (255 - i) * a / 255;
+        jint b = (i * 7 & 0xFF) * a / 255;
+        gradientColors[i] = (a << 24) | (r << 16) | (g << 8) | b;
+    }
+    for (y = 0; y < TEXTURE_SIZE; y++) {
+        for (x = 0; x < TEXTURE_SIZE; x++) {
+            jint a = ((x ^ y) & 0x20) ? 255 : 160;
+            jint v = (x * 255 / TEXTURE_SIZE) * a / 255;
+            textureData[y * TEXTURE_SIZE + x] = (a << 24) | (v << 16) |
+                ((y * 255 / TEXTURE_SIZE) * a / 255 << 8) | (a / 2);
+        }
+    }
+    for (i = 0; i < MASK_SIZE * MASK_SIZE; i++) {
+        seed = seed * 1103515245 + 12345;
+        maskData[i] = (jbyte)(seed >> 16);
+    }
+}
+
+static void identity(Transform6* t) {
+    t->m00 = t->m11 = 1 << 16;
+    t->m01 = t->m10 = t->m02 = t->m12 = 0;
+}
+
+static void scene_flat(Renderer* rdr, jint width, jint height) {
+    int i;
+
+    for (i = 0; i < 16; i++) {
+        renderer_setColor(rdr, (i * 40) & 0xFF, (i * 90) & 0xFF, (i * 20) & 0xFF,
+            (i & 1) ? 255 : 140);
+        renderer_fillRect(rdr, (i * 37 << 16) + 0x4000, (i * 23 << 16) + 0x8000,
+            (width - i * 60) << 16, (height - i * 40) << 16,
+            IMAGE_FRAC_EDGE_KEEP, IMAGE_FRAC_EDGE_KEEP,
+            IMAGE_FRAC_EDGE_KEEP, IMAGE_FRAC_EDGE_KEEP);
+    }
+}
+
+static void scene_gradients(Renderer* rdr, jint width, jint height) {
+    Transform6 t;
+
+    identity(&t);
+    rdr->_gradient_cycleMethod = CYCLE_REFLECT;
+    renderer_setLinearGradient(rdr, 0, 0, (width / 3) << 16, (height / 2) << 16,
+        gradientColors, &t);
+    renderer_fillRect(rdr, 0x2000, 0x2000, (width << 16) - 0x4000, (height << 16) - 0x4000,
+        IMAGE_FRAC_EDGE_KEEP, IMAGE_FRAC_EDGE_KEEP,
+        IMAGE_FRAC_EDGE_KEEP, IMAGE_FRAC_EDGE_KEEP);
+
+    rdr->_gradient_cycleMethod = CYCLE_REPEAT;
+    renderer_setRadialGradient(rdr, (width / 2) << 16, (height / 2) << 16,
+        (width / 3) << 16, (height / 3) << 16, (height / 4) << 16,
+        gradientColors, &t);
+    renderer_fillRect(rdr, (width / 8) << 16, (height / 8) << 16,
+        (width * 3 / 4) << 16, (height * 3 / 4) << 16,
+        IMAGE_FRAC_EDGE_KEEP, IMAGE_FRAC_EDGE_KEEP,
+        IMAGE_FRAC_EDGE_KEEP, IMAGE_FRAC_EDGE_KEEP);
+}
+
+static void scene_image(Renderer* rdr, jint width, jint height) {
+    Transform6 t;
+
+    // Scaled up to the surface, with filtering
+    t.m00 = (width << 16) / TEXTURE_SIZE;
+    t.m11 = (height << 16) / TEXTURE_SIZE;
+    t.m01 = t.m10 = 0;
+    t.m02 = 0x3000;
+    t.m12 = 0x5000;
+    renderer_setColor(rdr, 255, 255, 255, 255);
+    renderer_setTexture(rdr, IMAGE_MODE_NORMAL, textureData,
+        TEXTURE_SIZE, TEXTURE_SIZE, TEXTURE_SIZE, XNI_FALSE, XNI_TRUE,
+        &t, XNI_FALSE, XNI_TRUE, 0, 0, TEXTURE_SIZE - 1, TEXTURE_SIZE - 1);
+    renderer_fillRect(rdr, 0x3000, 0x5000, width << 16, height << 16,
+        IMAGE_FRAC_EDGE_KEEP, IMAGE_FRAC_EDGE_KEEP,
+        IMAGE_FRAC_EDGE_KEEP, IMAGE_FRAC_EDGE_KEEP);
+    rdr->_texture_intData = NULL;
+}
+
+static void scene_masks(Renderer* rdr, jint width, jint height) {
+    Transform6 t;
+    jint x, y;
+
+    identity(&t);
+    rdr->_gradient_cycleMethod = CYCLE_REFLECT;
+    renderer_setLinearGradient(rdr, 0, 0, (width / 5) << 16, (height / 7) << 16,
+        gradientColors, &t);
+    // Tiles of the mask, partly outside of the clip on the left and top edges
+    renderer_setClip(rdr, 10, 10, width - 20, height - 20);
+    for (y = -MASK_SIZE / 4; y < height; y += MASK_SIZE) {
+        for (x = -MASK_SIZE / 3; x < width; x += MASK_SIZE) {
+            jint minX = MAX(x, rdr->_clip_bbMinX);
+            jint minY = MAX(y, rdr->_clip_bbMinY);
+            jint maxX = MIN(x + MASK_SIZE - 1, rdr->_clip_bbMaxX);
+            jint maxY = MIN(y + MASK_SIZE - 1, rdr->_clip_bbMaxY);
+            renderer_fillAlphaMask(rdr, minX, minY, maxX, maxY, ALPHA_MASK, maskData,
+                x, y, MASK_SIZE, MASK_SIZE, (minY - y) * MASK_SIZE + minX - x);
+        }
+    }
+    renderer_setClip(rdr, 0, 0, width, height);
+}
+
+static const struct {
+    const char* name;
+    Scene* scene;
+} scenes[] = {
+    { "flat", scene_flat },
+    { "gradients", scene_gradients },
+    { "image", scene_image },
+    { "masks", scene_masks },
+};
+
+#define SCENE_COUNT ((int)(sizeof(scenes) / sizeof(scenes[0])))
+
+int main(int argc, char* argv[]) {
+    int max_threads = (argc > 1) ? atoi(argv[1]) : processor_count();
+    jint width = (argc > 3) ? atoi(argv[2]) : 1920;
+    jint height = (argc > 3) ? atoi(argv[3]) : 1080;
+    int iterations = (argc > 4) ? atoi(argv[4]) : 20;
+    size_t size = (size_t)width * height;
+    jint* expected = (jint*)calloc(size, sizeof(jint));
+    Surface surface;
+    Renderer* rdr;
+    int failures = 0;
+    int s, n, i;
+
+    if (max_threads < 1 || width < 1 || height < 1 || iterations < 1) {
+        fprintf(stderr, "Usage: %s [threads [width height [iterations]]]\n", argv[0]);
+        return 1;
+    }
+    max_threads = MIN(max_threads, MAX_BAND_THREADS);
+
+    surface.width = width;
+    surface.height = height;
+    surface.offset = 0;
+    surface.scanlineStride = width;
+    surface.pixelStride = 1;
+    surface.imageType = TYPE_INT_ARGB_PRE;
+    surface.data = calloc(size, sizeof(jint));
+    surface.alphaData = NULL;
+    if (surface.data == NULL || expected == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    init_data();
+    rdr = renderer_create(&surface);
+
+    printf("%dx%d, %d iterations\n", width, height, iterations);
+    for (s = 0; s < SCENE_COUNT; s++) {
+        double serial_ms = 0;
+
+        for (n = 1; n <= max_threads; n++) {
+            double start, ms;
+
+            if (pisces_bands_setThreadCount(n) != n) {
+                fprintf(stderr, "Could not start %d threads\n", n);
+                return 1;
+            }
+
+            // Once for the results, then timed
+            memset(surface.data, 0, size * sizeof(jint));
+            scenes[s].scene(rdr, width, height);
+            if (n == 1) {
+                memcpy(expected, surface.data, size * sizeof(jint));
+            } else if (memcmp(expected, surface.data, size * sizeof(jint)) != 0) {
+                printf("%-10s %2d threads: results differ from 1 thread\n",
+                    scenes[s].name, n);
+                failures++;
+            }
+
+            start = now_ms();
+            for (i = 0; i < iterations; i++) {
+                scenes[s].scene(rdr, width, height);
+            }
+            ms = (now_ms() - start) / iterations;
+            if (n == 1) {
+                serial_ms = ms;
+            }
+            printf("%-10s %2d threads: %8.3f ms, x%.2f\n",
+                scenes[s].name, n, ms, serial_ms / ms);
+        }
+    }
+
+    renderer_dispose(rdr);
+    free(surface.data);
+    free(expected);
+
+    if (failures == 0) {
+        printf("All the results match\n");
+    }
+    return failures ? 2 : 0;
+}
@@ -76,15 +76,26 @@ public abstract class ConnectionHolder {
      * closeConnection has been called
      */
     public int readNextBlock() throws IOException {
-        buffer.rewind();
-        if (buffer.limit() < buffer.capacity()) {
-            buffer.limit(buffer.capacity());
-        }
+        return readNextBlock(buffer, buffer.capacity());
+    }
+
+    /**
+     * Reads up to <code>size</code> bytes from the current position of the
+     * opened stream into <code>target</code>, from its start.
+     *
+     * @return The number of bytes read, possibly zero, or -1 if the channel
+     * has reached end-of-stream.
+     *
+     * @throws ClosedChannelException if an attempt is made to read after
+     * closeConnection has been called
+     */
+    int readNextBlock(ByteBuffer target, int size) throws IOException {
+        target.rewind().limit(size);
         // avoid NPE if channel does not exist or has been closed
         if (null == channel) {
             throw new ClosedChannelException();
         }
-        return channel.read(buffer);
+        return channel.read(target);
     }
 
     public ByteBuffer getBuffer() {
@@ -102,6 +113,27 @@ public abstract class ConnectionHolder {
      */
     abstract int readBlock(long position, int size) throws IOException;
 
+    /**
+     * Reads up to <code>size</code> bytes from the arbitrary position of the
+     * opened stream into <code>target</code>, from its start.
+     *
+     * @return The number of bytes read, possibly zero, or -1 if the given position
+     * is greater than or equal to the file's current size.
+     *
+     * @throws ClosedChannelException if an attempt is made to read after
+     * closeConnection has been called
+     */
+    int readBlock(long position, ByteBuffer target, int size) throws IOException {
+        int read = readBlock(position, size);
+        if (read > 0) {
+            ByteBuffer source = buffer.duplicate();
+            source.rewind().limit(read);
+            target.rewind().limit(read);
+            target.put(source);
+        }
+        return read;
+    }
+
     /**
      * Detects whether this source needs buffering at the pipeline level.
      * When true the pipeline contains progressbuffer after the source.
@@ -208,6 +240,16 @@ public abstract class ConnectionHolder {
             return ((FileChannel)channel).read(buffer, position);
         }
 
+        @Override
+        int readBlock(long position, ByteBuffer target, int size) throws IOException {
+            if (null == channel) {
+                throw new ClosedChannelException();
+            }
+
+            target.rewind().limit(size);
+            return ((FileChannel)channel).read(target, position);
+        }
+
         private ReadableByteChannel openFile(final URI uri) throws IOException {
             if (file != null) {
                 file.close();
@@ -368,7 +410,7 @@ public abstract class ConnectionHolder {
                     }
 
                     int actual;
-                    if (bb.equals(buffer)) {
+                    if (bb == buffer) {
                         // we'll cheat here as we know that bb is buffer and rather
                         // than copy the data, just slice it like for readBlock
                         actual = Math.min(DEFAULT_BUFFER_SIZE, backingBuffer.remaining());
@@ -30,6 +30,7 @@ import java.io.BufferedReader;
 import java.io.IOException;
 import java.io.InputStreamReader;
 import java.net.*;
+import java.nio.ByteBuffer;
 import java.nio.channels.Channels;
 import java.nio.channels.ReadableByteChannel;
 import java.nio.charset.Charset;
@@ -72,12 +73,12 @@ final class HLSConnectionHolder extends ConnectionHolder {
     }
 
     @Override
-    public int readNextBlock() throws IOException {
+    int readNextBlock(ByteBuffer target, int size) throws IOException {
         if (isBitrateAdjustable && startTime == -1) {
             startTime = System.currentTimeMillis();
         }
 
-        int read = super.readNextBlock();
+        int read = super.readNextBlock(target, size);
         if (isBitrateAdjustable && read == -1) {
             long readTime = System.currentTimeMillis() - startTime;
             startTime = -1;
@@ -25,6 +25,9 @@
 
 package com.sun.media.jfxmediaimpl.platform.gstreamer;
 
+import java.security.AccessController;
+import java.security.PrivilegedAction;
+
 import com.sun.media.jfxmedia.Media;
 import com.sun.media.jfxmedia.MediaError;
 import com.sun.media.jfxmedia.locator.Locator;
@@ -36,6 +39,13 @@ import com.sun.media.jfxmediaimpl.platform.Platform;
  * GStreamer implementation of Media
  */
 final class GSTMedia extends NativeMedia {
+    /**
+     * Number of threads of the video decoder, 0 (the default) for one per
+     * core, e.g. -Djfxmedia.videoDecoderThreads=1 to decode on a single thread.
+     */
+    private static final int videoDecoderThreads = AccessController.doPrivileged(
+            (PrivilegedAction<Integer>) () -> Math.max(0, Integer.getInteger("jfxmedia.videoDecoderThreads", 0)));
+
     /**
      * Synchronization mutex for markers.
      */
@@ -64,7 +74,7 @@ final class GSTMedia extends NativeMedia {
         Locator loc = getLocator();
         ret = MediaError.getFromCode(gstInitNativeMedia(loc,
                 loc.getContentType(), loc.getContentLength(),
-                nativeMediaHandle));
+                videoDecoderThreads, nativeMediaHandle));
         if (ret != MediaError.ERROR_NONE && ret != MediaError.ERROR_PLATFORM_UNSUPPORTED) {
             MediaUtils.nativeError(this, ret);
         }
@@ -92,6 +102,7 @@ final class GSTMedia extends NativeMedia {
     private native int gstInitNativeMedia(Locator locator,
                                                String contentType,
                                                long sizeHint,
+                                               int videoDecoderThreads,
                                                long[] nativeMediaHandle);
     private native void gstDispose(long refNativeMedia);
 }
@@ -36,5 +36,8 @@
 // New Frame alloc functions were introduced in 55.28.0
 #define NEW_ALLOC_FRAME        (LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(55,28,0))
 
+// Reference counted frames and get_buffer2 were introduced in 55.0.0
+#define NEW_GET_BUFFER         (LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(55,0,0))
+
 #endif  /* AVDEFINES_H */
 
@@ -35,6 +35,14 @@
 #include "videodecoder.h"
 #include <libavformat/avformat.h>
 
+#if NEW_GET_BUFFER
+#include <libavutil/buffer.h>
+
+#if !defined(AV_CODEC_CAP_DR1)
+#define AV_CODEC_CAP_DR1 CODEC_CAP_DR1
+#endif
+#endif
+
 GST_DEBUG_CATEGORY_STATIC(videodecoder_debug);
 #define GST_CAT_DEFAULT videodecoder_debug
 
@@ -66,6 +74,21 @@ static GstStaticPadTemplate source_template =
 //#define DEBUG_OUTPUT
 //#define VERBOSE_DEBUG
 
+enum
+{
+    PROP_0,
+    PROP_THREADS,
+    PROP_FRAMES_DECODED,
+    PROP_DECODE_TIME,
+    PROP_TOTAL_DECODE_TIME,
+    PROP_BUFFERS_ALLOCATED,
+    PROP_BUFFERS_REUSED,
+    PROP_BUFFERS_MAX
+};
+
+// Marks the pool buffers handed out at least once.
+static GQuark pooled_buffer_quark = 0;
+
 /***********************************************************************************
  * Substitution for
  * G_DEFINE_TYPE(VideoDecoder, videodecoder, BaseDecoder, TYPE_BASEDECODER);
@@ -105,16 +128,27 @@ GType videodecoder_get_type (void)
 static GstStateChangeReturn videodecoder_change_state(GstElement* element, GstStateChange transition);
 static gboolean             videodecoder_sink_event(GstPad *pad, GstObject *parent, GstEvent *event);
 static GstFlowReturn        videodecoder_chain(GstPad *pad, GstObject *parent, GstBuffer *buf);
+static void                 videodecoder_set_property(GObject *object, guint prop_id, const GValue *value, GParamSpec *spec);
+static void                 videodecoder_get_property(GObject *object, guint prop_id, GValue *value, GParamSpec *spec);
+static void                 videodecoder_finalize(GObject *object);
+static void                 videodecoder_init_context(BaseDecoder *base);
+static GstFlowReturn        videodecoder_drain(VideoDecoder *decoder);
 
 static void                 videodecoder_init_state(VideoDecoder *decoder);
 static void                 videodecoder_state_reset(VideoDecoder *decoder);
+static void                 videodecoder_free_pool(VideoDecoder *decoder);
 
 static gboolean videodecoder_configure(VideoDecoder *decoder, GstCaps *sink_caps);
 
 static void videodecoder_class_init(VideoDecoderClass *klass)
 {
+    GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
     GstElementClass *element_class = GST_ELEMENT_CLASS(klass);
 
+    gobject_class->set_property = videodecoder_set_property;
+    gobject_class->get_property = videodecoder_get_property;
+    gobject_class->finalize = videodecoder_finalize;
+
     gst_element_class_set_metadata(element_class,
                 "Videodecoder",
                 "Codec/Decoder/Video",
@@ -127,6 +161,38 @@ static void videodecoder_class_init(VideoDecoderClass *klass)
             gst_static_pad_template_get(&sink_template));
 
     element_class->change_state = videodecoder_change_state;
+
+    BASEDECODER_CLASS(klass)->init_context = videodecoder_init_context;
+
+    pooled_buffer_quark = g_quark_from_static_string("avvideodecoder-pooled");
+
+    g_object_class_install_property(gobject_class, PROP_THREADS,
+        g_param_spec_int("threads", "Threads", "Number of decoding threads, 0 for one per core",
+        0, G_MAXINT, 0, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | GST_PARAM_MUTABLE_READY));
+
+    g_object_class_install_property(gobject_class, PROP_FRAMES_DECODED,
+        g_param_spec_uint64("frames-decoded", "Frames decoded", "Number of frames decoded",
+        0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+    g_object_class_install_property(gobject_class, PROP_DECODE_TIME,
+        g_param_spec_uint64("decode-time", "Decode time", "Time spent in the last decoding call, in microseconds",
+        0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+    g_object_class_install_property(gobject_class, PROP_TOTAL_DECODE_TIME,
+        g_param_spec_uint64("total-decode-time", "Total decode time", "Time spent in all the decoding calls, in microseconds",
+        0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+    g_object_class_install_property(gobject_class, PROP_BUFFERS_ALLOCATED,
+        g_param_spec_uint64("buffers-allocated", "Buffers allocated", "Number of frame buffers allocated by the pool",
+        0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+    g_object_class_install_property(gobject_class, PROP_BUFFERS_REUSED,
+        g_param_spec_uint64("buffers-reused", "Buffers reused", "Number of frames decoded into a recycled buffer",
+        0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+    g_object_class_install_property(gobject_class, PROP_BUFFERS_MAX,
+        g_param_spec_uint("buffers-max", "Buffers max", "Largest number of pool buffers referenced by the decoder at once",
+        0, G_MAXUINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 }
 
 static void videodecoder_init(VideoDecoder *decoder)
@@ -143,6 +209,302 @@ static void videodecoder_init(VideoDecoder *decoder)
     base->srcpad = gst_pad_new_from_static_template(&source_template, "src");
     gst_pad_use_fixed_caps(base->srcpad);
     gst_element_add_pad(GST_ELEMENT(decoder), base->srcpad);
+
+    decoder->threads = 0;
+
+    g_mutex_init(&decoder->pool_lock);
+    decoder->pool = NULL;
+    decoder->pool_buffer_size = 0;
+    decoder->buffers_in_use = 0;
+    decoder->pooled_frames = g_hash_table_new(g_direct_hash, g_direct_equal);
+}
+
+static void videodecoder_finalize(GObject *object)
+{
+    VideoDecoder *decoder = VIDEODECODER(object);
+
+    videodecoder_free_pool(decoder);
+    g_hash_table_destroy(decoder->pooled_frames);
+    g_mutex_clear(&decoder->pool_lock);
+
+    G_OBJECT_CLASS(parent_class)->finalize(object);
+}
+
+/***********************************************************************************
+ * GObject overrides
+ ***********************************************************************************/
+static void videodecoder_set_property(GObject *object, guint prop_id, const GValue *value, GParamSpec *spec)
+{
+    VideoDecoder *decoder = VIDEODECODER(object);
+    switch (prop_id)
+    {
+        case PROP_THREADS:
+            decoder->threads = g_value_get_int(value);
+            break;
+        default:
+            break;
+    }
+}
+
+static void videodecoder_get_property(GObject *object, guint prop_id, GValue *value, GParamSpec *spec)
+{
+    VideoDecoder *decoder = VIDEODECODER(object);
+    switch (prop_id)
+    {
+        case PROP_THREADS:
+            g_value_set_int(value, decoder->threads);
+            break;
+        case PROP_FRAMES_DECODED:
+            g_value_set_uint64(value, decoder->frames_decoded);
+            break;
+        case PROP_DECODE_TIME:
+            g_value_set_uint64(value, decoder->decode_time);
+            break;
+        case PROP_TOTAL_DECODE_TIME:
+            g_value_set_uint64(value, decoder->total_decode_time);
+            break;
+        case PROP_BUFFERS_ALLOCATED:
+            g_mutex_lock(&decoder->pool_lock);
+            g_value_set_uint64(value, decoder->buffers_allocated);
+            g_mutex_unlock(&decoder->pool_lock);
+            break;
+        case PROP_BUFFERS_REUSED:
+            g_mutex_lock(&decoder->pool_lock);
+            g_value_set_uint64(value, decoder->buffers_reused);
+            g_mutex_unlock(&decoder->pool_lock);
+            break;
+        case PROP_BUFFERS_MAX:
+            g_mutex_lock(&decoder->pool_lock);
+            g_value_set_uint(value, decoder->buffers_max);
+            g_mutex_unlock(&decoder->pool_lock);
+            break;
+        default:
+            break;
+    }
+}
+
+/***********************************************************************************
+ * Frame buffer pool
+ ***********************************************************************************/
+// Called with the pool lock held.
+static void videodecoder_reset_pool(VideoDecoder *decoder)
+{
+    if (decoder->pool)
+    {
+        // Buffers still referenced by libavcodec or downstream are freed when
+        // they are released, and keep the pool alive until then.
+        gst_buffer_pool_set_active(decoder->pool, FALSE);
+        gst_object_unref(decoder->pool);
+        decoder->pool = NULL;
+    }
+    decoder->pool_buffer_size = 0;
+}
+
+static void videodecoder_free_pool(VideoDecoder *decoder)
+{
+    g_mutex_lock(&decoder->pool_lock);
+    videodecoder_reset_pool(decoder);
+    g_mutex_unlock(&decoder->pool_lock);
+}
+
+#if NEW_GET_BUFFER
+
+// Pool buffer of a frame, mapped for as long as libavcodec references it.
+typedef struct _PooledFrame
+{
+    VideoDecoder *decoder;
+    GstBuffer    *buffer;
+    GstMapInfo    info;
+} PooledFrame;
+
+// Hands a buffer taken by videodecoder_acquire_buffer() back.
+static void videodecoder_release_buffer(VideoDecoder *decoder, GstBuffer *buffer)
+{
+    g_mutex_lock(&decoder->pool_lock);
+    decoder->buffers_in_use--;
+    g_mutex_unlock(&decoder->pool_lock);
+
+    gst_buffer_unref(buffer); // Back to the pool, unless pushed downstream.
+}
+
+static void videodecoder_release_frame(void *opaque, uint8_t *data)
+{
+    PooledFrame *pooled = (PooledFrame*)opaque;
+    VideoDecoder *decoder = pooled->decoder;
+
+    g_mutex_lock(&decoder->pool_lock);
+    g_hash_table_remove(decoder->pooled_frames, pooled->info.data);
+    g_mutex_unlock(&decoder->pool_lock);
+
+    gst_buffer_unmap(pooled->buffer, &pooled->info);
+    videodecoder_release_buffer(decoder, pooled->buffer);
+    g_slice_free(PooledFrame, pooled);
+}
+
+// Called with the pool lock held.
+static gboolean videodecoder_configure_pool(VideoDecoder *decoder, gsize size)
+{
+    BaseDecoder *base = BASEDECODER(decoder);
+
+    if (decoder->pool && decoder->pool_buffer_size == size)
+        return TRUE;
+
+    videodecoder_reset_pool(decoder);
+
+    GstBufferPool *pool = gst_buffer_pool_new();
+    if (pool == NULL)
+        return FALSE;
+
+    // Preallocate the DPB: the reference frames plus the frame being decoded
+    // by each thread. There is no upper bound, as downstream holds on to the
+    // frames for a varying time.
+    guint min_buffers = MAX(base->context->refs, 1) + MAX(base->context->thread_count, 1);
+
+    GstAllocationParams params;
+    gst_allocation_params_init(&params);
+    params.align = AV_VIDEO_DECODER_FRAME_ALIGN - 1;
+
+    GstStructure *config = gst_buffer_pool_get_config(pool);
+    gst_buffer_pool_config_set_params(config, NULL, size, min_buffers, 0);
+    gst_buffer_pool_config_set_allocator(config, NULL, &params);
+    if (!gst_buffer_pool_set_config(pool, config) || !gst_buffer_pool_set_active(pool, TRUE))
+    {
+        gst_object_unref(pool);
+        return FALSE;
+    }
+
+    decoder->pool = pool;
+    decoder->pool_buffer_size = size;
+    return TRUE;
+}
+
+static GstBuffer* videodecoder_acquire_buffer(VideoDecoder *decoder, gsize size)
+{
+    GstBuffer *buffer = NULL;
+
+    g_mutex_lock(&decoder->pool_lock);
+    if (videodecoder_configure_pool(decoder, size) &&
+        gst_buffer_pool_acquire_buffer(decoder->pool, &buffer, NULL) == GST_FLOW_OK)
+    {
+        // Buffers are tagged the first time they are handed out.
+        if (gst_mini_object_get_qdata(GST_MINI_OBJECT(buffer), pooled_buffer_quark))
+            decoder->buffers_reused++;
+        else
+        {
+            gst_mini_object_set_qdata(GST_MINI_OBJECT(buffer), pooled_buffer_quark, GINT_TO_POINTER(TRUE), NULL);
+            decoder->buffers_allocated++;
+        }
+        decoder->buffers_in_use++;
+        decoder->buffers_max = MAX(decoder->buffers_max, decoder->buffers_in_use);
+    }
+    g_mutex_unlock(&decoder->pool_lock);
+
+    return buffer;
+}
+
+// Decodes I420 frames into pool buffers, laid out as the YV12 caps of the
+// source pad describe them: Y, U then V planes, with aligned rows.
+static int videodecoder_get_buffer2(AVCodecContext *context, AVFrame *frame, int flags)
+{
+    VideoDecoder *decoder = VIDEODECODER(context->opaque);
+
+    // Only the decoders with DR1 can decode into buffers of our own.
+    if (frame->format != AV_PIX_FMT_YUV420P || !(context->codec->capabilities & AV_CODEC_CAP_DR1))
+        return avcodec_default_get_buffer2(context, frame, flags);
+
+    int width = frame->width;
+    int height = frame->height;
+    avcodec_align_dimensions(context, &width, &height);
+
+    int y_stride = GST_ROUND_UP_N(width, 2 * AV_VIDEO_DECODER_FRAME_ALIGN);
+    int uv_stride = y_stride / 2;
+    gsize y_size = (gsize)y_stride * height;
+    gsize uv_size = (gsize)uv_stride * ((height + 1) / 2);
+
+    GstBuffer *buffer = videodecoder_acquire_buffer(decoder, y_size + 2 * uv_size + AV_VIDEO_DECODER_FRAME_PADDING);
+    if (buffer == NULL)
+        return AVERROR(ENOMEM);
+
+    PooledFrame *pooled = g_slice_new(PooledFrame);
+    pooled->decoder = decoder;
+    pooled->buffer = buffer;
+    if (!gst_buffer_map(buffer, &pooled->info, GST_MAP_READWRITE))
+    {
+        videodecoder_release_buffer(decoder, buffer);
+        g_slice_free(PooledFrame, pooled);
+        return AVERROR(ENOMEM);
+    }
+
+    frame->buf[0] = av_buffer_create(pooled->info.data, pooled->info.size, videodecoder_release_frame, pooled, 0);
+    if (frame->buf[0] == NULL)
+    {
+        videodecoder_release_frame(pooled, NULL);
+        return AVERROR(ENOMEM);
+    }
+
+    g_mutex_lock(&decoder->pool_lock);
+    g_hash_table_insert(decoder->pooled_frames, pooled->info.data, pooled);
+    g_mutex_unlock(&decoder->pool_lock);
+
+    frame->data[0] = pooled->info.data;
+    frame->data[1] = frame->data[0] + y_size;
+    frame->data[2] = frame->data[1] + uv_size;
+    frame->linesize[0] = y_stride;
+    frame->linesize[1] = uv_stride;
+    frame->linesize[2] = uv_stride;
+    frame->extended_data = frame->data;
+
+    return 0;
+}
+
+// The pool buffer [frame] was decoded into, or NULL. Frames libavcodec
+// allocated itself are not in the table, whatever their format.
+static GstBuffer* videodecoder_frame_buffer(VideoDecoder *decoder, AVFrame *frame)
+{
+    if (frame->format != AV_PIX_FMT_YUV420P || frame->buf[0] == NULL)
+        return NULL;
+
+    g_mutex_lock(&decoder->pool_lock);
+    PooledFrame *pooled = (PooledFrame*)g_hash_table_lookup(decoder->pooled_frames, frame->buf[0]->data);
+    g_mutex_unlock(&decoder->pool_lock);
+
+    // The frame holds a reference to the pool buffer, which stays valid.
+    return pooled ? pooled->buffer : NULL;
+}
+
+#endif // NEW_GET_BUFFER
+
+/***********************************************************************************
+ * Codec context
+ ***********************************************************************************/
+static void videodecoder_init_context(BaseDecoder *base)
+{
+    VideoDecoder *decoder = VIDEODECODER(base);
+
+    BASEDECODER_CLASS(parent_class)->init_context(base);
+
+    // Frame threading decodes consecutive frames in parallel (at the cost of
+    // one frame of delay per thread), slice threading the slices of a frame.
+    // libavcodec picks whichever the stream allows.
+    int threads = decoder->threads;
+    if (threads <= 0)
+        threads = MIN(g_get_num_processors(), AV_VIDEO_DECODER_MAX_AUTO_THREADS);
+
+    base->context->thread_count = threads;
+    base->context->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
+#if NEW_GET_BUFFER
+    base->context->opaque = decoder;
+    base->context->get_buffer2 = videodecoder_get_buffer2;
+#ifdef CODEC_FLAG_EMU_EDGE
+    // The pool buffers have no room for the edges older decoders draw
+    // around the planes.
+    base->context->flags |= CODEC_FLAG_EMU_EDGE;
+#endif
+    base->context->thread_safe_callbacks = 1;
+    // Keeps the buffer references in the frames returned by the decoder.
+    base->context->refcounted_frames = 1;
+#endif
 }
 
 
@@ -176,6 +538,8 @@ videodecoder_change_state(GstElement* element, GstStateChange transition)
     {
         case GST_STATE_CHANGE_PAUSED_TO_READY:
             basedecoder_close_decoder(BASEDECODER(decoder));
+            // After the decoder, which releases its frames.
+            videodecoder_free_pool(decoder);
             break;
         default:
             break;
@@ -208,6 +572,11 @@ static gboolean videodecoder_sink_event(GstPad *pad, GstObject *parent, GstEvent
             BASEDECODER(decoder)->is_flushing = FALSE;
             break;
 
+        case GST_EVENT_EOS:
+            // Output the frames still being decoded before the EOS.
+            videodecoder_drain(decoder);
+            break;
+
         case GST_EVENT_CAPS:
         {
             GstCaps *caps;
@@ -263,6 +632,14 @@ static void videodecoder_init_state(VideoDecoder *decoder)
     decoder->frame_size = 0;
     decoder->discont = FALSE;
 
+    decoder->frames_decoded = 0;
+    decoder->decode_time = 0;
+    decoder->total_decode_time = 0;
+
+    decoder->buffers_allocated = 0;
+    decoder->buffers_reused = 0;
+    decoder->buffers_max = 0;
+
     basedecoder_init_state(BASEDECODER(decoder));
 }
 
@@ -309,19 +686,34 @@ static gboolean videodecoder_configure_sourcepad(VideoDecoder *decoder)
     int height = base->context->height;
 #endif // NEW_CODEC_ID
 
+    // Frames are copied to tightly packed planes, unless they were decoded
+    // into a pool buffer, which is pushed as is.
+    int u_offset = base->frame->linesize[0] * height;
+    int uv_blocksize = base->frame->linesize[1] * height / 2;
+    int v_offset = u_offset + uv_blocksize;
+#if NEW_GET_BUFFER
+    if (videodecoder_frame_buffer(decoder, base->frame))
+    {
+        u_offset = base->frame->data[1] - base->frame->data[0];
+        v_offset = base->frame->data[2] - base->frame->data[0];
+        uv_blocksize = v_offset - u_offset;
+    }
+#endif
+
     if (caps == NULL ||
-        decoder->width != width || decoder->height != height)
+        decoder->width != width || decoder->height != height ||
+        decoder->u_offset != u_offset || decoder->v_offset != v_offset)
     {
         decoder->width = width;
         decoder->height = height;
 
         decoder->discont = (caps != NULL);
 
-        decoder->u_offset = base->frame->linesize[0] * decoder->height;
-        decoder->uv_blocksize = base->frame->linesize[1] * decoder->height / 2;
+        decoder->u_offset = u_offset;
+        decoder->uv_blocksize = uv_blocksize;
 
-        decoder->v_offset = decoder->u_offset + decoder->uv_blocksize;
-        decoder->frame_size = (base->frame->linesize[0] + base->frame->linesize[1]) * decoder->height;
+        decoder->v_offset = v_offset;
+        decoder->frame_size = v_offset + uv_blocksize;
 
         GstCaps *src_caps = gst_caps_new_simple("video/x-raw-yuv",
                                                 "format", G_TYPE_STRING, "YV12",
@@ -357,6 +749,134 @@ static gboolean videodecoder_configure_sourcepad(VideoDecoder *decoder)
 
     return TRUE;
 }
+/***********************************************************************************
+ * Decoding
+ ***********************************************************************************/
+static int videodecoder_decode(VideoDecoder *decoder)
+{
+    BaseDecoder *base = BASEDECODER(decoder);
+
+#if NEW_GET_BUFFER
+    // Releases the previous frame, pushed downstream or dropped by now.
+    av_frame_unref(base->frame);
+#endif
+
+    gint64 start_time = g_get_monotonic_time();
+    int num_dec = avcodec_decode_video2(base->context, base->frame, &decoder->frame_finished, &decoder->packet);
+
+    decoder->decode_time = g_get_monotonic_time() - start_time;
+    decoder->total_decode_time += decoder->decode_time;
+    if (num_dec >= 0 && decoder->frame_finished > 0)
+        decoder->frames_decoded++;
+
+    return num_dec;
+}
+
+static GstFlowReturn videodecoder_push_frame(VideoDecoder *decoder, GstClockTime duration, gboolean discont)
+{
+    BaseDecoder   *base = BASEDECODER(decoder);
+    GstMapInfo     info;
+
+    if (!videodecoder_configure_sourcepad(decoder))
+        return GST_FLOW_ERROR;
+
+    GstBuffer *outbuf = NULL;
+#if NEW_GET_BUFFER
+    GstBuffer *pooled = videodecoder_frame_buffer(decoder, base->frame);
+    if (pooled)
+    {
+        // Wraps the frame, which goes back to the pool once both libavcodec
+        // (reference frame) and downstream are done with it.
+        outbuf = gst_buffer_new_wrapped_full(GST_MEMORY_FLAG_READONLY, base->frame->data[0],
+                                             decoder->frame_size, 0, decoder->frame_size,
+                                             gst_buffer_ref(pooled), (GDestroyNotify)gst_buffer_unref);
+    }
+    else
+#endif
+    outbuf = gst_buffer_new_allocate(NULL, decoder->frame_size, NULL);
+    if (outbuf == NULL)
+    {
+        gst_element_message_full(GST_ELEMENT(decoder), GST_MESSAGE_ERROR,
+                                 GST_STREAM_ERROR, GST_STREAM_ERROR_DECODE,
+                                 ("Decoded video buffer allocation failed"), NULL,
+                                 ("videodecoder.c"), ("videodecoder_push_frame"), 0);
+        return GST_FLOW_OK;
+    }
+
+    GST_BUFFER_OFFSET(outbuf) = base->context->frame_number;
+    if (base->frame->reordered_opaque != AV_NOPTS_VALUE)
+    {
+        GST_BUFFER_TIMESTAMP(outbuf) = base->frame->reordered_opaque;
+        GST_BUFFER_DURATION(outbuf) = duration; // Duration for video usually same
+    }
+
+#if NEW_GET_BUFFER
+    if (pooled == NULL)
+#endif
+    {
+        if (!gst_buffer_map(outbuf, &info, GST_MAP_WRITE))
+        {
+            // INLINE - gst_buffer_unref()
+            gst_buffer_unref(outbuf);
+            gst_element_message_full(GST_ELEMENT(decoder), GST_MESSAGE_ERROR, GST_RESOURCE_ERROR, GST_RESOURCE_ERROR_NO_SPACE_LEFT,
+                             g_strdup("Decoded video buffer allocation failed"), NULL, ("videodecoder.c"), ("videodecoder_push_frame"), 0);
+            return GST_FLOW_OK;
+        }
+
+        // Copy image by parts from different arrays.
+        memcpy(info.data,                     base->frame->data[0], decoder->u_offset);
+        memcpy(info.data + decoder->u_offset, base->frame->data[1], decoder->uv_blocksize);
+        memcpy(info.data + decoder->v_offset, base->frame->data[2], decoder->uv_blocksize);
+
+        gst_buffer_unmap(outbuf, &info);
+    }
+
+    GST_BUFFER_OFFSET_END(outbuf) = GST_BUFFER_OFFSET_NONE;
+
+    if (decoder->discont || discont)
+    {
+#ifdef DEBUG_OUTPUT
+        g_print("Video discont: frame size=%dx%d\n", base->context->width, base->context->height);
+#endif
+        GST_BUFFER_FLAG_SET(outbuf, GST_BUFFER_FLAG_DISCONT);
+        decoder->discont = FALSE;
+    }
+
+#ifdef VERBOSE_DEBUG
+    g_print("videodecoder: pushing buffer ts=%.4f sec", (double)GST_BUFFER_TIMESTAMP(outbuf)/GST_SECOND);
+#endif
+    GstFlowReturn result = gst_pad_push(base->srcpad, outbuf);
+#ifdef VERBOSE_DEBUG
+    g_print(" done, res=%s\n", gst_flow_get_name(result));
+#endif
+    return result;
+}
+
+// With frame threading the decoder holds up to one frame per thread:
+// feed it empty packets until it has returned them all.
+static GstFlowReturn videodecoder_drain(VideoDecoder *decoder)
+{
+    BaseDecoder   *base = BASEDECODER(decoder);
+    GstFlowReturn  result = GST_FLOW_OK;
+
+    if (!base->is_initialized || base->is_flushing)
+        return result;
+
+    do
+    {
+        av_init_packet(&decoder->packet);
+        decoder->packet.data = NULL;
+        decoder->packet.size = 0;
+        if (videodecoder_decode(decoder) < 0)
+            break;
+
+        if (decoder->frame_finished > 0)
+            result = videodecoder_push_frame(decoder, GST_CLOCK_TIME_NONE, FALSE);
+    } while (decoder->frame_finished > 0 && result == GST_FLOW_OK);
+
+    return result;
+}
+
 /***********************************************************************************
  * chain
  ***********************************************************************************/
@@ -367,7 +887,6 @@ static GstFlowReturn videodecoder_chain(GstPad *pad, GstObject *parent, GstBuffe
     GstFlowReturn  result = GST_FLOW_OK;
     int            num_dec = NO_DATA_USED;
     GstMapInfo     info;
-    GstMapInfo     info2;
     gboolean       unmap_buf = FALSE;
 
     if (base->is_flushing)  // Reject buffers in flushing state.
@@ -399,7 +918,7 @@ static GstFlowReturn videodecoder_chain(GstPad *pad, GstObject *parent, GstBuffe
                 base->context->reordered_opaque = GST_BUFFER_TIMESTAMP(buf);
             else
                 base->context->reordered_opaque = AV_NOPTS_VALUE;
-            num_dec = avcodec_decode_video2(base->context, base->frame, &decoder->frame_finished, &decoder->packet);
+            num_dec = videodecoder_decode(decoder);
             av_free_packet(&decoder->packet);
         }
         else
@@ -418,7 +937,7 @@ static GstFlowReturn videodecoder_chain(GstPad *pad, GstObject *parent, GstBuffe
         else
             base->context->reordered_opaque = AV_NOPTS_VALUE;
 
-        num_dec = avcodec_decode_video2(base->context, base->frame, &decoder->frame_finished, &decoder->packet);
+        num_dec = videodecoder_decode(decoder);
     }
 
     if (num_dec < 0)
@@ -431,69 +950,7 @@ static GstFlowReturn videodecoder_chain(GstPad *pad, GstObject *parent, GstBuffe
     }
 
     if (decoder->frame_finished > 0)
-    {
-        if (!videodecoder_configure_sourcepad(decoder))
-            result = GST_FLOW_ERROR;
-        else
-        {
-            GstBuffer *outbuf = gst_buffer_new_allocate(NULL, decoder->frame_size, NULL);
-            if (outbuf == NULL)
-            {
-                if (result != GST_FLOW_FLUSHING)
-                {
-                    gst_element_message_full(GST_ELEMENT(decoder), GST_MESSAGE_ERROR,
-                                             GST_STREAM_ERROR, GST_STREAM_ERROR_DECODE,
-                                             ("Decoded video buffer allocation failed"), NULL,
-                                             ("videodecoder.c"), ("videodecoder_chain"), 0);
-                }
-            }
-            else
-            {
-                GST_BUFFER_OFFSET(outbuf) = base->context->frame_number;
-                if (base->frame->reordered_opaque != AV_NOPTS_VALUE)
-                {
-                    GST_BUFFER_TIMESTAMP(outbuf) = base->frame->reordered_opaque;
-                    GST_BUFFER_DURATION(outbuf) = GST_BUFFER_DURATION(buf); // Duration for video usually same
-                }
-
-                if (!gst_buffer_map(outbuf, &info2, GST_MAP_WRITE))
-                {
-                    // INLINE - gst_buffer_unref()
-                    gst_buffer_unref(outbuf);
-                    gst_element_message_full(GST_ELEMENT(decoder), GST_MESSAGE_ERROR, GST_RESOURCE_ERROR, GST_RESOURCE_ERROR_NO_SPACE_LEFT,
-                                     g_strdup("Decoded video buffer allocation failed"), NULL, ("videodecoder.c"), ("videodecoder_chain"), 0);
-                    goto _exit;
-                }
-
-                // Copy image by parts from different arrays.
-                memcpy(info2.data,                     base->frame->data[0], decoder->u_offset);
-                memcpy(info2.data + decoder->u_offset, base->frame->data[1], decoder->uv_blocksize);
-                memcpy(info2.data + decoder->v_offset, base->frame->data[2], decoder->uv_blocksize);
-
-                gst_buffer_unmap(outbuf, &info2);
-
-                GST_BUFFER_OFFSET_END(outbuf) = GST_BUFFER_OFFSET_NONE;
-
-                if (decoder->discont || GST_BUFFER_IS_DISCONT(buf))
-                {
-#ifdef DEBUG_OUTPUT
-                    g_print("Video discont: frame size=%dx%d\n", base->context->width, base->context->height);
-#endif
-                    GST_BUFFER_FLAG_SET(outbuf, GST_BUFFER_FLAG_DISCONT);
-                    decoder->discont = FALSE;
-                }
-
-
-#ifdef VERBOSE_DEBUG
-                g_print("videodecoder: pushing buffer ts=%.4f sec", (double)GST_BUFFER_TIMESTAMP(outbuf)/GST_SECOND);
-#endif
-                result = gst_pad_push(base->srcpad, outbuf);
-#ifdef VERBOSE_DEBUG
-                g_print(" done, res=%s\n", gst_flow_get_name(result));
-#endif
-            }
-        }
-    }
+        result = videodecoder_push_frame(decoder, GST_BUFFER_DURATION(buf), GST_BUFFER_IS_DISCONT(buf));
 
 _exit:
     if (unmap_buf)
@@ -43,6 +43,13 @@ G_BEGIN_DECLS
 
 #define AV_VIDEO_DECODER_PLUGIN_NAME "avvideodecoder"
 
+// Upper bound of the number of decoding threads picked automatically.
+#define AV_VIDEO_DECODER_MAX_AUTO_THREADS 16
+
+// Alignment and tail padding of the pooled frame buffers, for SIMD code.
+#define AV_VIDEO_DECODER_FRAME_ALIGN      64
+#define AV_VIDEO_DECODER_FRAME_PADDING    64
+
 typedef struct _VideoDecoder      VideoDecoder;
 typedef struct _VideoDecoderClass VideoDecoderClass;
 
@@ -60,6 +67,26 @@ struct _VideoDecoder {
     int         uv_blocksize;
 
     AVPacket       packet;
+
+    gint        threads;        // decoding threads, 0 for one per core
+
+    // Decoding statistics of the current stream.
+    guint64     frames_decoded;
+    guint64     decode_time;    // last frame, in microseconds
+    guint64     total_decode_time;
+
+    // Frames are decoded straight into the buffers of this pool (libavcodec
+    // with get_buffer2 and I420 output only), pushed downstream as is.
+    GMutex          pool_lock;  // get_buffer2 is called by the decoding threads
+    GstBufferPool  *pool;
+    gsize           pool_buffer_size;
+    guint           buffers_in_use;     // pool buffers referenced by libavcodec
+    GHashTable     *pooled_frames;      // their PooledFrame, by data address
+
+    // Pool statistics of the current stream.
+    guint64     buffers_allocated;
+    guint64     buffers_reused;
+    guint       buffers_max;            // high water mark of buffers_in_use
 };
 
 struct _VideoDecoderClass
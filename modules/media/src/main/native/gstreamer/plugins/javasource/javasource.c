@@ -33,6 +33,7 @@ GST_DEBUG_CATEGORY (java_source_debug);
 #define _BS(val) (val ? "TRUE" : "FALSE")
 #define BUFFER_SIZE 4096
 #define MAX_READ_SIZE 65536
+#define MAX_BLOCK_SIZE (256 * 1024) // Largest block read in push mode
 
 /***********************************************************************************
 * HLS Properties and Values
@@ -53,6 +54,8 @@ enum
     SIGNAL_CLOSE_CONNECTION,
     SIGNAL_PROPERTY,
     SIGNAL_GET_STREAM_SIZE,
+    SIGNAL_READ_NEXT_BUFFER,
+    SIGNAL_READ_BUFFER,
     LAST_SIGNAL
 };
 
@@ -105,6 +108,7 @@ struct _JavaSource
     gchar*        location; // property controlled
     gchar*        mimetype; // property controlled
     gdouble       rate;
+    gint          block_size; // Size of the next read in push mode
 };
 
 struct _JavaSourceClass
@@ -293,6 +297,30 @@ static void java_source_class_init (JavaSourceClass *klass)
         source_marshal_INT__VOID,
         G_TYPE_INT, /* return_type */
         0    /* n_params */ );
+
+    // Same as read-next-block and read-block followed by copy-block, but the data is
+    // read into a GstBuffer the handler creates (third parameter, GstBuffer**).
+    klass->signals[SIGNAL_READ_NEXT_BUFFER] = g_signal_new ("read-next-buffer",
+        G_TYPE_FROM_CLASS (klass),
+        G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+        0,
+        NULL, /* accumulator */
+        NULL, /* accu_data */
+        source_marshal_INT__INT_POINTER,
+        G_TYPE_INT, /* return_type */
+        2     /* n_params */,
+        G_TYPE_INT, G_TYPE_POINTER);
+
+    klass->signals[SIGNAL_READ_BUFFER] = g_signal_new ("read-buffer",
+        G_TYPE_FROM_CLASS (klass),
+        G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+        0,
+        NULL, /* accumulator */
+        NULL, /* accu_data */
+        source_marshal_INT__UINT64_UINT_POINTER,
+        G_TYPE_INT, /* return_type */
+        3     /* n_params */,
+        G_TYPE_UINT64, G_TYPE_UINT, G_TYPE_POINTER);
 }
 
 static void java_source_init(JavaSource *element)
@@ -314,6 +342,8 @@ static void java_source_init(JavaSource *element)
 
     element->rate = 1.0; // Default to 1.0
 
+    element->block_size = BUFFER_SIZE;
+
     element->mimetype = NULL;
 }
 
@@ -538,6 +568,52 @@ static gboolean java_source_event(GstPad *pad, GstObject *parent, GstEvent *even
 /***********************************************************************************
 * source pad loop
 ***********************************************************************************/
+/* Reads the next block of the stream into a new buffer. Returns the size of
+ * the buffer, or 0, EOS_CODE or OTHER_ERROR_CODE with no buffer. A NULL
+ * buffer with a positive size means it couldn't be allocated.
+ */
+static gint java_source_read_next_block(JavaSource *element, GstBuffer **buffer)
+{
+    JavaSourceClass *klass = JAVA_SOURCE_GET_CLASS(element);
+    gint     size = 0;
+    GstMapInfo info;
+
+    *buffer = NULL;
+
+    if (g_signal_has_handler_pending(element, klass->signals[SIGNAL_READ_NEXT_BUFFER], 0, FALSE))
+    {
+        g_signal_emit(element, klass->signals[SIGNAL_READ_NEXT_BUFFER], 0, element->block_size, buffer, &size);
+
+        // Sources that fill the blocks are read in larger ones, with fewer calls to Java,
+        // and the block size goes down again for sources that deliver less at once.
+        if (size == element->block_size)
+            element->block_size = MIN(2 * element->block_size, MAX_BLOCK_SIZE);
+        else if (size > 0 && size < element->block_size / 4)
+            element->block_size = MAX(element->block_size / 2, BUFFER_SIZE);
+
+        return size;
+    }
+
+    g_signal_emit(element, klass->signals[SIGNAL_READ_NEXT_BLOCK], 0, &size);
+    if (size > 0)
+    {
+        *buffer = gst_buffer_new_allocate(NULL, size, NULL);
+        if (*buffer && !gst_buffer_map(*buffer, &info, GST_MAP_WRITE))
+        {
+            gst_buffer_unref(*buffer);
+            *buffer = NULL;
+        }
+
+        if (*buffer)
+        {
+            g_signal_emit(element, klass->signals[SIGNAL_COPY_BLOCK], 0, info.data, size);
+            gst_buffer_unmap(*buffer, &info);
+        }
+    }
+
+    return size;
+}
+
 static void java_source_loop(void *user_data)
 {
     JavaSource   *element = JAVA_SOURCE(user_data);
@@ -628,26 +704,16 @@ next_event:
 
         case GST_EVENT_UNKNOWN: // Pushing buffers
             {
-                gint     size;
-                GstMapInfo info;
-                g_signal_emit(element, JAVA_SOURCE_GET_CLASS(element)->signals[SIGNAL_READ_NEXT_BLOCK], 0, &size);
+                GstBuffer *buffer = NULL;
+                gint     size = java_source_read_next_block(element, &buffer);
                 if (size > 0)
                 {
-                    GstBuffer *buffer = gst_buffer_new_allocate(NULL, size, NULL);
-                    if (buffer)
+                    if (buffer == NULL)
+                        result = GST_FLOW_ERROR;
+                    else
                     {
                         GST_BUFFER_OFFSET(buffer) = element->position;
 
-                        if (!gst_buffer_map(buffer, &info, GST_MAP_WRITE))
-                        {
-                            result = GST_FLOW_ERROR;
-                            break;
-                        }
-
-                        g_signal_emit(element, JAVA_SOURCE_GET_CLASS(element)->signals[SIGNAL_COPY_BLOCK], 0, info.data, size);
-
-                        gst_buffer_unmap(buffer, &info);
-
                         if (element->discont)
                         {
                             buffer = gst_buffer_make_writable (buffer);
@@ -809,9 +875,26 @@ static GstFlowReturn java_source_getrange(GstPad *pad, GstObject *parent, guint6
     guint    read = 0;
     guint    toRead = 0;
     GstMapInfo info;
+    GstBuffer *buf = NULL;
+
+    // The whole range is read at once, straight into the memory of the buffer.
+    if (g_signal_has_handler_pending(element, JAVA_SOURCE_GET_CLASS(element)->signals[SIGNAL_READ_BUFFER], 0, FALSE))
+    {
+        g_signal_emit(element, JAVA_SOURCE_GET_CLASS(element)->signals[SIGNAL_READ_BUFFER], 0, offset, length, &buf, &size);
+        if (size > 0 && buf != NULL)
+        {
+            GST_BUFFER_OFFSET(buf) = offset;
+            *buffer = buf;
+            return GST_FLOW_OK;
+        }
+        else if (size == EOS_CODE || size == 0)
+            return GST_FLOW_EOS; // See below for 0
+        else
+            return GST_FLOW_ERROR;
+    }
 
     // Do not read from Java more then MAX_READ_SIZE, so we do not allocate very large objects in Java
-    GstBuffer *buf = gst_buffer_new_allocate(NULL, length, NULL);
+    buf = gst_buffer_new_allocate(NULL, length, NULL);
     if (buf == NULL)
         return GST_FLOW_ERROR;
 
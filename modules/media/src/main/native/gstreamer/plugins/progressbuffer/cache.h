@@ -33,8 +33,19 @@ typedef struct _Cache Cache;
 void      cache_static_init(void); // Must be called only once from the ProgressBuffer class initializer
 
 Cache*    create_cache();
+/* Creates a cache for a stream of [size] bytes. Block indexed caches keep
+ * streams of at most [memory_limit] bytes in memory instead of a file.
+ * Other caches are the same as the ones create_cache() returns.
+ */
+Cache*    create_sized_cache(gint64 size, gint64 memory_limit);
 void      destroy_cache(Cache* instance);
 
+/* Returns TRUE if the cache keeps everything written to it, at the position
+ * it was written to, until it is destroyed. Otherwise only the data written
+ * since the last cache_set_write_position() call can be read.
+ */
+gboolean       cache_is_block_indexed(Cache* cache);
+
 // Writes a buffer.
 void           cache_write_buffer(Cache* cache, GstBuffer* buffer);
 
@@ -60,4 +71,7 @@ gboolean       cache_set_read_position(Cache* cache, gint64 position);
 // Returns true if the cache has enough data for fluent reading, but we can't expect more than total.
 gboolean       cache_has_enough_data(Cache* cache);
 
+// Returns the first position in [start, stop) that can't be read yet, or stop.
+gint64         cache_get_missing_position(Cache* cache, gint64 start, gint64 stop);
+
 #endif // __CACHE_H__
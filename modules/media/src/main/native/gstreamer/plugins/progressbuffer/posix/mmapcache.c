@@ -0,0 +1,426 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * Progress buffer cache that hands out buffers wrapping its storage instead
+ * of copies of it.
+ *
+ * The data is written with pwrite() to an unlinked temporary file, and read
+ * through a shared read-only mapping of it. Sized caches of small streams
+ * keep the data in memory instead. The storage is reference counted: buffers
+ * keep it alive after the cache is destroyed or remapped.
+ *
+ * Sized caches are block indexed: a bitmap of the blocks written so far
+ * lets the data downloaded before a seek of the source be read again after
+ * it. The data written since the last cache_set_write_position() call is
+ * tracked to the byte, so the blocks partly written when the write position
+ * moves are lost.
+ */
+
+#include <cache.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+
+#define READ_BUFFER_SIZE  (64 * 1024) // Largest buffer cache_read_buffer() returns
+#define MIN_MAPPING_SIZE  (1024 * 1024)
+#define BLOCK_SHIFT       16
+#define BLOCK_SIZE        (1 << BLOCK_SHIFT)
+
+static const char *tempDir = NULL;
+
+typedef struct _CacheStorage
+{
+    volatile gint ref_count;
+    guint8*       data;
+    gsize         size;
+    gboolean      mapped; // Unmapped or freed when the last reference is released.
+} CacheStorage;
+
+struct _Cache
+{
+    int           handle;     // -1 when the data is in memory.
+    CacheStorage* storage;    // NULL while unmapped, or if it can't be mapped.
+    gint64        size;       // -1 when unknown.
+    guint8*       blocks;     // Bitmap of the blocks written, sized caches only.
+
+    gint64        write_start; // Where the writes since the last seek started.
+    gint64        read_position;
+    gint64        write_position;
+};
+
+void cache_static_init(void)
+{
+    tempDir = g_get_tmp_dir();
+}
+
+/***********************************************************************************
+ * Storage
+ ***********************************************************************************/
+static CacheStorage* cache_storage_new(guint8 *data, gsize size, gboolean mapped)
+{
+    CacheStorage *storage = g_slice_new(CacheStorage);
+    storage->ref_count = 1;
+    storage->data = data;
+    storage->size = size;
+    storage->mapped = mapped;
+    return storage;
+}
+
+static CacheStorage* cache_storage_ref(CacheStorage *storage)
+{
+    g_atomic_int_inc(&storage->ref_count);
+    return storage;
+}
+
+static void cache_storage_unref(CacheStorage *storage)
+{
+    if (g_atomic_int_dec_and_test(&storage->ref_count))
+    {
+        if (storage->mapped)
+            munmap(storage->data, storage->size);
+        else
+            g_free(storage->data);
+        g_slice_free(CacheStorage, storage);
+    }
+}
+
+/* Makes sure the file is mapped up to [stop]. Files that grow are mapped
+ * past their end, with room to grow; only the bytes written are accessed.
+ */
+static gboolean cache_map(Cache* cache, gint64 stop)
+{
+    gint64 size;
+    void  *data;
+
+    if (cache->storage && (gint64)cache->storage->size >= stop)
+        return TRUE;
+    if (cache->handle < 0)
+        return FALSE;
+
+    if (cache->size >= 0)
+        size = cache->size;
+    else
+    {
+        size = MAX(stop, MIN_MAPPING_SIZE);
+        if (cache->storage)
+            size = MAX(size, 2 * (gint64)cache->storage->size);
+    }
+    if (size <= 0 || size > G_MAXSSIZE)
+        return FALSE;
+
+    data = mmap(NULL, (size_t)size, PROT_READ, MAP_SHARED, cache->handle, 0);
+    if (data == MAP_FAILED)
+        return FALSE;
+
+    // Buffers still reference the previous mapping.
+    if (cache->storage)
+        cache_storage_unref(cache->storage);
+    cache->storage = cache_storage_new((guint8*)data, (gsize)size, TRUE);
+    return TRUE;
+}
+
+// A buffer of the data in [position, position + size), that must have been written.
+static GstBuffer* cache_create_buffer(Cache* cache, gint64 position, guint size)
+{
+    GstBuffer *buffer = NULL;
+    guint8    *data;
+    guint      read_bytes = 0;
+
+    if (cache_map(cache, position + size))
+        return gst_buffer_new_wrapped_full(GST_MEMORY_FLAG_READONLY, cache->storage->data + position, size, 0, size,
+                                           cache_storage_ref(cache->storage), (GDestroyNotify)cache_storage_unref);
+
+    // Copy when the file can't be mapped, e.g. when out of address space.
+    data = (guint8*)g_try_malloc(size);
+    if (data == NULL)
+        return NULL;
+
+    while (read_bytes < size)
+    {
+        ssize_t result = pread(cache->handle, data + read_bytes, size - read_bytes, position + read_bytes);
+        if (result > 0)
+            read_bytes += result;
+        else if (result == 0 || errno != EINTR)
+            break;
+    }
+
+    if (read_bytes == size)
+        buffer = gst_buffer_new_wrapped_full(0, data, size, 0, size, data, g_free);
+    else
+        g_free(data); // Read error, deleting buffer to avoid leaking.
+
+    return buffer;
+}
+
+/***********************************************************************************
+ * Block index
+ ***********************************************************************************/
+static inline gboolean cache_block_is_written(Cache* cache, gint64 block)
+{
+    return (cache->blocks[block >> 3] >> (block & 7)) & 1;
+}
+
+// Marks the blocks completed by writing [start, stop) after [write_start, start).
+static void cache_mark_blocks(Cache* cache, gint64 start, gint64 stop)
+{
+    gint64 block = MAX((cache->write_start + BLOCK_SIZE - 1) >> BLOCK_SHIFT, start >> BLOCK_SHIFT);
+    // The last block ends at the end of the stream.
+    gint64 end = (stop == cache->size) ? (stop + BLOCK_SIZE - 1) >> BLOCK_SHIFT : stop >> BLOCK_SHIFT;
+
+    for (; block < end; block++)
+        cache->blocks[block >> 3] |= 1 << (block & 7);
+}
+
+gint64 cache_get_missing_position(Cache* cache, gint64 start, gint64 stop)
+{
+    gint64 position = start;
+
+    if (start < 0)
+        return start;
+
+    while (position < stop)
+    {
+        if (position >= cache->write_start && position < cache->write_position)
+            position = cache->write_position;
+        else if (cache->blocks && position < cache->size && cache_block_is_written(cache, position >> BLOCK_SHIFT))
+            position = MIN(((position >> BLOCK_SHIFT) + 1) << BLOCK_SHIFT, cache->size);
+        else
+            return position;
+    }
+
+    return stop;
+}
+
+/***********************************************************************************
+ * Cache
+ ***********************************************************************************/
+// Opens a new unlinked temporary file.
+static gboolean cache_open_file(Cache* cache)
+{
+    gchar *filename = g_build_filename(tempDir, "jfxmpbXXXXXX", NULL);
+    if (filename == NULL)
+        return FALSE;
+
+    cache->handle = g_mkstemp_full(filename, O_RDWR, S_IRUSR|S_IWUSR);
+    if (cache->handle >= 0 && unlink(filename) < 0)
+    {
+        close(cache->handle);
+        cache->handle = -1;
+    }
+    g_free(filename);
+
+    return cache->handle >= 0;
+}
+
+static Cache* cache_new(gint64 size, gint64 memory_limit)
+{
+    Cache* result = (Cache*)g_try_malloc0(sizeof(Cache));
+    if (result == NULL)
+        return NULL;
+
+    result->handle = -1;
+    result->size = size;
+
+    if (size > 0)
+    {
+        result->blocks = (guint8*)g_try_malloc0((((size + BLOCK_SIZE - 1) >> BLOCK_SHIFT) + 7) >> 3);
+        if (result->blocks == NULL)
+            goto _error_exit;
+
+        if (size <= memory_limit)
+        {
+            guint8 *data = (guint8*)g_try_malloc(size);
+            if (data)
+            {
+                result->storage = cache_storage_new(data, size, FALSE);
+                return result;
+            }
+        }
+    }
+
+    if (!cache_open_file(result))
+        goto _error_exit;
+
+    // Sparse file, mapped at once.
+    if (size > 0 && ftruncate(result->handle, size) < 0)
+    {
+        close(result->handle);
+        goto _error_exit;
+    }
+
+    return result;
+
+_error_exit:
+    g_free(result->blocks);
+    g_free(result);
+    return NULL;
+}
+
+Cache* create_cache()
+{
+    return cache_new(-1, 0);
+}
+
+Cache* create_sized_cache(gint64 size, gint64 memory_limit)
+{
+    return cache_new(size > 0 ? size : -1, memory_limit);
+}
+
+void destroy_cache(Cache* instance)
+{
+    if (instance->storage)
+        cache_storage_unref(instance->storage);
+    if (instance->handle >= 0)
+        close(instance->handle);
+    g_free(instance->blocks);
+
+    g_free(instance);
+}
+
+gboolean cache_is_block_indexed(Cache* cache)
+{
+    return cache->blocks != NULL;
+}
+
+void cache_write_buffer(Cache* cache, GstBuffer* buffer)
+{
+    GstMapInfo info;
+    if (gst_buffer_map(buffer, &info, GST_MAP_READ))
+    {
+        gsize size = info.size;
+        gsize written = 0;
+
+        if (cache->size >= 0)
+            size = (gsize)CLAMP(cache->size - cache->write_position, 0, (gint64)size);
+
+        if (cache->handle < 0)
+        {
+            memcpy(cache->storage->data + cache->write_position, info.data, size);
+            written = size;
+        }
+        else
+        {
+            while (written < size)
+            {
+                ssize_t result = pwrite(cache->handle, info.data + written, size - written, cache->write_position + written);
+                if (result > 0)
+                    written += result;
+                else if (result == 0 || errno != EINTR)
+                    break;
+            }
+        }
+
+        if (written > 0)
+        {
+            if (cache->blocks)
+                cache_mark_blocks(cache, cache->write_position, cache->write_position + written);
+            cache->write_position += written;
+        }
+        gst_buffer_unmap(buffer, &info);
+    }
+}
+
+gint64 cache_read_buffer(Cache* cache, GstBuffer** buffer)
+{
+    gint64 size = cache_get_missing_position(cache, cache->read_position, cache->read_position + READ_BUFFER_SIZE) - cache->read_position;
+
+    *buffer = NULL;
+    if (size > 0)
+    {
+        *buffer = cache_create_buffer(cache, cache->read_position, (guint)size);
+        if (*buffer != NULL)
+        {
+            GST_BUFFER_OFFSET(*buffer) = cache->read_position;
+            cache->read_position += size;
+            return cache->read_position;
+        }
+    }
+
+    return 0;
+}
+
+GstFlowReturn cache_read_buffer_from_position(Cache* cache, gint64 start_position, guint size, GstBuffer** buffer)
+{
+    GstFlowReturn result = GST_FLOW_ERROR;
+    *buffer = NULL;
+
+    if (cache_set_read_position(cache, start_position) &&
+        cache_get_missing_position(cache, start_position, start_position + size) == start_position + size)
+    {
+        *buffer = cache_create_buffer(cache, start_position, size);
+        if (*buffer != NULL)
+        {
+            GST_BUFFER_OFFSET(*buffer) = cache->read_position;
+            cache->read_position += size;
+            result = GST_FLOW_OK;
+        }
+    }
+    return result;
+}
+
+gboolean cache_set_write_position(Cache* cache, gint64 position)
+{
+    if (position < 0 || (cache->size >= 0 && position > cache->size))
+        return FALSE;
+
+    // Data read from sequential caches is overwritten when they are rewound.
+    // The buffers that still map it keep the old file, and a new one is used.
+    if (!cache->blocks && position < cache->write_position &&
+        cache->storage && g_atomic_int_get(&cache->storage->ref_count) > 1)
+    {
+        int handle = cache->handle;
+        if (!cache_open_file(cache))
+        {
+            cache->handle = handle;
+            return FALSE;
+        }
+        close(handle);
+        cache_storage_unref(cache->storage);
+        cache->storage = NULL;
+    }
+
+    // Only block indexed caches keep the data written before.
+    cache->write_start = cache->write_position = position;
+    return TRUE;
+}
+
+gboolean cache_set_read_position(Cache* cache, gint64 position)
+{
+    if (position < 0 || (cache->size >= 0 && position > cache->size))
+        return FALSE;
+
+    cache->read_position = position;
+    return TRUE;
+}
+
+gboolean cache_has_enough_data(Cache* cache)
+{
+    return cache_get_missing_position(cache, cache->read_position, cache->read_position + 1) > cache->read_position;
+}
@@ -48,7 +48,8 @@ enum
     PROP_THRESHOLD,
     PROP_BANDWIDTH,
     PROP_PREBUFFER_TIME,
-    PROP_WAIT_TOLERANCE
+    PROP_WAIT_TOLERANCE,
+    PROP_MEMORY_LIMIT
 };
 
 /***********************************************************************************
@@ -85,6 +86,7 @@ struct _ProgressBuffer
     gdouble       bandwidth; // property accessible.
     gdouble       prebuffer_time; // property controlled.
     gdouble       wait_tolerance; // property controlled.
+    gint64        memory_limit; // property controlled.
     GTimer        *bandwidth_timer;
 
     gboolean      unexpected;
@@ -237,6 +239,15 @@ static void progress_buffer_class_init (ProgressBufferClass *klass)
                                                           2.0  /* default value */,
                                                           G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
 
+    g_object_class_install_property (gobject_class, PROP_MEMORY_LIMIT,
+                                     g_param_spec_int64 ("memory-limit",
+                                                         "Memory cache limit",
+                                                         "Streams of up to memory-limit bytes are cached in memory instead of a file, where supported.",
+                                                         0  /* minimum value */,
+                                                         G_MAXINT64 /* maximum value */,
+                                                         8 * 1024 * 1024  /* default value */,
+                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
     cache_static_init();
 }
 
@@ -288,6 +299,9 @@ static void progress_buffer_set_property (GObject *object, guint property_id,
         case PROP_WAIT_TOLERANCE:
             element->wait_tolerance = g_value_get_double(value);
             break;
+        case PROP_MEMORY_LIMIT:
+            element->memory_limit = g_value_get_int64(value);
+            break;
 
         default:
             break;
@@ -321,6 +335,10 @@ static void progress_buffer_get_property (GObject *object, guint property_id,
             g_value_set_double(value, element->wait_tolerance);
             break;
 
+        case PROP_MEMORY_LIMIT:
+            g_value_set_int64(value, element->memory_limit);
+            break;
+
         default:
             break;
     }
@@ -627,7 +645,7 @@ static GstFlowReturn progress_buffer_enqueue_item(ProgressBuffer *element, GstMi
                     if (element->cache)
                         destroy_cache(element->cache);
 
-                    element->cache = create_cache();
+                    element->cache = create_sized_cache(segment.stop, element->memory_limit);
                     if (!element->cache)
                     {
                         gst_element_message_full(GST_ELEMENT(element), GST_MESSAGE_ERROR, GST_RESOURCE_ERROR, GST_RESOURCE_ERROR_OPEN_READ_WRITE,
@@ -637,6 +655,13 @@ static GstFlowReturn progress_buffer_enqueue_item(ProgressBuffer *element, GstMi
                         return GST_FLOW_ERROR;
                     }
                 }
+
+                if (cache_is_block_indexed(element->cache)) // Addressed by stream offsets, keeps the data downloaded before seeks.
+                {
+                    cache_set_write_position(element->cache, segment.start);
+                    cache_set_read_position(element->cache, segment.start);
+                    element->cache_read_offset = 0;
+                }
                 else
                 {
                     cache_set_write_position(element->cache, 0);
@@ -1044,22 +1069,31 @@ static GstFlowReturn progress_buffer_getrange(GstPad *pad, GstObject *parent, gu
     ProgressBuffer *element = PROGRESS_BUFFER(parent);
     GstFlowReturn  result = GST_FLOW_OK;
     guint64        end_position = start_position + size;
+    gint64         seek_position = start_position;
     gboolean       needs_seeking = FALSE;
+    gint64         missing_position = 0;
 
     g_mutex_lock(&element->lock); // Use one lock for push and pull modes
 
+    if (element->sink_segment.stop >= (gint64)end_position)
+        missing_position = cache_get_missing_position(element->cache, start_position - element->cache_read_offset,
+                                                      end_position - element->cache_read_offset) + element->cache_read_offset;
+
     if (element->sink_segment.stop < (gint64)end_position)
         result = GST_FLOW_EOS;
-    else if (element->sink_segment.start <= (gint64)start_position &&
-             element->sink_segment.position >= (gint64)end_position)
-        result = cache_read_buffer_from_position(element->cache, start_position, size, buffer);
+    else if (missing_position == (gint64)end_position)
+        result = cache_read_buffer_from_position(element->cache, start_position - element->cache_read_offset, size, buffer);
     else
     {
 #if ENABLE_SOURCE_SEEKING
-        needs_seeking = element->sink_segment.start > (gint64)start_position;
+        // Block indexed caches still have the data before the first missing byte after the seek.
+        if (cache_is_block_indexed(element->cache))
+            seek_position = missing_position;
+
+        needs_seeking = element->sink_segment.start > seek_position;
         if (needs_seeking)
         {
-            element->range_start = start_position;
+            element->range_start = seek_position;
             reset_eos(element, TRUE);
         }
 #endif
@@ -1084,7 +1118,7 @@ static GstFlowReturn progress_buffer_getrange(GstPad *pad, GstObject *parent, gu
 
     if (needs_seeking)
         gst_pad_push_event(element->sinkpad, gst_event_new_seek(element->sink_segment.rate, GST_FORMAT_BYTES, GST_SEEK_FLAG_NONE,
-            GST_SEEK_TYPE_SET, start_position, GST_SEEK_TYPE_NONE, 0));
+            GST_SEEK_TYPE_SET, seek_position, GST_SEEK_TYPE_NONE, 0));
 
     return result;
 #else
@@ -76,6 +76,11 @@ _error_exit:
     return NULL;
 }
 
+Cache* create_sized_cache(gint64 size, gint64 memory_limit)
+{
+    return create_cache(); // The file grows as data is written.
+}
+
 void destroy_cache(Cache* instance)
 {
     CloseHandle(instance->writeHandle);
@@ -84,6 +89,11 @@ void destroy_cache(Cache* instance)
     g_free(instance);
 }
 
+gboolean cache_is_block_indexed(Cache* cache)
+{
+    return FALSE;
+}
+
 void cache_write_buffer(Cache* cache, GstBuffer* buffer)
 {
     DWORD written = 0;
@@ -191,3 +201,10 @@ gboolean cache_has_enough_data(Cache* cache)
 {
     return cache->read_position < cache->write_position;
 }
+
+gint64 cache_get_missing_position(Cache* cache, gint64 start, gint64 stop)
+{
+    if (start < 0 || start >= cache->write_position)
+        return start;
+    return MIN(stop, cache->write_position);
+}
@@ -29,6 +29,23 @@
 #include "Locator.h"
 #include <stdint.h>
 
+/* Memory stream data is read into by CStreamCallbacks::ReadNextBuffer and
+ * ReadBuffer, that belongs to the callbacks.
+ */
+class CStreamBuffer
+{
+public:
+    virtual void* GetData() = 0;
+
+    /* Release gives the buffer back when done with its data. It may be called
+     * from any thread, and after the callbacks are deleted.
+     */
+    virtual void Release() = 0;
+
+protected:
+    virtual ~CStreamBuffer() {}
+};
+
 class CStreamCallbacks
 {
 public:
@@ -56,6 +73,16 @@ public:
     /* CopyBlock copies the datra from whatever internal buffer to the destination.*/
     virtual void CopyBlock(void* destination, int size) = 0;
 
+    /* ReadNextBuffer reads next available block of data, up to size bytes,
+     * straight into a buffer of the callbacks, that replaces the ReadNextBlock
+     * and CopyBlock pair. On success *buffer is set and must be released.
+     * Returns the same values as ReadNextBlock.
+     */
+    virtual int  ReadNextBuffer(int size, CStreamBuffer** buffer) = 0;
+
+    /* ReadBuffer is ReadNextBuffer for ReadBlock. */
+    virtual int  ReadBuffer(int64_t position, int size, CStreamBuffer** buffer) = 0;
+
     /* Detects whether the source is seekable.*/
     virtual bool IsSeekable() = 0;
 
@@ -48,7 +48,8 @@ public:
     :   m_PipelineType(pipelineType),
         m_bBufferingEnabled(false),
         m_StreamMimeType(-1),
-        m_bHLSModeEnabled(false)
+        m_bHLSModeEnabled(false),
+        m_VideoDecoderThreads(0)
     {}
 
     virtual ~CPipelineOptions() {}
@@ -64,11 +65,16 @@ public:
     inline void SetHLSModeEnabled(bool enabled) { m_bHLSModeEnabled = enabled; }
     inline bool GetHLSModeEnabled() { return m_bHLSModeEnabled; }
 
+    // Number of threads of the video decoder, 0 for one per core.
+    inline void SetVideoDecoderThreads(int threads) { m_VideoDecoderThreads = threads; }
+    inline int GetVideoDecoderThreads() { return m_VideoDecoderThreads; }
+
 private:
     int         m_PipelineType;
     bool        m_bBufferingEnabled;
     int         m_StreamMimeType;
     bool        m_bHLSModeEnabled;
+    int         m_VideoDecoderThreads;
 };
 
 #endif  //_PIPELINE_OPTIONS_H_
@@ -32,6 +32,20 @@
 #define ENABLE_SIMD_SSE2 0
 #endif
 
+#if ENABLE_SIMD_SSE2 && (defined(_MSC_VER) || defined(__clang__) || \
+    (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define ENABLE_SIMD_AVX2 1
+#else
+#define ENABLE_SIMD_AVX2 0
+#endif
+
+// Part of ARMv8, 32 bit ARM builds need to target it.
+#if !ENABLE_SIMD_SSE2 && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define ENABLE_SIMD_NEON 1
+#else
+#define ENABLE_SIMD_NEON 0
+#endif
+
 // --- Begin macros
 #define TCLAMP_U8(val, dst) dst = pClip[val]
 
@@ -41,6 +55,13 @@ int32_t v = s, mask = (v - 0x1fe) >> 31;           \
 \
 dst = (((uint32_t)v >> 1) | ~mask) & ~(v >> 31);    \
 }
+
+// AVX2 code is compiled for functions, and only used when the CPU has it.
+#if ENABLE_SIMD_AVX2 && defined(__GNUC__)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
 // --- End macros
 
 // --- Begin tables
@@ -375,6 +396,123 @@ const uint16_t color_tBU[256] = {
 };
 // --- End tables
 
+// --- Begin SIMD selection
+#if ENABLE_SIMD_AVX2 && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#elif ENABLE_SIMD_AVX2
+#include <cpuid.h>
+#endif
+
+static int color_simd = -1; // Picked by the first conversion.
+
+#if ENABLE_SIMD_AVX2
+static int color_cpu_has_avx2(void)
+{
+#if defined(_MSC_VER)
+    int regs[4];
+
+    __cpuid(regs, 0);
+    if (regs[0] < 7)
+        return 0;
+    // AVX, and the OS saves the YMM registers.
+    __cpuid(regs, 1);
+    if ((regs[2] & 0x18000000) != 0x18000000 || (_xgetbv(0) & 6) != 6)
+        return 0;
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & 0x20) != 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx) || eax < 7)
+        return 0;
+    // AVX, and the OS saves the YMM registers.
+    __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+    if ((ecx & 0x18000000) != 0x18000000)
+        return 0;
+    __asm__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+    if ((eax & 6) != 6)
+        return 0;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx & 0x20) != 0;
+#endif
+}
+#endif // ENABLE_SIMD_AVX2
+
+static int color_simd_supported(ColorConvertSimd simd)
+{
+    switch (simd) {
+        case COLOR_CONVERT_SIMD_NONE:
+            return 1;
+        case COLOR_CONVERT_SIMD_SSE2:
+            return ENABLE_SIMD_SSE2;
+#if ENABLE_SIMD_AVX2
+        case COLOR_CONVERT_SIMD_AVX2:
+            return color_cpu_has_avx2();
+#endif
+        case COLOR_CONVERT_SIMD_NEON:
+            return ENABLE_SIMD_NEON;
+        default:
+            return 0;
+    }
+}
+
+ColorConvertSimd ColorConvert_GetSimd(void)
+{
+    // Threads racing here all store the same value.
+    if (color_simd < 0) {
+        if (color_simd_supported(COLOR_CONVERT_SIMD_AVX2))
+            color_simd = COLOR_CONVERT_SIMD_AVX2;
+        else if (color_simd_supported(COLOR_CONVERT_SIMD_SSE2))
+            color_simd = COLOR_CONVERT_SIMD_SSE2;
+        else if (color_simd_supported(COLOR_CONVERT_SIMD_NEON))
+            color_simd = COLOR_CONVERT_SIMD_NEON;
+        else
+            color_simd = COLOR_CONVERT_SIMD_NONE;
+    }
+
+    return (ColorConvertSimd)color_simd;
+}
+
+int ColorConvert_SetSimd(ColorConvertSimd simd)
+{
+    if (!color_simd_supported(simd))
+        return 1;
+
+    color_simd = simd;
+    return 0;
+}
+
+#if ENABLE_SIMD_NEON
+#include <arm_neon.h>
+
+/*
+ * The lookup tables as arithmetic, for 8 values of [x]: color_tYY[i] is
+ * (i * 9539 + 2007) >> 12 for all i, and so on. The results are the same
+ * as with the tables, which ColorConverterBench checks.
+ */
+#define NEON_TABLE_HALF(x, mul, add, shift) \
+    vreinterpret_s16_u16(vshrn_n_u32(vmlal_n_u16(vdupq_n_u32(add), x, mul), shift))
+#define NEON_TABLE(x, mul, add, shift)                               \
+    vcombine_s16(NEON_TABLE_HALF(vget_low_u16(x), mul, add, shift),  \
+                 NEON_TABLE_HALF(vget_high_u16(x), mul, add, shift))
+
+#define NEON_tYY(x) NEON_TABLE(x, 9539, 2007, 12)
+#define NEON_tRV(x) NEON_TABLE(x, 13079, 2108, 12)
+#define NEON_tGV(x) NEON_TABLE(x, 13323, 4098, 13)
+#define NEON_tBU(x) NEON_TABLE(x, 16535, 2020, 12)
+/* (2226407 - i * 6423) >> 13, never negative */
+#define NEON_tGU(x)                                                                                   \
+    vcombine_s16(vreinterpret_s16_u16(vshrn_n_u32(vmlsl_n_u16(vdupq_n_u32(2226407), vget_low_u16(x), 6423), 13)), \
+                 vreinterpret_s16_u16(vshrn_n_u32(vmlsl_n_u16(vdupq_n_u32(2226407), vget_high_u16(x), 6423), 13)))
+
+/* 16 pixels: clamp((yy + c) >> 1) as TCLAMP_U8, the chroma terms [c] doubled */
+#define NEON_CLAMP_U8(yl, yh, c)                                  \
+    vcombine_u8(vqshrun_n_s16(vaddq_s16(yl, (c).val[0]), 1),      \
+                vqshrun_n_s16(vaddq_s16(yh, (c).val[1]), 1))
+#endif // ENABLE_SIMD_NEON
+// --- End SIMD selection
+
 // --- Begin YCbCr420p conversion functions
 #if ENABLE_SIMD_SSE2
 // --- Begin SSE2 YCbCr420p conversion functions
@@ -439,7 +577,7 @@ __m128i inline_loadu_si128(const __m128i *p)
     cc = _mm_packus_epi16(tt, x_temp1); \
 }
 
-int ColorConvert_YCbCr420p_to_ARGB32(
+static int YCbCr420p_to_ARGB32_sse2(
                                uint8_t *argb,
                                int32_t argb_stride,
                                int32_t width,
@@ -926,7 +1064,7 @@ int ColorConvert_YCbCr420p_to_ARGB32(
     return 0;
 }
 
-int ColorConvert_YCbCr420p_to_ARGB32_no_alpha(
+static int YCbCr420p_to_ARGB32_no_alpha_sse2(
                                      uint8_t *argb,
                                      int32_t argb_stride,
                                      int32_t width,
@@ -1379,7 +1517,7 @@ int ColorConvert_YCbCr420p_to_ARGB32_no_alpha(
     return 0;
 }
 
-int ColorConvert_YCbCr420p_to_BGRA32(
+static int YCbCr420p_to_BGRA32_sse2(
                                      uint8_t *bgra,
                                      int32_t bgra_stride,
                                      int32_t width,
@@ -1893,7 +2031,7 @@ int ColorConvert_YCbCr420p_to_BGRA32(
     return 0;
 }
 
-int ColorConvert_YCbCr420p_to_BGRA32_no_alpha(
+static int YCbCr420p_to_BGRA32_no_alpha_sse2(
                                               uint8_t *bgra,
                                               int32_t bgra_stride,
                                               int32_t width,
@@ -2347,10 +2485,247 @@ int ColorConvert_YCbCr420p_to_BGRA32_no_alpha(
 }
 // --- End SSE2 YCbCr420p conversion functions
 
+#if ENABLE_SIMD_AVX2
+// --- Begin AVX2 YCbCr420p conversion functions
+#include <immintrin.h>
+
+/*
+ * Converts the first (width & ~31) columns, 32 pixels of two rows at a time,
+ * with the same arithmetic as the SSE2 functions above, which convert the
+ * remaining columns: the results do not depend on the instruction set.
+ * As with SSE2, only the BGRA output is premultiplied. [a] may be NULL.
+ */
+TARGET_AVX2
+static void YCbCr420p_to_32bpp_avx2(uint8_t *dst,
+                                    int32_t dst_stride,
+                                    int32_t width,
+                                    int32_t height,
+                                    const uint8_t *y,
+                                    const uint8_t *v,
+                                    const uint8_t *u,
+                                    const uint8_t *a,
+                                    int32_t y_stride,
+                                    int32_t v_stride,
+                                    int32_t u_stride,
+                                    int32_t a_stride,
+                                    int bgra)
+{
+    const __m256i x_c0 = _mm256_set1_epi16(0x2543);
+    const __m256i x_c1 = _mm256_set1_epi16(0x4097);
+    const __m256i x_c4 = _mm256_set1_epi16(0xc8b);
+    const __m256i x_c5 = _mm256_set1_epi16(0x1a06);
+    const __m256i x_c8 = _mm256_set1_epi16(0x3317);
+    const __m256i x_coff0 = _mm256_set1_epi16((int16_t)0xdd60);
+    const __m256i x_coff1 = _mm256_set1_epi16(0x10f4);
+    const __m256i x_coff2 = _mm256_set1_epi16((int16_t)0xe420);
+    const __m256i x_zero = _mm256_setzero_si256();
+    const __m256i x_one = _mm256_set1_epi16(0x0001);
+    const __m256i x_aa = _mm256_set1_epi8((char)0xff);
+
+    int32_t jH, iW, row;
+    __m256i x_u, x_v, x_y, x_yl, x_yh, x_a, x_temp;
+    __m256i x_b, x_g, x_r, x_bl, x_bh, x_gl, x_gh, x_rl, x_rh;
+    __m256i x_l, x_h, x_0, x_1, x_2, x_3;
+
+    for (jH = 0; jH < (height >> 1); jH++) {
+        for (iW = 0; iW <= width - 32; iW += 32) {
+            /* 16 chroma samples in the high bytes, for both rows */
+            x_u = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(u + (iW >> 1))));
+            x_u = _mm256_slli_epi16(x_u, 8);
+            x_v = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(v + (iW >> 1))));
+            x_v = _mm256_slli_epi16(x_v, 8);
+
+            x_b = _mm256_add_epi16(_mm256_mulhi_epu16(x_u, x_c1), x_coff0);
+            x_temp = _mm256_add_epi16(_mm256_mulhi_epu16(x_u, x_c4), _mm256_mulhi_epu16(x_v, x_c5));
+            x_g = _mm256_sub_epi16(x_coff1, x_temp);
+            x_r = _mm256_add_epi16(_mm256_mulhi_epu16(x_v, x_c8), x_coff2);
+
+            /*
+             * Unpacking works within 128 bit lanes: the low half of the
+             * unpacked luma is pixels 0-7 and 16-23, the high half 8-15
+             * and 24-31, which use chroma samples 0-3, 8-11 and 4-7, 12-15.
+             */
+            x_bl = _mm256_unpacklo_epi16(x_b, x_b);
+            x_bh = _mm256_unpackhi_epi16(x_b, x_b);
+            x_gl = _mm256_unpacklo_epi16(x_g, x_g);
+            x_gh = _mm256_unpackhi_epi16(x_g, x_g);
+            x_rl = _mm256_unpacklo_epi16(x_r, x_r);
+            x_rh = _mm256_unpackhi_epi16(x_r, x_r);
+
+            for (row = 0; row < 2; row++) {
+                uint8_t *pd = dst + row * dst_stride + 4 * iW;
+
+                x_y = _mm256_loadu_si256((const __m256i*)(y + row * y_stride + iW));
+                x_yl = _mm256_mulhi_epu16(_mm256_unpacklo_epi8(x_zero, x_y), x_c0);
+                x_yh = _mm256_mulhi_epu16(_mm256_unpackhi_epi8(x_zero, x_y), x_c0);
+
+                /* pack: 16=>8, back in pixel order */
+                x_b = _mm256_packus_epi16(_mm256_srai_epi16(_mm256_add_epi16(x_yl, x_bl), 5),
+                                          _mm256_srai_epi16(_mm256_add_epi16(x_yh, x_bh), 5));
+                x_g = _mm256_packus_epi16(_mm256_srai_epi16(_mm256_add_epi16(x_yl, x_gl), 5),
+                                          _mm256_srai_epi16(_mm256_add_epi16(x_yh, x_gh), 5));
+                x_r = _mm256_packus_epi16(_mm256_srai_epi16(_mm256_add_epi16(x_yl, x_rl), 5),
+                                          _mm256_srai_epi16(_mm256_add_epi16(x_yh, x_rh), 5));
+
+                if (a != NULL) {
+                    x_a = _mm256_loadu_si256((const __m256i*)(a + row * a_stride + iW));
+                    if (bgra) {
+                        /* c * (a + 1) >> 8, as PREMULTIPLY_ALPHA */
+                        x_l = _mm256_add_epi16(_mm256_unpacklo_epi8(x_a, x_zero), x_one);
+                        x_h = _mm256_add_epi16(_mm256_unpackhi_epi8(x_a, x_zero), x_one);
+                        x_b = _mm256_packus_epi16(
+                                _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(x_b, x_zero), x_l), 8),
+                                _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(x_b, x_zero), x_h), 8));
+                        x_g = _mm256_packus_epi16(
+                                _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(x_g, x_zero), x_l), 8),
+                                _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(x_g, x_zero), x_h), 8));
+                        x_r = _mm256_packus_epi16(
+                                _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(x_r, x_zero), x_l), 8),
+                                _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(x_r, x_zero), x_h), 8));
+                    }
+                } else {
+                    x_a = x_aa;
+                }
+
+                /* create bgra or argb sequences: pixels 0-3 and 16-19, 4-7 and 20-23, ... */
+                if (bgra) {
+                    x_l = _mm256_unpacklo_epi8(x_b, x_g);
+                    x_h = _mm256_unpackhi_epi8(x_b, x_g);
+                    x_temp = _mm256_unpacklo_epi8(x_r, x_a);
+                    x_a = _mm256_unpackhi_epi8(x_r, x_a);
+                } else {
+                    x_l = _mm256_unpacklo_epi8(x_a, x_r);
+                    x_h = _mm256_unpackhi_epi8(x_a, x_r);
+                    x_temp = _mm256_unpacklo_epi8(x_g, x_b);
+                    x_a = _mm256_unpackhi_epi8(x_g, x_b);
+                }
+                x_0 = _mm256_unpacklo_epi16(x_l, x_temp);
+                x_1 = _mm256_unpackhi_epi16(x_l, x_temp);
+                x_2 = _mm256_unpacklo_epi16(x_h, x_a);
+                x_3 = _mm256_unpackhi_epi16(x_h, x_a);
+
+                _mm256_storeu_si256((__m256i*)pd, _mm256_permute2x128_si256(x_0, x_1, 0x20));
+                _mm256_storeu_si256((__m256i*)(pd + 32), _mm256_permute2x128_si256(x_2, x_3, 0x20));
+                _mm256_storeu_si256((__m256i*)(pd + 64), _mm256_permute2x128_si256(x_0, x_1, 0x31));
+                _mm256_storeu_si256((__m256i*)(pd + 96), _mm256_permute2x128_si256(x_2, x_3, 0x31));
+            }
+        }
+
+        y += 2 * y_stride;
+        u += u_stride;
+        v += v_stride;
+        if (a != NULL)
+            a += 2 * a_stride;
+        dst += 2 * dst_stride;
+    }
+}
+
+static int YCbCr420p_to_ARGB32_avx2(uint8_t *argb,
+                                    int32_t argb_stride,
+                                    int32_t width,
+                                    int32_t height,
+                                    const uint8_t *y,
+                                    const uint8_t *v,
+                                    const uint8_t *u,
+                                    const uint8_t *a,
+                                    int32_t y_stride,
+                                    int32_t v_stride,
+                                    int32_t u_stride,
+                                    int32_t a_stride)
+{
+    int32_t w = width & ~31;
+
+    if (w > 0)
+        YCbCr420p_to_32bpp_avx2(argb, argb_stride, w, height, y, v, u, a,
+                                y_stride, v_stride, u_stride, a_stride, 0);
+    if (w == width)
+        return 0;
+
+    return YCbCr420p_to_ARGB32_sse2(argb + 4 * w, argb_stride, width - w, height,
+                                    y + w, v + (w >> 1), u + (w >> 1), a + w,
+                                    y_stride, v_stride, u_stride, a_stride);
+}
+
+static int YCbCr420p_to_ARGB32_no_alpha_avx2(uint8_t *argb,
+                                             int32_t argb_stride,
+                                             int32_t width,
+                                             int32_t height,
+                                             const uint8_t *y,
+                                             const uint8_t *v,
+                                             const uint8_t *u,
+                                             int32_t y_stride,
+                                             int32_t v_stride,
+                                             int32_t u_stride)
+{
+    int32_t w = width & ~31;
+
+    if (w > 0)
+        YCbCr420p_to_32bpp_avx2(argb, argb_stride, w, height, y, v, u, NULL,
+                                y_stride, v_stride, u_stride, 0, 0);
+    if (w == width)
+        return 0;
+
+    return YCbCr420p_to_ARGB32_no_alpha_sse2(argb + 4 * w, argb_stride, width - w, height,
+                                             y + w, v + (w >> 1), u + (w >> 1),
+                                             y_stride, v_stride, u_stride);
+}
+
+static int YCbCr420p_to_BGRA32_avx2(uint8_t *bgra,
+                                    int32_t bgra_stride,
+                                    int32_t width,
+                                    int32_t height,
+                                    const uint8_t *y,
+                                    const uint8_t *v,
+                                    const uint8_t *u,
+                                    const uint8_t *a,
+                                    int32_t y_stride,
+                                    int32_t v_stride,
+                                    int32_t u_stride,
+                                    int32_t a_stride)
+{
+    int32_t w = width & ~31;
+
+    if (w > 0)
+        YCbCr420p_to_32bpp_avx2(bgra, bgra_stride, w, height, y, v, u, a,
+                                y_stride, v_stride, u_stride, a_stride, 1);
+    if (w == width)
+        return 0;
+
+    return YCbCr420p_to_BGRA32_sse2(bgra + 4 * w, bgra_stride, width - w, height,
+                                    y + w, v + (w >> 1), u + (w >> 1), a + w,
+                                    y_stride, v_stride, u_stride, a_stride);
+}
+
+static int YCbCr420p_to_BGRA32_no_alpha_avx2(uint8_t *bgra,
+                                             int32_t bgra_stride,
+                                             int32_t width,
+                                             int32_t height,
+                                             const uint8_t *y,
+                                             const uint8_t *v,
+                                             const uint8_t *u,
+                                             int32_t y_stride,
+                                             int32_t v_stride,
+                                             int32_t u_stride)
+{
+    int32_t w = width & ~31;
+
+    if (w > 0)
+        YCbCr420p_to_32bpp_avx2(bgra, bgra_stride, w, height, y, v, u, NULL,
+                                y_stride, v_stride, u_stride, 0, 1);
+    if (w == width)
+        return 0;
+
+    return YCbCr420p_to_BGRA32_no_alpha_sse2(bgra + 4 * w, bgra_stride, width - w, height,
+                                             y + w, v + (w >> 1), u + (w >> 1),
+                                             y_stride, v_stride, u_stride);
+}
+// --- End AVX2 YCbCr420p conversion functions
+#endif // ENABLE_SIMD_AVX2
+
 #else // Generic C implementation
 
 // --- Begin C YCbCr420p conversion functions
-int ColorConvert_YCbCr420p_to_ARGB32(
+static int YCbCr420p_to_ARGB32_c(
                                uint8_t *argb,
                                int32_t argb_stride,
                                int32_t width,
@@ -2367,7 +2742,7 @@ int ColorConvert_YCbCr420p_to_ARGB32(
     return 1; // NOTE: Not implemented
 }
 
-int ColorConvert_YCbCr420p_to_ARGB32_no_alpha(
+static int YCbCr420p_to_ARGB32_no_alpha_c(
                                      uint8_t *argb,
                                      int32_t argb_stride,
                                      int32_t width,
@@ -2382,18 +2757,18 @@ int ColorConvert_YCbCr420p_to_ARGB32_no_alpha(
     return 1; // NOTE: Not implemented
 }
 
-int ColorConvert_YCbCr420p_to_BGRA32(uint8_t *bgra,
-                                     int32_t bgra_stride,
-                                     int32_t width,
-                                     int32_t height,
-                                     const uint8_t *y,
-                                     const uint8_t *v,
-                                     const uint8_t *u,
-                                     const uint8_t *a,
-                                     int32_t y_stride,
-                                     int32_t v_stride,
-                                     int32_t u_stride,
-                                     int32_t a_stride)
+static int YCbCr420p_to_BGRA32_c(uint8_t *bgra,
+                                 int32_t bgra_stride,
+                                 int32_t width,
+                                 int32_t height,
+                                 const uint8_t *y,
+                                 const uint8_t *v,
+                                 const uint8_t *u,
+                                 const uint8_t *a,
+                                 int32_t y_stride,
+                                 int32_t v_stride,
+                                 int32_t u_stride,
+                                 int32_t a_stride)
 {
     int32_t i, j;
     const uint8_t *say1, *say2, *sau, *sav, *sly1, *sly2, *slu, *slv;
@@ -2492,7 +2867,7 @@ int ColorConvert_YCbCr420p_to_BGRA32(uint8_t *bgra,
     return 0;
 }
 
-int ColorConvert_YCbCr420p_to_BGRA32_no_alpha(
+static int YCbCr420p_to_BGRA32_no_alpha_c(
                                               uint8_t *bgra,
                                               int32_t bgra_stride,
                                               int32_t width,
@@ -2587,12 +2962,166 @@ int ColorConvert_YCbCr420p_to_BGRA32_no_alpha(
     return 0;
 }
 // --- End C YCbCr420p conversion functions
+
+#if ENABLE_SIMD_NEON
+// --- Begin NEON YCbCr420p conversion functions
+/*
+ * Converts the first (width & ~15) columns, 16 pixels of two rows at a time,
+ * with the arithmetic of the C functions above, which convert the remaining
+ * columns. The alpha plane [a] is copied as is, or may be NULL.
+ */
+static void YCbCr420p_to_BGRA32_rows_neon(uint8_t *bgra,
+                                          int32_t bgra_stride,
+                                          int32_t width,
+                                          int32_t height,
+                                          const uint8_t *y,
+                                          const uint8_t *v,
+                                          const uint8_t *u,
+                                          const uint8_t *a,
+                                          int32_t y_stride,
+                                          int32_t v_stride,
+                                          int32_t u_stride,
+                                          int32_t a_stride)
+{
+    int32_t jH, iW, row;
+    uint16x8_t x_u, x_v;
+    uint8x16_t x_y;
+    int16x8_t x_yl, x_yh;
+    int16x8x2_t x_b, x_g, x_r;
+    uint8x16x4_t x_bgra;
+
+    for (jH = 0; jH < (height >> 1); jH++) {
+        for (iW = 0; iW <= width - 16; iW += 16) {
+            x_u = vmovl_u8(vld1_u8(u + (iW >> 1)));
+            x_v = vmovl_u8(vld1_u8(v + (iW >> 1)));
+
+            /* chroma terms of 8 pixel pairs, doubled */
+            x_yl = vsubq_s16(NEON_tBU(x_u), vdupq_n_s16(554));
+            x_b = vzipq_s16(x_yl, x_yl);
+            x_yl = vsubq_s16(NEON_tGU(x_u), NEON_tGV(x_v));
+            x_g = vzipq_s16(x_yl, x_yl);
+            x_yl = vsubq_s16(NEON_tRV(x_v), vdupq_n_s16(446));
+            x_r = vzipq_s16(x_yl, x_yl);
+
+            for (row = 0; row < 2; row++) {
+                x_y = vld1q_u8(y + row * y_stride + iW);
+                x_yl = NEON_tYY(vmovl_u8(vget_low_u8(x_y)));
+                x_yh = NEON_tYY(vmovl_u8(vget_high_u8(x_y)));
+
+                x_bgra.val[0] = NEON_CLAMP_U8(x_yl, x_yh, x_b);
+                x_bgra.val[1] = NEON_CLAMP_U8(x_yl, x_yh, x_g);
+                x_bgra.val[2] = NEON_CLAMP_U8(x_yl, x_yh, x_r);
+                x_bgra.val[3] = (a != NULL) ? vld1q_u8(a + row * a_stride + iW) : vdupq_n_u8(0xff);
+                vst4q_u8(bgra + row * bgra_stride + 4 * iW, x_bgra);
+            }
+        }
+
+        y += 2 * y_stride;
+        u += u_stride;
+        v += v_stride;
+        if (a != NULL)
+            a += 2 * a_stride;
+        bgra += 2 * bgra_stride;
+    }
+}
+
+static int YCbCr420p_to_BGRA32_neon(uint8_t *bgra,
+                                    int32_t bgra_stride,
+                                    int32_t width,
+                                    int32_t height,
+                                    const uint8_t *y,
+                                    const uint8_t *v,
+                                    const uint8_t *u,
+                                    const uint8_t *a,
+                                    int32_t y_stride,
+                                    int32_t v_stride,
+                                    int32_t u_stride,
+                                    int32_t a_stride)
+{
+    int32_t w = width & ~15;
+
+    if (bgra == NULL || y == NULL || u == NULL || v == NULL)
+        return 1;
+
+    if (width <= 0 || height <= 0)
+        return 1;
+
+    if ((width | height) & 1)
+        return 1;
+
+    YCbCr420p_to_BGRA32_rows_neon(bgra, bgra_stride, w, height, y, v, u, a,
+                                  y_stride, v_stride, u_stride, a_stride);
+    if (w == width)
+        return 0;
+
+    return YCbCr420p_to_BGRA32_c(bgra + 4 * w, bgra_stride, width - w, height,
+                                 y + w, v + (w >> 1), u + (w >> 1), a + w,
+                                 y_stride, v_stride, u_stride, a_stride);
+}
+
+static int YCbCr420p_to_BGRA32_no_alpha_neon(uint8_t *bgra,
+                                             int32_t bgra_stride,
+                                             int32_t width,
+                                             int32_t height,
+                                             const uint8_t *y,
+                                             const uint8_t *v,
+                                             const uint8_t *u,
+                                             int32_t y_stride,
+                                             int32_t v_stride,
+                                             int32_t u_stride)
+{
+    int32_t w = width & ~15;
+
+    if (bgra == NULL || y == NULL || u == NULL || v == NULL)
+        return 1;
+
+    if (width <= 0 || height <= 0)
+        return 1;
+
+    if ((width | height) & 1)
+        return 1;
+
+    YCbCr420p_to_BGRA32_rows_neon(bgra, bgra_stride, w, height, y, v, u, NULL,
+                                  y_stride, v_stride, u_stride, 0);
+    if (w == width)
+        return 0;
+
+    return YCbCr420p_to_BGRA32_no_alpha_c(bgra + 4 * w, bgra_stride, width - w, height,
+                                          y + w, v + (w >> 1), u + (w >> 1),
+                                          y_stride, v_stride, u_stride);
+}
+// --- End NEON YCbCr420p conversion functions
+#endif // ENABLE_SIMD_NEON
 #endif // ENABLE_SIMD_SSE2
-// --- End YCbCr420p conversion functions
 
-// --- Begin YCbCr422p conversion functions
+int ColorConvert_YCbCr420p_to_ARGB32(uint8_t *argb,
+                                     int32_t argb_stride,
+                                     int32_t width,
+                                     int32_t height,
+                                     const uint8_t *y,
+                                     const uint8_t *v,
+                                     const uint8_t *u,
+                                     const uint8_t *a,
+                                     int32_t y_stride,
+                                     int32_t v_stride,
+                                     int32_t u_stride,
+                                     int32_t a_stride)
+{
+#if ENABLE_SIMD_AVX2
+    if (ColorConvert_GetSimd() == COLOR_CONVERT_SIMD_AVX2)
+        return YCbCr420p_to_ARGB32_avx2(argb, argb_stride, width, height, y, v, u, a,
+                                        y_stride, v_stride, u_stride, a_stride);
+#endif
+#if ENABLE_SIMD_SSE2
+    return YCbCr420p_to_ARGB32_sse2(argb, argb_stride, width, height, y, v, u, a,
+                                    y_stride, v_stride, u_stride, a_stride);
+#else
+    return YCbCr420p_to_ARGB32_c(argb, argb_stride, width, height, y, v, u, a,
+                                 y_stride, v_stride, u_stride, a_stride);
+#endif
+}
 
-int ColorConvert_YCbCr422p_to_ARGB32_no_alpha(uint8_t *argb,
+int ColorConvert_YCbCr420p_to_ARGB32_no_alpha(uint8_t *argb,
                                               int32_t argb_stride,
                                               int32_t width,
                                               int32_t height,
@@ -2600,12 +3129,56 @@ int ColorConvert_YCbCr422p_to_ARGB32_no_alpha(uint8_t *argb,
                                               const uint8_t *v,
                                               const uint8_t *u,
                                               int32_t y_stride,
-                                              int32_t uv_stride)
+                                              int32_t v_stride,
+                                              int32_t u_stride)
 {
-    return 1; // NOTE: Not implemented
+#if ENABLE_SIMD_AVX2
+    if (ColorConvert_GetSimd() == COLOR_CONVERT_SIMD_AVX2)
+        return YCbCr420p_to_ARGB32_no_alpha_avx2(argb, argb_stride, width, height, y, v, u,
+                                                 y_stride, v_stride, u_stride);
+#endif
+#if ENABLE_SIMD_SSE2
+    return YCbCr420p_to_ARGB32_no_alpha_sse2(argb, argb_stride, width, height, y, v, u,
+                                             y_stride, v_stride, u_stride);
+#else
+    return YCbCr420p_to_ARGB32_no_alpha_c(argb, argb_stride, width, height, y, v, u,
+                                          y_stride, v_stride, u_stride);
+#endif
 }
 
-int ColorConvert_YCbCr422p_to_BGRA32_no_alpha(uint8_t *bgra,
+int ColorConvert_YCbCr420p_to_BGRA32(uint8_t *bgra,
+                                     int32_t bgra_stride,
+                                     int32_t width,
+                                     int32_t height,
+                                     const uint8_t *y,
+                                     const uint8_t *v,
+                                     const uint8_t *u,
+                                     const uint8_t *a,
+                                     int32_t y_stride,
+                                     int32_t v_stride,
+                                     int32_t u_stride,
+                                     int32_t a_stride)
+{
+#if ENABLE_SIMD_AVX2
+    if (ColorConvert_GetSimd() == COLOR_CONVERT_SIMD_AVX2)
+        return YCbCr420p_to_BGRA32_avx2(bgra, bgra_stride, width, height, y, v, u, a,
+                                        y_stride, v_stride, u_stride, a_stride);
+#endif
+#if ENABLE_SIMD_SSE2
+    return YCbCr420p_to_BGRA32_sse2(bgra, bgra_stride, width, height, y, v, u, a,
+                                    y_stride, v_stride, u_stride, a_stride);
+#else
+#if ENABLE_SIMD_NEON
+    if (ColorConvert_GetSimd() == COLOR_CONVERT_SIMD_NEON)
+        return YCbCr420p_to_BGRA32_neon(bgra, bgra_stride, width, height, y, v, u, a,
+                                        y_stride, v_stride, u_stride, a_stride);
+#endif
+    return YCbCr420p_to_BGRA32_c(bgra, bgra_stride, width, height, y, v, u, a,
+                                 y_stride, v_stride, u_stride, a_stride);
+#endif
+}
+
+int ColorConvert_YCbCr420p_to_BGRA32_no_alpha(uint8_t *bgra,
                                               int32_t bgra_stride,
                                               int32_t width,
                                               int32_t height,
@@ -2613,7 +3186,53 @@ int ColorConvert_YCbCr422p_to_BGRA32_no_alpha(uint8_t *bgra,
                                               const uint8_t *v,
                                               const uint8_t *u,
                                               int32_t y_stride,
+                                              int32_t v_stride,
+                                              int32_t u_stride)
+{
+#if ENABLE_SIMD_AVX2
+    if (ColorConvert_GetSimd() == COLOR_CONVERT_SIMD_AVX2)
+        return YCbCr420p_to_BGRA32_no_alpha_avx2(bgra, bgra_stride, width, height, y, v, u,
+                                                 y_stride, v_stride, u_stride);
+#endif
+#if ENABLE_SIMD_SSE2
+    return YCbCr420p_to_BGRA32_no_alpha_sse2(bgra, bgra_stride, width, height, y, v, u,
+                                             y_stride, v_stride, u_stride);
+#else
+#if ENABLE_SIMD_NEON
+    if (ColorConvert_GetSimd() == COLOR_CONVERT_SIMD_NEON)
+        return YCbCr420p_to_BGRA32_no_alpha_neon(bgra, bgra_stride, width, height, y, v, u,
+                                                 y_stride, v_stride, u_stride);
+#endif
+    return YCbCr420p_to_BGRA32_no_alpha_c(bgra, bgra_stride, width, height, y, v, u,
+                                          y_stride, v_stride, u_stride);
+#endif
+}
+// --- End YCbCr420p conversion functions
+
+// --- Begin YCbCr422p conversion functions
+
+int ColorConvert_YCbCr422p_to_ARGB32_no_alpha(uint8_t *argb,
+                                              int32_t argb_stride,
+                                              int32_t width,
+                                              int32_t height,
+                                              const uint8_t *y,
+                                              const uint8_t *v,
+                                              const uint8_t *u,
+                                              int32_t y_stride,
                                               int32_t uv_stride)
+{
+    return 1; // NOTE: Not implemented
+}
+
+static int YCbCr422p_to_BGRA32_no_alpha_c(uint8_t *bgra,
+                                          int32_t bgra_stride,
+                                          int32_t width,
+                                          int32_t height,
+                                          const uint8_t *y,
+                                          const uint8_t *v,
+                                          const uint8_t *u,
+                                          int32_t y_stride,
+                                          int32_t uv_stride)
 {
     int32_t i, j;
     const uint8_t *say1, *sau, *sav, *sly1, *slu, *slv;
@@ -2678,4 +3297,201 @@ int ColorConvert_YCbCr422p_to_BGRA32_no_alpha(uint8_t *bgra,
 
     return 0;
 }
+
+#if ENABLE_SIMD_SSE2
+/*
+ * The lookup tables of the C function as arithmetic on (i, 1) pairs of 16 bit
+ * values, see NEON_tYY & co: _mm_madd_epi16 gives i * mul + add.
+ */
+#define SSE2_TABLE_COEFFS(mul, add) _mm_set1_epi32((int32_t)(((uint32_t)(add) << 16) | (uint16_t)(mul)))
+
+/* 16 bit values of the even pixels in [even], of the odd ones in [odd] */
+#define SSE2_INTERLEAVE_32(even, odd) \
+    _mm_or_si128(_mm_and_si128(even, x_low), _mm_slli_epi32(odd, 16))
+
+/*
+ * UYVY, as passed by all the callers: the scalar function does not assume
+ * the three pointers are that close, so this is only used when they are.
+ * Computes 8 pixels of [uyvy] as 16 bit values, halved.
+ */
+static void YCbCr422_to_16bpp_sse2(const uint8_t *uyvy, __m128i *x_b, __m128i *x_g, __m128i *x_r)
+{
+    const __m128i x_mask = _mm_set1_epi32(0xff);
+    const __m128i x_pair = _mm_set1_epi32(0x10000);
+    const __m128i x_low = _mm_set1_epi32(0xffff);
+    const __m128i x_tYY = SSE2_TABLE_COEFFS(9539, 2007);
+    const __m128i x_tRV = SSE2_TABLE_COEFFS(13079, 2108);
+    const __m128i x_tGU = SSE2_TABLE_COEFFS(-6423, 6375);
+    const __m128i x_tGV = SSE2_TABLE_COEFFS(13323, 4098);
+    const __m128i x_tBU = SSE2_TABLE_COEFFS(16535, 2020);
+
+    __m128i x_in, x_u, x_v, x_y0, x_y1, x_c;
+
+    x_in = _mm_loadu_si128((const __m128i*)uyvy);
+    x_u = _mm_or_si128(_mm_and_si128(x_in, x_mask), x_pair);
+    x_y0 = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(x_in, 8), x_mask), x_pair);
+    x_v = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(x_in, 16), x_mask), x_pair);
+    x_y1 = _mm_or_si128(_mm_srli_epi32(x_in, 24), x_pair);
+
+    x_y0 = _mm_srli_epi32(_mm_madd_epi16(x_y0, x_tYY), 12);
+    x_y1 = _mm_srli_epi32(_mm_madd_epi16(x_y1, x_tYY), 12);
+
+    /* color_tBU[u] - 554 */
+    x_c = _mm_sub_epi32(_mm_srli_epi32(_mm_madd_epi16(x_u, x_tBU), 12), _mm_set1_epi32(554));
+    *x_b = _mm_srai_epi16(SSE2_INTERLEAVE_32(_mm_add_epi32(x_y0, x_c), _mm_add_epi32(x_y1, x_c)), 1);
+
+    /* color_tGU[u] - color_tGV[v], color_tGU[u] being 271 + ((6375 - u * 6423) >> 13) */
+    x_c = _mm_add_epi32(_mm_srai_epi32(_mm_madd_epi16(x_u, x_tGU), 13), _mm_set1_epi32(271));
+    x_c = _mm_sub_epi32(x_c, _mm_srli_epi32(_mm_madd_epi16(x_v, x_tGV), 13));
+    *x_g = _mm_srai_epi16(SSE2_INTERLEAVE_32(_mm_add_epi32(x_y0, x_c), _mm_add_epi32(x_y1, x_c)), 1);
+
+    /* color_tRV[v] - 446 */
+    x_c = _mm_sub_epi32(_mm_srli_epi32(_mm_madd_epi16(x_v, x_tRV), 12), _mm_set1_epi32(446));
+    *x_r = _mm_srai_epi16(SSE2_INTERLEAVE_32(_mm_add_epi32(x_y0, x_c), _mm_add_epi32(x_y1, x_c)), 1);
+}
+
+static int YCbCr422p_to_BGRA32_no_alpha_sse2(uint8_t *bgra,
+                                             int32_t bgra_stride,
+                                             int32_t width,
+                                             int32_t height,
+                                             const uint8_t *y,
+                                             const uint8_t *v,
+                                             const uint8_t *u,
+                                             int32_t y_stride,
+                                             int32_t uv_stride)
+{
+    const __m128i x_aa = _mm_set1_epi8((char)0xff);
+    int32_t w = width & ~15;
+    int32_t jH, iW;
+    __m128i x_b1, x_b2, x_g1, x_g2, x_r1, x_r2, x_bgl, x_bgh, x_ral, x_rah;
+    uint8_t *pd;
+
+    if (bgra == NULL || y == NULL || u == NULL || v == NULL)
+        return 1;
+
+    if (width <= 0 || height <= 0)
+        return 1;
+
+    if (width & 1)
+        return 1;
+
+    if (y != u + 1 || v != u + 2 || y_stride != uv_stride)
+        return YCbCr422p_to_BGRA32_no_alpha_c(bgra, bgra_stride, width, height, y, v, u, y_stride, uv_stride);
+
+    for (jH = 0; jH < height; jH++) {
+        pd = bgra + jH * bgra_stride;
+        for (iW = 0; iW < w; iW += 16) {
+            YCbCr422_to_16bpp_sse2(u + jH * uv_stride + 2 * iW, &x_b1, &x_g1, &x_r1);
+            YCbCr422_to_16bpp_sse2(u + jH * uv_stride + 2 * iW + 16, &x_b2, &x_g2, &x_r2);
+
+            /* pack: 16=>8 */
+            x_b1 = _mm_packus_epi16(x_b1, x_b2);
+            x_g1 = _mm_packus_epi16(x_g1, x_g2);
+            x_r1 = _mm_packus_epi16(x_r1, x_r2);
+
+            /* create bgra sequences */
+            x_bgl = _mm_unpacklo_epi8(x_b1, x_g1);
+            x_bgh = _mm_unpackhi_epi8(x_b1, x_g1);
+            x_ral = _mm_unpacklo_epi8(x_r1, x_aa);
+            x_rah = _mm_unpackhi_epi8(x_r1, x_aa);
+
+            SAVE_BGRA2(_mm_unpacklo_epi16(x_bgl, x_ral), pd);
+            SAVE_BGRA2(_mm_unpackhi_epi16(x_bgl, x_ral), pd);
+            SAVE_BGRA2(_mm_unpacklo_epi16(x_bgh, x_rah), pd);
+            SAVE_BGRA2(_mm_unpackhi_epi16(x_bgh, x_rah), pd);
+        }
+    }
+
+    if (w == width)
+        return 0;
+
+    return YCbCr422p_to_BGRA32_no_alpha_c(bgra + 4 * w, bgra_stride, width - w, height,
+                                          y + 2 * w, v + 2 * w, u + 2 * w, y_stride, uv_stride);
+}
+#endif // ENABLE_SIMD_SSE2
+
+#if ENABLE_SIMD_NEON
+/* UYVY only, as the SSE2 function above */
+static int YCbCr422p_to_BGRA32_no_alpha_neon(uint8_t *bgra,
+                                             int32_t bgra_stride,
+                                             int32_t width,
+                                             int32_t height,
+                                             const uint8_t *y,
+                                             const uint8_t *v,
+                                             const uint8_t *u,
+                                             int32_t y_stride,
+                                             int32_t uv_stride)
+{
+    int32_t w = width & ~15;
+    int32_t jH, iW;
+    uint8x8x4_t x_uyvy;
+    uint16x8_t x_u, x_v;
+    int16x8_t x_y0, x_y1, x_b, x_g, x_r;
+    uint8x8x2_t x_temp;
+    uint8x16x4_t x_bgra;
+
+    if (bgra == NULL || y == NULL || u == NULL || v == NULL)
+        return 1;
+
+    if (width <= 0 || height <= 0)
+        return 1;
+
+    if (width & 1)
+        return 1;
+
+    if (y != u + 1 || v != u + 2 || y_stride != uv_stride)
+        return YCbCr422p_to_BGRA32_no_alpha_c(bgra, bgra_stride, width, height, y, v, u, y_stride, uv_stride);
+
+    x_bgra.val[3] = vdupq_n_u8(0xff);
+    for (jH = 0; jH < height; jH++) {
+        for (iW = 0; iW < w; iW += 16) {
+            /* U, Y0, V and Y1 of 8 pixel pairs */
+            x_uyvy = vld4_u8(u + jH * uv_stride + 2 * iW);
+            x_u = vmovl_u8(x_uyvy.val[0]);
+            x_v = vmovl_u8(x_uyvy.val[2]);
+            x_y0 = NEON_tYY(vmovl_u8(x_uyvy.val[1]));
+            x_y1 = NEON_tYY(vmovl_u8(x_uyvy.val[3]));
+
+            x_b = vsubq_s16(NEON_tBU(x_u), vdupq_n_s16(554));
+            x_g = vsubq_s16(NEON_tGU(x_u), NEON_tGV(x_v));
+            x_r = vsubq_s16(NEON_tRV(x_v), vdupq_n_s16(446));
+
+            x_temp = vzip_u8(vqshrun_n_s16(vaddq_s16(x_y0, x_b), 1), vqshrun_n_s16(vaddq_s16(x_y1, x_b), 1));
+            x_bgra.val[0] = vcombine_u8(x_temp.val[0], x_temp.val[1]);
+            x_temp = vzip_u8(vqshrun_n_s16(vaddq_s16(x_y0, x_g), 1), vqshrun_n_s16(vaddq_s16(x_y1, x_g), 1));
+            x_bgra.val[1] = vcombine_u8(x_temp.val[0], x_temp.val[1]);
+            x_temp = vzip_u8(vqshrun_n_s16(vaddq_s16(x_y0, x_r), 1), vqshrun_n_s16(vaddq_s16(x_y1, x_r), 1));
+            x_bgra.val[2] = vcombine_u8(x_temp.val[0], x_temp.val[1]);
+
+            vst4q_u8(bgra + jH * bgra_stride + 4 * iW, x_bgra);
+        }
+    }
+
+    if (w == width)
+        return 0;
+
+    return YCbCr422p_to_BGRA32_no_alpha_c(bgra + 4 * w, bgra_stride, width - w, height,
+                                          y + 2 * w, v + 2 * w, u + 2 * w, y_stride, uv_stride);
+}
+#endif // ENABLE_SIMD_NEON
+
+int ColorConvert_YCbCr422p_to_BGRA32_no_alpha(uint8_t *bgra,
+                                              int32_t bgra_stride,
+                                              int32_t width,
+                                              int32_t height,
+                                              const uint8_t *y,
+                                              const uint8_t *v,
+                                              const uint8_t *u,
+                                              int32_t y_stride,
+                                              int32_t uv_stride)
+{
+#if ENABLE_SIMD_SSE2
+    if (ColorConvert_GetSimd() != COLOR_CONVERT_SIMD_NONE)
+        return YCbCr422p_to_BGRA32_no_alpha_sse2(bgra, bgra_stride, width, height, y, v, u, y_stride, uv_stride);
+#elif ENABLE_SIMD_NEON
+    if (ColorConvert_GetSimd() == COLOR_CONVERT_SIMD_NEON)
+        return YCbCr422p_to_BGRA32_no_alpha_neon(bgra, bgra_stride, width, height, y, v, u, y_stride, uv_stride);
+#endif
+    return YCbCr422p_to_BGRA32_no_alpha_c(bgra, bgra_stride, width, height, y, v, u, y_stride, uv_stride);
+}
 // --- End YCbCr422p conversion functions
@@ -32,6 +32,22 @@
 extern "C" {
 #endif
 
+    // Instruction set extensions the conversions can use.
+    typedef enum {
+        COLOR_CONVERT_SIMD_NONE = 0,
+        COLOR_CONVERT_SIMD_SSE2,
+        COLOR_CONVERT_SIMD_AVX2,
+        COLOR_CONVERT_SIMD_NEON
+    } ColorConvertSimd;
+
+    // The extensions in use: the best the CPU has, unless set. The results
+    // of the conversions are the same with any of them, on a given platform.
+    ColorConvertSimd ColorConvert_GetSimd(void);
+
+    // Restricts the conversions to [simd], for tests and benchmarks. The x86
+    // builds always use SSE2 at least for 420p. Returns 1 if unsupported.
+    int ColorConvert_SetSimd(ColorConvertSimd simd);
+
     int ColorConvert_YCbCr420p_to_ARGB32(uint8_t *argb,
                                          int32_t argb_stride,
                                          int32_t width,
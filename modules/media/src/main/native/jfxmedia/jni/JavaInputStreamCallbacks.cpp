@@ -26,15 +26,186 @@
 #include "JavaInputStreamCallbacks.h"
 #include "JniUtils.h"
 #include <Common/VSMemory.h>
-#if TARGET_OS_LINUX
+#include <Utils/AutoLock.h>
+#include <new>
 #include <stdlib.h>
+#if TARGET_OS_LINUX
 #include <string.h>
 #endif // TARGET_OS_LINUX
 
+// Released buffers kept for reuse, larger ones are freed.
+#define MAX_FREE_BUFFERS        8
+#define MAX_FREE_BUFFER_SIZE    (1024 * 1024)
+#define BUFFER_SIZE_ALIGN       4096
+
+/***********************************************************************************
+ * CJavaStreamBuffer
+ ***********************************************************************************/
+CJavaStreamBuffer::CJavaStreamBuffer(CJavaStreamBufferPool *pPool, void *pData, int capacity, jobject byteBuffer)
+    : m_pPool(pPool),
+      m_pData(pData),
+      m_Capacity(capacity),
+      m_ByteBuffer(byteBuffer)
+{}
+
+void CJavaStreamBuffer::Release()
+{
+    m_pPool->Put(this);
+}
+
+/***********************************************************************************
+ * CJavaStreamBufferPool
+ ***********************************************************************************/
+CJavaStreamBufferPool* CJavaStreamBufferPool::Create(JavaVM *jvm)
+{
+    CJfxCriticalSection *pLock = CJfxCriticalSection::Create();
+    if (NULL == pLock)
+        return NULL;
+
+    CJavaStreamBufferPool *pPool = new (std::nothrow) CJavaStreamBufferPool(jvm, pLock);
+    if (NULL == pPool)
+        delete pLock;
+    return pPool;
+}
+
+CJavaStreamBufferPool::CJavaStreamBufferPool(JavaVM *jvm, CJfxCriticalSection *pLock)
+    : m_jvm(jvm),
+      m_pLock(pLock),
+      m_BusyCount(0),
+      m_Closed(false)
+{}
+
+CJavaStreamBufferPool::~CJavaStreamBufferPool()
+{
+    delete m_pLock;
+}
+
+CJavaStreamBuffer* CJavaStreamBufferPool::Get(JNIEnv *env, int size)
+{
+    std::vector<CJavaStreamBuffer*> unused;
+    CJavaStreamBuffer *pBuffer = NULL;
+
+    if (size <= 0)
+        return NULL;
+
+    {
+        CAutoLock lock(m_pLock);
+        for (std::vector<CJavaStreamBuffer*>::iterator it = m_FreeBuffers.begin(); it != m_FreeBuffers.end(); ++it)
+        {
+            if ((*it)->m_Capacity >= size)
+            {
+                pBuffer = *it;
+                m_FreeBuffers.erase(it);
+                break;
+            }
+        }
+
+        // Reads grow: the buffers too small are not needed anymore.
+        if (NULL == pBuffer && m_FreeBuffers.size() == MAX_FREE_BUFFERS)
+            unused.swap(m_FreeBuffers);
+        m_BusyCount++;
+    }
+
+    DeleteBuffers(unused);
+    if (NULL != pBuffer)
+        return pBuffer;
+
+    int capacity = (size + BUFFER_SIZE_ALIGN - 1) & ~(BUFFER_SIZE_ALIGN - 1);
+    void *pData = malloc(capacity);
+    jobject byteBuffer = NULL;
+    if (NULL != pData)
+    {
+        jobject localBuffer = env->NewDirectByteBuffer(pData, capacity);
+        if (NULL != localBuffer)
+        {
+            byteBuffer = env->NewGlobalRef(localBuffer);
+            env->DeleteLocalRef(localBuffer);
+        }
+    }
+
+    if (NULL != byteBuffer)
+        pBuffer = new (std::nothrow) CJavaStreamBuffer(this, pData, capacity, byteBuffer);
+
+    if (NULL == pBuffer)
+    {
+        if (NULL != byteBuffer)
+            env->DeleteGlobalRef(byteBuffer);
+        free(pData);
+        env->ExceptionClear();
+
+        CAutoLock lock(m_pLock);
+        m_BusyCount--;
+    }
+
+    return pBuffer;
+}
+
+void CJavaStreamBufferPool::Put(CJavaStreamBuffer *pBuffer)
+{
+    std::vector<CJavaStreamBuffer*> unused;
+    bool deletePool = false;
+
+    {
+        CAutoLock lock(m_pLock);
+        if (!m_Closed && pBuffer->m_Capacity <= MAX_FREE_BUFFER_SIZE && m_FreeBuffers.size() < MAX_FREE_BUFFERS)
+            m_FreeBuffers.push_back(pBuffer);
+        else
+            unused.push_back(pBuffer);
+        m_BusyCount--;
+        deletePool = m_Closed && 0 == m_BusyCount;
+    }
+
+    DeleteBuffers(unused);
+    if (deletePool)
+        delete this;
+}
+
+void CJavaStreamBufferPool::Close()
+{
+    std::vector<CJavaStreamBuffer*> unused;
+    bool deletePool = false;
+
+    {
+        CAutoLock lock(m_pLock);
+        unused.swap(m_FreeBuffers);
+        m_Closed = true;
+        deletePool = 0 == m_BusyCount;
+    }
+
+    DeleteBuffers(unused);
+    if (deletePool)
+        delete this;
+}
+
+void CJavaStreamBufferPool::DeleteBuffer(JNIEnv *env, CJavaStreamBuffer *pBuffer)
+{
+    if (NULL != env)
+        env->DeleteGlobalRef(pBuffer->m_ByteBuffer);
+    free(pBuffer->m_pData);
+    delete pBuffer;
+}
+
+void CJavaStreamBufferPool::DeleteBuffers(std::vector<CJavaStreamBuffer*>& buffers)
+{
+    if (buffers.empty())
+        return;
+
+    CJavaEnvironment javaEnv(m_jvm);
+    JNIEnv *pEnv = javaEnv.getEnvironment();
+    for (std::vector<CJavaStreamBuffer*>::iterator it = buffers.begin(); it != buffers.end(); ++it)
+        DeleteBuffer(pEnv, *it);
+}
+
+/***********************************************************************************
+ * CJavaInputStreamCallbacks
+ ***********************************************************************************/
+
 jfieldID  CJavaInputStreamCallbacks::m_BufferFID = 0;
 jmethodID CJavaInputStreamCallbacks::m_NeedBufferMID = 0;
 jmethodID CJavaInputStreamCallbacks::m_ReadNextBlockMID = 0;
 jmethodID CJavaInputStreamCallbacks::m_ReadBlockMID = 0;
+jmethodID CJavaInputStreamCallbacks::m_ReadNextBufferMID = 0;
+jmethodID CJavaInputStreamCallbacks::m_ReadBufferMID = 0;
 jmethodID CJavaInputStreamCallbacks::m_IsSeekableMID = 0;
 jmethodID CJavaInputStreamCallbacks::m_IsRandomAccessMID = 0;
 jmethodID CJavaInputStreamCallbacks::m_SeekMID = 0;
@@ -43,11 +214,15 @@ jmethodID CJavaInputStreamCallbacks::m_PropertyMID = 0;
 jmethodID CJavaInputStreamCallbacks::m_GetStreamSizeMID = 0;
 
 CJavaInputStreamCallbacks::CJavaInputStreamCallbacks()
-    : m_ConnectionHolder(0)
+    : m_ConnectionHolder(0),
+      m_pBufferPool(NULL)
 {}
 
 CJavaInputStreamCallbacks::~CJavaInputStreamCallbacks()
-{}
+{
+    if (NULL != m_pBufferPool)
+        m_pBufferPool->Close();
+}
 
 bool CJavaInputStreamCallbacks::Init(JNIEnv *env, jobject jLocator)
 {
@@ -60,6 +235,10 @@ bool CJavaInputStreamCallbacks::Init(JNIEnv *env, jobject jLocator)
 
     CJavaEnvironment javaEnv(m_jvm);
 
+    m_pBufferPool = CJavaStreamBufferPool::Create(m_jvm);
+    if (NULL == m_pBufferPool)
+        return false;
+
     static jmethodID createConnectionHolder = 0;
     if (0 == createConnectionHolder)
     {
@@ -112,6 +291,18 @@ bool CJavaInputStreamCallbacks::Init(JNIEnv *env, jobject jLocator)
             hasException = javaEnv.reportException();
         }
 
+        if (!hasException)
+        {
+            m_ReadNextBufferMID = env->GetMethodID(klass, "readNextBlock", "(Ljava/nio/ByteBuffer;I)I");
+            hasException = javaEnv.reportException();
+        }
+
+        if (!hasException)
+        {
+            m_ReadBufferMID = env->GetMethodID(klass, "readBlock", "(JLjava/nio/ByteBuffer;I)I");
+            hasException = javaEnv.reportException();
+        }
+
         if (!hasException)
         {
             m_IsSeekableMID = env->GetMethodID(klass, "isSeekable", "()Z");
@@ -235,6 +426,68 @@ void CJavaInputStreamCallbacks::CopyBlock(void* destination, int size)
     }
  }
 
+int CJavaInputStreamCallbacks::ReadNextBuffer(int size, CStreamBuffer** buffer)
+{
+    int result = -1;
+    CJavaEnvironment javaEnv(m_jvm);
+    JNIEnv *pEnv = javaEnv.getEnvironment();
+
+    *buffer = NULL;
+    if (pEnv) {
+        CJavaStreamBuffer *pBuffer = m_pBufferPool->Get(pEnv, size);
+        if (NULL == pBuffer)
+            return -2;
+
+        jobject connection = pEnv->NewLocalRef(m_ConnectionHolder);
+        if (connection) {
+            result = pEnv->CallIntMethod(connection, m_ReadNextBufferMID, pBuffer->GetByteBuffer(), (jint)size);
+            pEnv->DeleteLocalRef(connection);
+        }
+
+        if (javaEnv.clearException()) {
+            result = -2;
+        }
+
+        if (result > 0)
+            *buffer = pBuffer;
+        else
+            pBuffer->Release();
+    }
+
+    return result;
+}
+
+int CJavaInputStreamCallbacks::ReadBuffer(int64_t position, int size, CStreamBuffer** buffer)
+{
+    int result = -1;
+    CJavaEnvironment javaEnv(m_jvm);
+    JNIEnv *pEnv = javaEnv.getEnvironment();
+
+    *buffer = NULL;
+    if (pEnv) {
+        CJavaStreamBuffer *pBuffer = m_pBufferPool->Get(pEnv, size);
+        if (NULL == pBuffer)
+            return -2;
+
+        jobject connection = pEnv->NewLocalRef(m_ConnectionHolder);
+        if (connection) {
+            result = pEnv->CallIntMethod(connection, m_ReadBufferMID, (jlong)position, pBuffer->GetByteBuffer(), (jint)size);
+            pEnv->DeleteLocalRef(connection);
+        }
+
+        if (javaEnv.clearException()) {
+            result = -2;
+        }
+
+        if (result > 0)
+            *buffer = pBuffer;
+        else
+            pBuffer->Release();
+    }
+
+    return result;
+}
+
 bool CJavaInputStreamCallbacks::IsSeekable()
 {
     CJavaEnvironment javaEnv(m_jvm);
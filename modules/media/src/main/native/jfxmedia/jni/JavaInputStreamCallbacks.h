@@ -27,7 +27,62 @@
 #define _JAVA_INPUT_STREAM_CALLBACKS_H_
 
 #include <jni.h>
+#include <vector>
 #include <Locator/LocatorStream.h>
+#include <Utils/JfxCriticalSection.h>
+
+class CJavaStreamBufferPool;
+
+// Native memory seen by Java as a direct ByteBuffer, for the stream to be read into.
+class CJavaStreamBuffer : public CStreamBuffer
+{
+public:
+    void* GetData() { return m_pData; }
+    void  Release();
+
+    inline jobject GetByteBuffer() { return m_ByteBuffer; }
+    inline int     GetCapacity() { return m_Capacity; }
+
+private:
+    friend class CJavaStreamBufferPool;
+    CJavaStreamBuffer(CJavaStreamBufferPool *pPool, void *pData, int capacity, jobject byteBuffer);
+    virtual ~CJavaStreamBuffer() {}
+
+    CJavaStreamBufferPool *m_pPool;
+    void                  *m_pData;
+    int                    m_Capacity;
+    jobject                m_ByteBuffer; // Global reference
+};
+
+/*
+ * Buffers of a connection, kept for reuse once released. Creating the
+ * ByteBuffer of a buffer costs more than a read into it.
+ *
+ * Buffers may be released after the connection is closed: the pool is
+ * deleted once it is closed and all its buffers are back.
+ */
+class CJavaStreamBufferPool
+{
+public:
+    static CJavaStreamBufferPool* Create(JavaVM *jvm);
+
+    CJavaStreamBuffer* Get(JNIEnv *env, int size);
+    void Put(CJavaStreamBuffer *pBuffer);
+    void Close();
+
+private:
+    CJavaStreamBufferPool(JavaVM *jvm, CJfxCriticalSection *pLock);
+    ~CJavaStreamBufferPool();
+
+    static void DeleteBuffer(JNIEnv *env, CJavaStreamBuffer *pBuffer);
+    void DeleteBuffers(std::vector<CJavaStreamBuffer*>& buffers);
+
+    JavaVM                         *m_jvm;
+    CJfxCriticalSection            *m_pLock;
+    std::vector<CJavaStreamBuffer*> m_FreeBuffers;
+    int                             m_BusyCount;
+    bool                            m_Closed;
+};
 
 class CJavaInputStreamCallbacks : public CStreamCallbacks
 {
@@ -41,6 +96,8 @@ virtual ~CJavaInputStreamCallbacks();
     int  ReadNextBlock();
     int  ReadBlock(int64_t position, int size);
     void CopyBlock(void* destination, int size);
+    int  ReadNextBuffer(int size, CStreamBuffer** buffer);
+    int  ReadBuffer(int64_t position, int size, CStreamBuffer** buffer);
     bool IsSeekable();
     bool IsRandomAccess();
     int64_t Seek(int64_t position);
@@ -50,12 +107,15 @@ virtual ~CJavaInputStreamCallbacks();
 
 private:
     jobject          m_ConnectionHolder;
+    CJavaStreamBufferPool *m_pBufferPool;
 
     JavaVM           *m_jvm;
     static jfieldID  m_BufferFID;
     static jmethodID m_NeedBufferMID;
     static jmethodID m_ReadNextBlockMID;
     static jmethodID m_ReadBlockMID;
+    static jmethodID m_ReadNextBufferMID;
+    static jmethodID m_ReadBufferMID;
     static jmethodID m_IsSeekableMID;
     static jmethodID m_IsRandomAccessMID;
     static jmethodID m_SeekMID;
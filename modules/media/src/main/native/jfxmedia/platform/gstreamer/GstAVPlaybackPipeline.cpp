@@ -257,6 +257,19 @@ GstFlowReturn CGstAVPlaybackPipeline::OnAppSinkHaveFrame(GstElement* pElem, CGst
 {
     LOWLEVELPERF_RESETCOUNTER("FPS");
 
+#if ENABLE_LOWLEVELPERF
+    // Frames are pushed by the decoder right after being decoded.
+    GstElement* pDecoder = pPipeline->m_Elements[VIDEO_DECODER];
+    if (NULL != pDecoder && NULL != g_object_class_find_property(G_OBJECT_GET_CLASS(pDecoder), "decode-time"))
+    {
+        guint64 decodeTime = 0;
+        g_object_get(pDecoder, "decode-time", &decodeTime, NULL);
+        gchar* name = g_strdup_printf("%s decode time", GST_ELEMENT_NAME(pDecoder));
+        LOWLEVELPERF_LOGVALUE(name, (long)decodeTime, "us", 1);
+        g_free(name);
+    }
+#endif
+
     //***** get the buffer from appsink
     GstSample* pSample = gst_app_sink_pull_sample(GST_APP_SINK (pElem));
     if (pSample == NULL)
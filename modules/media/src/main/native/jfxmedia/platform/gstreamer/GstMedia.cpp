@@ -71,8 +71,8 @@ extern "C" {
         return result;
     }
 
-    static jint InitMedia(JNIEnv *env, CPipelineOptions* pOptions, jobject jLocator, jstring jContentType, jlong jSizeHint,
-                          jlongArray jlMediaHandle)
+    static jint InitMedia(JNIEnv *env, jobject jLocator, jstring jContentType, jlong jSizeHint,
+                          jint jVideoDecoderThreads, jlongArray jlMediaHandle)
     {
         CMedia*         pMedia = NULL;
         char*           pjContent = (char*)env->GetStringUTFChars(jContentType , NULL);
@@ -128,6 +128,14 @@ extern "C" {
             return ERROR_MEMORY_ALLOCATION;
 
         //***** Create the media object
+        CPipelineOptions *pOptions = new (nothrow) CPipelineOptions();
+        if (NULL == pOptions)
+        {
+            delete locator;
+            return ERROR_MEMORY_ALLOCATION;
+        }
+        pOptions->SetVideoDecoderThreads(jVideoDecoderThreads);
+
         uErrCode  = pManager->CreatePlayer(locator, pOptions, &pMedia);
 
         //***** return
@@ -166,11 +174,11 @@ extern "C" {
      * @return  Media reference.  This reference must be used when calling GSTMediaPlayer function.
      */
     JNIEXPORT jint JNICALL Java_com_sun_media_jfxmediaimpl_platform_gstreamer_GSTMedia_gstInitNativeMedia
-    (JNIEnv *env, jobject obj, jobject jLocator, jstring jContentType, jlong jSizeHint, jlongArray jlMediaHandle)
+    (JNIEnv *env, jobject obj, jobject jLocator, jstring jContentType, jlong jSizeHint, jint jVideoDecoderThreads, jlongArray jlMediaHandle)
     {
         LOWLEVELPERF_EXECTIMESTART("gstInitNativeMediaToSendToJavaPlayerStateEventPaused");
         LOWLEVELPERF_EXECTIMESTART("gstInitNativeMedia()");
-        uint32_t result = InitMedia(env, NULL, jLocator, jContentType, jSizeHint, jlMediaHandle);
+        uint32_t result = InitMedia(env, jLocator, jContentType, jSizeHint, jVideoDecoderThreads, jlMediaHandle);
         LOWLEVELPERF_EXECTIMESTOP("gstInitNativeMedia()");
 
         return result;
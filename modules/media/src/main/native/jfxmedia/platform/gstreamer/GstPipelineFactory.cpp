@@ -218,13 +218,17 @@ uint32_t CGstPipelineFactory::CreateSourceElement(CLocator* locator, GstElement*
 
             g_signal_connect (javaSource, "read-next-block", G_CALLBACK (SourceReadNextBlock), callbacks);
             g_signal_connect (javaSource, "copy-block", G_CALLBACK (SourceCopyBlock), callbacks);
+            g_signal_connect (javaSource, "read-next-buffer", G_CALLBACK (SourceReadNextBuffer), callbacks);
             g_signal_connect (javaSource, "seek-data", G_CALLBACK (SourceSeekData), callbacks);
             g_signal_connect (javaSource, "close-connection", G_CALLBACK (SourceCloseConnection), callbacks);
             g_signal_connect (javaSource, "property", G_CALLBACK (SourceProperty), callbacks);
             g_signal_connect (javaSource, "get-stream-size", G_CALLBACK (SourceGetStreamSize), callbacks);
 
             if (isRandomAccess)
+            {
                 g_signal_connect (javaSource, "read-block", G_CALLBACK (SourceReadBlock), callbacks);
+                g_signal_connect (javaSource, "read-buffer", G_CALLBACK (SourceReadBuffer), callbacks);
+            }
 
             if (hlsMode == 1)
                 g_object_set (javaSource, "hls-mode", TRUE, NULL);
@@ -310,6 +314,38 @@ void CGstPipelineFactory::SourceCopyBlock(GstElement *src, gpointer buffer, int
     ((CStreamCallbacks*)data)->CopyBlock(buffer, size);
 }
 
+gint CGstPipelineFactory::SourceReadNextBuffer(GstElement *src, gint size, gpointer buffer, gpointer data)
+{
+    CStreamBuffer *streamBuffer = NULL;
+    gint result = ((CStreamCallbacks*)data)->ReadNextBuffer(size, &streamBuffer);
+    return (result > 0) ? WrapStreamBuffer(streamBuffer, result, (GstBuffer**)buffer) : result;
+}
+
+gint CGstPipelineFactory::SourceReadBuffer(GstElement *src, guint64 position, guint size, gpointer buffer, gpointer data)
+{
+    CStreamBuffer *streamBuffer = NULL;
+    gint result = ((CStreamCallbacks*)data)->ReadBuffer((int64_t)position, (int)size, &streamBuffer);
+    return (result > 0) ? WrapStreamBuffer(streamBuffer, result, (GstBuffer**)buffer) : result;
+}
+
+// Hands the memory the data was read into downstream, it goes back to the callbacks with the buffer.
+gint CGstPipelineFactory::WrapStreamBuffer(CStreamBuffer *streamBuffer, gint size, GstBuffer **buffer)
+{
+    *buffer = gst_buffer_new_wrapped_full((GstMemoryFlags)0, streamBuffer->GetData(), size, 0, size,
+                                          streamBuffer, ReleaseStreamBuffer);
+    if (NULL == *buffer)
+    {
+        streamBuffer->Release();
+        return -2;
+    }
+    return size;
+}
+
+void CGstPipelineFactory::ReleaseStreamBuffer(gpointer streamBuffer)
+{
+    ((CStreamBuffer*)streamBuffer)->Release();
+}
+
 gint64 CGstPipelineFactory::SourceSeekData(GstElement *src, guint64 offset, gpointer data)
 {
     return (gint64)((CStreamCallbacks*)data)->Seek((int64_t)offset);
@@ -332,6 +368,8 @@ void CGstPipelineFactory::SourceCloseConnection(GstElement *src, gpointer data)
     g_signal_handlers_disconnect_by_func (src, (void*)G_CALLBACK (SourceReadNextBlock), callbacks);
     g_signal_handlers_disconnect_by_func (src, (void*)G_CALLBACK (SourceReadBlock), callbacks);
     g_signal_handlers_disconnect_by_func (src, (void*)G_CALLBACK (SourceCopyBlock), callbacks);
+    g_signal_handlers_disconnect_by_func (src, (void*)G_CALLBACK (SourceReadNextBuffer), callbacks);
+    g_signal_handlers_disconnect_by_func (src, (void*)G_CALLBACK (SourceReadBuffer), callbacks);
     g_signal_handlers_disconnect_by_func (src, (void*)G_CALLBACK (SourceSeekData), callbacks);
     g_signal_handlers_disconnect_by_func (src, (void*)G_CALLBACK (SourceCloseConnection), callbacks);
     g_signal_handlers_disconnect_by_func (src, (void*)G_CALLBACK (SourceProperty), callbacks);
@@ -700,6 +738,9 @@ uint32_t CGstPipelineFactory::CreateAVPipeline(GstElement* source, const char* s
         g_object_set(G_OBJECT(elements[VIDEO_DECODER]), "location", location, NULL);
     }
 
+    if (elements[VIDEO_DECODER] != NULL && NULL != g_object_class_find_property(G_OBJECT_GET_CLASS(G_OBJECT(elements[VIDEO_DECODER])), "threads"))
+        g_object_set(G_OBJECT(elements[VIDEO_DECODER]), "threads", (gint)pOptions->GetVideoDecoderThreads(), NULL);
+
     *ppPipeline = new CGstAVPlaybackPipeline(elements, audioFlags, pOptions);
     if( NULL == *ppPipeline)
         return ERROR_MEMORY_ALLOCATION;
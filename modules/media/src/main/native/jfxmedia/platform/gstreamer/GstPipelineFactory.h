@@ -27,6 +27,7 @@
 #define _GST_PIPELINE_FACTORY_H_
 
 #include <Locator/Locator.h>
+#include <Locator/LocatorStream.h>
 #include <PipelineManagement/PipelineFactory.h>
 #include <PipelineManagement/PipelineOptions.h>
 #include <platform/gstreamer/GstElementContainer.h>
@@ -89,6 +90,10 @@ private:
     static gint     SourceReadNextBlock(GstElement *src, gpointer data);
     static gint     SourceReadBlock(GstElement *src, guint64 position, guint size, gpointer data);
     static void     SourceCopyBlock(GstElement *src, gpointer buffer, int size, gpointer data);
+    static gint     SourceReadNextBuffer(GstElement *src, gint size, gpointer buffer, gpointer data);
+    static gint     SourceReadBuffer(GstElement *src, guint64 position, guint size, gpointer buffer, gpointer data);
+    static gint     WrapStreamBuffer(CStreamBuffer *streamBuffer, gint size, GstBuffer **buffer);
+    static void     ReleaseStreamBuffer(gpointer streamBuffer);
     static gint64   SourceSeekData(GstElement *src, guint64 offset, gpointer data);
     static void     SourceCloseConnection(GstElement *src, gpointer data);
     static int      SourceProperty(GstElement *src, int prop, int value, gpointer data);
@@ -26,6 +26,7 @@
 #include "GstVideoFrame.h"
 #include "GstPipelineFactory.h"
 #include <cstring>
+#include <thread>
 #include <Common/ProductFlags.h>
 #include <Common/VSMemory.h>
 #include <Utils/LowLevelPerf.h>
@@ -72,6 +73,176 @@ static GstBuffer *alloc_aligned_buffer(guint size)
     return gst_buffer_new_wrapped_full((GstMemoryFlags)0, alignedData, alignedSize, 0, alignedSize, newData, free_aligned_buffer);
 }
 
+// Frames of at least that many pixels are converted in bands of rows, on up
+// to CONVERT_MAX_BANDS threads: a 4K frame takes milliseconds on one core.
+#define CONVERT_BANDS_MIN_PIXELS    (2560 * 1440)
+#define CONVERT_MAX_BANDS           4
+
+// Converts [rows] rows of a frame, from [first_row]. Returns 0 on success.
+typedef int (*ConvertBandFunc)(const void *job, guint first_row, guint rows);
+
+typedef struct {
+    GMutex          lock;
+    GCond           done;
+    guint           pending;
+    int             status;
+} ConvertBands;
+
+typedef struct {
+    ConvertBandFunc function;
+    const void      *job;
+    guint           first_row;
+    guint           rows;
+    ConvertBands    *bands;
+} ConvertBandTask;
+
+static void convert_band_thread(gpointer data, gpointer user_data)
+{
+    ConvertBandTask *task = (ConvertBandTask*)data;
+    int status = task->function(task->job, task->first_row, task->rows);
+
+    g_mutex_lock(&task->bands->lock);
+    task->bands->status |= status;
+    if (--task->bands->pending == 0) {
+        g_cond_signal(&task->bands->done);
+    }
+    g_mutex_unlock(&task->bands->lock);
+}
+
+static GThreadPool *get_convert_pool()
+{
+    static gsize pool = 0;
+
+    if (g_once_init_enter(&pool)) {
+        // Shared threads: they are not kept around for the conversions.
+        GThreadPool *newPool = g_thread_pool_new(convert_band_thread, NULL, CONVERT_MAX_BANDS - 1, FALSE, NULL);
+        g_once_init_leave(&pool, (gsize)newPool);
+    }
+
+    return (GThreadPool*)pool;
+}
+
+/*
+ * Converts the [height] rows of a frame with [function], on several threads
+ * for large frames. Bands start at multiples of [row_align] rows.
+ */
+static int convert_in_bands(ConvertBandFunc function, const void *job, guint width, guint height, guint row_align)
+{
+    guint num_bands = 1;
+    if ((guint64)width * height >= CONVERT_BANDS_MIN_PIXELS) {
+        num_bands = MIN(std::thread::hardware_concurrency(), (guint)CONVERT_MAX_BANDS);
+    }
+
+    GThreadPool *pool = (num_bands > 1) ? get_convert_pool() : NULL;
+    if (pool == NULL) {
+        return function(job, 0, height);
+    }
+
+    guint band_rows = (height + num_bands - 1) / num_bands;
+    band_rows = (band_rows + row_align - 1) / row_align * row_align;
+    ConvertBandTask tasks[CONVERT_MAX_BANDS];
+    ConvertBands bands;
+    g_mutex_init(&bands.lock);
+    g_cond_init(&bands.done);
+    bands.pending = 0;
+    bands.status = 0;
+
+    // The first band is converted on this thread, the others on the pool.
+    guint row = band_rows, num_tasks = 0;
+    g_mutex_lock(&bands.lock);
+    while (row < height) {
+        ConvertBandTask *task = &tasks[num_tasks++];
+        task->function = function;
+        task->job = job;
+        task->first_row = row;
+        task->rows = MIN(band_rows, height - row);
+        task->bands = &bands;
+        bands.pending++;
+        if (!g_thread_pool_push(pool, task, NULL)) {
+            bands.pending--;
+            bands.status |= function(job, task->first_row, task->rows);
+        }
+        row += task->rows;
+    }
+    g_mutex_unlock(&bands.lock);
+
+    int status = function(job, 0, MIN(band_rows, height));
+
+    g_mutex_lock(&bands.lock);
+    while (bands.pending > 0) {
+        g_cond_wait(&bands.done, &bands.lock);
+    }
+    status |= bands.status;
+    g_mutex_unlock(&bands.lock);
+
+    g_cond_clear(&bands.done);
+    g_mutex_clear(&bands.lock);
+
+    return status;
+}
+
+typedef struct {
+    CVideoFrame::FrameType type;
+    uint8_t         *dest;
+    guint           dest_stride;
+    guint           width;
+    const uint8_t   *y, *v, *u, *a; // a is NULL without alpha
+    guint           y_stride, v_stride, u_stride, a_stride;
+} Convert420pJob;
+
+static int convert_420p_band(const void *data, guint first_row, guint rows)
+{
+    const Convert420pJob *job = (const Convert420pJob*)data;
+    uint8_t *dest = job->dest + first_row * job->dest_stride;
+    const uint8_t *y = job->y + first_row * job->y_stride;
+    const uint8_t *v = job->v + first_row / 2 * job->v_stride;
+    const uint8_t *u = job->u + first_row / 2 * job->u_stride;
+
+    if (job->type == CVideoFrame::ARGB) {
+        if (job->a != NULL) {
+            return ColorConvert_YCbCr420p_to_ARGB32(dest, job->dest_stride, job->width, rows,
+                                                    y, v, u, job->a + first_row * job->a_stride,
+                                                    job->y_stride, job->v_stride, job->u_stride, job->a_stride);
+        } else {
+            return ColorConvert_YCbCr420p_to_ARGB32_no_alpha(dest, job->dest_stride, job->width, rows,
+                                                             y, v, u, job->y_stride, job->v_stride, job->u_stride);
+        }
+    } else {
+        if (job->a != NULL) {
+            return ColorConvert_YCbCr420p_to_BGRA32(dest, job->dest_stride, job->width, rows,
+                                                    y, v, u, job->a + first_row * job->a_stride,
+                                                    job->y_stride, job->v_stride, job->u_stride, job->a_stride);
+        } else {
+            return ColorConvert_YCbCr420p_to_BGRA32_no_alpha(dest, job->dest_stride, job->width, rows,
+                                                             y, v, u, job->y_stride, job->v_stride, job->u_stride);
+        }
+    }
+}
+
+typedef struct {
+    CVideoFrame::FrameType type;
+    uint8_t         *dest;
+    guint           dest_stride;
+    guint           width;
+    const uint8_t   *uyvy;
+    guint           stride;
+} Convert422Job;
+
+static int convert_422_band(const void *data, guint first_row, guint rows)
+{
+    const Convert422Job *job = (const Convert422Job*)data;
+    uint8_t *dest = job->dest + first_row * job->dest_stride;
+    const uint8_t *uyvy = job->uyvy + first_row * job->stride;
+
+    if (job->type == CVideoFrame::ARGB) {
+        return ColorConvert_YCbCr422p_to_ARGB32_no_alpha(dest, job->dest_stride, job->width, rows,
+                                                         uyvy + 1, uyvy + 2, uyvy, job->stride, job->stride);
+    } else {
+        return ColorConvert_YCbCr422p_to_BGRA32_no_alpha(dest, job->dest_stride, job->width, rows,
+                                                         uyvy + 1, uyvy + 2, uyvy, job->stride, job->stride);
+    }
+}
+
 GstCaps *create_RGB_caps(CVideoFrame::FrameType type, guint width, guint height, guint encodedWidth, guint encodedHeight, guint stride)
 {
     gint red_mask, green_mask, blue_mask, alpha_mask;
@@ -430,49 +601,20 @@ CGstVideoFrame *CGstVideoFrame::ConvertFromYCbCr420p(FrameType destType)
     }
 
     // now do the conversion
-    if (destType == ARGB) {
-        if (m_bHasAlpha) {
-            status = ColorConvert_YCbCr420p_to_ARGB32(
-                        info.data, stride,
-                        m_uiEncodedWidth, m_uiEncodedHeight,
-                        (const uint8_t*)m_pvPlaneData[0],
-                        (const uint8_t*)m_pvPlaneData[v_index],
-                        (const uint8_t*)m_pvPlaneData[u_index],
-                        (const uint8_t*)m_pvPlaneData[3],
-                        m_puiPlaneStrides[0], m_puiPlaneStrides[v_index],
-                        m_puiPlaneStrides[u_index], m_puiPlaneStrides[3]);
-        } else {
-            status = ColorConvert_YCbCr420p_to_ARGB32_no_alpha(
-                        info.data, stride,
-                        m_uiEncodedWidth, m_uiEncodedHeight,
-                        (const uint8_t*)m_pvPlaneData[0],
-                        (const uint8_t*)m_pvPlaneData[v_index],
-                        (const uint8_t*)m_pvPlaneData[u_index],
-                        m_puiPlaneStrides[0], m_puiPlaneStrides[v_index],
-                        m_puiPlaneStrides[u_index]);
-        }
-    } else {
-        if (m_bHasAlpha) {
-            status = ColorConvert_YCbCr420p_to_BGRA32(
-                        info.data, stride,
-                        m_uiEncodedWidth, m_uiEncodedHeight,
-                        (const uint8_t*)m_pvPlaneData[0],
-                        (const uint8_t*)m_pvPlaneData[v_index],
-                        (const uint8_t*)m_pvPlaneData[u_index],
-                        (const uint8_t*)m_pvPlaneData[3],
-                        m_puiPlaneStrides[0], m_puiPlaneStrides[v_index],
-                        m_puiPlaneStrides[u_index], m_puiPlaneStrides[3]);
-        } else {
-            status = ColorConvert_YCbCr420p_to_BGRA32_no_alpha(
-                        info.data, stride,
-                        m_uiEncodedWidth, m_uiEncodedHeight,
-                        (const uint8_t*)m_pvPlaneData[0],
-                        (const uint8_t*)m_pvPlaneData[v_index],
-                        (const uint8_t*)m_pvPlaneData[u_index],
-                        m_puiPlaneStrides[0], m_puiPlaneStrides[v_index],
-                        m_puiPlaneStrides[u_index]);
-        }
-    }
+    Convert420pJob job;
+    job.type = destType;
+    job.dest = info.data;
+    job.dest_stride = stride;
+    job.width = m_uiEncodedWidth;
+    job.y = (const uint8_t*)m_pvPlaneData[0];
+    job.v = (const uint8_t*)m_pvPlaneData[v_index];
+    job.u = (const uint8_t*)m_pvPlaneData[u_index];
+    job.a = m_bHasAlpha ? (const uint8_t*)m_pvPlaneData[3] : NULL;
+    job.y_stride = m_puiPlaneStrides[0];
+    job.v_stride = m_puiPlaneStrides[v_index];
+    job.u_stride = m_puiPlaneStrides[u_index];
+    job.a_stride = m_bHasAlpha ? m_puiPlaneStrides[3] : 0;
+    status = convert_in_bands(convert_420p_band, &job, m_uiEncodedWidth, m_uiEncodedHeight, 2);
 
     gst_buffer_unmap(destBuffer, &info);
 
@@ -561,21 +703,14 @@ CGstVideoFrame *CGstVideoFrame::ConvertFromYCbCr422(FrameType destType)
     }
 
     // now do the conversion
-    if (destType == ARGB) {
-        status = ColorConvert_YCbCr422p_to_ARGB32_no_alpha(info.data, stride,
-                                                           m_uiEncodedWidth, m_uiEncodedHeight,
-                                                           (uint8_t*)m_pvPlaneData[0] + 1,
-                                                           (uint8_t*)m_pvPlaneData[0] + 2,
-                                                           (uint8_t*)m_pvPlaneData[0],
-                                                           m_puiPlaneStrides[0], m_puiPlaneStrides[0]);
-    } else {
-        status = ColorConvert_YCbCr422p_to_BGRA32_no_alpha(info.data, stride,
-                                                           m_uiEncodedWidth, m_uiEncodedHeight,
-                                                           (uint8_t*)m_pvPlaneData[0] + 1,
-                                                           (uint8_t*)m_pvPlaneData[0] + 2,
-                                                           (uint8_t*)m_pvPlaneData[0],
-                                                           m_puiPlaneStrides[0], m_puiPlaneStrides[0]);
-    }
+    Convert422Job job;
+    job.type = destType;
+    job.dest = info.data;
+    job.dest_stride = stride;
+    job.width = m_uiEncodedWidth;
+    job.uyvy = (const uint8_t*)m_pvPlaneData[0];
+    job.stride = m_puiPlaneStrides[0];
+    status = convert_in_bands(convert_422_band, &job, m_uiEncodedWidth, m_uiEncodedHeight, 1);
 
     gst_buffer_unmap(destBuffer, &info);
 
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * Checks that the conversions of jfxmedia/Utils/ColorConverter.c give the
+ * same results with all the instruction sets the CPU supports as with the
+ * original code (SSE2 for 420p on x86, C otherwise), and times them.
+ *
+ * Build from this directory, adding -DTARGET_OS_LINUX=1 on Linux:
+ *   cc -O2 -msse2 -I../../main/native/jfxmedia ColorConverterBench.c \
+ *       ../../main/native/jfxmedia/Utils/ColorConverter.c -o ColorConverterBench
+ *
+ * Usage: ColorConverterBench [width height [iterations]], 3840x2160 by default.
+ */
+
+#include <Utils/ColorConverter.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+extern const uint16_t color_tYY[256];
+extern const uint16_t color_tRV[256];
+extern const uint16_t color_tGU[256];
+extern const uint16_t color_tGV[256];
+extern const uint16_t color_tBU[256];
+
+static const char *simd_names[] = { "none", "SSE2", "AVX2", "NEON" };
+
+typedef enum {
+    YCbCr420p_to_ARGB32,
+    YCbCr420p_to_ARGB32_no_alpha,
+    YCbCr420p_to_BGRA32,
+    YCbCr420p_to_BGRA32_no_alpha,
+    YCbCr422p_to_BGRA32_no_alpha,
+    CONVERSION_COUNT
+} Conversion;
+
+static const char *conversion_names[] = {
+    "YCbCr420p_to_ARGB32",
+    "YCbCr420p_to_ARGB32_no_alpha",
+    "YCbCr420p_to_BGRA32",
+    "YCbCr420p_to_BGRA32_no_alpha",
+    "YCbCr422p_to_BGRA32_no_alpha"
+};
+
+typedef struct {
+    int32_t width, height;
+    uint8_t *y, *u, *v, *a, *uyvy;
+    int32_t y_stride, uv_stride, a_stride, uyvy_stride;
+    uint8_t *dest;
+    int32_t dest_stride;
+    size_t dest_size;
+} Frame;
+
+static double now_ms(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER count, frequency;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&frequency);
+    return count.QuadPart * 1000.0 / frequency.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+#endif
+}
+
+// 64 byte aligned, plus [offset]. The block malloc() returned is kept
+// right before the aligned pointer.
+static uint8_t *alloc_plane(size_t size, int offset)
+{
+    uint8_t *data = (uint8_t*)malloc(size + 128 + sizeof(void*));
+    uint8_t *aligned;
+
+    if (data == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(2);
+    }
+    aligned = (uint8_t*)(((uintptr_t)data + sizeof(void*) + 63) & ~(uintptr_t)63);
+    ((void**)aligned)[-1] = data;
+    return aligned + offset;
+}
+
+static void free_plane(uint8_t *plane, int offset)
+{
+    free(((void**)(plane - offset))[-1]);
+}
+
+// Random samples, or mostly extreme ones to exercise the clamping.
+static void fill_plane(uint8_t *data, size_t size, int extremes)
+{
+    size_t i;
+    for (i = 0; i < size; i++) {
+        int r = rand();
+        data[i] = (extremes && (r & 0x300)) ? ((r & 1) ? 0xff : 0) : (uint8_t)(r >> 4);
+    }
+}
+
+// Plane pointers are moved by [offset] from 64 byte alignment. The
+// destination is always 16 byte aligned, as the SSE2 code needs.
+static void init_frame(Frame *frame, int32_t width, int32_t height, int offset, int extremes)
+{
+    frame->width = width;
+    frame->height = height;
+    frame->y_stride = frame->a_stride = width + offset;
+    frame->uv_stride = (width + 1) / 2 + offset;
+    frame->uyvy_stride = 2 * width + offset;
+    frame->dest_stride = (4 * width + 15) & ~15;
+    frame->dest_size = (size_t)frame->dest_stride * height;
+
+    frame->y = alloc_plane((size_t)frame->y_stride * height, offset);
+    frame->a = alloc_plane((size_t)frame->a_stride * height, offset);
+    frame->u = alloc_plane((size_t)frame->uv_stride * height, offset);
+    frame->v = alloc_plane((size_t)frame->uv_stride * height, offset);
+    frame->uyvy = alloc_plane((size_t)frame->uyvy_stride * height, offset);
+    frame->dest = alloc_plane(frame->dest_size, 0);
+
+    fill_plane(frame->y, (size_t)frame->y_stride * height, extremes);
+    fill_plane(frame->a, (size_t)frame->a_stride * height, extremes);
+    fill_plane(frame->u, (size_t)frame->uv_stride * height, extremes);
+    fill_plane(frame->v, (size_t)frame->uv_stride * height, extremes);
+    fill_plane(frame->uyvy, (size_t)frame->uyvy_stride * height, extremes);
+}
+
+static void free_frame(Frame *frame, int offset)
+{
+    free_plane(frame->y, offset);
+    free_plane(frame->a, offset);
+    free_plane(frame->u, offset);
+    free_plane(frame->v, offset);
+    free_plane(frame->uyvy, offset);
+    free_plane(frame->dest, 0);
+}
+
+static int convert(Conversion conversion, Frame *frame)
+{
+    // Bytes past the rows must be left alone.
+    memset(frame->dest, 0x5a, frame->dest_size);
+
+    switch (conversion) {
+        case YCbCr420p_to_ARGB32:
+            return ColorConvert_YCbCr420p_to_ARGB32(frame->dest, frame->dest_stride, frame->width, frame->height,
+                                                    frame->y, frame->v, frame->u, frame->a,
+                                                    frame->y_stride, frame->uv_stride, frame->uv_stride, frame->a_stride);
+        case YCbCr420p_to_ARGB32_no_alpha:
+            return ColorConvert_YCbCr420p_to_ARGB32_no_alpha(frame->dest, frame->dest_stride, frame->width, frame->height,
+                                                             frame->y, frame->v, frame->u,
+                                                             frame->y_stride, frame->uv_stride, frame->uv_stride);
+        case YCbCr420p_to_BGRA32:
+            return ColorConvert_YCbCr420p_to_BGRA32(frame->dest, frame->dest_stride, frame->width, frame->height,
+                                                    frame->y, frame->v, frame->u, frame->a,
+                                                    frame->y_stride, frame->uv_stride, frame->uv_stride, frame->a_stride);
+        case YCbCr420p_to_BGRA32_no_alpha:
+            return ColorConvert_YCbCr420p_to_BGRA32_no_alpha(frame->dest, frame->dest_stride, frame->width, frame->height,
+                                                             frame->y, frame->v, frame->u,
+                                                             frame->y_stride, frame->uv_stride, frame->uv_stride);
+        case YCbCr422p_to_BGRA32_no_alpha:
+            // UYVY, as the callers pass it
+            return ColorConvert_YCbCr422p_to_BGRA32_no_alpha(frame->dest, frame->dest_stride, frame->width, frame->height,
+                                                             frame->uyvy + 1, frame->uyvy + 2, frame->uyvy,
+                                                             frame->uyvy_stride, frame->uyvy_stride);
+        default:
+            return 1;
+    }
+}
+
+// The tables of the C code, as computed by the SIMD code.
+static int check_tables(void)
+{
+    int i, errors = 0;
+
+    for (i = 0; i < 256; i++) {
+        errors += color_tYY[i] != ((i * 9539 + 2007) >> 12);
+        errors += color_tRV[i] != ((i * 13079 + 2108) >> 12);
+        errors += color_tGU[i] != ((2226407 - i * 6423) >> 13);
+        errors += color_tGV[i] != ((i * 13323 + 4098) >> 13);
+        errors += color_tBU[i] != ((i * 16535 + 2020) >> 12);
+    }
+
+    if (errors > 0)
+        printf("FAILED: %d table values differ\n", errors);
+    return errors;
+}
+
+static int check_frame(int32_t width, int32_t height, int offset, int extremes)
+{
+    Frame frame;
+    uint8_t *expected;
+    int conversion, simd, status, expected_status, errors = 0;
+
+    init_frame(&frame, width, height, offset, extremes);
+    expected = alloc_plane(frame.dest_size, 0);
+
+    for (conversion = 0; conversion < CONVERSION_COUNT; conversion++) {
+        ColorConvert_SetSimd(COLOR_CONVERT_SIMD_NONE);
+        expected_status = convert((Conversion)conversion, &frame);
+        memcpy(expected, frame.dest, frame.dest_size);
+
+        for (simd = COLOR_CONVERT_SIMD_SSE2; simd <= COLOR_CONVERT_SIMD_NEON; simd++) {
+            if (ColorConvert_SetSimd((ColorConvertSimd)simd) != 0)
+                continue;
+
+            status = convert((Conversion)conversion, &frame);
+            if (status != expected_status || memcmp(frame.dest, expected, frame.dest_size) != 0) {
+                printf("FAILED: %s, %s, %dx%d, offset %d\n", conversion_names[conversion],
+                       simd_names[simd], width, height, offset);
+                errors++;
+            }
+        }
+    }
+
+    free_plane(expected, 0);
+    free_frame(&frame, offset);
+    return errors;
+}
+
+static void time_conversions(int32_t width, int32_t height, int iterations)
+{
+    Frame frame;
+    int conversion, simd, i;
+    double start;
+
+    init_frame(&frame, width, height, 0, 0);
+    printf("%dx%d, ms per frame:\n", width, height);
+
+    for (conversion = 0; conversion < CONVERSION_COUNT; conversion++) {
+        printf("  %-30s", conversion_names[conversion]);
+        for (simd = COLOR_CONVERT_SIMD_NONE; simd <= COLOR_CONVERT_SIMD_NEON; simd++) {
+            if (ColorConvert_SetSimd((ColorConvertSimd)simd) != 0)
+                continue;
+
+            if (convert((Conversion)conversion, &frame) != 0) {
+                printf("  %s: n/a", simd_names[simd]);
+                continue;
+            }
+            start = now_ms();
+            for (i = 0; i < iterations; i++)
+                convert((Conversion)conversion, &frame);
+            printf("  %s: %.2f", simd_names[simd], (now_ms() - start) / iterations);
+        }
+        printf("\n");
+    }
+
+    free_frame(&frame, 0);
+}
+
+int main(int argc, char **argv)
+{
+    int32_t width = 3840, height = 2160, w, h;
+    int iterations = 20, errors, i;
+
+    if (argc >= 3) {
+        width = atoi(argv[1]);
+        height = atoi(argv[2]);
+    }
+    if (argc >= 4)
+        iterations = atoi(argv[3]);
+    if (width <= 0 || height <= 0 || iterations <= 0) {
+        fprintf(stderr, "Usage: %s [width height [iterations]]\n", argv[0]);
+        return 2;
+    }
+
+    printf("Best instruction set: %s\n", simd_names[ColorConvert_GetSimd()]);
+
+    errors = check_tables();
+    // All the tails of the SIMD loops, aligned and not.
+    for (w = 2; w <= 130; w++) {
+        for (h = 2; h <= 4; h++) {
+            errors += check_frame(w, h, 0, w & 1);
+            errors += check_frame(w, h, 1, !(w & 1));
+        }
+    }
+    srand(1);
+    for (i = 0; i < 100; i++)
+        errors += check_frame(2 + rand() % 2000, 2 + rand() % 16, i & 1, i & 2);
+    errors += check_frame(width, height, 0, 1);
+
+    if (errors > 0) {
+        printf("%d errors\n", errors);
+        return 1;
+    }
+    printf("All the results match\n");
+
+    time_conversions(width, height, iterations);
+    return 0;
+}
@@ -103,14 +103,24 @@ final class WCFontImpl extends WCFont {
         return strike;
     }
 
-    @Override public double getGlyphWidth(int glyph) {
-        return getFontStrike().getFontResource().getAdvance(glyph, font.getSize());
-    }
-
-    @Override public float[] getGlyphBoundingBox(int glyph) {
-        float[] bb = new float[4];
-        bb = getFontStrike().getFontResource().getGlyphBoundingBox(glyph, font.getSize(), bb);
-        return new float[]{bb[0], -bb[3], bb[2], bb[3] - bb[1]};
+    @Override public void getGlyphMetrics(int firstGlyph, float[] advances, float[] bounds) {
+        FontResource fr = getFontStrike().getFontResource();
+        float size = font.getSize();
+        if (advances != null) {
+            for (int i = 0; i < advances.length; i++) {
+                advances[i] = fr.getAdvance(firstGlyph + i, size);
+            }
+        }
+        if (bounds != null) {
+            float[] bb = new float[4];
+            for (int i = 0; i < bounds.length / 4; i++) {
+                bb = fr.getGlyphBoundingBox(firstGlyph + i, size, bb);
+                bounds[4 * i] = bb[0];
+                bounds[4 * i + 1] = -bb[3];
+                bounds[4 * i + 2] = bb[2];
+                bounds[4 * i + 3] = bb[3] - bb[1];
+            }
+        }
     }
 
     @Override public float getXHeight() {
@@ -35,9 +35,10 @@ import com.sun.webkit.graphics.WCGraphicsManager;
 import com.sun.webkit.graphics.WCImage;
 import com.sun.webkit.graphics.WCImageDecoder;
 import com.sun.webkit.graphics.WCImageFrame;
-import java.io.ByteArrayInputStream;
+import com.sun.webkit.perf.WCImageDecoderPerfLogger;
 import java.io.IOException;
 import java.io.InputStream;
+import java.nio.ByteBuffer;
 import java.util.Arrays;
 import java.util.logging.Level;
 import java.util.logging.Logger;
@@ -57,7 +58,10 @@ final class WCImageDecoderImpl extends WCImageDecoder {
     private boolean fullDataReceived = false;
     private boolean framesDecoded = false; // guards frames from repeated decoding
     private PrismImage[] images;
-    private volatile byte[] data;
+    // Views of the native data, in order. Only the native decoder thread
+    // appends, readers take segmentCount first (see addSegment).
+    private volatile ByteBuffer[] segments;
+    private volatile int segmentCount = 0;
     private volatile int dataSize = 0;
     private String fileNameExtension;
 
@@ -80,6 +84,10 @@ final class WCImageDecoderImpl extends WCImageDecoder {
         frames = null;
         images = null;
         framesDecoded = false;
+        // The native data are released once the decoder is destroyed.
+        segments = null;
+        segmentCount = 0;
+        dataSize = 0;
     }
 
     @Override protected String getFilenameExtension() {
@@ -90,33 +98,35 @@ final class WCImageDecoderImpl extends WCImageDecoder {
         return imageWidth > 0 && imageHeight > 0;
     }
 
-    @Override protected void addImageData(byte[] dataPortion) {
+    @Override protected void addImageData(ByteBuffer dataPortion) {
         if (dataPortion != null) {
             fullDataReceived = false;
-            if (data == null) {
-                data = Arrays.copyOf(dataPortion, dataPortion.length * 2);
-                dataSize = dataPortion.length;
-            } else {
-                int newDataSize = dataSize + dataPortion.length;
-                if (newDataSize > data.length) {
-                    resizeDataArray(Math.max(newDataSize, data.length * 2));
-                }
-                System.arraycopy(dataPortion, 0, data, dataSize, dataPortion.length);
-                dataSize = newDataSize;
-            }
+            addSegment(dataPortion.asReadOnlyBuffer());
             // Try to decode the partial data until we get image size.
             if (!imageSizeAvilable()) {
                 loadFrames();
             }
-        } else if (data != null && !fullDataReceived) {
+        } else if (segmentCount > 0 && !fullDataReceived) {
             // null dataPortion means data completion
-            if (data.length > dataSize) {
-                resizeDataArray(dataSize);
-            }
             fullDataReceived = true;
         }
     }
 
+    private void addSegment(ByteBuffer segment) {
+        ByteBuffer[] s = segments;
+        int count = segmentCount;
+        if (s == null) {
+            s = new ByteBuffer[4];
+        } else if (count == s.length) {
+            s = Arrays.copyOf(s, count * 2);
+        }
+        s[count] = segment;
+        segments = s;
+        dataSize += segment.remaining();
+        // Published last: a reader seeing the new count sees the segment too.
+        segmentCount = count + 1;
+    }
+
     private void destroyLoader() {
         if (loader != null) {
             loader.cancel();
@@ -146,12 +156,6 @@ final class WCImageDecoderImpl extends WCImageDecoder {
         }
     }
 
-    private void resizeDataArray(int newDataSize) {
-        byte[] newData = new byte[newDataSize];
-        System.arraycopy(data, 0, newData, 0, dataSize);
-        data = newData;
-    }
-
     @Override protected void loadFromResource(String name) {
         if (log.isLoggable(Level.FINE)) {
             log.fine(String.format(
@@ -168,18 +172,26 @@ final class WCImageDecoderImpl extends WCImageDecoder {
             return;
         }
 
-        setFrames(loadFrames(in));
+        setFrames(loadFrames(in, 0, true));
     }
 
-    private synchronized ImageFrame[] loadFrames(InputStream in) {
+    private synchronized ImageFrame[] loadFrames(InputStream in, int size, boolean complete) {
         if (log.isLoggable(Level.FINE)) {
             log.fine(String.format("%X Decoding frames", hashCode()));
         }
+        long start = System.nanoTime();
+        ImageFrame[] result = null;
         try {
-            return ImageStorage.loadAll(in, readerListener, 0, 0, true, 1.0f, false);
+            result = ImageStorage.loadAll(in, readerListener, 0, 0, true, 1.0f, false);
+            return result;
         } catch (ImageStorageException e) {
             return null; // consider image missing
         } finally {
+            if (WCImageDecoderPerfLogger.isEnabled()) {
+                WCImageDecoderPerfLogger.logDecode(this, fileNameExtension, size,
+                        result == null ? 0 : result.length, complete,
+                        System.nanoTime() - start);
+            }
             try {
                 in.close();
             } catch (IOException e) {
@@ -188,8 +200,73 @@ final class WCImageDecoderImpl extends WCImageDecoder {
         }
     }
 
-    private ImageFrame[] loadFrames() {
-        return loadFrames(new ByteArrayInputStream(this.data, 0, this.dataSize));
+    // Synchronized with destroy(), so that the native data are not
+    // read after being released.
+    private synchronized ImageFrame[] loadFrames() {
+        boolean complete = fullDataReceived;
+        int count = segmentCount;
+        ByteBuffer[] s = segments;
+        int size = dataSize;
+        return loadFrames(new SegmentInputStream(s, count), size, complete);
+    }
+
+    /**
+     * Reads the native data segments in place.
+     */
+    private static final class SegmentInputStream extends InputStream {
+        private final ByteBuffer[] segments;
+        private final int count;
+        private int index = 0;
+        private ByteBuffer current;
+
+        private SegmentInputStream(ByteBuffer[] segments, int count) {
+            this.segments = segments;
+            this.count = count;
+        }
+
+        // Returns the segment to read from, or null at the end of data.
+        private ByteBuffer segment() {
+            while (current == null || !current.hasRemaining()) {
+                if (index >= count) {
+                    return null;
+                }
+                current = segments[index++].duplicate();
+            }
+            return current;
+        }
+
+        @Override public int read() {
+            ByteBuffer b = segment();
+            return b == null ? -1 : (b.get() & 0xff);
+        }
+
+        @Override public int read(byte[] b, int off, int len) {
+            if (len == 0) {
+                return 0;
+            }
+            ByteBuffer s = segment();
+            if (s == null) {
+                return -1;
+            }
+            int n = Math.min(len, s.remaining());
+            s.get(b, off, n);
+            return n;
+        }
+
+        @Override public long skip(long n) {
+            long skipped = 0;
+            ByteBuffer s;
+            while (skipped < n && (s = segment()) != null) {
+                int k = (int) Math.min(n - skipped, s.remaining());
+                s.position(s.position() + k);
+                skipped += k;
+            }
+            return skipped;
+        }
+
+        @Override public int available() {
+            return current == null ? 0 : current.remaining();
+        }
     }
 
     private final ImageLoadListener readerListener = new ImageLoadListener() {
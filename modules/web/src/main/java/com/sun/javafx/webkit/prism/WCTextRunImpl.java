@@ -46,11 +46,6 @@ public final class WCTextRunImpl implements WCTextRun {
         return run.isLeftToRight();
     }
 
-    @Override
-    public int getGlyph(int index) {
-        return index < run.getGlyphCount() ? run.getGlyphCode(index) : 0;
-    }
-
     // Avoid repeated allocation
     private static float POS_AND_ADVANCE[] = new float[4];
 
@@ -75,7 +70,11 @@ public final class WCTextRunImpl implements WCTextRun {
     }
 
     @Override
-    public int getCharOffset(int index) {
-        return run.getCharOffset(index);
+    public void getGlyphs(int[] glyphs, int[] charOffsets, float[] advances) {
+        for (int i = 0; i < glyphs.length; i++) {
+            glyphs[i] = run.getGlyphCode(i);
+            charOffsets[i] = run.getCharOffset(i);
+            advances[i] = run.getAdvance(i);
+        }
     }
 }
@@ -25,16 +25,39 @@
 
 package com.sun.webkit;
 
+import java.util.concurrent.ScheduledExecutorService;
+import java.util.concurrent.ScheduledThreadPoolExecutor;
+import java.util.concurrent.TimeUnit;
+
 /**
  * The class reflects the native webkit module.
  */
 final class MainThread {
 
+    // Delays the dispatches requested by the timers of the main RunLoop.
+    private static ScheduledExecutorService timerExecutor;
+
     private static void fwkScheduleDispatchFunctions() {
         Invoker.getInvoker().postOnEventThread(() -> {
             twkScheduleDispatchFunctions();
         });
     }
 
+    /**
+     * @param delay time to wait in seconds
+     */
+    private static synchronized void fwkScheduleDispatchFunctionsAfter(double delay) {
+        if (timerExecutor == null) {
+            timerExecutor = new ScheduledThreadPoolExecutor(1, r -> {
+                Thread thread = new Thread(r, "WebPane-RunLoopTimer");
+                thread.setDaemon(true);
+                return thread;
+            });
+        }
+        // Rounded up: native timers must not be found unexpired when dispatched.
+        timerExecutor.schedule(MainThread::fwkScheduleDispatchFunctions,
+                (long) Math.ceil(delay * 1e9), TimeUnit.NANOSECONDS);
+    }
+
     private static native void twkScheduleDispatchFunctions();
 }
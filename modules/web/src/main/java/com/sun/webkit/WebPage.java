@@ -128,6 +128,9 @@ public final class WebPage {
     // An ID of the current updateContent cycle associated with an updateContent call.
     private int updateContentCycleID;
 
+    // The size of the tiled backing store of the new pages, 0 if not used.
+    private static long tiledBackingStoreSize;
+
     static {
         AccessController.doPrivileged((PrivilegedAction<Void>) () -> {
             NativeLibLoader.loadLibrary("jfxwebkit");
@@ -152,8 +155,28 @@ public final class WebPage {
                     "com.sun.webkit.useCSS3D", "false"));
             useCSS3D = useCSS3D && Platform.isSupported(ConditionalFeature.SCENE3D);
 
+            // Release memory when the system (or the container) runs low.
+            final boolean useMemoryPressureMonitor = Boolean.valueOf(System.getProperty(
+                    "com.sun.webkit.useMemoryPressureMonitor", "true"));
+
             // Initialize WTF, WebCore and JavaScriptCore.
-            twkInitWebCore(useJIT, useDFGJIT, useCSS3D);
+            twkInitWebCore(useJIT, useDFGJIT, useCSS3D, useMemoryPressureMonitor);
+
+            // Keep the bytecode of the page scripts on disk (off by default).
+            final String bytecodeCacheDirectory = System.getProperty(
+                    "com.sun.webkit.bytecodeCacheDirectory");
+            if (bytecodeCacheDirectory != null) {
+                setBytecodeCache(bytecodeCacheDirectory, Long.getLong(
+                        "com.sun.webkit.bytecodeCacheMaxSize",
+                        DEFAULT_BYTECODE_CACHE_MAX_SIZE));
+            }
+
+            // Keep the painted contents of the pages in tiles (off by default).
+            if (Boolean.getBoolean("com.sun.webkit.tiledBackingStore")) {
+                tiledBackingStoreSize = Long.getLong(
+                        "com.sun.webkit.tiledBackingStoreMaxSize",
+                        DEFAULT_TILED_BACKING_STORE_MAX_SIZE);
+            }
             return null;
         });
 
@@ -197,6 +220,9 @@ public final class WebPage {
         pPage = twkCreatePage(editable);
 
         twkInit(pPage, false, WCGraphicsManager.getGraphicsManager().getDevicePixelScale());
+        if (tiledBackingStoreSize > 0) {
+            twkSetTiledBackingStore(pPage, true, tiledBackingStoreSize);
+        }
 
         if (pageClient != null && pageClient.isBackBufferSupported()) {
             backbuffer = pageClient.createBackBuffer();
@@ -244,6 +270,9 @@ public final class WebPage {
     private WCPageBackBuffer backbuffer;
     private List<WCRectangle> dirtyRects = new LinkedList<WCRectangle>();
 
+    // Whether the composited layers need an update, with no rect to repaint.
+    private boolean updateRequested;
+
     private void addDirtyRect(WCRectangle toPaint) {
         if (toPaint.getWidth() <= 0 || toPaint.getHeight() <= 0) {
             return;
@@ -276,7 +305,7 @@ public final class WebPage {
     public boolean isDirty() {
         lockPage();
         try {
-            return !dirtyRects.isEmpty();
+            return !dirtyRects.isEmpty() || updateRequested;
         } finally {
             unlockPage();
         }
@@ -294,6 +323,7 @@ public final class WebPage {
             // Clear the list so that the platform doesn't consider
             // the page dirty.
             dirtyRects.clear();
+            updateRequested = false;
             return;
         }
         if (clip == null) {
@@ -301,12 +331,20 @@ public final class WebPage {
         }
         List<WCRectangle> oldDirtyRects = dirtyRects;
         dirtyRects = new LinkedList<WCRectangle>();
+        updateRequested = false;
         twkPrePaint(getPage());
+        // The area repainted, composited again along with the changed layers
+        WCRectangle repainted = new WCRectangle();
         while (!oldDirtyRects.isEmpty()) {
             WCRectangle r = oldDirtyRects.remove(0).intersection(clip);
             if (r.getWidth() <= 0 || r.getHeight() <= 0) {
                 continue;
             }
+            if (repainted.isEmpty()) {
+                repainted.setFrame(r.getX(), r.getY(), r.getWidth(), r.getHeight());
+            } else {
+                WCRectangle.union(repainted, r, repainted);
+            }
             paintLog.log(Level.FINEST, "Updating: {0}", r);
             WCRenderQueue rq = WCGraphicsManager.getGraphicsManager()
                     .createRenderQueue(r, true);
@@ -318,8 +356,8 @@ public final class WebPage {
             WCRenderQueue rq = WCGraphicsManager.getGraphicsManager()
                     .createRenderQueue(clip, false);
             twkPostPaint(getPage(), rq,
-                         clip.getIntX(), clip.getIntY(),
-                         clip.getIntWidth(), clip.getIntHeight());
+                         repainted.getIntX(), repainted.getIntY(),
+                         repainted.getIntWidth(), repainted.getIntHeight());
             currentFrame.addRenderQueue(rq);
         }
 
@@ -2101,6 +2139,209 @@ public final class WebPage {
         }
     }
 
+    // ---- MEMORY ---- //
+
+    /**
+     * Releases the memory held by the caches of all the pages, as done when
+     * the system runs low on memory.
+     * @param critical {@code false} to release the font, style and dead
+     *        resource caches only, {@code true} to also empty the page cache,
+     *        drop the decoded data of live resources, discard the compiled
+     *        JavaScript code and collect the JavaScript heap.
+     */
+    public static void releaseMemory(boolean critical) {
+        Invoker.getInvoker().checkEventThread();
+        lockPage();
+        try {
+            log.log(Level.FINE, "Releasing memory, critical: [{0}]", critical);
+            twkReleaseMemory(critical);
+        } finally {
+            unlockPage();
+        }
+    }
+
+    // ---- BYTECODE CACHE ---- //
+
+    public static final long DEFAULT_BYTECODE_CACHE_MAX_SIZE = 64L * 1024 * 1024;
+
+    /**
+     * Counters of the bytecode cache, since the start of the process.
+     */
+    public static final class BytecodeCacheStatistics {
+        private final long[] values;
+
+        private BytecodeCacheStatistics(long[] values) {
+            this.values = values;
+        }
+
+        /** Scripts whose bytecode was read from the cache. */
+        public long getHits() { return values[0]; }
+
+        /** Scripts that were not in the cache. */
+        public long getMisses() { return values[1]; }
+
+        /** Cache entries that were outdated, and compiled again. */
+        public long getRejected() { return values[2]; }
+
+        /** Bytecode read from the cache instead of being compiled. */
+        public long getBytesLoaded() { return values[3]; }
+
+        public long getBytesWritten() { return values[4]; }
+
+        public long getEvictions() { return values[5]; }
+
+        @Override
+        public String toString() {
+            return String.format("Bytecode cache: hits %d, misses %d, rejected %d, "
+                    + "loaded %d bytes, written %d bytes, evictions %d",
+                    getHits(), getMisses(), getRejected(),
+                    getBytesLoaded(), getBytesWritten(), getEvictions());
+        }
+    }
+
+    /**
+     * Keeps the bytecode JavaScriptCore compiles for the external scripts
+     * of all the pages in {@code directory}, so that the next loads of the
+     * same scripts (in this or a later process) skip their compilation.
+     * Entries are keyed by script URL and contents. The least recently used
+     * ones are removed when the directory grows over {@code maxSize} bytes.
+     * Only supported on Linux; does nothing elsewhere.
+     * @param directory the cache directory, created if needed, or
+     *        {@code null} to stop using the cache
+     * @param maxSize the maximum size of the directory, in bytes
+     */
+    public static void setBytecodeCache(String directory, long maxSize) {
+        if (maxSize <= 0) {
+            throw new IllegalArgumentException("maxSize: " + maxSize);
+        }
+        log.log(Level.FINE, "Bytecode cache: [{0}], max size: [{1}]",
+                new Object[] {directory, maxSize});
+        twkSetBytecodeCache(directory, maxSize);
+    }
+
+    public static BytecodeCacheStatistics getBytecodeCacheStatistics() {
+        long[] values = new long[6];
+        twkGetBytecodeCacheStatistics(values);
+        return new BytecodeCacheStatistics(values);
+    }
+
+    // ---- TILED BACKING STORE ---- //
+
+    public static final long DEFAULT_TILED_BACKING_STORE_MAX_SIZE = 32L * 1024 * 1024;
+
+    /**
+     * Counters of the tiled backing store of a page, since it was enabled.
+     */
+    public static final class TiledBackingStoreStatistics {
+        private final long[] values;
+
+        private TiledBackingStoreStatistics(long[] values) {
+            this.values = values;
+        }
+
+        /** Tiles drawn without being painted. */
+        public long getHits() { return values[0]; }
+
+        /** Tiles painted when drawn. */
+        public long getMisses() { return values[1]; }
+
+        /** Tiles painted ahead of the scroll, while the page was idle. */
+        public long getPrerendered() { return values[2]; }
+
+        public long getEvictions() { return values[3]; }
+
+        /** Time spent painting the tiles, in microseconds. */
+        public long getPaintTime() { return values[4]; }
+
+        @Override
+        public String toString() {
+            return String.format("Tiled backing store: hits %d, misses %d, "
+                    + "prerendered %d, evictions %d, paint time %d us",
+                    getHits(), getMisses(), getPrerendered(),
+                    getEvictions(), getPaintTime());
+        }
+    }
+
+    /**
+     * Keeps the painted contents of the page in tiles, when it is not
+     * composited, so that scrolling draws the tiles instead of painting the
+     * page again. The tiles ahead in the scroll direction are painted while
+     * the page is idle. The least recently drawn tiles are dropped when the
+     * tiles grow over {@code maxSize} bytes.
+     * Pages with fixed position elements are painted as usual.
+     * @param enabled whether to use the tiles
+     * @param maxSize the maximum size of the tiles, in bytes
+     */
+    public void setTiledBackingStore(boolean enabled, long maxSize) {
+        if (maxSize <= 0) {
+            throw new IllegalArgumentException("maxSize: " + maxSize);
+        }
+        lockPage();
+        try {
+            log.log(Level.FINE, "Tiled backing store: [{0}], max size: [{1}]",
+                    new Object[] {enabled, maxSize});
+            if (isDisposed) {
+                log.log(Level.FINE, "setTiledBackingStore() request for a disposed web page.");
+                return;
+            }
+            twkSetTiledBackingStore(getPage(), enabled, maxSize);
+        } finally {
+            unlockPage();
+        }
+    }
+
+    /**
+     * Counters of the compositing of the page, when it has composited layers.
+     * Only the areas changed since the previous frame are composited.
+     */
+    public static final class CompositingStatistics {
+        private final long[] values;
+
+        private CompositingStatistics(long[] values) {
+            this.values = values;
+        }
+
+        public long getFrames() { return values[0]; }
+
+        /** Pixels composited, over all the frames. */
+        public long getCompositedArea() { return values[1]; }
+
+        /** Pixels of the page, over all the frames. */
+        public long getPageArea() { return values[2]; }
+
+        @Override
+        public String toString() {
+            return String.format("Compositing: %d frames, %d of %d pixels composited",
+                    getFrames(), getCompositedArea(), getPageArea());
+        }
+    }
+
+    public CompositingStatistics getCompositingStatistics() {
+        long[] values = new long[3];
+        lockPage();
+        try {
+            if (!isDisposed) {
+                twkGetCompositingStatistics(getPage(), values);
+            }
+        } finally {
+            unlockPage();
+        }
+        return new CompositingStatistics(values);
+    }
+
+    public TiledBackingStoreStatistics getTiledBackingStoreStatistics() {
+        long[] values = new long[5];
+        lockPage();
+        try {
+            if (!isDisposed) {
+                twkGetTiledBackingStoreStatistics(getPage(), values);
+            }
+        } finally {
+            unlockPage();
+        }
+        return new TiledBackingStoreStatistics(values);
+    }
+
     // *************************************************************************
     // Native callbacks
     // *************************************************************************
@@ -2136,6 +2377,16 @@ public final class WebPage {
         }
     }
 
+    private void fwkRequestUpdate() {
+        lockPage();
+        try {
+            paintLog.finest("Update requested");
+            updateRequested = true;
+        } finally {
+            unlockPage();
+        }
+    }
+
     private void fwkScroll(int x, int y, int w, int h, int deltaX, int deltaY) {
         if (paintLog.isLoggable(Level.FINEST)) {
             paintLog.finest("Scroll: " + x + " " + y + " " + w + " " + h + "  " + deltaX + " " + deltaY);
@@ -2559,7 +2810,8 @@ public final class WebPage {
     // Native methods
     // *************************************************************************
 
-    private static native void twkInitWebCore(boolean useJIT, boolean useDFGJIT, boolean useCSS3D);
+    private static native void twkInitWebCore(boolean useJIT, boolean useDFGJIT, boolean useCSS3D,
+                                              boolean useMemoryPressureMonitor);
     private native long twkCreatePage(boolean editable);
     private native void twkInit(long pPage, boolean usePlugins, float devicePixelScale);
     private native void twkDestroyPage(long pPage);
@@ -2622,6 +2874,9 @@ public final class WebPage {
     private native void twkUpdateRendering(long pPage);
     private native void twkPostPaint(long pPage, WCRenderQueue rq,
                                      int x, int y, int w, int h);
+    private native void twkGetCompositingStatistics(long pPage, long[] values);
+    private native void twkSetTiledBackingStore(long pPage, boolean enabled, long maxSize);
+    private native void twkGetTiledBackingStoreStatistics(long pPage, long[] values);
 
     private native String twkGetEncoding(long pPage);
     private native void twkSetEncoding(long pPage, String encoding);
@@ -2689,4 +2944,7 @@ public final class WebPage {
     private native void twkDispatchInspectorMessageFromFrontend(long pPage,
                                                                 String message);
     private static native void twkDoJSCGarbageCollection();
+    private static native void twkReleaseMemory(boolean critical);
+    private static native void twkSetBytecodeCache(String directory, long maxSize);
+    private static native void twkGetBytecodeCacheStatistics(long[] values);
 }
@@ -61,7 +61,6 @@ public final class GraphicsDecoder  {
     @Native public final static int SCALE                  = 27;
     @Native public final static int SETSHADOW              = 28;
     @Native public final static int DRAWSTRING             = 29;
-    @Native public final static int DRAWSTRING_FAST        = 31;
     @Native public final static int DRAWWIDGET             = 33;
     @Native public final static int DRAWSCROLLBAR          = 34;
     @Native public final static int CLEARRECT_FFFF         = 36;
@@ -85,6 +84,8 @@ public final class GraphicsDecoder  {
     @Native public final static int SET_MITER_LIMIT        = 54;
     @Native public final static int SET_TEXT_MODE          = 55;
     @Native public final static int SET_PERSPECTIVE_TRANSFORM = 56;
+    @Native public final static int FILLRECTS_FFFF         = 57;
+    @Native public final static int DRAWGLYPHS             = 58;
 
     private final static Logger log =
         Logger.getLogger(GraphicsDecoder.class.getName());
@@ -110,6 +111,18 @@ public final class GraphicsDecoder  {
                         buf.getFloat(),
                         null);
                     break;
+                case FILLRECTS_FFFF: {
+                    int n = buf.getInt();   // number of rectangles
+                    for (int i = 0; i < n; i++) {
+                        gc.fillRect(
+                            buf.getFloat(),
+                            buf.getFloat(),
+                            buf.getFloat(),
+                            buf.getFloat(),
+                            null);
+                    }
+                    break;
+                }
                 case FILLRECT_FFFFI:
                     gc.fillRect(
                         buf.getFloat(),
@@ -301,14 +314,14 @@ public final class GraphicsDecoder  {
                         buf.getInt(), buf.getInt(),     // from and to positions
                         buf.getFloat(), buf.getFloat());// (x,y) position
                     break;
-                case DRAWSTRING_FAST:
-                    gc.drawString(
-                        (WCFont) gm.getRef(buf.getInt()),
-                        bdata.getIntArray(buf.getInt()), //glyphs
-                        bdata.getFloatArray(buf.getInt()), //offsets
-                        buf.getFloat(),
-                        buf.getFloat());
+                case DRAWGLYPHS: {
+                    WCFont font = (WCFont) gm.getRef(buf.getInt());
+                    int n = buf.getInt();   // number of glyphs
+                    float x = buf.getFloat();
+                    float y = buf.getFloat();
+                    gc.drawString(font, getIntArray(buf, n), getFloatArray(buf, n), x, y);
                     break;
+                }
                 case DRAWWIDGET:
                     gc.drawWidget((RenderTheme)(gm.getRef(buf.getInt())),
                         gm.getRef(buf.getInt()), buf.getInt(), buf.getInt());
@@ -452,10 +465,20 @@ public final class GraphicsDecoder  {
     }
 
     private static float[] getFloatArray(ByteBuffer buf) {
-        float[] array = new float[buf.getInt()];
-        for (int i = 0; i < array.length; i++) {
-            array[i] = buf.getFloat();
-        }
+        return getFloatArray(buf, buf.getInt());
+    }
+
+    private static float[] getFloatArray(ByteBuffer buf, int length) {
+        float[] array = new float[length];
+        buf.asFloatBuffer().get(array);
+        buf.position(buf.position() + length * Float.BYTES);
+        return array;
+    }
+
+    private static int[] getIntArray(ByteBuffer buf, int length) {
+        int[] array = new int[length];
+        buf.asIntBuffer().get(array);
+        buf.position(buf.position() + length * Integer.BYTES);
         return array;
     }
 
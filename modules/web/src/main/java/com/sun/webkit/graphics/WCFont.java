@@ -37,9 +37,18 @@ public abstract class WCFont extends Ref {
 
     public abstract float getXHeight();
 
-    public abstract double getGlyphWidth(int glyph);
-
-    public abstract float[] getGlyphBoundingBox(int glyph);
+    /**
+     * Returns the metrics of the consecutive glyphs starting at
+     * {@code firstGlyph}: their advances in {@code advances}, and their
+     * bounding boxes as 4 values (x, y, width, height) per glyph in
+     * {@code bounds}. Either array may be {@code null}.
+     * NB: This method is called from native code!
+     *
+     * @param firstGlyph  the code of the first glyph
+     * @param advances  the array receiving one advance per glyph, or {@code null}
+     * @param bounds  the array receiving 4 values per glyph, or {@code null}
+     */
+    public abstract void getGlyphMetrics(int firstGlyph, float[] advances, float[] bounds);
 
     /**
      * Returns a hash code value for the object.
@@ -93,6 +93,14 @@ public abstract class WCGraphicsManager {
 
     protected abstract WCPath createWCPath(WCPath path);
 
+    /**
+     * Creates a path from segments built natively, in the layout of
+     * {@link WCPathIterator}: one SEG_* type per segment and two coordinates
+     * per point. The arrays are owned by the path from now on.
+     */
+    protected abstract WCPath createWCPath(byte[] types, int numTypes,
+                                           float[] coords, int numCoords);
+
     protected abstract WCImage createWCImage(int w, int h);
 
     protected abstract WCImage createRTImage(int w, int h);
@@ -25,16 +25,20 @@
 
 package com.sun.webkit.graphics;
 
+import java.nio.ByteBuffer;
 
 public abstract class WCImageDecoder {
 
     /**
      * Receives a portion of image data.
      *
+     * The buffer is a direct view of native memory, which stays valid
+     * until {@link #destroy()} is called.
+     *
      * @param data  a portion of image data,
      *              or {@code null} if all data received
      */
-    protected abstract void addImageData(byte[] data);
+    protected abstract void addImageData(ByteBuffer data);
 
     /**
      * Returns image size.
@@ -39,6 +39,8 @@ public abstract class WCRenderQueue extends Ref {
     private final static Logger log =
         Logger.getLogger(WCRenderQueue.class.getName());
     @Native public final static int MAX_QUEUE_SIZE = 0x80000;
+    // Upper bound of GraphicsDecoder opcodes counted by the native encoder.
+    @Native public final static int MAX_OPCODE = 64;
 
     private final LinkedList<BufferData> buffers = new LinkedList<BufferData>();
     private BufferData currentBuffer = new BufferData();
@@ -73,7 +75,7 @@ public abstract class WCRenderQueue extends Ref {
         currentBuffer.setBuffer(buffer);
         buffers.addLast(currentBuffer);
         currentBuffer = new BufferData();
-        size += buffer.capacity();
+        size += buffer.limit();
         if (size > MAX_QUEUE_SIZE && gc!=null) {
             // It is isolated queue over the canvas image [image-gc!=null].
             // We need to flush the changes periodically
@@ -127,7 +129,11 @@ public abstract class WCRenderQueue extends Ref {
         flush();
     }
 
-    private void fwkAddBuffer(ByteBuffer buffer) {
+    private void fwkAddBuffer(ByteBuffer buffer, int limit) {
+        // Native buffers are recycled, so the same NIO wrapper may
+        // come back here with a different amount of data.
+        buffer.clear();
+        buffer.limit(limit);
         addBuffer(buffer);
     }
 
@@ -163,19 +169,31 @@ public abstract class WCRenderQueue extends Ref {
 
     private native void twkRelease(Object[] bufs);
 
-    /*is called from native*/
-    private int refString(String str) {
-        return currentBuffer.addString(str);
-    }
-
-    /*is called from native*/
-    private int refIntArr(int[] arr) {
-        return currentBuffer.addIntArray(arr);
+    private static native void twkGetEncoderHistogram(int[] emitted, int[] elided);
+
+    /**
+     * Returns the number of operations written to render queues and the
+     * number of operations dropped (or merged) by the native encoder,
+     * per GraphicsDecoder opcode.
+     */
+    public static String getEncoderStatistics() {
+        int[] emitted = new int[MAX_OPCODE];
+        int[] elided = new int[MAX_OPCODE];
+        twkGetEncoderHistogram(emitted, elided);
+
+        StringBuilder sb = new StringBuilder("Render queue encoder:\n");
+        for (int op = 0; op < MAX_OPCODE; op++) {
+            if (emitted[op] != 0 || elided[op] != 0) {
+                sb.append(String.format("opcode %d: written %d, dropped %d%n",
+                                        op, emitted[op], elided[op]));
+            }
+        }
+        return sb.toString();
     }
 
     /*is called from native*/
-    private int refFloatArr(float[] arr) {
-        return currentBuffer.addFloatArray(arr);
+    private int refString(String str) {
+        return currentBuffer.addString(str);
     }
 
     public boolean isOpaque() {
@@ -196,10 +214,6 @@ final class BufferData {
     private final AtomicInteger idCount = new AtomicInteger(0);
     private final HashMap<Integer,String> strMap =
             new HashMap<Integer,String>();
-    private final HashMap<Integer,int[]> intArrMap =
-            new HashMap<Integer,int[]>();
-    private final HashMap<Integer,float[]> floatArrMap =
-            new HashMap<Integer,float[]>();
 
     private ByteBuffer buffer;
 
@@ -207,26 +221,6 @@ final class BufferData {
         return idCount.incrementAndGet();
     }
 
-    int addIntArray(int[] a) {
-        int id = createID();
-        intArrMap.put(id, a);
-        return id;
-    }
-
-    int[] getIntArray(int id) {
-        return intArrMap.get(id);
-    }
-
-    int addFloatArray(float[] a) {
-        int id = createID();
-        floatArrMap.put(id, a);
-        return id;
-    }
-
-    float[] getFloatArray(int id) {
-        return floatArrMap.get(id);
-    }
-
     int addString(String s) {
         int id = createID();
         strMap.put(id, s);
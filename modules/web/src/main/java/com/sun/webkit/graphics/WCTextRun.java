@@ -28,9 +28,15 @@ package com.sun.webkit.graphics;
 public interface WCTextRun {
     boolean isLeftToRight();
     float[] getGlyphPosAndAdvance(int glyphIndex);
-    int getCharOffset(int index);
     int getEnd();
-    int getGlyph(int index);
     int getGlyphCount();
     int getStart();
+
+    /**
+     * Copies the codes of the glyphs of this run into {@code glyphs}, the
+     * offsets of their characters into {@code charOffsets} and their
+     * advances into {@code advances}. Each array holds getGlyphCount() values.
+     * NB: This method is called from native code!
+     */
+    void getGlyphs(int[] glyphs, int[] charOffsets, float[] advances);
 }
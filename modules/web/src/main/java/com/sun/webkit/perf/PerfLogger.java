@@ -261,6 +261,23 @@ public final class PerfLogger {
         stat.resume();
     }
 
+    /**
+     * Adds an invocation of the probe that took {@code time} ms, for the
+     * cases that are measured by the caller (e.g. running concurrently).
+     */
+    public synchronized void addCount(String probe, long time) {
+        if (!isEnabled()) {
+            return;
+        }
+        String p = probe.intern();
+        ProbeStat stat = probes.get(p);
+        if (stat == null) {
+            stat = registerProbe(p);
+        }
+        stat.count++;
+        stat.totalTime += time;
+    }
+
     /**
      * Prints perf statistics to the buffer.
      */
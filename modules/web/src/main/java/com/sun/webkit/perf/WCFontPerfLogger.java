@@ -86,18 +86,10 @@ public final class WCFontPerfLogger extends WCFont {
         return res;
     }
 
-    public double getGlyphWidth(int glyph) {
-        logger.resumeCount("GETGLYPHWIDTH");
-        double res = fnt.getGlyphWidth(glyph);
-        logger.suspendCount("GETGLYPHWIDTH");
-        return res;
-    }
-
-    public float[] getGlyphBoundingBox(int glyph) {
-        logger.resumeCount("GETGLYPHBOUNDINGBOX");
-        float[] res = fnt.getGlyphBoundingBox(glyph);
-        logger.suspendCount("GETGLYPHBOUNDINGBOX");
-        return res;
+    public void getGlyphMetrics(int firstGlyph, float[] advances, float[] bounds) {
+        logger.resumeCount("GETGLYPHMETRICS");
+        fnt.getGlyphMetrics(firstGlyph, advances, bounds);
+        logger.suspendCount("GETGLYPHMETRICS");
     }
 
     public int hashCode() {
@@ -40,6 +40,7 @@ import com.sun.webkit.graphics.WCImage;
 import com.sun.webkit.graphics.WCPath;
 import com.sun.webkit.graphics.WCPoint;
 import com.sun.webkit.graphics.WCRectangle;
+import com.sun.webkit.graphics.WCRenderQueue;
 import com.sun.webkit.graphics.WCTransform;
 
 public final class WCGraphicsPerfLogger extends WCGraphicsContext {
@@ -59,6 +60,9 @@ public final class WCGraphicsPerfLogger extends WCGraphicsContext {
 
     public static void log() {
         logger.log();
+        if (logger.isEnabled()) {
+            log.fine(WCRenderQueue.getEncoderStatistics());
+        }
     }
 
     public static void reset() {
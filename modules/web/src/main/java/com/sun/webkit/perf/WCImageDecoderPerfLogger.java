@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package com.sun.webkit.perf;
+
+import java.util.logging.Logger;
+
+/**
+ * Decode time of images. Decoding runs on several threads at once, so
+ * the decoders measure it themselves and report each decoded image here.
+ */
+public final class WCImageDecoderPerfLogger {
+    private static final Logger log = Logger.getLogger(WCImageDecoderPerfLogger.class.getName());
+
+    private static final PerfLogger logger = PerfLogger.getLogger(log);
+
+    private WCImageDecoderPerfLogger() {
+    }
+
+    public synchronized static boolean isEnabled() {
+        return logger.isEnabled();
+    }
+
+    /**
+     * Reports one decode of an image.
+     *
+     * @param decoder   the decoder, for identification in the log
+     * @param extension the image format, or {@code null} if unknown
+     * @param size      the number of encoded bytes decoded
+     * @param frames    the number of decoded frames
+     * @param complete  whether all the image data were received
+     * @param nanos     the decode time
+     */
+    public static void logDecode(Object decoder, String extension, int size,
+                                 int frames, boolean complete, long nanos)
+    {
+        if (!logger.isEnabled()) {
+            return;
+        }
+        long ms = nanos / 1000000;
+        logger.addCount(complete ? "DECODE" : "DECODE_PARTIAL", ms);
+        if (extension != null) {
+            logger.addCount("DECODE_" + extension.toUpperCase(), ms);
+        }
+        log.fine(String.format("%X Decoded %s%s image of %d bytes, %d frame(s) in %.3fms",
+                decoder.hashCode(), complete ? "" : "partial ",
+                extension == null ? "unknown" : extension, size, frames,
+                nanos / 1e6));
+    }
+
+    public static void log() {
+        logger.log();
+    }
+
+    public static void reset() {
+        logger.reset();
+    }
+}
@@ -293,7 +293,7 @@ MappedFileData::MappedFileData(const String& filePath, MappedFileMode mapMode, b
     closeFile(fd);
 }
 
-#if HAVE(MMAP) && !PLATFORM(JAVA)
+#if HAVE(MMAP) && (!PLATFORM(JAVA) || OS(LINUX))
 
 bool MappedFileData::mapFileHandle(PlatformFileHandle handle, FileOpenMode openMode, MappedFileMode mapMode)
 {
@@ -305,8 +305,7 @@ bool MappedFileData::mapFileHandle(PlatformFileHandle handle, FileOpenMode openM
     auto* inputStream = g_io_stream_get_input_stream(G_IO_STREAM(handle));
     fd = g_file_descriptor_based_get_fd(G_FILE_DESCRIPTOR_BASED(inputStream));
 #else
-    // FIXME: jfx2.26 compilation failure
-    // fd = handle;
+    fd = handle;
 #endif
 
     struct stat fileStat;
@@ -75,7 +75,7 @@ typedef HANDLE PlatformFileHandle;
 // FIXME: -1 is INVALID_HANDLE_VALUE, defined in <winbase.h>. Chromium tries to
 // avoid using Windows headers in headers. We'd rather move this into the .cpp.
 const PlatformFileHandle invalidPlatformFileHandle = reinterpret_cast<HANDLE>(-1);
-#elif PLATFORM(JAVA)
+#elif PLATFORM(JAVA) && !OS(LINUX)
 typedef JGObject PlatformFileHandle;
 const PlatformFileHandle invalidPlatformFileHandle { nullptr };
 #else
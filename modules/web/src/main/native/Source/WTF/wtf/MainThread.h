@@ -74,6 +74,7 @@ WTF_EXPORT_PRIVATE bool isMainThreadOrGCThread();
 void initializeMainThreadPlatform();
 #if PLATFORM(JAVA)
 void scheduleDispatchFunctionsOnMainThread();
+void scheduleDispatchFunctionsOnMainThread(Seconds delay);
 #endif
 
 } // namespace WTF
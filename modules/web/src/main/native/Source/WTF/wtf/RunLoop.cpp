@@ -183,6 +183,9 @@ void RunLoop::suspendFunctionDispatchForCurrentCycle()
 #if PLATFORM(JAVA)
 void RunLoop::dispatchFunctionsFromMainThread()
 {
+#if USE(GENERIC_EVENT_LOOP)
+    fireExpiredTimers();
+#endif
     performWork();
 }
 #endif
@@ -253,6 +253,13 @@ private:
     };
     void runImpl(RunMode);
     bool populateTasks(RunMode, Status&, Deque<RefPtr<TimerBase::ScheduledTask>>&);
+    void takeExpiredTimers(const AbstractLocker&, Deque<RefPtr<TimerBase::ScheduledTask>>&);
+#if PLATFORM(JAVA)
+    // The main loop of the java port is never run: its timers are fired
+    // from dispatchFunctionsFromMainThread.
+    void fireExpiredTimers();
+    void scheduleTimerWakeUp(const AbstractLocker&);
+#endif
 
     friend class TimerBase;
 
@@ -263,6 +270,9 @@ private:
     Vector<Status*> m_mainLoops;
     bool m_shutdown { false };
     bool m_pendingTasks { false };
+#if PLATFORM(JAVA)
+    MonotonicTime m_timerWakeUp { MonotonicTime::infinity() };
+#endif
 #endif
 
 #if USE(GENERIC_EVENT_LOOP) || USE(WINDOWS_EVENT_LOOP)
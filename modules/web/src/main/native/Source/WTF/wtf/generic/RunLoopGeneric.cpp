@@ -27,6 +27,10 @@
 #include "config.h"
 #include <wtf/RunLoop.h>
 
+#if PLATFORM(JAVA)
+#include <wtf/MainThread.h>
+#endif
+
 namespace WTF {
 
 class RunLoop::TimerBase::ScheduledTask : public ThreadSafeRefCounted<ScheduledTask> {
@@ -136,7 +140,12 @@ inline bool RunLoop::populateTasks(RunMode runMode, Status& statusOfThisLoop, De
     if (runMode == RunMode::Iterate)
         statusOfThisLoop = Status::Stopping;
 
-    // Check expired timers.
+    takeExpiredTimers(locker, firedTimers);
+    return true;
+}
+
+void RunLoop::takeExpiredTimers(const AbstractLocker&, Deque<RefPtr<TimerBase::ScheduledTask>>& firedTimers)
+{
     MonotonicTime now = MonotonicTime::now();
     while (!m_schedules.isEmpty()) {
         RefPtr<TimerBase::ScheduledTask> earliest = m_schedules.first();
@@ -146,10 +155,45 @@ inline bool RunLoop::populateTasks(RunMode runMode, Status& statusOfThisLoop, De
         m_schedules.removeLast();
         firedTimers.append(WTFMove(earliest));
     }
+}
 
-    return true;
+#if PLATFORM(JAVA)
+void RunLoop::fireExpiredTimers()
+{
+    Deque<RefPtr<TimerBase::ScheduledTask>> firedTimers;
+    {
+        LockHolder locker(m_loopLock);
+        // The requested wake up has come (the java side may round it off a little early).
+        if (m_timerWakeUp <= MonotonicTime::now() + 1_ms)
+            m_timerWakeUp = MonotonicTime::infinity();
+        takeExpiredTimers(locker, firedTimers);
+    }
+
+    while (!firedTimers.isEmpty()) {
+        RefPtr<TimerBase::ScheduledTask> task = firedTimers.takeFirst();
+        if (task->fired())
+            schedule(*task);
+    }
+
+    LockHolder locker(m_loopLock);
+    scheduleTimerWakeUp(locker);
 }
 
+void RunLoop::scheduleTimerWakeUp(const AbstractLocker&)
+{
+    if (m_schedules.isEmpty())
+        return;
+
+    // Nothing to do if an earlier wake up is already on its way.
+    MonotonicTime fireTime = m_schedules.first()->scheduledTimePoint();
+    if (fireTime >= m_timerWakeUp)
+        return;
+
+    m_timerWakeUp = fireTime;
+    scheduleDispatchFunctionsOnMainThread(std::max<Seconds>(fireTime - MonotonicTime::now(), 0_s));
+}
+#endif
+
 void RunLoop::runImpl(RunMode runMode)
 {
     ASSERT(this == &RunLoop::current());
@@ -213,6 +257,12 @@ void RunLoop::stop()
 
 void RunLoop::wakeUp(const AbstractLocker&)
 {
+#if PLATFORM(JAVA)
+    if (this == &RunLoop::main()) {
+        scheduleDispatchFunctionsOnMainThread();
+        return;
+    }
+#endif
     m_pendingTasks = true;
     m_readyToRun.notifyOne();
 
@@ -247,6 +297,12 @@ void RunLoop::schedule(Ref<TimerBase::ScheduledTask>&& task)
 void RunLoop::scheduleAndWakeUp(const AbstractLocker& locker, Ref<TimerBase::ScheduledTask>&& task)
 {
     schedule(locker, WTFMove(task));
+#if PLATFORM(JAVA)
+    if (this == &RunLoop::main()) {
+        scheduleTimerWakeUp(locker);
+        return;
+    }
+#endif
     wakeUp(locker);
 }
 
@@ -330,6 +330,29 @@ struct SSizeCounterLogger {\
 #define LOG_COMMON_SIZE_ADD(size)    __lSizeCount__.add((LONG)size);
 #define LOG_COMMON_SIZE_REMOVE(size) __lSizeCount__.remove((LONG)size);
 
+#define LOG_HIT_RATIO(T) \
+struct SHitRatioLogger {\
+    void hit() {\
+        LONG p = InterlockedIncrement(getHits()); \
+        DBG::snTrace(L"%p " L#T L" Hit:%d Miss:%d", this, p, *getMisses());\
+    }\
+    void miss() {\
+        LONG p = InterlockedIncrement(getMisses()); \
+        DBG::snTrace(L"%p " L#T L" Hit:%d Miss:%d", this, *getHits(), p);\
+    }\
+    LPLONG getHits() {\
+        static LONG hitCount = 0L;\
+        return &hitCount;\
+    }\
+    LPLONG getMisses() {\
+        static LONG missCount = 0L;\
+        return &missCount;\
+    }\
+} __lHitRatio__;
+
+#define LOG_HIT()  __lHitRatio__.hit();
+#define LOG_MISS() __lHitRatio__.miss();
+
 #else //WIN32 & debug
 
 #define DBG_CHECKPOINT(a1, a2)
@@ -338,6 +361,9 @@ struct SSizeCounterLogger {\
 #define LOG_COMMON_SIZE(T)
 #define LOG_COMMON_SIZE_ADD(size)
 #define LOG_COMMON_SIZE_REMOVE(size)
+#define LOG_HIT_RATIO(T)
+#define LOG_HIT()
+#define LOG_MISS()
 
 #endif//WIN32 & debug
 
@@ -346,11 +372,17 @@ struct SSizeCounterLogger {\
 #define RQ_LOG_COMMON_SIZE(T) LOG_COMMON_SIZE(T)
 #define RQ_LOG_COMMON_SIZE_ADD(size) LOG_COMMON_SIZE_ADD(size)
 #define RQ_LOG_COMMON_SIZE_REMOVE(size) LOG_COMMON_SIZE_REMOVE(size)
+#define RQ_LOG_HIT_RATIO(T) LOG_HIT_RATIO(T)
+#define RQ_LOG_HIT() LOG_HIT()
+#define RQ_LOG_MISS() LOG_MISS()
 #else
 #define RQ_LOG_INSTANCE_COUNT(T)
 #define RQ_LOG_COMMON_SIZE(T)
 #define RQ_LOG_COMMON_SIZE_ADD(size)
 #define RQ_LOG_COMMON_SIZE_REMOVE(size)
+#define RQ_LOG_HIT_RATIO(T)
+#define RQ_LOG_HIT()
+#define RQ_LOG_MISS()
 #endif
 
 #endif//_DBGUTILS_H
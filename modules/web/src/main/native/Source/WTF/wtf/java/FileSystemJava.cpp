@@ -29,6 +29,15 @@
 #include <wtf/java/JavaEnv.h>
 #include <wtf/text/CString.h>
 
+#if OS(LINUX)
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 
 namespace WTF {
 
@@ -206,9 +215,158 @@ Vector<String> listDirectory(const String&, const String&)
 
 CString fileSystemRepresentation(const String& s)
 {
+#if OS(LINUX)
+    return s.utf8();
+#else
     return CString(s.latin1().data());
+#endif
+}
+
+String pathGetFileName(const String& path)
+{
+    JNIEnv* env = WTF::GetJavaEnv();
+
+    static jmethodID mid = env->GetStaticMethodID(
+            comSunWebkitFileSystem,
+            "fwkPathGetFileName",
+            "(Ljava/lang/String;)Ljava/lang/String;");
+    ASSERT(mid);
+
+    JLString result = static_cast<jstring>(env->CallStaticObjectMethod(
+            comSunWebkitFileSystem,
+            mid,
+            (jstring) path.toJavaString(env)));
+    WTF::CheckAndClearException(env);
+
+    return String(env, result);
+}
+
+#if OS(LINUX)
+// Open files are plain file descriptors on Linux, so that they can be mapped
+// and read without a round trip through java for every call.
+
+String openTemporaryFile(const String& prefix, PlatformFileHandle& handle, const String&)
+{
+    const char* tmpDir = getenv("TMPDIR");
+    if (!tmpDir)
+        tmpDir = "/tmp";
+
+    char buffer[PATH_MAX];
+    if (snprintf(buffer, PATH_MAX, "%s/%sXXXXXX", tmpDir, prefix.utf8().data()) >= PATH_MAX) {
+        handle = invalidPlatformFileHandle;
+        return String();
+    }
+
+    handle = mkostemp(buffer, O_CLOEXEC);
+    if (handle < 0) {
+        handle = invalidPlatformFileHandle;
+        return String();
+    }
+    return String::fromUTF8(buffer);
+}
+
+PlatformFileHandle openFile(const String& path, FileOpenMode mode, FileAccessPermission permission, bool failIfFileExists)
+{
+    CString fsRep = fileSystemRepresentation(path);
+    if (fsRep.isNull())
+        return invalidPlatformFileHandle;
+
+    int flags = O_CLOEXEC;
+    switch (mode) {
+    case FileOpenMode::Read:
+        flags |= O_RDONLY;
+        break;
+    case FileOpenMode::Write:
+        flags |= O_WRONLY | O_CREAT | O_TRUNC;
+        break;
+    case FileOpenMode::ReadWrite:
+        flags |= O_RDWR | O_CREAT;
+        break;
+    }
+    if (failIfFileExists)
+        flags |= O_CREAT | O_EXCL;
+
+    mode_t permissions = S_IRUSR | S_IWUSR;
+    if (permission == FileAccessPermission::All)
+        permissions |= S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
+
+    int fd;
+    do {
+        fd = open(fsRep.data(), flags, permissions);
+    } while (fd == -1 && errno == EINTR);
+    return fd;
+}
+
+void closeFile(PlatformFileHandle& handle)
+{
+    if (isHandleValid(handle)) {
+        close(handle);
+        handle = invalidPlatformFileHandle;
+    }
+}
+
+int readFromFile(PlatformFileHandle handle, char* data, int length)
+{
+    if (length < 0 || !isHandleValid(handle) || data == nullptr) {
+        return -1;
+    }
+    do {
+        ssize_t bytesRead = read(handle, data, static_cast<size_t>(length));
+        if (bytesRead >= 0)
+            return static_cast<int>(bytesRead);
+    } while (errno == EINTR);
+    return -1;
 }
 
+int writeToFile(PlatformFileHandle handle, const char* data, int length)
+{
+    if (length < 0 || !isHandleValid(handle) || data == nullptr) {
+        return -1;
+    }
+    do {
+        ssize_t bytesWritten = write(handle, data, static_cast<size_t>(length));
+        if (bytesWritten >= 0)
+            return static_cast<int>(bytesWritten);
+    } while (errno == EINTR);
+    return -1;
+}
+
+bool truncateFile(PlatformFileHandle handle, long long offset)
+{
+    return !ftruncate(handle, offset);
+}
+
+long long seekFile(PlatformFileHandle handle, long long offset, FileSeekOrigin origin)
+{
+    int whence = SEEK_SET;
+    switch (origin) {
+    case FileSeekOrigin::Beginning:
+        whence = SEEK_SET;
+        break;
+    case FileSeekOrigin::Current:
+        whence = SEEK_CUR;
+        break;
+    case FileSeekOrigin::End:
+        whence = SEEK_END;
+        break;
+    }
+    return static_cast<long long>(lseek(handle, offset, whence));
+}
+
+bool getFileSize(PlatformFileHandle handle, long long& result)
+{
+    struct stat fileInfo;
+    if (fstat(handle, &fileInfo))
+        return false;
+
+    result = fileInfo.st_size;
+    return true;
+}
+
+// MappedFileData::mapFileHandle and unmapViewOfFile are the mmap based ones of FileSystem.cpp.
+
+#else
+
 String openTemporaryFile(const String&, PlatformFileHandle& handle, const String&)
 {
     handle = invalidPlatformFileHandle;
@@ -292,25 +450,6 @@ bool truncateFile(PlatformFileHandle, long long offset)
     return false;
 }
 
-String pathGetFileName(const String& path)
-{
-    JNIEnv* env = WTF::GetJavaEnv();
-
-    static jmethodID mid = env->GetStaticMethodID(
-            comSunWebkitFileSystem,
-            "fwkPathGetFileName",
-            "(Ljava/lang/String;)Ljava/lang/String;");
-    ASSERT(mid);
-
-    JLString result = static_cast<jstring>(env->CallStaticObjectMethod(
-            comSunWebkitFileSystem,
-            mid,
-            (jstring) path.toJavaString(env)));
-    WTF::CheckAndClearException(env);
-
-    return String(env, result);
-}
-
 long long seekFile(PlatformFileHandle handle, long long offset, FileSeekOrigin)
 {
     // we always get positive value for offset from webkit.
@@ -335,11 +474,6 @@ long long seekFile(PlatformFileHandle handle, long long offset, FileSeekOrigin)
     return offset;
 }
 
-Optional<int32_t> getFileDeviceId(const CString&)
-{
-    return {};
-}
-
 bool MappedFileData::mapFileHandle(PlatformFileHandle, FileOpenMode, MappedFileMode)
 {
     fprintf(stderr, "MappedFileData::mapFileHandle(PlatformFileHandle handle, MappedFileMode) notImplemented()\n");
@@ -352,6 +486,13 @@ bool unmapViewOfFile(void* , size_t)
     return false;
 }
 
+#endif // OS(LINUX)
+
+Optional<int32_t> getFileDeviceId(const CString&)
+{
+    return {};
+}
+
 } // namespace FileSystemImpl
 
 } // namespace WTF
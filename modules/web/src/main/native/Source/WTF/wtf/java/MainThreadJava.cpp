@@ -7,6 +7,7 @@
 #include <wtf/java/JavaRef.h>
 #include <wtf/MainThread.h>
 #include <wtf/RunLoop.h>
+#include <wtf/Seconds.h>
 
 #if OS(UNIX)
 #include <pthread.h>
@@ -15,6 +16,7 @@
 namespace WTF {
 static JGClass jMainThreadCls;
 static jmethodID fwkScheduleDispatchFunctions;
+static jmethodID fwkScheduleDispatchFunctionsAfter;
 
 #if OS(UNIX)
 static pthread_t mainThread;
@@ -30,6 +32,14 @@ void scheduleDispatchFunctionsOnMainThread()
     WTF::CheckAndClearException(env);
 }
 
+void scheduleDispatchFunctionsOnMainThread(Seconds delay)
+{
+    AttachThreadAsNonDaemonToJavaEnv autoAttach;
+    JNIEnv* env = autoAttach.env();
+    env->CallStaticVoidMethod(jMainThreadCls, fwkScheduleDispatchFunctionsAfter, delay.value());
+    WTF::CheckAndClearException(env);
+}
+
 void initializeMainThreadPlatform()
 {
     // Initialize the class reference and methodids for the MainThread. The
@@ -64,6 +74,13 @@ void initializeMainThreadPlatform()
 
     ASSERT(fwkScheduleDispatchFunctions);
 
+    fwkScheduleDispatchFunctionsAfter = env->GetStaticMethodID(
+            jMainThreadCls,
+            "fwkScheduleDispatchFunctionsAfter",
+            "(D)V");
+
+    ASSERT(fwkScheduleDispatchFunctionsAfter);
+
 #if OS(UNIX)
     mainThread = pthread_self();
 #elif OS(WINDOWS)
@@ -28,11 +28,21 @@
 #include "config.h"
 #include <wtf/MemoryPressureHandler.h>
 
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <malloc.h>
+#include <mutex>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <wtf/MainThread.h>
 #include <wtf/MemoryFootprint.h>
 #include <wtf/linux/CurrentProcessMemoryStatus.h>
+#include <wtf/text/CString.h>
+#include <wtf/text/StringConcatenate.h>
 #include <wtf/text/WTFString.h>
 #include <wtf/Threading.h>
 
@@ -53,6 +63,222 @@ static const Seconds s_maximumHoldOffTime { 30_s };
 static const size_t s_minimumBytesFreedToUseMinimumHoldOffTime = 1 * MB;
 static const unsigned s_holdOffMultiplier = 20;
 
+#if OS(LINUX)
+// Turns the memory notifications of the kernel into memory pressure events:
+// - the "high", "max" and "oom" counters of memory.events of the cgroup (v2)
+//   of the process, which change when it hits its memory.high or memory.max,
+// - PSI (pressure stall information) triggers of the cgroup, or of the whole
+//   system when the process is not in a cgroup of its own.
+// Hitting memory.high or tasks stalled on memory is non-critical pressure,
+// hitting memory.max (or the OOM killer) or all tasks stalled is critical.
+class MemoryPressureMonitor {
+    WTF_MAKE_NONCOPYABLE(MemoryPressureMonitor);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    // The monitor lives as long as the process: the main thread may still
+    // have one of its events to handle.
+    static void start()
+    {
+        static std::once_flag onceFlag;
+        std::call_once(onceFlag, [] {
+            auto* monitor = new MemoryPressureMonitor();
+            if (!monitor->hasSources()) {
+                delete monitor;
+                return;
+            }
+            Thread::create("MemoryPressureMonitor", [monitor] {
+                monitor->run();
+            })->detach();
+        });
+    }
+
+private:
+    // Stall of 150ms in a 2s window: the shortest window unprivileged processes may use.
+    static constexpr const char* s_someTrigger = "some 150000 2000000";
+    static constexpr const char* s_fullTrigger = "full 150000 2000000";
+
+    struct MemoryEvents {
+        uint64_t high { 0 };
+        uint64_t max { 0 };
+        uint64_t oom { 0 };
+    };
+
+    enum Source { EventsSource, SomeStallSource, FullStallSource, SourceCount };
+
+    MemoryPressureMonitor()
+    {
+        for (auto& fd : m_fds) {
+            fd.fd = -1;
+            fd.events = POLLPRI;
+            fd.revents = 0;
+        }
+
+        String cgroup = cgroupPath();
+        if (!cgroup.isNull()) {
+            m_fds[EventsSource].fd = open(makeString(cgroup, "/memory.events").utf8().data(), O_RDONLY | O_CLOEXEC);
+            if (m_fds[EventsSource].fd != -1 && !readMemoryEvents(m_memoryEvents))
+                closeSource(EventsSource);
+        }
+
+        String pressure = cgroup.isNull() ? String() : makeString(cgroup, "/memory.pressure");
+        if (!openStallTrigger(SomeStallSource, pressure, s_someTrigger))
+            openStallTrigger(SomeStallSource, "/proc/pressure/memory", s_someTrigger);
+        if (!openStallTrigger(FullStallSource, pressure, s_fullTrigger))
+            openStallTrigger(FullStallSource, "/proc/pressure/memory", s_fullTrigger);
+    }
+
+    ~MemoryPressureMonitor()
+    {
+        for (int source = 0; source < SourceCount; ++source)
+            closeSource(static_cast<Source>(source));
+    }
+
+    // The cgroup of the process in the unified hierarchy, the null string
+    // without one (cgroup v1 only) or for the root cgroup.
+    static String cgroupPath()
+    {
+        FILE* file = fopen("/proc/self/cgroup", "re");
+        if (!file)
+            return String();
+
+        String path;
+        char line[PATH_MAX + 8];
+        while (fgets(line, sizeof(line), file)) {
+            if (strncmp(line, "0::/", 4))
+                continue;
+            size_t length = strcspn(line + 3, "\n");
+            if (length > 1)
+                path = makeString("/sys/fs/cgroup", String::fromUTF8(line + 3, length));
+            break;
+        }
+        fclose(file);
+        return path;
+    }
+
+    bool openStallTrigger(Source source, const String& path, const char* trigger)
+    {
+        if (path.isNull())
+            return false;
+
+        int fd = open(path.utf8().data(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+        if (fd == -1)
+            return false;
+        // The kernel expects the terminating null character.
+        if (write(fd, trigger, strlen(trigger) + 1) < 0) {
+            close(fd);
+            return false;
+        }
+        m_fds[source].fd = fd;
+        return true;
+    }
+
+    void closeSource(Source source)
+    {
+        if (m_fds[source].fd != -1) {
+            close(m_fds[source].fd);
+            m_fds[source].fd = -1;
+        }
+    }
+
+    bool hasSources() const
+    {
+        return std::any_of(std::begin(m_fds), std::end(m_fds), [] (const struct pollfd& fd) {
+            return fd.fd != -1;
+        });
+    }
+
+    bool readMemoryEvents(MemoryEvents& events)
+    {
+        char buffer[512];
+        ssize_t size = pread(m_fds[EventsSource].fd, buffer, sizeof(buffer) - 1, 0);
+        if (size <= 0)
+            return false;
+        buffer[size] = '\0';
+
+        events = { };
+        for (char* line = buffer; line && *line; ) {
+            char* next = strchr(line, '\n');
+            if (next)
+                *next++ = '\0';
+            unsigned long long value;
+            char name[16];
+            if (sscanf(line, "%15s %llu", name, &value) == 2) {
+                if (!strcmp(name, "high"))
+                    events.high = value;
+                else if (!strcmp(name, "max"))
+                    events.max = value;
+                else if (!strcmp(name, "oom"))
+                    events.oom = value;
+            }
+            line = next;
+        }
+        return true;
+    }
+
+    // Whether memory.events reports pressure, and how critical it is.
+    Optional<bool> memoryEventsChanged()
+    {
+        MemoryEvents events;
+        if (!readMemoryEvents(events)) {
+            closeSource(EventsSource);
+            return WTF::nullopt;
+        }
+
+        Optional<bool> isCritical;
+        if (events.max > m_memoryEvents.max || events.oom > m_memoryEvents.oom)
+            isCritical = true;
+        else if (events.high > m_memoryEvents.high)
+            isCritical = false;
+        m_memoryEvents = events;
+        return isCritical;
+    }
+
+    void run()
+    {
+        while (hasSources()) {
+            if (poll(m_fds, SourceCount, -1) < 0) {
+                if (errno == EINTR)
+                    continue;
+                break;
+            }
+
+            Optional<bool> isCritical;
+            auto notify = [&] (bool critical) {
+                isCritical = critical || isCritical.valueOr(false);
+            };
+            for (int source = 0; source < SourceCount; ++source) {
+                short revents = m_fds[source].revents;
+                if (!revents || m_fds[source].fd == -1)
+                    continue;
+
+                if (source == EventsSource) {
+                    // Changes of kernfs files are reported as POLLPRI | POLLERR.
+                    if (auto critical = memoryEventsChanged())
+                        notify(*critical);
+                } else if (revents & POLLPRI)
+                    notify(source == FullStallSource);
+                else {
+                    // The trigger is gone with its cgroup.
+                    closeSource(static_cast<Source>(source));
+                }
+            }
+
+            // One event at a time: the main thread may already be busy releasing memory.
+            if (!isCritical || m_eventPending.exchange(true))
+                continue;
+            RunLoop::main().dispatch([this, isCritical = *isCritical] {
+                m_eventPending = false;
+                MemoryPressureHandler::singleton().triggerMemoryPressureEvent(isCritical);
+            });
+        }
+    }
+
+    struct pollfd m_fds[SourceCount];
+    MemoryEvents m_memoryEvents;
+    std::atomic<bool> m_eventPending { false };
+};
+#endif
+
 void MemoryPressureHandler::triggerMemoryPressureEvent(bool isCritical)
 {
     if (!m_installed)
@@ -82,6 +308,9 @@ void MemoryPressureHandler::install()
         return;
 
     m_installed = true;
+#if OS(LINUX)
+    MemoryPressureMonitor::start();
+#endif
 }
 
 void MemoryPressureHandler::uninstall()
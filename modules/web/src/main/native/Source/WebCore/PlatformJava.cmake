@@ -85,8 +85,11 @@ list(APPEND WebCore_PRIVATE_FRAMEWORK_HEADERS
     bindings/java/JavaNodeFilterCondition.h
     bridge/jni/jsc/BridgeUtils.h
     dom/DOMStringList.h
+    platform/graphics/java/GlyphMetricsCacheJava.h
     platform/graphics/java/ImageBufferJavaBackend.h
     platform/graphics/java/PlatformContextJava.h
+    platform/graphics/java/PlatformPathJava.h
+    platform/graphics/java/RQEncoder.h
     platform/graphics/java/RQRef.h
     platform/graphics/java/RenderingQueue.h
     platform/graphics/texmap/BitmapTextureJava.h
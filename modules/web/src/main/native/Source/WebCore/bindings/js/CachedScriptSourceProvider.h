@@ -31,6 +31,13 @@
 #include "CachedScriptFetcher.h"
 #include <JavaScriptCore/SourceProvider.h>
 
+#if PLATFORM(JAVA)
+#include "BytecodeCacheJava.h"
+#include <JavaScriptCore/CachedTypes.h>
+#include <JavaScriptCore/UnlinkedFunctionExecutable.h>
+#include <wtf/MainThread.h>
+#endif
+
 namespace WebCore {
 
 class CachedScriptSourceProvider : public JSC::SourceProvider, public CachedResourceClient {
@@ -40,12 +47,65 @@ public:
 
     virtual ~CachedScriptSourceProvider()
     {
+#if PLATFORM(JAVA)
+        commitCachedBytecode();
+#endif
         m_cachedScript->removeClient(*this);
     }
 
     unsigned hash() const override { return m_cachedScript->scriptHash(); }
     StringView source() const override { return m_cachedScript->script(); }
 
+#if PLATFORM(JAVA)
+    RefPtr<JSC::CachedBytecode> cachedBytecode() const final
+    {
+        if (!m_didLoadBytecode) {
+            m_didLoadBytecode = true;
+            m_cachedBytecode = BytecodeCacheJava::singleton().load(url(), hash(), source().length());
+            m_isBytecodeFromCache = !!m_cachedBytecode;
+        }
+        return m_cachedBytecode.copyRef();
+    }
+
+    void cacheBytecode(const JSC::BytecodeCacheGenerator& generator) const final
+    {
+        if (!BytecodeCacheJava::singleton().isEnabled())
+            return;
+        auto update = generator();
+        if (!update)
+            return;
+        if (m_isBytecodeFromCache) {
+            // JSC could not use the cached bytecode (outdated), start over.
+            BytecodeCacheJava::singleton().didRejectEntry(m_cachedBytecode->size());
+            m_isBytecodeFromCache = false;
+        }
+        m_cachedBytecode = JSC::CachedBytecode::create();
+        m_cachedBytecode->addGlobalUpdate(*update);
+        scheduleCommit();
+    }
+
+    void updateCache(const JSC::UnlinkedFunctionExecutable* executable, const JSC::SourceCode&, JSC::CodeSpecializationKind kind, const JSC::UnlinkedFunctionCodeBlock* codeBlock) const final
+    {
+        if (!m_cachedBytecode)
+            return;
+        JSC::BytecodeCacheError error;
+        RefPtr<JSC::CachedBytecode> cachedBytecode = JSC::encodeFunctionCodeBlock(executable->vm(), codeBlock, error);
+        if (cachedBytecode && !error.isValid()) {
+            m_cachedBytecode->addFunctionUpdate(executable, kind, *cachedBytecode);
+            scheduleCommit();
+        }
+    }
+
+    void commitCachedBytecode() const final
+    {
+        m_isCommitScheduled = false;
+        if (!m_cachedBytecode || !m_hasUncommittedUpdates)
+            return;
+        m_hasUncommittedUpdates = false;
+        BytecodeCacheJava::singleton().commit(url(), hash(), source().length(), *m_cachedBytecode);
+    }
+#endif
+
 private:
     CachedScriptSourceProvider(CachedScript* cachedScript, JSC::SourceProviderSourceType sourceType, Ref<CachedScriptFetcher>&& scriptFetcher)
         : SourceProvider(JSC::SourceOrigin { cachedScript->response().url(), WTFMove(scriptFetcher) }, String(cachedScript->response().url().string()), TextPosition(), sourceType)
@@ -54,7 +114,30 @@ private:
         m_cachedScript->addClient(*this);
     }
 
+#if PLATFORM(JAVA)
+    const URL& url() const { return m_cachedScript->response().url(); }
+
+    // Written once the script (and the functions it ran) has been compiled.
+    void scheduleCommit() const
+    {
+        m_hasUncommittedUpdates = true;
+        if (m_isCommitScheduled)
+            return;
+        m_isCommitScheduled = true;
+        callOnMainThread([protectedThis = makeRef(const_cast<CachedScriptSourceProvider&>(*this))] {
+            protectedThis->commitCachedBytecode();
+        });
+    }
+#endif
+
     CachedResourceHandle<CachedScript> m_cachedScript;
+#if PLATFORM(JAVA)
+    mutable RefPtr<JSC::CachedBytecode> m_cachedBytecode;
+    mutable bool m_didLoadBytecode { false };
+    mutable bool m_isBytecodeFromCache { false };
+    mutable bool m_hasUncommittedUpdates { false };
+    mutable bool m_isCommitScheduled { false };
+#endif
 };
 
 } // namespace WebCore
@@ -35,6 +35,7 @@
 #include "runtime_root.h"
 #include <JavaScriptCore/JSArray.h>
 #include <JavaScriptCore/JSLock.h>
+#include <JavaScriptCore/JSTypedArrays.h>
 
 #include "JavaArrayJSC.h"
 #include "JavaInstanceJSC.h"
@@ -61,6 +62,114 @@ static jchar toJCharValue(const JSValue& value, JSGlobalObject* globalObject)
     return (jchar)value.toNumber(globalObject);
 }
 
+// Java arrays of primitives, and the JS typed array with the same elements.
+template<typename T> struct PrimitiveArrayTraits;
+
+#define DEFINE_PRIMITIVE_ARRAY_TRAITS(ElementType, Name, JSTypedArrayType) \
+    template<> struct PrimitiveArrayTraits<ElementType> { \
+        typedef JSTypedArrayType TypedArray; \
+        static jarray create(JNIEnv* env, jsize length) { return env->New##Name##Array(length); } \
+        static void set(JNIEnv* env, jarray array, jsize length, const ElementType* elements) \
+        { \
+            env->Set##Name##ArrayRegion(static_cast<ElementType##Array>(array), 0, length, elements); \
+        } \
+    };
+
+DEFINE_PRIMITIVE_ARRAY_TRAITS(jboolean, Boolean, void)
+DEFINE_PRIMITIVE_ARRAY_TRAITS(jbyte, Byte, JSInt8Array)
+DEFINE_PRIMITIVE_ARRAY_TRAITS(jchar, Char, JSUint16Array)
+DEFINE_PRIMITIVE_ARRAY_TRAITS(jshort, Short, JSInt16Array)
+DEFINE_PRIMITIVE_ARRAY_TRAITS(jint, Int, JSInt32Array)
+DEFINE_PRIMITIVE_ARRAY_TRAITS(jlong, Long, void)
+DEFINE_PRIMITIVE_ARRAY_TRAITS(jfloat, Float, JSFloat32Array)
+DEFINE_PRIMITIVE_ARRAY_TRAITS(jdouble, Double, JSFloat64Array)
+
+#undef DEFINE_PRIMITIVE_ARRAY_TRAITS
+
+// Converts a JS array or typed array to a java array of primitives, which is
+// filled with a single copy instead of one JNI call per element.
+template<typename T>
+static jobject convertToPrimitiveArray(JSGlobalObject* globalObject, JSObject* object, T (*convert)(JSGlobalObject*, JSValue))
+{
+    typedef PrimitiveArrayTraits<T> Traits;
+    VM& vm = globalObject->vm();
+    JNIEnv* env = getJNIEnv();
+
+    if constexpr (!std::is_void<typename Traits::TypedArray>::value) {
+        // Same element layout: copied as is.
+        if (auto* view = jsDynamicCast<typename Traits::TypedArray*>(vm, object)) {
+            if (view->isNeutered())
+                return nullptr;
+            static_assert(sizeof(*view->typedVector()) == sizeof(T), "element size mismatch");
+            jsize length = view->length();
+            jarray array = Traits::create(env, length);
+            if (array)
+                Traits::set(env, array, length, reinterpret_cast<const T*>(view->typedVector()));
+            return array;
+        }
+    }
+
+    unsigned length;
+    if (isJSArray(object))
+        length = asArray(object)->length();
+    else if (auto* view = jsDynamicCast<JSArrayBufferView*>(vm, object))
+        length = view->length();
+    else
+        return nullptr;
+
+    Vector<T> elements;
+    if (!elements.tryReserveCapacity(length))
+        return nullptr;
+    for (unsigned i = 0; i < length; i++)
+        elements.uncheckedAppend(convert(globalObject, object->getIndex(globalObject, i)));
+
+    jarray array = Traits::create(env, length);
+    if (array)
+        Traits::set(env, array, length, elements.data());
+    return array;
+}
+
+static jobject convertToPrimitiveArray(JSGlobalObject* globalObject, JSObject* object, char elementType)
+{
+    // Elements are converted as convertValueToJValue does for single values.
+    switch (javaTypeFromPrimitiveType(elementType)) {
+    case JavaTypeBoolean:
+        return convertToPrimitiveArray<jboolean>(globalObject, object, [] (JSGlobalObject* globalObject, JSValue value) {
+            return (jboolean)value.toNumber(globalObject);
+        });
+    case JavaTypeByte:
+        return convertToPrimitiveArray<jbyte>(globalObject, object, [] (JSGlobalObject* globalObject, JSValue value) {
+            return (jbyte)value.toNumber(globalObject);
+        });
+    case JavaTypeChar:
+        return convertToPrimitiveArray<jchar>(globalObject, object, [] (JSGlobalObject* globalObject, JSValue value) {
+            return toJCharValue(value, globalObject);
+        });
+    case JavaTypeShort:
+        return convertToPrimitiveArray<jshort>(globalObject, object, [] (JSGlobalObject* globalObject, JSValue value) {
+            return (jshort)value.toNumber(globalObject);
+        });
+    case JavaTypeInt:
+        return convertToPrimitiveArray<jint>(globalObject, object, [] (JSGlobalObject* globalObject, JSValue value) {
+            return (jint)value.toNumber(globalObject);
+        });
+    case JavaTypeLong:
+        return convertToPrimitiveArray<jlong>(globalObject, object, [] (JSGlobalObject* globalObject, JSValue value) {
+            return (jlong)value.toNumber(globalObject);
+        });
+    case JavaTypeFloat:
+        return convertToPrimitiveArray<jfloat>(globalObject, object, [] (JSGlobalObject* globalObject, JSValue value) {
+            return (jfloat)value.toNumber(globalObject);
+        });
+    case JavaTypeDouble:
+        return convertToPrimitiveArray<jdouble>(globalObject, object, [] (JSGlobalObject* globalObject, JSValue value) {
+            return (jdouble)value.toNumber(globalObject);
+        });
+    default:
+        return nullptr;
+    }
+}
+
 jobject convertUndefinedToJObject()
 {
     static JGObject jgoUndefined;
@@ -117,6 +226,9 @@ jvalue convertValueToJValue(JSGlobalObject* globalObject, RootObject* rootObject
                         return result;
                     }
                     result.l = array->javaArray();
+                } else if (javaType == JavaTypeArray && javaClassName[0] == '[' && javaClassName[1] && !javaClassName[2]) {
+                    // JavaScript Array for a one-dimensional Java array of primitives, e.g. "[I".
+                    result.l = convertToPrimitiveArray(globalObject, object, javaClassName[1]);
                 } else if ((!result.l && (!strcmp(javaClassName, "java.lang.Object")))
                            || (!strcmp(javaClassName, "netscape.javascript.JSObject"))) {
                     // Wrap objects in JSObject instances.
@@ -255,50 +367,49 @@ jvalue convertValueToJValue(JSGlobalObject* globalObject, RootObject* rootObject
 
 jobject jvalueToJObject(jvalue value, JavaType jtype) {
     JNIEnv* env = getJNIEnv();
-    jmethodID meth;
     switch (jtype) {
     case JavaTypeObject:
     case JavaTypeArray:
         return value.l;
     case JavaTypeBoolean: {
       static JGClass clsZ(env->FindClass("java/lang/Boolean"));
-      meth = env->GetStaticMethodID(clsZ, "valueOf", "(Z)Ljava/lang/Boolean;");
+      static jmethodID meth = env->GetStaticMethodID(clsZ, "valueOf", "(Z)Ljava/lang/Boolean;");
       return env->CallStaticObjectMethod(clsZ, meth, value.z);
     }
     case JavaTypeChar: {
       static JGClass clsC(env->FindClass("java/lang/Character"));
-      meth = env->GetStaticMethodID(clsC, "valueOf",
-                                    "(C)Ljava/lang/Character;");
+      static jmethodID meth = env->GetStaticMethodID(clsC, "valueOf",
+                                                     "(C)Ljava/lang/Character;");
       return env->CallStaticObjectMethod(clsC, meth, value.c);
     }
     case JavaTypeByte: {
       static JGClass clsB(env->FindClass("java/lang/Byte"));
-      meth = env->GetStaticMethodID(clsB, "valueOf", "(B)Ljava/lang/Byte;");
+      static jmethodID meth = env->GetStaticMethodID(clsB, "valueOf", "(B)Ljava/lang/Byte;");
       return env->CallStaticObjectMethod(clsB, meth, value.b);
     }
     case JavaTypeShort: {
       static JGClass clsS(env->FindClass("java/lang/Short"));
-      meth = env->GetStaticMethodID(clsS, "valueOf", "(S)Ljava/lang/Short;");
+      static jmethodID meth = env->GetStaticMethodID(clsS, "valueOf", "(S)Ljava/lang/Short;");
       return env->CallStaticObjectMethod(clsS, meth, value.s);
     }
     case JavaTypeInt: {
       static JGClass clsI(env->FindClass("java/lang/Integer"));
-      meth = env->GetStaticMethodID(clsI, "valueOf", "(I)Ljava/lang/Integer;");
+      static jmethodID meth = env->GetStaticMethodID(clsI, "valueOf", "(I)Ljava/lang/Integer;");
       return env->CallStaticObjectMethod(clsI, meth, value.i);
     }
     case JavaTypeLong: {
       static JGClass clsJ(env->FindClass("java/lang/Long"));
-      meth = env->GetStaticMethodID(clsJ, "valueOf", "(J)Ljava/lang/Long;");
+      static jmethodID meth = env->GetStaticMethodID(clsJ, "valueOf", "(J)Ljava/lang/Long;");
       return env->CallStaticObjectMethod(clsJ, meth, value.j);
     }
     case JavaTypeFloat: {
       static JGClass clsF(env->FindClass("java/lang/Float"));
-      meth = env->GetStaticMethodID(clsF, "valueOf", "(F)Ljava/lang/Float;");
+      static jmethodID meth = env->GetStaticMethodID(clsF, "valueOf", "(F)Ljava/lang/Float;");
       return env->CallStaticObjectMethod(clsF, meth, value.f);
     }
     case JavaTypeDouble: {
       static JGClass clsD(env->FindClass("java/lang/Double"));
-      meth = env->GetStaticMethodID(clsD, "valueOf", "(D)Ljava/lang/Double;");
+      static jmethodID meth = env->GetStaticMethodID(clsD, "valueOf", "(D)Ljava/lang/Double;");
       return env->CallStaticObjectMethod(clsD, meth, value.d);
     }
     default:
@@ -306,7 +417,7 @@ jobject jvalueToJObject(jvalue value, JavaType jtype) {
     }
 }
 
-jthrowable dispatchJNICall(int count, RootObject*, jobject obj, bool isStatic, JavaType returnType, jmethodID methodId, jobject* args, jvalue& result, jobject accessControlContext) {
+jthrowable dispatchJNICall(int count, RootObject* rootObject, jobject obj, bool isStatic, JavaType returnType, jmethodID methodId, jobject* args, jvalue& result, jobject accessControlContext) {
 
     // Since obj is WeakGlobalRef, creating a localref to safeguard instance() from GC
     JLObject jlinstance(obj, true);
@@ -317,18 +428,34 @@ jthrowable dispatchJNICall(int count, RootObject*, jobject obj, bool isStatic, J
     }
 
     JNIEnv* env = getJNIEnv();
-    jclass objClass = env->GetObjectClass(obj);
-    jobject rmethod = env->ToReflectedMethod(objClass, methodId, isStatic);
-    jclass utilityCls = env->FindClass("com/sun/webkit/Utilities");
-    jclass objectCls = env->FindClass("java/lang/Object");
-    jobjectArray argsArray = env->NewObjectArray(count, objectCls, NULL);
-    for (int i = 0;  i < count; i++)
-      env->SetObjectArrayElement(argsArray, i, args[i]);
-    jmethodID invokeMethod =
+    JLClass objClass(env->GetObjectClass(obj));
+    JLObject rmethod(env->ToReflectedMethod(objClass, methodId, isStatic));
+    return dispatchJNICall(count, rootObject, obj, rmethod, returnType, args, result, accessControlContext);
+}
+
+jthrowable dispatchJNICall(int count, RootObject*, jobject obj, jobject rmethod, JavaType returnType, jobject* args, jvalue& result, jobject accessControlContext) {
+
+    // Since obj is WeakGlobalRef, creating a localref to safeguard instance() from GC
+    JLObject jlinstance(obj, true);
+
+    if (!jlinstance) {
+        LOG_ERROR("Could not get javaInstance for %p in JNIUtilityPrivate::dispatchJNICall", (jobject)jlinstance);
+        return NULL;
+    }
+
+    JNIEnv* env = getJNIEnv();
+    static JGClass utilityCls(env->FindClass("com/sun/webkit/Utilities"));
+    static JGClass objectCls(env->FindClass("java/lang/Object"));
+    static jmethodID invokeMethod =
         env->GetStaticMethodID(utilityCls, "fwkInvokeWithContext",
                                "(Ljava/lang/reflect/Method;Ljava/lang/Object;[Ljava/lang/Object;Ljava/security/AccessControlContext;)Ljava/lang/Object;");
+    ASSERT(invokeMethod);
+
+    JLObjectArray argsArray(env->NewObjectArray(count, objectCls, NULL));
+    for (int i = 0;  i < count; i++)
+      env->SetObjectArrayElement(argsArray, i, args[i]);
     jobject r = env->CallStaticObjectMethod(utilityCls, invokeMethod,
-                                            rmethod, obj, argsArray,
+                                            rmethod, obj, (jobjectArray)argsArray,
                                             accessControlContext);
 
     jthrowable ex = env->ExceptionOccurred();
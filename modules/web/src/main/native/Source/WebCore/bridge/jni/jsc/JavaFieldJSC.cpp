@@ -43,6 +43,44 @@ using namespace JSC;
 using namespace JSC::Bindings;
 using namespace WebCore;
 
+namespace {
+
+struct FieldAccessors {
+    const char* getter;
+    const char* getterSignature;
+    const char* setter;
+    const char* setterSignature;
+};
+
+}
+
+// Methods of java.lang.reflect.Field reading and writing a field of the given type.
+static FieldAccessors fieldAccessors(JavaType type)
+{
+    switch (type) {
+    case JavaTypeBoolean:
+        return { "getBoolean", "(Ljava/lang/Object;)Z", "setBoolean", "(Ljava/lang/Object;Z)V" };
+    case JavaTypeByte:
+        return { "getByte", "(Ljava/lang/Object;)B", "setByte", "(Ljava/lang/Object;B)V" };
+    case JavaTypeChar:
+        // Since we can't convert java.lang.Character to any JS primitive, we
+        // read it as JS foreign object.
+        return { "get", "(Ljava/lang/Object;)Ljava/lang/Object;", "setChar", "(Ljava/lang/Object;C)V" };
+    case JavaTypeShort:
+        return { "getShort", "(Ljava/lang/Object;)S", "setShort", "(Ljava/lang/Object;S)V" };
+    case JavaTypeInt:
+        return { "getInt", "(Ljava/lang/Object;)I", "setInt", "(Ljava/lang/Object;I)V" };
+    case JavaTypeLong:
+        return { "getLong", "(Ljava/lang/Object;)J", "setLong", "(Ljava/lang/Object;J)V" };
+    case JavaTypeFloat:
+        return { "getFloat", "(Ljava/lang/Object;)F", "setFloat", "(Ljava/lang/Object;F)V" };
+    case JavaTypeDouble:
+        return { "getDouble", "(Ljava/lang/Object;)D", "setDouble", "(Ljava/lang/Object;D)V" };
+    default:
+        return { "get", "(Ljava/lang/Object;)Ljava/lang/Object;", "set", "(Ljava/lang/Object;Ljava/lang/Object;)V" };
+    }
+}
+
 JavaField::JavaField(JNIEnv* env, jobject aField)
 {
     // Get field type name
@@ -66,6 +104,13 @@ JavaField::JavaField(JNIEnv* env, jobject aField)
     env->DeleteLocalRef(fieldName);
 
     m_field = JobjectWrapper::create(aField);
+
+    // Resolved once here instead of by name and signature on every access.
+    FieldAccessors accessors = fieldAccessors(m_type);
+    JLClass fieldClass(env->GetObjectClass(aField));
+    m_getter = env->GetMethodID(fieldClass, accessors.getter, accessors.getterSignature);
+    m_setter = env->GetMethodID(fieldClass, accessors.setter, accessors.setterSignature);
+    ASSERT(m_getter && m_setter);
 }
 
 JSValue JavaField::valueFromInstance(JSGlobalObject* globalObject, const Instance* i) const
@@ -91,6 +136,9 @@ JSValue JavaField::valueFromInstance(JSGlobalObject* globalObject, const Instanc
         return jsresult;
     }
 
+    jvalue instanceArg;
+    instanceArg.l = jinstance;
+
     switch (m_type) {
     case JavaTypeArray:
     case JavaTypeObject:
@@ -98,7 +146,7 @@ JSValue JavaField::valueFromInstance(JSGlobalObject* globalObject, const Instanc
     // to treat it as JS foreign object.
     case JavaTypeChar:
         {
-            jobject anObject = callJNIMethod<jobject>(jfield, "get", "(Ljava/lang/Object;)Ljava/lang/Object;", jinstance);
+            jobject anObject = callJNIMethodIDA<jobject>(jfield, m_getter, &instanceArg);
             if (!anObject)
                 return jsNull();
 
@@ -112,30 +160,30 @@ JSValue JavaField::valueFromInstance(JSGlobalObject* globalObject, const Instanc
         break;
 
     case JavaTypeBoolean:
-        jsresult = jsBoolean(callJNIMethod<jboolean>(jfield, "getBoolean", "(Ljava/lang/Object;)Z", jinstance));
+        jsresult = jsBoolean(callJNIMethodIDA<jboolean>(jfield, m_getter, &instanceArg));
         break;
 
     case JavaTypeByte:
-        jsresult = jsNumber(callJNIMethod<jbyte>(jfield, "getByte", "(Ljava/lang/Object;)B", jinstance));
+        jsresult = jsNumber(callJNIMethodIDA<jbyte>(jfield, m_getter, &instanceArg));
         break;
 
     case JavaTypeShort:
-        jsresult = jsNumber(callJNIMethod<jshort>(jfield, "getShort", "(Ljava/lang/Object;)S", jinstance));
+        jsresult = jsNumber(callJNIMethodIDA<jshort>(jfield, m_getter, &instanceArg));
         break;
 
     case JavaTypeInt:
-        jsresult = jsNumber(static_cast<int>(callJNIMethod<jint>(jfield, "getInt", "(Ljava/lang/Object;)I", jinstance)));
+        jsresult = jsNumber(static_cast<int>(callJNIMethodIDA<jint>(jfield, m_getter, &instanceArg)));
         break;
 
     case JavaTypeLong:
-        jsresult = jsNumber(static_cast<double>(callJNIMethod<jlong>(jfield, "getLong", "(Ljava/lang/Object;)J", jinstance)));
+        jsresult = jsNumber(static_cast<double>(callJNIMethodIDA<jlong>(jfield, m_getter, &instanceArg)));
         break;
     case JavaTypeFloat:
-        jsresult = jsNumber(static_cast<double>(callJNIMethod<jfloat>(jfield, "getFloat", "(Ljava/lang/Object;)F", jinstance)));
+        jsresult = jsNumber(static_cast<double>(callJNIMethodIDA<jfloat>(jfield, m_getter, &instanceArg)));
         break;
 
     case JavaTypeDouble:
-        jsresult = jsNumber(static_cast<double>(callJNIMethod<jdouble>(jfield, "getDouble", "(Ljava/lang/Object;)D", jinstance)));
+        jsresult = jsNumber(static_cast<double>(callJNIMethodIDA<jdouble>(jfield, m_getter, &instanceArg)));
         break;
 
     default:
@@ -171,42 +219,22 @@ bool JavaField::setValueToInstance(JSGlobalObject* globalObject, const Instance*
         return false;
     }
 
+    jvalue args[2];
+    args[0].l = jinstance;
+    args[1] = javaValue;
+
     switch (m_type) {
     case JavaTypeArray:
     case JavaTypeObject:
-        callJNIMethod<void>(jfield, "set", "(Ljava/lang/Object;Ljava/lang/Object;)V", jinstance, javaValue.l);
-        break;
-
     case JavaTypeBoolean:
-        callJNIMethod<void>(jfield, "setBoolean", "(Ljava/lang/Object;Z)V", jinstance, javaValue.z);
-        break;
-
     case JavaTypeByte:
-        callJNIMethod<void>(jfield, "setByte", "(Ljava/lang/Object;B)V", jinstance, javaValue.b);
-        break;
-
     case JavaTypeChar:
-        callJNIMethod<void>(jfield, "setChar", "(Ljava/lang/Object;C)V", jinstance, javaValue.c);
-        break;
-
     case JavaTypeShort:
-        callJNIMethod<void>(jfield, "setShort", "(Ljava/lang/Object;S)V", jinstance, javaValue.s);
-        break;
-
     case JavaTypeInt:
-        callJNIMethod<void>(jfield, "setInt", "(Ljava/lang/Object;I)V", jinstance, javaValue.i);
-        break;
-
     case JavaTypeLong:
-        callJNIMethod<void>(jfield, "setLong", "(Ljava/lang/Object;J)V", jinstance, javaValue.j);
-        break;
-
     case JavaTypeFloat:
-        callJNIMethod<void>(jfield, "setFloat", "(Ljava/lang/Object;F)V", jinstance, javaValue.f);
-        break;
-
     case JavaTypeDouble:
-        callJNIMethod<void>(jfield, "setDouble", "(Ljava/lang/Object;D)V", jinstance, javaValue.d);
+        callJNIMethodIDA<void>(jfield, m_setter, args);
         break;
 
     default:
@@ -54,6 +54,9 @@ private:
     JavaString m_typeClassName;
     JavaType m_type;
     RefPtr<JobjectWrapper> m_field;
+    // Accessors of java.lang.reflect.Field for m_type.
+    jmethodID m_getter;
+    jmethodID m_setter;
 };
 
 } // namespace Bindings
@@ -66,6 +66,8 @@ JavaMethod::JavaMethod(JNIEnv* env, jobject aMethod)
             if (!parameterName)
                 parameterName = env->NewStringUTF("<Unknown>");
             m_parameters.append(JavaString(env, parameterName).impl());
+            m_parameterClassNames.append(m_parameters.last().utf8());
+            m_parameterTypes.append(javaTypeFromClassName(m_parameterClassNames.last().data()));
             env->DeleteLocalRef(aParameter);
             env->DeleteLocalRef(parameterName);
         }
@@ -77,6 +79,9 @@ JavaMethod::JavaMethod(JNIEnv* env, jobject aMethod)
 
     jint modifiers = callJNIMethod<jint>(aMethod, "getModifiers", "()I");
     m_isStatic = (modifiers & 0x8) != 0;
+
+    // Kept for invocation, so that calls need no lookup by name and signature.
+    m_reflectedMethod = JLObject(aMethod, true);
 }
 
 JavaMethod::~JavaMethod()
@@ -47,20 +47,27 @@ public:
     const String name() const { return m_name.impl(); }
     RuntimeType returnTypeClassName() const { return m_returnTypeClassName.utf8(); }
     const String parameterAt(int i) const { return m_parameters[i]; }
+    // Type and class name of the parameter, resolved once per method.
+    JavaType parameterTypeAt(int i) const { return m_parameterTypes[i]; }
+    const char* parameterClassNameAt(int i) const { return m_parameterClassNames[i].data(); }
     const char* signature() const;
     JavaType returnType() const { return m_returnType; }
     bool isStatic() const { return m_isStatic; }
+    jobject reflectedMethod() const { return m_reflectedMethod; }
 
     // Method implementation
     int numParameters() const { return m_parameters.size(); }
 
 private:
     Vector<WTF::String> m_parameters;
+    Vector<JavaType> m_parameterTypes;
+    Vector<CString> m_parameterClassNames;
     JavaString m_name;
     mutable char* m_signature;
     JavaString m_returnTypeClassName;
     JavaType m_returnType;
     bool m_isStatic;
+    JGObject m_reflectedMethod;
 };
 
 } // namespace Bindings
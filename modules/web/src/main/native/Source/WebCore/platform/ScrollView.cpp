@@ -1149,7 +1149,11 @@ void ScrollView::positionScrollbarLayers()
 void ScrollView::repaintContentRectangle(const IntRect& rect)
 {
     IntRect paintRect = rect;
+#if PLATFORM(JAVA)
+    if (clipsRepaints() && !paintsEntireContents())
+#else
     if (!paintsEntireContents())
+#endif
         paintRect.intersect(visibleContentRect(LegacyIOSDocumentVisibleRect));
     if (paintRect.isEmpty())
         return;
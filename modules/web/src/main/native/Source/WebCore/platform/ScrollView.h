@@ -137,6 +137,13 @@ public:
     bool delegatesScrolling() const { return m_delegatesScrolling; }
     WEBCORE_EXPORT void setDelegatesScrolling(bool);
 
+#if PLATFORM(JAVA)
+    // By default the repaints are clipped to the visible area. A backing store
+    // caching the contents outside of it needs them all.
+    bool clipsRepaints() const { return m_clipsRepaints; }
+    void setClipsRepaints(bool clipsRepaints) { m_clipsRepaints = clipsRepaints; }
+#endif
+
     // Overridden by FrameView to create custom CSS scrollbars if applicable.
     virtual Ref<Scrollbar> createScrollbar(ScrollbarOrientation);
 
@@ -570,6 +577,9 @@ private:
 
     bool m_paintsEntireContents { false };
     bool m_delegatesScrolling { false };
+#if PLATFORM(JAVA)
+    bool m_clipsRepaints { true };
+#endif
 
 }; // class ScrollView
 
@@ -46,6 +46,7 @@
 #endif
 
 #if PLATFORM(JAVA)
+#include "GlyphMetricsCacheJava.h"
 #include "PlatformJavaClasses.h"
 #include "RQRef.h"
 #endif
@@ -183,6 +184,7 @@ public:
 
 #if PLATFORM(JAVA)
     RefPtr<RQRef> nativeFontData() const { return m_jFont; }
+    GlyphMetricsCacheJava& glyphMetrics() const;
 #endif
 
     unsigned hash() const;
@@ -264,6 +266,7 @@ private:
 
 #if PLATFORM(JAVA)
     RefPtr<RQRef> m_jFont;
+    mutable RefPtr<GlyphMetricsCacheJava> m_glyphMetrics;
 #endif
 
     // The values below are common to all ports
@@ -67,8 +67,8 @@ typedef WebCore::PlatformPath PlatformPath;
 
 #elif PLATFORM(JAVA)
 #include <wtf/RefPtr.h>
-#include "RQRef.h"
-typedef RefPtr<WebCore::RQRef> PlatformPath;
+#include "PlatformPathJava.h"
+typedef RefPtr<WebCore::PlatformPathJava> PlatformPath;
 
 #else
 
@@ -78,7 +78,7 @@ typedef void PlatformPath;
 
 #if !USE(CAIRO)
 #if PLATFORM(JAVA)
-typedef RefPtr<WebCore::RQRef> PlatformPathPtr;
+typedef RefPtr<WebCore::PlatformPathJava> PlatformPathPtr;
 #else
 typedef PlatformPath* PlatformPathPtr;
 #endif
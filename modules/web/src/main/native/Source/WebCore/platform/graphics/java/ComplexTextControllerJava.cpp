@@ -91,34 +91,35 @@ unsigned jGetEnd(jobject jRun)
     return env->CallIntMethod(jRun, mID);
 }
 
-unsigned jGetCharOffset(jobject jRun, unsigned glyphIndex)
+// Copies the codes, character offsets and advances of the glyphs of the run,
+// with a single call for the whole run
+bool jGetGlyphs(jobject jRun, unsigned glyphCount, jint* glyphs, jint* charOffsets, jfloat* advances)
 {
-    if (!jGetGlyphCount(jRun)) {
-        // Return same value as TextRun.getCharOffset() when there is
-        // no glyph information available.
-        return glyphIndex;
-    }
-
     JNIEnv* env = WTF::GetJavaEnv();
-    static jmethodID mID = env->GetMethodID(
-        PG_GetTextRun(env),
-        "getCharOffset",
-        "(I)I");
-    ASSERT(mID);
 
-    return env->CallIntMethod(jRun, mID, glyphIndex);
-}
+    JLocalRef<jintArray> jGlyphs(env->NewIntArray(glyphCount));
+    JLocalRef<jintArray> jCharOffsets(env->NewIntArray(glyphCount));
+    JLocalRef<jfloatArray> jAdvances(env->NewFloatArray(glyphCount));
+    WTF::CheckAndClearException(env); // OOME
+    if (!jGlyphs || !jCharOffsets || !jAdvances) {
+        return false;
+    }
 
-CGGlyph jGetGlyph(jobject jRun, unsigned glyphIndex)
-{
-    JNIEnv* env = WTF::GetJavaEnv();
     static jmethodID mID = env->GetMethodID(
         PG_GetTextRun(env),
-        "getGlyph",
-        "(I)I");
+        "getGlyphs",
+        "([I[I[F)V");
     ASSERT(mID);
 
-    return env->CallIntMethod(jRun, mID, glyphIndex);
+    env->CallVoidMethod(jRun, mID, (jintArray)jGlyphs, (jintArray)jCharOffsets, (jfloatArray)jAdvances);
+    if (WTF::CheckAndClearException(env)) {
+        return false;
+    }
+
+    env->GetIntArrayRegion(jGlyphs, 0, glyphCount, glyphs);
+    env->GetIntArrayRegion(jCharOffsets, 0, glyphCount, charOffsets);
+    env->GetFloatArrayRegion(jAdvances, 0, glyphCount, advances);
+    return true;
 }
 
 FloatRect jGetGlyphPosAndAdvance(jobject jRun, unsigned glyphIndex)
@@ -165,6 +166,7 @@ ComplexTextController::ComplexTextRun::ComplexTextRun(JLObject jRun, const Font&
     , m_stringLocation(stringLocation)
     , m_isLTR(jIsLTR(jobject(jRun)))
 {
+    unsigned glyphCount = m_glyphCount;
     if (!m_glyphCount) {
         // There won't be any glyph when TextRun contains a line break or a soft break.
         // However WebCore expects us to return a empty value for all of it's query,
@@ -172,27 +174,28 @@ ComplexTextController::ComplexTextRun::ComplexTextRun(JLObject jRun, const Font&
         m_glyphCount = 1;
     }
 
-    m_glyphs.grow(m_glyphCount);
-    m_baseAdvances.grow(m_glyphCount);
+    m_glyphs.fill(0, m_glyphCount);
+    m_baseAdvances.fill({ }, m_glyphCount);
     // There is no way to get glyph origin from Prism Font implementation.
     // m_glyphOrigins.grow(m_glyphCount);
-    m_coreTextIndices.grow(m_glyphCount);
+    m_coreTextIndices.fill(m_indexBegin, m_glyphCount);
 
-    for (unsigned i = 0; i < m_glyphCount; ++i) {
+    Vector<jint, 64> charOffsets(glyphCount);
+    Vector<jfloat, 64> advances(glyphCount);
+    if (!glyphCount || !jGetGlyphs(jRun, glyphCount, m_glyphs.data(), charOffsets.data(), advances.data())) {
+        return;
+    }
+
+    for (unsigned i = 0; i < glyphCount; ++i) {
         // The given string will be broken down into multiple java TextRuns. Each
         // java TextRun will have indicies relative to it's text. So it has to
         // be converted to absolute index w.r.t WebCore String.
         // Refer {CTGlyphLayout, DWGlyphLayout, PangoGlyphLayout}.layout()
-        m_coreTextIndices[i] = m_indexBegin + jGetCharOffset(jRun, i);
+        m_coreTextIndices[i] = m_indexBegin + charOffsets[i];
 
-        m_glyphs[i]= jGetGlyph(jRun, i);
-        if (m_font.isZeroWidthSpaceGlyph(m_glyphs[i])) {
-            m_baseAdvances[i] = { };
-            continue;
+        if (!m_font.isZeroWidthSpaceGlyph(m_glyphs[i])) {
+            m_baseAdvances[i] = { advances[i], 0 };
         }
-
-        auto glyphBox = jGetGlyphPosAndAdvance(jRun, i);
-        m_baseAdvances[i] = glyphBox.size();
     }
 }
 
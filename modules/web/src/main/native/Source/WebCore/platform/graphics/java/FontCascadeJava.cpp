@@ -44,64 +44,24 @@ void FontCascade::drawGlyphs(GraphicsContext& gc,
                       const FloatPoint& point,
                       FontSmoothingMode)
 {
-    // we need to call freeSpace() before refIntArr() and refFloatArr(), see RT-19695.
-    RenderingQueue& rq = gc.platformContext()->rq().freeSpace(24);
+    // The glyphs and their advances follow the operation in the queue.
+    RenderingQueue& rq = gc.platformContext()->rq().freeSpace(
+        5 * sizeof(jint) + numGlyphs * (sizeof(jint) + sizeof(jfloat)));
 
-    JNIEnv* env = WTF::GetJavaEnv();
-
-    //prepare Glyphs array
-    JLocalRef<jintArray> jGlyphs(env->NewIntArray(numGlyphs));
-    ASSERT(jGlyphs);
-    {
-        jint *bufArray = (jint*)env->GetPrimitiveArrayCritical(jGlyphs, NULL);
-        ASSERT(bufArray);
-        memcpy(bufArray, glyphBuffer.glyphs(from), sizeof(jint)*numGlyphs);
-        env->ReleasePrimitiveArrayCritical(jGlyphs, bufArray, 0);
-    }
-    static jmethodID refIntArr_mID = env->GetMethodID(
-        PG_GetRenderQueueClass(env),
-        "refIntArr",
-        "([I)I");
-    ASSERT(refIntArr_mID);
-    jint sid = env->CallIntMethod(
-        rq.getWCRenderingQueue(),
-        refIntArr_mID,
-        (jintArray)jGlyphs);
-    WTF::CheckAndClearException(env);
-
-
-    // Prepare Offsets/Advances array
-    JLocalRef<jfloatArray> jAdvance(env->NewFloatArray(numGlyphs));
-    WTF::CheckAndClearException(env);
-    ASSERT(jAdvance);
-    {
-        jfloat *bufArray = env->GetFloatArrayElements(jAdvance, NULL);
-        ASSERT(bufArray);
-        for (unsigned i = 0; i < numGlyphs; ++i) {
-            auto pAdvance = glyphBuffer.advances(from + i);
-            if (!pAdvance)
-                continue;
-            bufArray[i] = jfloat(pAdvance->width());
-        }
-        env->ReleaseFloatArrayElements(jAdvance, bufArray, 0);
-    }
-    static jmethodID refFloatArr_mID = env->GetMethodID(
-        PG_GetRenderQueueClass(env),
-        "refFloatArr",
-        "([F)I");
-    ASSERT(refFloatArr_mID);
-    jint aid = env->CallIntMethod(
-        rq.getWCRenderingQueue(),
-        refFloatArr_mID,
-        (jfloatArray)jAdvance);
-    WTF::CheckAndClearException(env);
-
-    rq  << (jint)com_sun_webkit_graphics_GraphicsDecoder_DRAWSTRING_FAST
+    rq  << (jint)com_sun_webkit_graphics_GraphicsDecoder_DRAWGLYPHS
         << font.platformData().nativeFontData()
-        << sid
-        << aid
+        << (jint)numGlyphs
         << (jfloat)point.x()
         << (jfloat)point.y();
+
+    const GlyphBufferGlyph* glyphs = glyphBuffer.glyphs(from);
+    for (unsigned i = 0; i < numGlyphs; ++i) {
+        rq << (jint)glyphs[i];
+    }
+    for (unsigned i = 0; i < numGlyphs; ++i) {
+        auto pAdvance = glyphBuffer.advances(from + i);
+        rq << (pAdvance ? (jfloat)pAdvance->width() : 0.0f);
+    }
 }
 
 bool FontCascade::canReturnFallbackFontsForComplexText()
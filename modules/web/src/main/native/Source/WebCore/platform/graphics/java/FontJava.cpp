@@ -124,40 +124,19 @@ RefPtr<Font> Font::platformCreateScaledFont(const FontDescription&, float scaleF
 
 float Font::platformWidthForGlyph(Glyph c) const
 {
-    JNIEnv* env = WTF::GetJavaEnv();
-
-    RefPtr<RQRef> jFont = m_platformData.nativeFontData();
-    if (!jFont)
+    if (!m_platformData.nativeFontData())
         return 0.0f;
 
-    static jmethodID getGlyphWidth_mID = env->GetMethodID(PG_GetFontClass(env),
-        "getGlyphWidth", "(I)D");
-    ASSERT(getGlyphWidth_mID);
-
-    float res = env->CallDoubleMethod(*jFont, getGlyphWidth_mID, (jint)c);
-    WTF::CheckAndClearException(env);
-
-    return res;
+    return m_platformData.glyphMetrics().widthForGlyph(c);
 }
 
 FloatRect Font::platformBoundsForGlyph(Glyph c) const
 {
-    JNIEnv* env = WTF::GetJavaEnv();
-
-    RefPtr<RQRef> jFont = m_platformData.nativeFontData();
-    if (!jFont) {
+    if (!m_platformData.nativeFontData()) {
         return {};
     }
 
-    static jmethodID getGlyphBoundingBox_mID = env->GetMethodID(PG_GetFontClass(env), "getGlyphBoundingBox", "(I)[F");
-    ASSERT(getGlyphBoundingBox_mID);
-
-    jfloatArray boundingBox = (jfloatArray)env->CallObjectMethod(*jFont, getGlyphBoundingBox_mID, (jint)c);
-    jfloat *bBox = env->GetFloatArrayElements(boundingBox,0);
-    auto bb = FloatRect { bBox[0], bBox[1], bBox[2], bBox[3] };
-    env->ReleaseFloatArrayElements(boundingBox, bBox, 0);
-    WTF::CheckAndClearException(env);
-    return bb;
+    return m_platformData.glyphMetrics().boundsForGlyph(c);
 }
 
 Path Font::platformPathForGlyph(Glyph) const
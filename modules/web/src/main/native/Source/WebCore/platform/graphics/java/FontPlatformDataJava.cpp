@@ -91,6 +91,15 @@ std::unique_ptr<FontPlatformData> FontPlatformData::derive(float scaleFactor) co
     return std::make_unique<FontPlatformData>(RQRef::create(wcFont), size);
 }
 
+GlyphMetricsCacheJava& FontPlatformData::glyphMetrics() const
+{
+    ASSERT(m_jFont);
+    if (!m_glyphMetrics) {
+        m_glyphMetrics = GlyphMetricsCacheJava::forFont(m_jFont);
+    }
+    return *m_glyphMetrics;
+}
+
 bool FontPlatformData::platformIsEqual(const FontPlatformData& other) const
 {
     JNIEnv* env = WTF::GetJavaEnv();
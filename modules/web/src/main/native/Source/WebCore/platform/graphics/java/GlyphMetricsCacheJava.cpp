@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "config.h"
+
+#include "GlyphMetricsCacheJava.h"
+#include "GraphicsContextJava.h"
+
+#include <wtf/NeverDestroyed.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+namespace {
+
+// The caches by hash code of their font. The keys are the 32 bit hash codes
+// widened to 64 bits, so none of them is the empty or deleted value.
+typedef HashMap<uint64_t, Vector<Ref<GlyphMetricsCacheJava>>, IntHash<uint64_t>,
+    WTF::UnsignedWithZeroKeyHashTraits<uint64_t>> CacheMap;
+
+CacheMap& caches()
+{
+    static NeverDestroyed<CacheMap> caches;
+    return caches;
+}
+
+unsigned cacheCount = 0;
+
+jint fontHashCode(JNIEnv* env, const RefPtr<RQRef>& jFont)
+{
+    static jmethodID hash_mID = env->GetMethodID(PG_GetFontClass(env), "hashCode", "()I");
+    ASSERT(hash_mID);
+
+    jint res = env->CallIntMethod(*jFont, hash_mID);
+    WTF::CheckAndClearException(env);
+    return res;
+}
+
+bool fontEquals(JNIEnv* env, const RefPtr<RQRef>& jFont, const RefPtr<RQRef>& other)
+{
+    if (jFont == other) {
+        return true;
+    }
+
+    static jmethodID compare_mID = env->GetMethodID(
+        PG_GetFontClass(env), "equals", "(Ljava/lang/Object;)Z");
+    ASSERT(compare_mID);
+
+    jboolean res = env->CallBooleanMethod(*jFont, compare_mID, (jobject)(*other));
+    WTF::CheckAndClearException(env);
+    return jbool_to_bool(res);
+}
+
+// Drops the caches only referenced from the map.
+void purgeUnusedCaches()
+{
+    Vector<uint64_t> emptyKeys;
+    for (auto& entry : caches()) {
+        cacheCount -= entry.value.removeAllMatching([] (auto& cache) {
+            return cache->hasOneRef();
+        });
+        if (entry.value.isEmpty()) {
+            emptyKeys.append(entry.key);
+        }
+    }
+    for (auto key : emptyKeys) {
+        caches().remove(key);
+    }
+}
+
+}
+
+Ref<GlyphMetricsCacheJava> GlyphMetricsCacheJava::forFont(const RefPtr<RQRef>& jFont)
+{
+    ASSERT(jFont);
+    JNIEnv* env = WTF::GetJavaEnv();
+
+    auto& bucket = caches().ensure((uint32_t)fontHashCode(env, jFont), [] {
+        return Vector<Ref<GlyphMetricsCacheJava>>();
+    }).iterator->value;
+    for (auto& cache : bucket) {
+        if (fontEquals(env, cache->m_jFont, jFont)) {
+            return cache.copyRef();
+        }
+    }
+
+    Ref<GlyphMetricsCacheJava> cache = adoptRef(*new GlyphMetricsCacheJava(jFont));
+    bucket.append(cache.copyRef());
+    if (++cacheCount > MAX_CACHES) {
+        purgeUnusedCaches();
+    }
+    return cache;
+}
+
+// The metrics of the page of glyph, or null if java failed to provide them.
+// Failed pages are not cached, so they are fetched again the next time.
+const GlyphMetricsCacheJava::Page* GlyphMetricsCacheJava::page(Glyph glyph, bool withBounds)
+{
+    unsigned pageNumber = (unsigned)glyph / PAGE_SIZE;
+    auto it = m_pages.find(pageNumber);
+    Page* page = it != m_pages.end() ? it->value.get() : nullptr;
+    bool needsWidths = !page;
+    bool needsBounds = withBounds && (!page || !page->bounds);
+    if (!needsWidths && !needsBounds) {
+        return page;
+    }
+
+    JNIEnv* env = WTF::GetJavaEnv();
+
+    JLocalRef<jfloatArray> jWidths(needsWidths ? env->NewFloatArray(PAGE_SIZE) : nullptr);
+    JLocalRef<jfloatArray> jBounds(needsBounds ? env->NewFloatArray(4 * PAGE_SIZE) : nullptr);
+    WTF::CheckAndClearException(env); // OOME
+    if ((needsWidths && !jWidths) || (needsBounds && !jBounds)) {
+        return nullptr;
+    }
+
+    static jmethodID getGlyphMetrics_mID = env->GetMethodID(PG_GetFontClass(env),
+        "getGlyphMetrics", "(I[F[F)V");
+    ASSERT(getGlyphMetrics_mID);
+
+    env->CallVoidMethod(*m_jFont, getGlyphMetrics_mID,
+        (jint)(pageNumber * PAGE_SIZE), (jfloatArray)jWidths, (jfloatArray)jBounds);
+    if (WTF::CheckAndClearException(env)) {
+        return nullptr;
+    }
+
+    if (needsWidths) {
+        auto newPage = makeUnique<Page>();
+        env->GetFloatArrayRegion(jWidths, 0, PAGE_SIZE, newPage->widths.data());
+        page = m_pages.add(pageNumber, WTFMove(newPage)).iterator->value.get();
+    }
+    if (needsBounds) {
+        jfloat bounds[4 * PAGE_SIZE];
+        env->GetFloatArrayRegion(jBounds, 0, 4 * PAGE_SIZE, bounds);
+        auto pageBounds = makeUnique<std::array<FloatRect, PAGE_SIZE>>();
+        for (unsigned i = 0; i < PAGE_SIZE; ++i) {
+            const jfloat* bb = bounds + 4 * i;
+            (*pageBounds)[i] = FloatRect { bb[0], bb[1], bb[2], bb[3] };
+        }
+        page->bounds = WTFMove(pageBounds);
+    }
+    return page;
+}
+
+float GlyphMetricsCacheJava::widthForGlyph(Glyph glyph)
+{
+    const Page* metrics = page(glyph, false);
+    return metrics ? metrics->widths[(unsigned)glyph % PAGE_SIZE] : 0;
+}
+
+FloatRect GlyphMetricsCacheJava::boundsForGlyph(Glyph glyph)
+{
+    const Page* metrics = page(glyph, true);
+    return metrics ? (*metrics->bounds)[(unsigned)glyph % PAGE_SIZE] : FloatRect();
+}
+
+} // namespace WebCore
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#pragma once
+
+#include "FloatRect.h"
+#include "Glyph.h"
+#include "RQRef.h"
+
+#include <array>
+#include <wtf/HashMap.h>
+#include <wtf/RefCounted.h>
+
+namespace WebCore {
+
+/*
+ * Advances and bounding boxes of the glyphs of a java font.
+ *
+ * The metrics are fetched from the WCFont a page of PAGE_SIZE consecutive
+ * glyphs at a time, with a single getGlyphMetrics() call. The caches are
+ * process-wide: all the FontPlatformData holding equal WCFonts share one,
+ * so the web pages using the same fonts query each glyph once.
+ */
+class GlyphMetricsCacheJava : public RefCounted<GlyphMetricsCacheJava> {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    static const unsigned PAGE_SIZE = 256;
+    // Caches no longer used by any font are dropped beyond this count.
+    static const unsigned MAX_CACHES = 256;
+
+    // The cache of the fonts equal to jFont.
+    static Ref<GlyphMetricsCacheJava> forFont(const RefPtr<RQRef>& jFont);
+
+    float widthForGlyph(Glyph);
+    FloatRect boundsForGlyph(Glyph);
+
+private:
+    explicit GlyphMetricsCacheJava(const RefPtr<RQRef>& jFont)
+        : m_jFont(jFont)
+    {}
+
+    struct Page {
+        WTF_MAKE_STRUCT_FAST_ALLOCATED;
+
+        std::array<float, PAGE_SIZE> widths;
+        std::unique_ptr<std::array<FloatRect, PAGE_SIZE>> bounds;
+    };
+
+    const Page* page(Glyph, bool withBounds);
+
+    RefPtr<RQRef> m_jFont;
+    HashMap<unsigned, std::unique_ptr<Page>, IntHash<unsigned>, WTF::UnsignedWithZeroKeyHashTraits<unsigned>> m_pages;
+};
+
+} // namespace WebCore
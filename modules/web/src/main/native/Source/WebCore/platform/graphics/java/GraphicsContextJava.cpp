@@ -49,6 +49,7 @@
 #include "Path.h"
 #include "Pattern.h"
 #include "PlatformContextJava.h"
+#include "RQEncoder.h"
 #include "RenderingQueue.h"
 #include "Font.h"
 #include "TransformationMatrix.h"
@@ -92,6 +93,12 @@ static void setGradient(Gradient &gradient, PlatformGraphicsContext* context, ji
     p0 = gt.mapPoint(p0);
     p1 = gt.mapPoint(p1);
 
+    if (id == com_sun_webkit_graphics_GraphicsDecoder_SET_FILL_GRADIENT) {
+        context->rq().encoder().invalidateFillPaint();
+    } else {
+        context->rq().encoder().invalidateStrokePaint();
+    }
+
     context->rq().freeSpace(4 * 11 + 20 * nStops)
     << id
     << (jfloat)p0.x()
@@ -142,8 +149,7 @@ void GraphicsContext::savePlatformState()
     if (paintingDisabled())
         return;
 
-    platformContext()->rq().freeSpace(4)
-    << (jint)com_sun_webkit_graphics_GraphicsDecoder_SAVESTATE;
+    platformContext()->rq().encoder().save();
 }
 
 void GraphicsContext::restorePlatformState()
@@ -151,8 +157,7 @@ void GraphicsContext::restorePlatformState()
     if (paintingDisabled())
         return;
 
-    platformContext()->rq().freeSpace(4)
-    << (jint)com_sun_webkit_graphics_GraphicsDecoder_RESTORESTATE;
+    platformContext()->rq().encoder().restore();
 }
 
 // Draws a filled rectangle with a stroked border.
@@ -243,10 +248,7 @@ void GraphicsContext::fillRect(const FloatRect& rect)
                 com_sun_webkit_graphics_GraphicsDecoder_SET_FILL_GRADIENT);
         }
 
-        platformContext()->rq().freeSpace(20)
-        << (jint)com_sun_webkit_graphics_GraphicsDecoder_FILLRECT_FFFF
-        << rect.x() << rect.y()
-        << rect.width() << rect.height();
+        platformContext()->rq().encoder().fillRect(rect);
     }
 }
 
@@ -481,12 +483,7 @@ void GraphicsContext::setPlatformFillColor(const Color& color)
     if (paintingDisabled())
         return;
 
-    //auto [r, g, b, a] = color.toSRGBALossy<float>();
-    auto col = std::make_tuple(color.toSRGBALossy<float>().red, color.toSRGBALossy<float>().green, color.toSRGBALossy<float>().blue, color.toSRGBALossy<float>().alpha);
-    auto [r, g, b, a] = col;
-    platformContext()->rq().freeSpace(20)
-    << (jint)com_sun_webkit_graphics_GraphicsDecoder_SETFILLCOLOR
-    << r << g << b << a;
+    platformContext()->rq().encoder().setFillColor(color);
 }
 
 void GraphicsContext::setPlatformTextDrawingMode(TextDrawingModeFlags mode)
@@ -494,11 +491,9 @@ void GraphicsContext::setPlatformTextDrawingMode(TextDrawingModeFlags mode)
     if (paintingDisabled())
         return;
 
-    platformContext()->rq().freeSpace(16)
-    << (jint)com_sun_webkit_graphics_GraphicsDecoder_SET_TEXT_MODE
-    << (jint)(mode.contains(TextDrawingMode::Fill))
-    << (jint)(mode.contains(TextDrawingMode::Stroke))
-    << (jint)0;
+    platformContext()->rq().encoder().setTextMode(
+        mode.contains(TextDrawingMode::Fill),
+        mode.contains(TextDrawingMode::Stroke));
     //utatodo:
     //<< (jint)(mode & TextModeClip);
 }
@@ -508,9 +503,7 @@ void GraphicsContext::setPlatformStrokeStyle(StrokeStyle style)
     if (paintingDisabled())
         return;
 
-    platformContext()->rq().freeSpace(8)
-    << (jint)com_sun_webkit_graphics_GraphicsDecoder_SETSTROKESTYLE
-    << (jint)style;
+    platformContext()->rq().encoder().setStrokeStyle(style);
 }
 
 void GraphicsContext::setPlatformStrokeColor(const Color& color)
@@ -518,12 +511,7 @@ void GraphicsContext::setPlatformStrokeColor(const Color& color)
     if (paintingDisabled())
         return;
 
-    //auto [r, g, b, a] = color.toSRGBALossy<float>();
-    auto col = std::make_tuple(color.toSRGBALossy<float>().red, color.toSRGBALossy<float>().green, color.toSRGBALossy<float>().blue, color.toSRGBALossy<float>().alpha);
-    auto [r, g, b, a] = col;
-    platformContext()->rq().freeSpace(20)
-    << (jint)com_sun_webkit_graphics_GraphicsDecoder_SETSTROKECOLOR
-    << r << g << b << a;
+    platformContext()->rq().encoder().setStrokeColor(color);
 }
 
 void GraphicsContext::setPlatformStrokeThickness(float strokeThickness)
@@ -531,9 +519,7 @@ void GraphicsContext::setPlatformStrokeThickness(float strokeThickness)
     if (paintingDisabled())
         return;
 
-    platformContext()->rq().freeSpace(8)
-    << (jint)com_sun_webkit_graphics_GraphicsDecoder_SETSTROKEWIDTH
-    << strokeThickness;
+    platformContext()->rq().encoder().setStrokeWidth(strokeThickness);
 }
 
 void GraphicsContext::setPlatformImageInterpolationQuality(InterpolationQuality)
@@ -588,12 +574,7 @@ void GraphicsContext::setPlatformShadow(const FloatSize& s, float blur, const Co
         height = -height;
     }
 
-    //auto [r, g, b, a] = color.toSRGBALossy<float>();
-    auto col = std::make_tuple(color.toSRGBALossy<float>().red, color.toSRGBALossy<float>().green, color.toSRGBALossy<float>().blue, color.toSRGBALossy<float>().alpha);
-    auto [r, g, b, a] = col;
-    platformContext()->rq().freeSpace(32)
-    << (jint)com_sun_webkit_graphics_GraphicsDecoder_SETSHADOW
-    << width << height << blur << r << g << b << a;;
+    platformContext()->rq().encoder().setShadow(width, height, blur, color);
 }
 
 void GraphicsContext::clearPlatformShadow()
@@ -611,9 +592,7 @@ void GraphicsContext::beginPlatformTransparencyLayer(float opacity)
     if (paintingDisabled())
       return;
 
-    platformContext()->rq().freeSpace(8)
-    << (jint)com_sun_webkit_graphics_GraphicsDecoder_BEGINTRANSPARENCYLAYER
-    << opacity;
+    platformContext()->rq().encoder().beginTransparencyLayer(opacity);
 }
 
 void GraphicsContext::endPlatformTransparencyLayer()
@@ -621,8 +600,7 @@ void GraphicsContext::endPlatformTransparencyLayer()
     if (paintingDisabled())
       return;
 
-    platformContext()->rq().freeSpace(4)
-    << (jint)com_sun_webkit_graphics_GraphicsDecoder_ENDTRANSPARENCYLAYER;
+    platformContext()->rq().encoder().endTransparencyLayer();
 }
 
 void GraphicsContext::clearRect(const FloatRect& rect)
@@ -679,9 +657,7 @@ void GraphicsContext::setLineCap(LineCap cap)
       return;
     }
 
-    platformContext()->rq().freeSpace(8)
-    << (jint)com_sun_webkit_graphics_GraphicsDecoder_SET_LINE_CAP
-    << (jint)cap;
+    platformContext()->rq().encoder().setLineCap(cap);
 
     platformContext()->setLineCap(cap);
 }
@@ -691,9 +667,7 @@ void GraphicsContext::setLineJoin(LineJoin join)
     if (paintingDisabled())
         return;
 
-    platformContext()->rq().freeSpace(8)
-    << (jint)com_sun_webkit_graphics_GraphicsDecoder_SET_LINE_JOIN
-    << (jint)join;
+    platformContext()->rq().encoder().setLineJoin(join);
 
     platformContext()->setLineJoin(join);
 }
@@ -703,18 +677,14 @@ void GraphicsContext::setMiterLimit(float limit)
     if (paintingDisabled())
         return;
 
-    platformContext()->rq().freeSpace(8)
-    << (jint)com_sun_webkit_graphics_GraphicsDecoder_SET_MITER_LIMIT
-    << (jfloat)limit;
+    platformContext()->rq().encoder().setMiterLimit(limit);
 
     platformContext()->setMiterLimit(limit);
 }
 
 void GraphicsContext::setPlatformAlpha(float alpha)
 {
-    platformContext()->rq().freeSpace(8)
-    << (jint)com_sun_webkit_graphics_GraphicsDecoder_SETALPHA
-    << alpha;
+    platformContext()->rq().encoder().setAlpha(alpha);
 }
 
 void GraphicsContext::setPlatformCompositeOperation(CompositeOperator op, BlendMode)
@@ -722,9 +692,7 @@ void GraphicsContext::setPlatformCompositeOperation(CompositeOperator op, BlendM
     if (paintingDisabled())
         return;
 
-    platformContext()->rq().freeSpace(8)
-    << (jint)com_sun_webkit_graphics_GraphicsDecoder_SETCOMPOSITE
-    << (jint)op;
+    platformContext()->rq().encoder().setCompositeOperation(op);
     //utatodo: add BlendMode
 }
 
@@ -742,7 +710,7 @@ void GraphicsContext::strokePath(const Path& path)
 
     platformContext()->rq().freeSpace(12)
     << (jint)com_sun_webkit_graphics_GraphicsDecoder_STROKE_PATH
-    << copyPath(path.platformPath())
+    << sharedPath(path.platformPath())
     << (jint)fillRule();
 }
 
@@ -863,7 +831,7 @@ void GraphicsContext::fillPath(const Path& path)
 
         platformContext()->rq().freeSpace(12)
         << (jint)com_sun_webkit_graphics_GraphicsDecoder_FILL_PATH
-        << copyPath(path.platformPath())
+        << sharedPath(path.platformPath())
         << (jint)fillRule();
     }
 }
@@ -29,7 +29,6 @@
 
 #include "NotImplemented.h"
 #include "SharedBuffer.h"
-#include "SharedBuffer.h"
 #include "PlatformJavaClasses.h"
 #include "Logging.h"
 
@@ -93,6 +92,7 @@ ImageDecoderJava::~ImageDecoderJava()
             "()V");
     ASSERT(midDestroy);
 
+    // Waits for a running decode, java does not read m_segments after that.
     env->CallVoidMethod(m_nativeDecoder, midDestroy);
     WTF::CheckAndClearException(env);
 }
@@ -107,20 +107,34 @@ void ImageDecoderJava::setData(SharedBuffer& data, bool allDataReceived)
     static jmethodID midAddImageData = env->GetMethodID(
         PG_GetGraphicsImageDecoderClass(env),
         "addImageData",
-        "([B)V");
+        "(Ljava/nio/ByteBuffer;)V");
     ASSERT(midAddImageData);
 
-    while (m_receivedDataSize < data.size()) {
-        const auto& someData = data.getSomeData(m_receivedDataSize);
-        unsigned length = someData.size();
-        JLByteArray jArray(env->NewByteArray(length));
-        if (jArray && !WTF::CheckAndClearException(env)) {
+    // The segments are immutable, so java is given direct buffers over them
+    // instead of copies. Start with the segment holding the first new byte.
+    auto it = std::upper_bound(data.begin(), data.end(), m_receivedDataSize,
+        [] (size_t position, const SharedBuffer::DataSegmentVectorEntry& entry) {
+            return position < entry.beginPosition;
+        });
+    if (it != data.begin()) {
+        --it;
+    }
+    for (; it != data.end() && m_receivedDataSize < data.size(); ++it) {
+        size_t end = it->beginPosition + it->segment->size();
+        if (end <= m_receivedDataSize) {
+            continue;
+        }
+        size_t offset = m_receivedDataSize - it->beginPosition;
+        JLObject jBuffer(env->NewDirectByteBuffer(
+            const_cast<char*>(it->segment->data() + offset),
+            end - m_receivedDataSize));
+        if (jBuffer && !WTF::CheckAndClearException(env)) {
             // not OOME in Java
-            env->SetByteArrayRegion(jArray, 0, length, (const jbyte*)someData.data());
-            env->CallVoidMethod(m_nativeDecoder, midAddImageData, (jbyteArray)jArray);
+            m_segments.append(it->segment.copyRef());
+            env->CallVoidMethod(m_nativeDecoder, midAddImageData, (jobject)jBuffer);
             WTF::CheckAndClearException(env);
         }
-        m_receivedDataSize += length;
+        m_receivedDataSize = end;
     }
 
     if (allDataReceived) {
@@ -257,8 +271,8 @@ IntSize ImageDecoderJava::frameSizeAtIndex(size_t idx, SubsamplingLevel) const
 
 bool ImageDecoderJava::frameAllowSubsamplingAtIndex(size_t) const
 {
-    notImplemented();
-    return true;
+    // Frames are always decoded at full size.
+    return false;
 }
 
 bool ImageDecoderJava::frameHasAlphaAtIndex(size_t) const
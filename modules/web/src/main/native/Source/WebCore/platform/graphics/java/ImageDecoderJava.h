@@ -82,6 +82,8 @@ public:
 protected:
     bool m_isAllDataReceived { false };
     size_t m_receivedDataSize { 0 };
+    // Segments the java decoder reads in place, kept until it is destroyed.
+    Vector<Ref<SharedBuffer::DataSegment>> m_segments;
     mutable EncodedDataStatus m_encodedDataStatus { EncodedDataStatus::Unknown };
     // Native Handle for Java object.
     JGObject m_nativeDecoder;
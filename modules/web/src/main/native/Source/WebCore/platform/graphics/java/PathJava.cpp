@@ -26,16 +26,17 @@
 #include "config.h"
 
 #include "Path.h"
+#include "AffineTransform.h"
 #include "FloatRect.h"
 #include "StrokeStyleApplier.h"
 #include "PlatformContextJava.h"
 #include "PlatformJavaClasses.h"
-#include "NotImplemented.h"
 #include "GraphicsContextJava.h"
 #include "RQRef.h"
 #include "GraphicsContext.h"
 #include "ImageBuffer.h"
 
+#include <wtf/MathExtras.h>
 #include <wtf/text/WTFString.h>
 #include <wtf/java/JavaRef.h>
 
@@ -44,6 +45,15 @@
 
 namespace WebCore {
 
+static const jbyte SEG_MOVETO = com_sun_webkit_graphics_WCPathIterator_SEG_MOVETO;
+static const jbyte SEG_LINETO = com_sun_webkit_graphics_WCPathIterator_SEG_LINETO;
+static const jbyte SEG_QUADTO = com_sun_webkit_graphics_WCPathIterator_SEG_QUADTO;
+static const jbyte SEG_CUBICTO = com_sun_webkit_graphics_WCPathIterator_SEG_CUBICTO;
+static const jbyte SEG_CLOSE = com_sun_webkit_graphics_WCPathIterator_SEG_CLOSE;
+
+// Number of line segments a curve is split into by hit testing.
+static const int CURVE_FLATTENING_STEPS = 16;
+
 static GraphicsContext& scratchContext()
 {
     static std::unique_ptr<ImageBuffer> img = ImageBuffer::create(FloatSize(1.f, 1.f), RenderingMode::Unaccelerated);
@@ -51,49 +61,406 @@ static GraphicsContext& scratchContext()
     return context;
 }
 
-RefPtr<RQRef> createEmptyPath()
+// A WCPath the receiver may modify.
+RefPtr<RQRef> copyPath(PlatformPathPtr p)
 {
-    JNIEnv* env = WTF::GetJavaEnv();
-    static jmethodID mid = env->GetMethodID(PG_GetGraphicsManagerClass(env),
-        "createWCPath", "()Lcom/sun/webkit/graphics/WCPath;");
-    ASSERT(mid);
+    return p ? p->createJavaPath() : PlatformPathJava::create()->createJavaPath();
+}
 
-    JLObject ref(env->CallObjectMethod(PL_GetGraphicsManager(env), mid));
-    ASSERT(ref);
-    WTF::CheckAndClearException(env);
-    return RQRef::create(ref);
+// A read-only WCPath, created once until the path changes.
+RefPtr<RQRef> sharedPath(PlatformPathPtr p)
+{
+    return p ? p->javaPath() : PlatformPathJava::create()->javaPath();
+}
+
+RefPtr<PlatformPathJava> PlatformPathJava::copy() const
+{
+    RefPtr<PlatformPathJava> path = create();
+    path->m_types = m_types;
+    path->m_coords = m_coords;
+    path->m_moveTo = m_moveTo;
+    // The cached java copy is read-only, so it can be shared.
+    path->m_javaPath = m_javaPath;
+    return path;
+}
+
+FloatPoint PlatformPathJava::currentPoint() const
+{
+    if (isEmpty()) {
+        float quietNaN = std::numeric_limits<float>::quiet_NaN();
+        return FloatPoint(quietNaN, quietNaN);
+    }
+    if (m_types.last() == SEG_CLOSE) {
+        return m_moveTo;
+    }
+    size_t n = m_coords.size();
+    return FloatPoint(m_coords[n - 2], m_coords[n - 1]);
+}
+
+void PlatformPathJava::clear()
+{
+    m_types.clear();
+    m_coords.clear();
+    m_moveTo = FloatPoint();
+    changed();
+}
+
+void PlatformPathJava::append(jbyte type, std::initializer_list<FloatPoint> points)
+{
+    m_types.append(type);
+    for (const auto& p : points) {
+        m_coords.append(p.x());
+        m_coords.append(p.y());
+    }
+    changed();
+}
+
+void PlatformPathJava::moveTo(const FloatPoint& p)
+{
+    m_moveTo = p;
+    if (!isEmpty() && m_types.last() == SEG_MOVETO) {
+        // Consecutive moves collapse as in Path2D.
+        size_t n = m_coords.size();
+        m_coords[n - 2] = p.x();
+        m_coords[n - 1] = p.y();
+        changed();
+        return;
+    }
+    append(SEG_MOVETO, { p });
+}
+
+void PlatformPathJava::lineTo(const FloatPoint& p)
+{
+    if (isEmpty()) {
+        moveTo(p);
+        return;
+    }
+    append(SEG_LINETO, { p });
+}
+
+void PlatformPathJava::quadTo(const FloatPoint& cp, const FloatPoint& p)
+{
+    if (isEmpty()) {
+        moveTo(cp);
+    }
+    append(SEG_QUADTO, { cp, p });
+}
+
+void PlatformPathJava::cubicTo(const FloatPoint& cp1, const FloatPoint& cp2, const FloatPoint& p)
+{
+    if (isEmpty()) {
+        moveTo(cp1);
+    }
+    append(SEG_CUBICTO, { cp1, cp2, p });
 }
 
-RefPtr<RQRef> copyPath(RefPtr<RQRef> p)
+void PlatformPathJava::closeSubpath()
 {
-    if (!p) {
-        return createEmptyPath();
+    if (isEmpty() || m_types.last() == SEG_CLOSE) {
+        return;
+    }
+    append(SEG_CLOSE, { });
+}
+
+// Same as Path2D.append(shape, true) does with the first point of the shape.
+void PlatformPathJava::connectTo(const FloatPoint& p)
+{
+    if (isEmpty()) {
+        moveTo(p);
+        return;
+    }
+    size_t n = m_coords.size();
+    if (m_types.last() != SEG_CLOSE && m_coords[n - 2] == p.x() && m_coords[n - 1] == p.y()) {
+        return;
+    }
+    lineTo(p);
+}
+
+void PlatformPathJava::addArc(const AffineTransform& transform, float startAngle, float sweepAngle)
+{
+    connectTo(transform.mapPoint(FloatPoint(cos(startAngle), sin(startAngle))));
+    if (!sweepAngle) {
+        return;
+    }
+
+    // One cubic per quarter of the circle at most.
+    int count = clampTo<int>(ceil(fabs(sweepAngle) / piOverTwoDouble), 1, 4);
+    double step = static_cast<double>(sweepAngle) / count;
+    double k = 4.0 / 3.0 * tan(step / 4);
+    double a0 = startAngle;
+    for (int i = 0; i < count; ++i) {
+        double a1 = a0 + step;
+        double c0 = cos(a0), s0 = sin(a0);
+        double c1 = cos(a1), s1 = sin(a1);
+        cubicTo(
+            transform.mapPoint(FloatPoint(c0 - k * s0, s0 + k * c0)),
+            transform.mapPoint(FloatPoint(c1 + k * s1, s1 - k * c1)),
+            transform.mapPoint(FloatPoint(c1, s1)));
+        a0 = a1;
     }
+}
+
+void PlatformPathJava::addArcTo(const FloatPoint& p1, const FloatPoint& p2, float radius)
+{
+    if (isEmpty()) {
+        moveTo(p1);
+        return;
+    }
+
+    FloatPoint p0 = currentPoint();
+    double x1 = p0.x() - p1.x(), y1 = p0.y() - p1.y();
+    double x2 = p2.x() - p1.x(), y2 = p2.y() - p1.y();
+    double l1 = hypot(x1, y1), l2 = hypot(x2, y2);
+    if (!l1 || !l2 || !radius) {
+        lineTo(p1);
+        return;
+    }
+    x1 /= l1; y1 /= l1;
+    x2 /= l2; y2 /= l2;
+
+    double cosPhi = x1 * x2 + y1 * y2;
+    if (fabs(cosPhi) >= 1 - std::numeric_limits<float>::epsilon()) {
+        // The points are collinear.
+        lineTo(p1);
+        return;
+    }
+
+    // The circle touches both p1->p0 and p1->p2, its center is on the bisector.
+    double halfPhi = acos(cosPhi) / 2;
+    double tangentDistance = radius / tan(halfPhi);
+    double centerDistance = radius / sin(halfPhi);
+    double bx = x1 + x2, by = y1 + y2;
+    double bl = hypot(bx, by);
+    double cx = p1.x() + bx / bl * centerDistance;
+    double cy = p1.y() + by / bl * centerDistance;
+
+    double a1 = atan2(p1.y() + y1 * tangentDistance - cy, p1.x() + x1 * tangentDistance - cx);
+    double a2 = atan2(p1.y() + y2 * tangentDistance - cy, p1.x() + x2 * tangentDistance - cx);
+    double sweep = a2 - a1;
+    if (sweep > piDouble) {
+        sweep -= 2 * piDouble;
+    } else if (sweep < -piDouble) {
+        sweep += 2 * piDouble;
+    }
+
+    AffineTransform transform;
+    transform.translate(cx, cy).scale(radius);
+    addArc(transform, a1, sweep);
+}
+
+void PlatformPathJava::addRect(const FloatRect& r)
+{
+    moveTo(r.location());
+    lineTo(FloatPoint(r.maxX(), r.y()));
+    lineTo(r.maxXMaxYCorner());
+    lineTo(FloatPoint(r.x(), r.maxY()));
+    closeSubpath();
+}
+
+void PlatformPathJava::addEllipse(const FloatRect& r)
+{
+    AffineTransform transform;
+    transform.translate(r.center().x(), r.center().y()).scale(r.width() / 2, r.height() / 2);
+    moveTo(transform.mapPoint(FloatPoint(1, 0)));
+    addArc(transform, 0, 2 * piFloat);
+    closeSubpath();
+}
+
+void PlatformPathJava::addPath(const PlatformPathJava& path, const AffineTransform& transform)
+{
+    if (&path == this) {
+        addPath(*copy(), transform);
+        return;
+    }
+
+    const jfloat* c = path.m_coords.data();
+    auto point = [&] (int i) {
+        return transform.mapPoint(FloatPoint(c[2 * i], c[2 * i + 1]));
+    };
+    for (jbyte type : path.m_types) {
+        switch (type) {
+        case SEG_MOVETO:
+            moveTo(point(0));
+            c += 2;
+            break;
+        case SEG_LINETO:
+            lineTo(point(0));
+            c += 2;
+            break;
+        case SEG_QUADTO:
+            quadTo(point(0), point(1));
+            c += 4;
+            break;
+        case SEG_CUBICTO:
+            cubicTo(point(0), point(1), point(2));
+            c += 6;
+            break;
+        case SEG_CLOSE:
+            closeSubpath();
+            break;
+        }
+    }
+}
+
+void PlatformPathJava::transform(const AffineTransform& transform)
+{
+    for (size_t i = 0; i + 1 < m_coords.size(); i += 2) {
+        FloatPoint p = transform.mapPoint(FloatPoint(m_coords[i], m_coords[i + 1]));
+        m_coords[i] = p.x();
+        m_coords[i + 1] = p.y();
+    }
+    m_moveTo = transform.mapPoint(m_moveTo);
+    changed();
+}
+
+FloatRect PlatformPathJava::boundingRect() const
+{
+    if (m_coords.isEmpty()) {
+        return FloatRect();
+    }
+    float minX = m_coords[0], maxX = m_coords[0];
+    float minY = m_coords[1], maxY = m_coords[1];
+    for (size_t i = 2; i + 1 < m_coords.size(); i += 2) {
+        minX = std::min(minX, m_coords[i]);
+        maxX = std::max(maxX, m_coords[i]);
+        minY = std::min(minY, m_coords[i + 1]);
+        maxY = std::max(maxY, m_coords[i + 1]);
+    }
+    return FloatRect(minX, minY, maxX - minX, maxY - minY);
+}
+
+// Winding contribution of the edge [a, b] for a ray cast from [p] towards +x.
+static int windingCrossing(const FloatPoint& a, const FloatPoint& b, const FloatPoint& p)
+{
+    float side = (b.x() - a.x()) * (p.y() - a.y()) - (p.x() - a.x()) * (b.y() - a.y());
+    if (a.y() <= p.y()) {
+        if (b.y() > p.y() && side > 0) {
+            return 1;
+        }
+    } else if (b.y() <= p.y() && side < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+bool PlatformPathJava::contains(const FloatPoint& p, WindRule rule) const
+{
+    int winding = 0;
+    FloatPoint start, current;
+    const jfloat* c = m_coords.data();
+    auto point = [&] (int i) {
+        return FloatPoint(c[2 * i], c[2 * i + 1]);
+    };
+    auto lineTo = [&] (const FloatPoint& to) {
+        winding += windingCrossing(current, to, p);
+        current = to;
+    };
+
+    for (jbyte type : m_types) {
+        switch (type) {
+        case SEG_MOVETO:
+            // Subpaths are closed implicitly.
+            lineTo(start);
+            start = current = point(0);
+            c += 2;
+            break;
+        case SEG_LINETO:
+            lineTo(point(0));
+            c += 2;
+            break;
+        case SEG_QUADTO: {
+            FloatPoint p0 = current, p1 = point(0), p2 = point(1);
+            for (int i = 1; i <= CURVE_FLATTENING_STEPS; ++i) {
+                float t = static_cast<float>(i) / CURVE_FLATTENING_STEPS, u = 1 - t;
+                lineTo(FloatPoint(
+                    u * u * p0.x() + 2 * u * t * p1.x() + t * t * p2.x(),
+                    u * u * p0.y() + 2 * u * t * p1.y() + t * t * p2.y()));
+            }
+            c += 4;
+            break;
+        }
+        case SEG_CUBICTO: {
+            FloatPoint p0 = current, p1 = point(0), p2 = point(1), p3 = point(2);
+            for (int i = 1; i <= CURVE_FLATTENING_STEPS; ++i) {
+                float t = static_cast<float>(i) / CURVE_FLATTENING_STEPS, u = 1 - t;
+                lineTo(FloatPoint(
+                    u * u * u * p0.x() + 3 * u * u * t * p1.x() + 3 * u * t * t * p2.x() + t * t * t * p3.x(),
+                    u * u * u * p0.y() + 3 * u * u * t * p1.y() + 3 * u * t * t * p2.y() + t * t * t * p3.y()));
+            }
+            c += 6;
+            break;
+        }
+        case SEG_CLOSE:
+            lineTo(start);
+            break;
+        }
+    }
+    lineTo(start);
+
+    return rule == WindRule::EvenOdd ? (winding & 1) : winding;
+}
+
+RefPtr<RQRef> PlatformPathJava::javaPath() const
+{
+    if (!m_javaPath) {
+        m_javaPath = createJavaPath();
+    }
+    return m_javaPath;
+}
+
+RefPtr<RQRef> PlatformPathJava::createJavaPath() const
+{
     JNIEnv* env = WTF::GetJavaEnv();
 
     static jmethodID mid = env->GetMethodID(PG_GetGraphicsManagerClass(env),
-        "createWCPath",
-        "(Lcom/sun/webkit/graphics/WCPath;)Lcom/sun/webkit/graphics/WCPath;");
+        "createWCPath", "([BI[FI)Lcom/sun/webkit/graphics/WCPath;");
     ASSERT(mid);
 
-    JLObject ref(env->CallObjectMethod(PL_GetGraphicsManager(env), mid, (jobject)*p));
+    JLocalRef<jbyteArray> types(env->NewByteArray(m_types.size()));
+    env->SetByteArrayRegion(types, 0, m_types.size(), m_types.data());
+    JLocalRef<jfloatArray> coords(env->NewFloatArray(m_coords.size()));
+    env->SetFloatArrayRegion(coords, 0, m_coords.size(), m_coords.data());
+
+    JLObject ref(env->CallObjectMethod(PL_GetGraphicsManager(env), mid,
+        (jbyteArray)types, (jint)m_types.size(),
+        (jfloatArray)coords, (jint)m_coords.size()));
     ASSERT(ref);
     WTF::CheckAndClearException(env);
 
     return RQRef::create(ref);
 }
 
+// Direction adjustment of the arc's end angle as done by canvas arc().
+static float arcSweepAngle(float startAngle, float endAngle, bool anticlockwise)
+{
+    const float twoPi = 2.0f * piFloat;
+    float newEndAngle = endAngle;
+
+    // http://www.whatwg.org/specs/web-apps/current-work/multipage/the-canvas-element.html#dom-context-2d-arc
+    // The arc goes anti-clockwise if the anticlockwise argument is true, and
+    // clockwise otherwise, and can never cover an angle greater than 2pi.
+    // NOTE: When startAngle = 0, endAngle = 2Pi and anticlockwise = true, the
+    // spec does not indicate clearly. We draw the entire circle, because some
+    // web sites use arc(x, y, r, 0, 2*Math.PI, true) to draw circle.
+    if (!anticlockwise && startAngle > endAngle) {
+        newEndAngle = startAngle + (twoPi - fmodf(startAngle - endAngle, twoPi));
+    } else if (anticlockwise && startAngle < endAngle) {
+        newEndAngle = startAngle - (twoPi - fmodf(endAngle - startAngle, twoPi));
+    }
+    return clampTo<float>(newEndAngle - startAngle, -twoPi, twoPi);
+}
+
 bool Path::isNull() const
 {
     return !m_path;
 }
 
 Path::Path()
-    : m_path(createEmptyPath())
+    : m_path(PlatformPathJava::create())
 {}
 
 Path::Path(const Path& p)
-    : m_path(copyPath(p.platformPath()))
+    : m_path(p.m_path ? p.m_path->copy() : PlatformPathJava::create())
 {}
 
 Path::~Path()
@@ -108,7 +475,7 @@ Path::Path(Path&& other)
 Path& Path::operator=(const Path &p)
 {
     if (this != &p) {
-        m_path = copyPath(p.platformPath());
+        m_path = p.m_path ? p.m_path->copy() : PlatformPathJava::create();
     }
     return *this;
 }
@@ -127,17 +494,7 @@ bool Path::contains(const FloatPoint& p, WindRule rule) const
 {
     ASSERT(m_path);
 
-    JNIEnv* env = WTF::GetJavaEnv();
-
-    static jmethodID mid = env->GetMethodID(PG_GetPathClass(env), "contains",
-        "(IDD)Z");
-    ASSERT(mid);
-
-    jboolean res = env->CallBooleanMethod(*m_path, mid, (jint)rule,
-        (jdouble)p.x(), (jdouble)p.y());
-    WTF::CheckAndClearException(env);
-
-    return jbool_to_bool(res);
+    return m_path->contains(p, rule);
 }
 
 FloatRect Path::boundingRectSlowCase() const
@@ -154,123 +511,58 @@ FloatRect Path::strokeBoundingRect(StrokeStyleApplier *applier) const
 {
     ASSERT(m_path);
 
-    JNIEnv* env = WTF::GetJavaEnv();
-
-    static jmethodID mid = env->GetMethodID(PG_GetPathClass(env), "getBounds",
-            "()Lcom/sun/webkit/graphics/WCRectangle;");
-    ASSERT(mid);
-
-    JLObject rect(env->CallObjectMethod(*m_path, mid));
-    WTF::CheckAndClearException(env);
-    if (rect) {
-        static jfieldID rectxFID = env->GetFieldID(PG_GetRectangleClass(env), "x", "F");
-        ASSERT(rectxFID);
-        static jfieldID rectyFID = env->GetFieldID(PG_GetRectangleClass(env), "y", "F");
-        ASSERT(rectyFID);
-        static jfieldID rectwFID = env->GetFieldID(PG_GetRectangleClass(env), "w", "F");
-        ASSERT(rectwFID);
-        static jfieldID recthFID = env->GetFieldID(PG_GetRectangleClass(env), "h", "F");
-        ASSERT(recthFID);
-
-        FloatRect bounds(
-            float(env->GetFloatField(rect, rectxFID)),
-            float(env->GetFloatField(rect, rectyFID)),
-            float(env->GetFloatField(rect, rectwFID)),
-            float(env->GetFloatField(rect, recthFID)));
-        WTF::CheckAndClearException(env);
-
-        float thickness;
-        if (applier) {
-            GraphicsContext& gc = scratchContext();
-            gc.save();
-            applier->strokeStyle(&gc);
-            thickness = gc.strokeThickness();
-            gc.restore();
-            bounds.inflate(thickness / 2);
-        }
-        return bounds;
-    } else {
-        return FloatRect();
+    FloatRect bounds = m_path->boundingRect();
+    if (applier) {
+        GraphicsContext& gc = scratchContext();
+        gc.save();
+        applier->strokeStyle(&gc);
+        float thickness = gc.strokeThickness();
+        gc.restore();
+        bounds.inflate(thickness / 2);
     }
+    return bounds;
 }
 
 void Path::clear()
 {
     ASSERT(m_path);
 
-    JNIEnv* env = WTF::GetJavaEnv();
-
-    static jmethodID mid = env->GetMethodID(PG_GetPathClass(env),
-        "clear", "()V");
-    ASSERT(mid);
-
-    env->CallVoidMethod(*m_path, mid);
-    WTF::CheckAndClearException(env);
+    m_path->clear();
 }
 
 bool Path::isEmptySlowCase() const
 {
     ASSERT(m_path);
 
-    JNIEnv* env = WTF::GetJavaEnv();
-
-    static jmethodID mid = env->GetMethodID(PG_GetPathClass(env),
-                                            "isEmpty", "()Z");
-    ASSERT(mid);
-
-    jboolean res = env->CallBooleanMethod(*m_path, mid);
-    WTF::CheckAndClearException(env);
-
-    return jbool_to_bool(res);
+    return m_path->isEmpty();
 }
 
 FloatPoint Path::currentPointSlowCase() const
 {
-    //utatodo: return current point of subpath.
-    float quietNaN = std::numeric_limits<float>::quiet_NaN();
-    return FloatPoint(quietNaN, quietNaN);
+    ASSERT(m_path);
+
+    return m_path->currentPoint();
 }
 
 void Path::moveToSlowCase(const FloatPoint &p)
 {
     ASSERT(m_path);
 
-    JNIEnv* env = WTF::GetJavaEnv();
-
-    static jmethodID mid = env->GetMethodID(PG_GetPathClass(env), "moveTo",
-        "(DD)V");
-    ASSERT(mid);
-
-    env->CallVoidMethod(*m_path, mid, (jdouble)p.x(), (jdouble)p.y());
-    WTF::CheckAndClearException(env);
+    m_path->moveTo(p);
 }
 
 void Path::addLineToSlowCase(const FloatPoint &p)
 {
     ASSERT(m_path);
 
-    JNIEnv* env = WTF::GetJavaEnv();
-
-    static jmethodID mid = env->GetMethodID(PG_GetPathClass(env), "addLineTo",
-        "(DD)V");
-    ASSERT(mid);
-
-    env->CallVoidMethod(*m_path, mid, (jdouble)p.x(), (jdouble)p.y());
-    WTF::CheckAndClearException(env);
+    m_path->lineTo(p);
 }
 
 void Path::addQuadCurveToSlowCase(const FloatPoint &cp, const FloatPoint &p)
 {
     ASSERT(m_path);
 
-    JNIEnv* env = WTF::GetJavaEnv();
-
-    static jmethodID mid = env->GetMethodID(PG_GetPathClass(env), "addQuadCurveTo",
-                                            "(DDDD)V");
-    ASSERT(mid);
-
-    env->CallVoidMethod(*m_path, mid, (jdouble)cp.x(), (jdouble)cp.y(), (jdouble)p.x(), (jdouble)p.y());
-    WTF::CheckAndClearException(env);
+    m_path->quadTo(cp, p);
 }
 
 void Path::addBezierCurveToSlowCase(const FloatPoint & controlPoint1,
@@ -279,206 +571,121 @@ void Path::addBezierCurveToSlowCase(const FloatPoint & controlPoint1,
 {
     ASSERT(m_path);
 
-    JNIEnv* env = WTF::GetJavaEnv();
-
-    static jmethodID mid = env->GetMethodID(PG_GetPathClass(env),
-        "addBezierCurveTo", "(DDDDDD)V");
-    ASSERT(mid);
-
-    env->CallVoidMethod(*m_path, mid,
-                        (jdouble)controlPoint1.x(), (jdouble)controlPoint1.y(),
-                        (jdouble)controlPoint2.x(), (jdouble)controlPoint2.y(),
-                        (jdouble)controlPoint3.x(), (jdouble)controlPoint3.y());
-    WTF::CheckAndClearException(env);
+    m_path->cubicTo(controlPoint1, controlPoint2, controlPoint3);
 }
 
 void Path::addArcTo(const FloatPoint & p1, const FloatPoint & p2, float radius)
 {
     ASSERT(m_path);
 
-    JNIEnv* env = WTF::GetJavaEnv();
-
-    static jmethodID mid = env->GetMethodID(PG_GetPathClass(env), "addArcTo",
-        "(DDDDD)V");
-    ASSERT(mid);
-
-    env->CallVoidMethod(*m_path, mid,
-                        (jdouble)p1.x(), (jdouble)p1.y(),
-                        (jdouble)p2.x(), (jdouble)p2.y(), (jdouble)radius);
-    WTF::CheckAndClearException(env);
+    m_path->addArcTo(p1, p2, radius);
 }
 
 void Path::closeSubpath()
 {
     ASSERT(m_path);
 
-    JNIEnv* env = WTF::GetJavaEnv();
-
-    static jmethodID mid = env->GetMethodID(PG_GetPathClass(env),
-        "closeSubpath", "()V");
-    ASSERT(mid);
-
-    env->CallVoidMethod(*m_path, mid);
-    WTF::CheckAndClearException(env);
+    m_path->closeSubpath();
 }
 
 void Path::addArcSlowCase(const FloatPoint & p, float radius, float startAngle,
-                  float endAngle, bool clockwise)
+                  float endAngle, bool anticlockwise)
 {
     ASSERT(m_path);
 
-    JNIEnv* env = WTF::GetJavaEnv();
-
-    static jmethodID mid = env->GetMethodID(PG_GetPathClass(env), "addArc",
-        "(DDDDDZ)V");
-    ASSERT(mid);
-
-    env->CallVoidMethod(*m_path, mid, (jdouble)p.x(), (jdouble)p.y(),
-        (jdouble)radius, (jdouble)startAngle, (jdouble)endAngle,
-        bool_to_jbool(clockwise));
-    WTF::CheckAndClearException(env);
+    AffineTransform transform;
+    transform.translate(p.x(), p.y()).scale(radius);
+    m_path->addArc(transform, startAngle, arcSweepAngle(startAngle, endAngle, anticlockwise));
 }
 
 void Path::addRect(const FloatRect& r)
 {
     ASSERT(m_path);
 
-    JNIEnv* env = WTF::GetJavaEnv();
-
-    static jmethodID mid = env->GetMethodID(PG_GetPathClass(env), "addRect",
-        "(DDDD)V");
-    ASSERT(mid);
-
-    env->CallVoidMethod(*m_path, mid, (jdouble)r.x(), (jdouble)r.y(),
-                              (jdouble)r.width(), (jdouble)r.height());
-    WTF::CheckAndClearException(env);
+    m_path->addRect(r);
 }
 
-void Path::addEllipse(FloatPoint, float, float, float, float, float, bool)
+void Path::addEllipse(FloatPoint p, float radiusX, float radiusY, float rotation,
+                      float startAngle, float endAngle, bool anticlockwise)
 {
-    notImplemented();
+    ASSERT(m_path);
+
+    AffineTransform transform;
+    transform.translate(p.x(), p.y()).rotate(rad2deg(rotation)).scale(radiusX, radiusY);
+    m_path->addArc(transform, startAngle, arcSweepAngle(startAngle, endAngle, anticlockwise));
 }
 
-void Path::addPath(const Path&, const AffineTransform&)
+void Path::addPath(const Path& path, const AffineTransform& transform)
 {
-    notImplemented();
+    ASSERT(m_path);
+
+    if (path.m_path) {
+        m_path->addPath(*path.m_path, transform);
+    }
 }
 
 void Path::addEllipse(const FloatRect& r)
 {
     ASSERT(m_path);
 
-    JNIEnv* env = WTF::GetJavaEnv();
-    static jmethodID mid = env->GetMethodID(PG_GetPathClass(env), "addEllipse",
-        "(DDDD)V");
-    ASSERT(mid);
-
-    env->CallVoidMethod(*m_path, mid,
-                        (jdouble)r.x(), (jdouble)r.y(),
-                        (jdouble)r.width(), (jdouble)r.height());
-    WTF::CheckAndClearException(env);
+    m_path->addEllipse(r);
 }
 
 void Path::translate(const FloatSize &sz)
 {
     ASSERT(m_path);
 
-    JNIEnv* env = WTF::GetJavaEnv();
-    static jmethodID mid = env->GetMethodID(PG_GetPathClass(env), "translate",
-        "(DD)V");
-    ASSERT(mid);
-
-    env->CallVoidMethod(*m_path, mid,
-                        (jdouble)sz.width(), (jdouble)sz.height());
-    WTF::CheckAndClearException(env);
+    AffineTransform transform;
+    transform.translate(sz.width(), sz.height());
+    m_path->transform(transform);
 }
 
 void Path::transform(const AffineTransform &at)
 {
     ASSERT(m_path);
 
-    JNIEnv* env = WTF::GetJavaEnv();
-
-    static jmethodID mid = env->GetMethodID(PG_GetPathClass(env),
-        "transform", "(DDDDDD)V");
-    ASSERT(mid);
-
-    env->CallVoidMethod(*m_path, mid,
-                        (jdouble)at.a(), (jdouble)at.b(),
-                        (jdouble)at.c(), (jdouble)at.d(),
-                        (jdouble)at.e(), (jdouble)at.f());
-    WTF::CheckAndClearException(env);
+    m_path->transform(at);
 }
 
 void Path::applySlowCase(const PathApplierFunction& function) const
 {
     ASSERT(m_path);
 
-    JNIEnv* env = WTF::GetJavaEnv();
-
-    static jmethodID mid = env->GetMethodID(PG_GetPathClass(env),
-        "getPathIterator", "()Lcom/sun/webkit/graphics/WCPathIterator;");
-    ASSERT(mid);
-
-    JLObject iter(env->CallObjectMethod(*m_path, mid));
-    WTF::CheckAndClearException(env);
-
-    if (iter) {
-        static jmethodID midIsDone = env->GetMethodID(PG_GetPathIteratorClass(env),
-            "isDone", "()Z");
-        ASSERT(midIsDone);
-
-        static jmethodID midNext = env->GetMethodID(PG_GetPathIteratorClass(env),
-            "next", "()V");
-        ASSERT(midNext);
-
-        static jmethodID midCurrentSegment = env->GetMethodID(PG_GetPathIteratorClass(env),
-            "currentSegment", "([D)I");
-        ASSERT(midCurrentSegment);
-
-        PathElement pathElement;
-
-        JLocalRef<jdoubleArray> coords(env->NewDoubleArray(6));
-        while(JNI_FALSE == env->CallBooleanMethod(iter, midIsDone)) {
-            jint type = env->CallBooleanMethod(
-                iter,
-                midCurrentSegment,
-                (jdoubleArray)coords);
-            jboolean isCopy = JNI_FALSE;
-            jdouble *data = env->GetDoubleArrayElements(coords, &isCopy);
-            switch (type) {
-            case com_sun_webkit_graphics_WCPathIterator_SEG_MOVETO:
-                pathElement.type = PathElement::Type::MoveToPoint;
-                pathElement.points[0] = FloatPoint(data[0],data[1]);
-                function(pathElement);
-                break;
-            case com_sun_webkit_graphics_WCPathIterator_SEG_LINETO:
-                pathElement.type = PathElement::Type::AddLineToPoint;
-                pathElement.points[0] = FloatPoint(data[0],data[1]);
-                function(pathElement);
-                break;
-            case com_sun_webkit_graphics_WCPathIterator_SEG_QUADTO:
-                pathElement.type = PathElement::Type::AddQuadCurveToPoint;
-                pathElement.points[0] = FloatPoint(data[0],data[1]);
-                pathElement.points[1] = FloatPoint(data[2],data[3]);
-                function(pathElement);
-                break;
-            case com_sun_webkit_graphics_WCPathIterator_SEG_CUBICTO:
-                pathElement.type = PathElement::Type::AddCurveToPoint;
-                pathElement.points[0] = FloatPoint(data[0],data[1]);
-                pathElement.points[1] = FloatPoint(data[2],data[3]);
-                pathElement.points[2] = FloatPoint(data[4],data[5]);
-                function(pathElement);
-                break;
-            case com_sun_webkit_graphics_WCPathIterator_SEG_CLOSE:
-                pathElement.type = PathElement::Type::CloseSubpath;
-                function(pathElement);
-                break;
-            }
-            env->ReleaseDoubleArrayElements(coords, data, JNI_ABORT);
-            env->CallVoidMethod(iter, midNext);
+    PathElement pathElement;
+    const jfloat* c = m_path->coords().data();
+    auto point = [&] (int i) {
+        return FloatPoint(c[2 * i], c[2 * i + 1]);
+    };
+    for (jbyte type : m_path->types()) {
+        switch (type) {
+        case SEG_MOVETO:
+            pathElement.type = PathElement::Type::MoveToPoint;
+            pathElement.points[0] = point(0);
+            c += 2;
+            break;
+        case SEG_LINETO:
+            pathElement.type = PathElement::Type::AddLineToPoint;
+            pathElement.points[0] = point(0);
+            c += 2;
+            break;
+        case SEG_QUADTO:
+            pathElement.type = PathElement::Type::AddQuadCurveToPoint;
+            pathElement.points[0] = point(0);
+            pathElement.points[1] = point(1);
+            c += 4;
+            break;
+        case SEG_CUBICTO:
+            pathElement.type = PathElement::Type::AddCurveToPoint;
+            pathElement.points[0] = point(0);
+            pathElement.points[1] = point(1);
+            pathElement.points[2] = point(2);
+            c += 6;
+            break;
+        case SEG_CLOSE:
+            pathElement.type = PathElement::Type::CloseSubpath;
+            break;
         }
-        WTF::CheckAndClearException(env);
+        function(pathElement);
     }
 }
 
@@ -515,7 +722,7 @@ bool Path::strokeContains(StrokeStyleApplier& applier, const FloatPoint& p) cons
     JLocalRef<jdoubleArray> dashArray(env->NewDoubleArray(size));
     env->SetDoubleArrayRegion(dashArray, 0, size, dashes.data());
 
-    jboolean res = env->CallBooleanMethod(*m_path, mid, (jdouble)p.x(),
+    jboolean res = env->CallBooleanMethod(*m_path->javaPath(), mid, (jdouble)p.x(),
         (jdouble)p.y(), (jdouble) thickness, (jdouble) miterLimit,
         (jint) cap, (jint) join, (jdouble) dashOffset, (jdoubleArray) dashArray);
 
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include "AffineTransform.h"
 #include "GraphicsContext.h"
 #include "Path.h"
 #include "RenderingQueue.h"
@@ -34,7 +35,8 @@
 
 namespace WebCore {
 
-    RefPtr<RQRef> copyPath(RefPtr<RQRef> p);
+    RefPtr<RQRef> copyPath(PlatformPathPtr p);
+    RefPtr<RQRef> sharedPath(PlatformPathPtr p);
 
     class PlatformContextJava {
         WTF_MAKE_NONCOPYABLE(PlatformContextJava);
@@ -69,14 +71,7 @@ namespace WebCore {
         }
 
         void addPath(PlatformPathPtr pPath) {
-            JNIEnv* env = WTF::GetJavaEnv();
-
-            static jmethodID mid = env->GetMethodID(PG_GetPathClass(env),
-                "addPath", "(Lcom/sun/webkit/graphics/WCPath;)V");
-            ASSERT(mid);
-
-            env->CallVoidMethod((jobject)*m_path.platformPath(), mid, (jobject)*pPath);
-            WTF::CheckAndClearException(env);
+            m_path.platformPath()->addPath(*pPath, AffineTransform());
         }
 
         PlatformPathPtr platformPath() {
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#pragma once
+
+#include <jni.h>
+#include <wtf/RefCounted.h>
+#include <wtf/RefPtr.h>
+#include <wtf/Vector.h>
+
+#include "FloatPoint.h"
+#include "FloatRect.h"
+#include "RQRef.h"
+#include "WindRule.h"
+
+namespace WebCore {
+
+class AffineTransform;
+
+/*
+ * Native storage of a WebCore::Path.
+ *
+ * Segments are kept in the layout of com.sun.javafx.geom.Path2D: one
+ * WCPathIterator.SEG_* code per segment and two floats per point. The path
+ * is built, queried and transformed in C++; java gets a copy of it in one
+ * transfer only when it is needed there (drawing, clipping, stroke tests).
+ * The copy used for filling, stroking and stroke tests is cached until the
+ * path changes: java only reads it. Clipping changes its WCPath in place,
+ * so it gets a fresh copy of its own.
+ */
+class PlatformPathJava : public RefCounted<PlatformPathJava> {
+public:
+    static RefPtr<PlatformPathJava> create()
+    {
+        return adoptRef(new PlatformPathJava());
+    }
+
+    RefPtr<PlatformPathJava> copy() const;
+
+    const Vector<jbyte>& types() const { return m_types; }
+    const Vector<jfloat>& coords() const { return m_coords; }
+
+    bool isEmpty() const { return m_types.isEmpty(); }
+    bool hasCurrentPoint() const { return !isEmpty(); }
+    FloatPoint currentPoint() const;
+
+    void clear();
+    void moveTo(const FloatPoint&);
+    void lineTo(const FloatPoint&);
+    void quadTo(const FloatPoint& controlPoint, const FloatPoint&);
+    void cubicTo(const FloatPoint& controlPoint1, const FloatPoint& controlPoint2, const FloatPoint&);
+    void closeSubpath();
+
+    // Arc of the unit circle mapped by [transform], connected to the current point.
+    void addArc(const AffineTransform&, float startAngle, float sweepAngle);
+    void addArcTo(const FloatPoint&, const FloatPoint&, float radius);
+    void addRect(const FloatRect&);
+    void addEllipse(const FloatRect&);
+    void addPath(const PlatformPathJava&, const AffineTransform&);
+
+    void transform(const AffineTransform&);
+
+    // Bounds of all the points, control points included (as Path2D.getBounds).
+    FloatRect boundingRect() const;
+    bool contains(const FloatPoint&, WindRule) const;
+
+    // A java WCPath with the same segments, shared with the copies of this
+    // path. It must not be modified.
+    RefPtr<RQRef> javaPath() const;
+    // A new java WCPath with the same segments.
+    RefPtr<RQRef> createJavaPath() const;
+
+private:
+    PlatformPathJava() = default;
+
+    void append(jbyte type, std::initializer_list<FloatPoint>);
+    void connectTo(const FloatPoint&);
+    void changed() { m_javaPath = nullptr; }
+
+    Vector<jbyte> m_types;
+    Vector<jfloat> m_coords;
+    // Start of the current subpath, the current point after SEG_CLOSE.
+    FloatPoint m_moveTo;
+    mutable RefPtr<RQRef> m_javaPath;
+};
+
+} // namespace WebCore
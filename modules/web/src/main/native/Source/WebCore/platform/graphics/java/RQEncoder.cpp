@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "config.h"
+
+#include "RQEncoder.h"
+#include "RenderingQueue.h"
+
+#include "com_sun_webkit_graphics_GraphicsDecoder.h"
+
+namespace WebCore {
+
+// Statistics only, so no synchronization.
+static jint s_emitted[RQEncoder::MAX_OPCODE];
+static jint s_elided[RQEncoder::MAX_OPCODE];
+
+static_assert(com_sun_webkit_graphics_GraphicsDecoder_DRAWGLYPHS < RQEncoder::MAX_OPCODE,
+    "GraphicsDecoder opcodes do not fit the histogram");
+
+void RQEncoder::getHistogram(jint* emitted, jint* elided, int size)
+{
+    size = std::min(size, static_cast<int>(MAX_OPCODE));
+    std::copy(s_emitted, s_emitted + size, emitted);
+    std::copy(s_elided, s_elided + size, elided);
+}
+
+RenderingQueue& RQEncoder::emit(jint opcode, int size)
+{
+    commit();
+    ASSERT(opcode >= 0 && opcode < MAX_OPCODE);
+    ++s_emitted[opcode];
+    return m_rq.reserve(size) << opcode;
+}
+
+void RQEncoder::elide(jint opcode, unsigned count)
+{
+    ASSERT(opcode >= 0 && opcode < MAX_OPCODE);
+    s_elided[opcode] += count;
+}
+
+void RQEncoder::commitRects()
+{
+    // Taken out first: writing to the RQ may flush its buffer and get here again.
+    Vector<FloatRect, MAX_BATCHED_RECTS> rects = WTFMove(m_pendingRects);
+    m_pendingRects.clear();
+
+    size_t count = rects.size();
+    if (count == 1) {
+        ++s_emitted[com_sun_webkit_graphics_GraphicsDecoder_FILLRECT_FFFF];
+        m_rq.reserve(20)
+        << (jint)com_sun_webkit_graphics_GraphicsDecoder_FILLRECT_FFFF
+        << rects[0].x() << rects[0].y()
+        << rects[0].width() << rects[0].height();
+    } else if (count > 1) {
+        ++s_emitted[com_sun_webkit_graphics_GraphicsDecoder_FILLRECTS_FFFF];
+        elide(com_sun_webkit_graphics_GraphicsDecoder_FILLRECT_FFFF, count);
+        m_rq.reserve(8 + 16 * count)
+        << (jint)com_sun_webkit_graphics_GraphicsDecoder_FILLRECTS_FFFF
+        << (jint)count;
+        for (const auto& rect : rects) {
+            m_rq << rect.x() << rect.y() << rect.width() << rect.height();
+        }
+    }
+}
+
+void RQEncoder::commit()
+{
+    if (!hasPendingCommands()) {
+        return;
+    }
+
+    // Rectangles are never batched while a save is pending, so they go first.
+    commitRects();
+
+    unsigned saves = m_pendingSaves;
+    m_pendingSaves = 0;
+    if (!saves) {
+        return;
+    }
+    s_emitted[com_sun_webkit_graphics_GraphicsDecoder_SAVESTATE] += saves;
+    m_rq.reserve(4 * saves);
+    while (saves--) {
+        m_rq << (jint)com_sun_webkit_graphics_GraphicsDecoder_SAVESTATE;
+    }
+}
+
+void RQEncoder::save()
+{
+    m_stateStack.append(m_state);
+    ++m_pendingSaves;
+}
+
+void RQEncoder::restore()
+{
+    if (m_stateStack.isEmpty()) {
+        // Unbalanced restore: nothing is known about the java state anymore.
+        m_state = State();
+        emit(com_sun_webkit_graphics_GraphicsDecoder_RESTORESTATE, 4);
+        return;
+    }
+
+    m_state = m_stateStack.takeLast();
+    if (m_pendingSaves) {
+        // Nothing was drawn or changed since the matching save.
+        --m_pendingSaves;
+        elide(com_sun_webkit_graphics_GraphicsDecoder_SAVESTATE);
+        elide(com_sun_webkit_graphics_GraphicsDecoder_RESTORESTATE);
+        return;
+    }
+    emit(com_sun_webkit_graphics_GraphicsDecoder_RESTORESTATE, 4);
+}
+
+void RQEncoder::beginTransparencyLayer(float opacity)
+{
+    // The java context saves its state when a layer starts.
+    emit(com_sun_webkit_graphics_GraphicsDecoder_BEGINTRANSPARENCYLAYER, 8)
+    << opacity;
+    m_stateStack.append(m_state);
+}
+
+void RQEncoder::endTransparencyLayer()
+{
+    emit(com_sun_webkit_graphics_GraphicsDecoder_ENDTRANSPARENCYLAYER, 4);
+    m_state = m_stateStack.isEmpty() ? State() : m_stateStack.takeLast();
+}
+
+void RQEncoder::setFillColor(const Color& color)
+{
+    if (m_state.fillColor == color) {
+        elide(com_sun_webkit_graphics_GraphicsDecoder_SETFILLCOLOR);
+        return;
+    }
+    m_state.fillColor = color;
+
+    auto c = color.toSRGBALossy<float>();
+    emit(com_sun_webkit_graphics_GraphicsDecoder_SETFILLCOLOR, 20)
+    << c.red << c.green << c.blue << c.alpha;
+}
+
+void RQEncoder::setStrokeColor(const Color& color)
+{
+    if (m_state.strokeColor == color) {
+        elide(com_sun_webkit_graphics_GraphicsDecoder_SETSTROKECOLOR);
+        return;
+    }
+    m_state.strokeColor = color;
+
+    auto c = color.toSRGBALossy<float>();
+    emit(com_sun_webkit_graphics_GraphicsDecoder_SETSTROKECOLOR, 20)
+    << c.red << c.green << c.blue << c.alpha;
+}
+
+void RQEncoder::setStrokeStyle(StrokeStyle style)
+{
+    if (m_state.strokeStyle == (jint)style) {
+        elide(com_sun_webkit_graphics_GraphicsDecoder_SETSTROKESTYLE);
+        return;
+    }
+    m_state.strokeStyle = (jint)style;
+
+    emit(com_sun_webkit_graphics_GraphicsDecoder_SETSTROKESTYLE, 8)
+    << (jint)style;
+}
+
+void RQEncoder::setStrokeWidth(float width)
+{
+    if (m_state.strokeWidth == width) {
+        elide(com_sun_webkit_graphics_GraphicsDecoder_SETSTROKEWIDTH);
+        return;
+    }
+    m_state.strokeWidth = width;
+
+    emit(com_sun_webkit_graphics_GraphicsDecoder_SETSTROKEWIDTH, 8)
+    << width;
+}
+
+void RQEncoder::setAlpha(float alpha)
+{
+    if (m_state.alpha == alpha) {
+        elide(com_sun_webkit_graphics_GraphicsDecoder_SETALPHA);
+        return;
+    }
+    m_state.alpha = alpha;
+
+    emit(com_sun_webkit_graphics_GraphicsDecoder_SETALPHA, 8)
+    << alpha;
+}
+
+void RQEncoder::setCompositeOperation(CompositeOperator op)
+{
+    if (m_state.compositeOperation == (jint)op) {
+        elide(com_sun_webkit_graphics_GraphicsDecoder_SETCOMPOSITE);
+        return;
+    }
+    m_state.compositeOperation = (jint)op;
+
+    emit(com_sun_webkit_graphics_GraphicsDecoder_SETCOMPOSITE, 8)
+    << (jint)op;
+}
+
+void RQEncoder::setLineCap(LineCap cap)
+{
+    if (m_state.lineCap == (jint)cap) {
+        elide(com_sun_webkit_graphics_GraphicsDecoder_SET_LINE_CAP);
+        return;
+    }
+    m_state.lineCap = (jint)cap;
+
+    emit(com_sun_webkit_graphics_GraphicsDecoder_SET_LINE_CAP, 8)
+    << (jint)cap;
+}
+
+void RQEncoder::setLineJoin(LineJoin join)
+{
+    if (m_state.lineJoin == (jint)join) {
+        elide(com_sun_webkit_graphics_GraphicsDecoder_SET_LINE_JOIN);
+        return;
+    }
+    m_state.lineJoin = (jint)join;
+
+    emit(com_sun_webkit_graphics_GraphicsDecoder_SET_LINE_JOIN, 8)
+    << (jint)join;
+}
+
+void RQEncoder::setMiterLimit(float limit)
+{
+    if (m_state.miterLimit == limit) {
+        elide(com_sun_webkit_graphics_GraphicsDecoder_SET_MITER_LIMIT);
+        return;
+    }
+    m_state.miterLimit = limit;
+
+    emit(com_sun_webkit_graphics_GraphicsDecoder_SET_MITER_LIMIT, 8)
+    << (jfloat)limit;
+}
+
+void RQEncoder::setTextMode(bool fill, bool stroke)
+{
+    jint mode = (fill ? 1 : 0) | (stroke ? 2 : 0);
+    if (m_state.textMode == mode) {
+        elide(com_sun_webkit_graphics_GraphicsDecoder_SET_TEXT_MODE);
+        return;
+    }
+    m_state.textMode = mode;
+
+    emit(com_sun_webkit_graphics_GraphicsDecoder_SET_TEXT_MODE, 16)
+    << (jint)fill
+    << (jint)stroke
+    << (jint)0;
+}
+
+void RQEncoder::setShadow(float width, float height, float blur, const Color& color)
+{
+    Shadow shadow { width, height, blur, color };
+    if (m_state.shadow == shadow) {
+        elide(com_sun_webkit_graphics_GraphicsDecoder_SETSHADOW);
+        return;
+    }
+    m_state.shadow = shadow;
+
+    auto c = color.toSRGBALossy<float>();
+    emit(com_sun_webkit_graphics_GraphicsDecoder_SETSHADOW, 32)
+    << width << height << blur << c.red << c.green << c.blue << c.alpha;
+}
+
+void RQEncoder::fillRect(const FloatRect& rect)
+{
+    if (m_pendingSaves) {
+        commit();
+    }
+    if (m_pendingRects.size() == MAX_BATCHED_RECTS) {
+        commitRects();
+    }
+    m_pendingRects.append(rect);
+}
+
+} // namespace WebCore
+
+JNIEXPORT void JNICALL Java_com_sun_webkit_graphics_WCRenderQueue_twkGetEncoderHistogram
+    (JNIEnv* env, jclass, jintArray emitted, jintArray elided)
+{
+    using namespace WebCore;
+
+    jint e[RQEncoder::MAX_OPCODE];
+    jint d[RQEncoder::MAX_OPCODE];
+    RQEncoder::getHistogram(e, d, RQEncoder::MAX_OPCODE);
+
+    jint size = std::min(env->GetArrayLength(emitted), env->GetArrayLength(elided));
+    size = std::min(size, static_cast<jint>(RQEncoder::MAX_OPCODE));
+    env->SetIntArrayRegion(emitted, 0, size, e);
+    env->SetIntArrayRegion(elided, 0, size, d);
+}
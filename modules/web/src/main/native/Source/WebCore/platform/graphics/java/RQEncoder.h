@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#pragma once
+
+#include <jni.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Optional.h>
+#include <wtf/Vector.h>
+
+#include "Color.h"
+#include "FloatRect.h"
+#include "GraphicsContext.h"
+
+#include "com_sun_webkit_graphics_WCRenderQueue.h"
+
+namespace WebCore {
+
+class RenderingQueue;
+
+/*
+ * State-tracking front end of a RenderingQueue (RQ).
+ *
+ * The encoder mirrors the state of the java graphics context the RQ is
+ * decoded into (including its save/restore stack), so that:
+ *  - state operations that do not change anything are dropped,
+ *  - a SAVESTATE immediately followed by its RESTORESTATE is dropped,
+ *  - consecutive FILLRECT_FFFF operations are merged into FILLRECTS_FFFF.
+ *
+ * Saves and rectangles are kept pending until the next operation is written
+ * to the RQ. The RQ commits them from [freeSpace] and [flushBuffer], so any
+ * code writing to the RQ directly keeps the original order of operations.
+ */
+class RQEncoder {
+    WTF_MAKE_NONCOPYABLE(RQEncoder);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    static const int MAX_OPCODE = com_sun_webkit_graphics_WCRenderQueue_MAX_OPCODE;
+    // Upper bound of rectangles merged into one FILLRECTS_FFFF.
+    static const int MAX_BATCHED_RECTS = 64;
+
+    explicit RQEncoder(RenderingQueue& rq)
+        : m_rq(rq)
+    {}
+
+    void save();
+    void restore();
+    void beginTransparencyLayer(float opacity);
+    void endTransparencyLayer();
+
+    void setFillColor(const Color&);
+    void setStrokeColor(const Color&);
+    void setStrokeStyle(StrokeStyle);
+    void setStrokeWidth(float);
+    void setAlpha(float);
+    void setCompositeOperation(CompositeOperator);
+    void setLineCap(LineCap);
+    void setLineJoin(LineJoin);
+    void setMiterLimit(float);
+    void setTextMode(bool fill, bool stroke);
+    void setShadow(float width, float height, float blur, const Color&);
+
+    // Fills with the current paint of the java context.
+    void fillRect(const FloatRect&);
+
+    // The fill/stroke paint was replaced by a gradient written directly to the RQ.
+    void invalidateFillPaint() { m_state.fillColor = WTF::nullopt; }
+    void invalidateStrokePaint() { m_state.strokeColor = WTF::nullopt; }
+
+    bool hasPendingCommands() const { return m_pendingSaves || !m_pendingRects.isEmpty(); }
+    void commit();
+
+    // Process-wide counts of written and dropped (or merged) operations.
+    static void getHistogram(jint* emitted, jint* elided, int size);
+
+private:
+    struct Shadow {
+        float width;
+        float height;
+        float blur;
+        Color color;
+
+        bool operator==(const Shadow& other) const
+        {
+            return width == other.width && height == other.height
+                && blur == other.blur && color == other.color;
+        }
+    };
+
+    struct State {
+        Optional<Color> fillColor;
+        Optional<Color> strokeColor;
+        Optional<jint> strokeStyle;
+        Optional<float> strokeWidth;
+        Optional<float> alpha;
+        Optional<jint> compositeOperation;
+        Optional<jint> lineCap;
+        Optional<jint> lineJoin;
+        Optional<float> miterLimit;
+        Optional<jint> textMode;
+        Optional<Shadow> shadow;
+    };
+
+    RenderingQueue& emit(jint opcode, int size);
+    void elide(jint opcode, unsigned count = 1);
+    void commitRects();
+
+    RenderingQueue& m_rq;
+    State m_state;
+    Vector<State> m_stateStack;
+    unsigned m_pendingSaves { 0 };
+    Vector<FloatRect, MAX_BATCHED_RECTS> m_pendingRects;
+};
+
+} // namespace WebCore
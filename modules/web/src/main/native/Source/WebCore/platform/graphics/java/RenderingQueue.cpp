@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011, 2019, Oracle and/or its affiliates. All rights reserved.
+ * Copyright (c) 2011, 2020, Oracle and/or its affiliates. All rights reserved.
  * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
  *
  * This code is free software; you can redistribute it and/or modify it
@@ -45,6 +45,35 @@ static Addr2ByteBuffer& getAddr2ByteBuffer()
     return container.get();
 }
 
+RefPtr<ByteBuffer> ByteBufferPool::acquire()
+{
+    if (!m_freeList.isEmpty()) {
+        ++m_hitCount;
+        RQ_LOG_HIT()
+        return m_freeList.takeLast();
+    }
+    ++m_missCount;
+    RQ_LOG_MISS()
+    return ByteBuffer::create(m_bufferCapacity, this);
+}
+
+void ByteBufferPool::recycle(ByteBuffer& buffer)
+{
+    ASSERT(buffer.pool() == this);
+    // Referenced resources are released right here, on the Event thread.
+    buffer.reset();
+    if (!m_detached && m_freeList.size() < m_maxSize) {
+        m_freeList.append(&buffer);
+    }
+}
+
+void ByteBufferPool::detach()
+{
+    // Breaks the pool <-> free buffer reference cycle.
+    m_detached = true;
+    m_freeList.clear();
+}
+
 /*static*/
 RefPtr<RenderingQueue> RenderingQueue::create(
     const JLObject &jRQ,
@@ -57,15 +86,29 @@ RefPtr<RenderingQueue> RenderingQueue::create(
         autoFlush));
 }
 
+RenderingQueue::~RenderingQueue() {
+    m_pool->detach();
+    disposeGraphics();
+}
+
 RenderingQueue& RenderingQueue::freeSpace(int size) {
+    // Whoever writes to the queue directly comes after the pending operations.
+    m_encoder->commit();
+    return reserve(size);
+}
+
+RenderingQueue& RenderingQueue::reserve(int size) {
     if (m_buffer && !m_buffer->hasFreeSpace(size)) {
-        flushBuffer();
+        sendBuffer();
         if (m_autoFlush) {
             flush();
         }
     }
     if (!m_buffer) {
-        m_buffer = RefPtr<ByteBuffer>(ByteBuffer::create(std::max(m_capacity, size)));
+        // Oversized buffers are rare and are not worth keeping around.
+        m_buffer = (size <= m_capacity)
+            ? m_pool->acquire()
+            : ByteBuffer::create(size);
     }
     return *this;
 }
@@ -96,17 +139,22 @@ void RenderingQueue::disposeGraphics() {
     WTF::CheckAndClearException(env);
 }
 
+RenderingQueue& RenderingQueue::flushBuffer() {
+    m_encoder->commit();
+    return sendBuffer();
+}
+
 /*
  * The method is called on Event thread (so, it's not concurrent with JS and the release of resources).
  */
-RenderingQueue& RenderingQueue::flushBuffer() {
-    if (isEmpty()) {
+RenderingQueue& RenderingQueue::sendBuffer() {
+    if (!m_buffer || m_buffer->isEmpty()) {
         return *this;
     }
     JNIEnv* env = WTF::GetJavaEnv();
 
     static jmethodID midFwkAddBuffer = env->GetMethodID(PG_GetRenderQueueClass(env),
-        "fwkAddBuffer", "(Ljava/nio/ByteBuffer;)V");
+        "fwkAddBuffer", "(Ljava/nio/ByteBuffer;I)V");
     ASSERT(midFwkAddBuffer);
 
     Addr2ByteBuffer &a2bb = getAddr2ByteBuffer();
@@ -114,7 +162,8 @@ RenderingQueue& RenderingQueue::flushBuffer() {
     env->CallVoidMethod(
         getWCRenderingQueue(),
         midFwkAddBuffer,
-        (jobject)(m_buffer->createDirectByteBuffer(env)));
+        (jobject)(m_buffer->createDirectByteBuffer(env)),
+        (jint)m_buffer->position());
     WTF::CheckAndClearException(env);
 
     m_buffer = nullptr;
@@ -139,7 +188,10 @@ JNIEXPORT void JNICALL Java_com_sun_webkit_graphics_WCRenderQueue_twkRelease
         char *key = (char *)env->GetDirectBufferAddress(
             JLObject(env->GetObjectArrayElement(bufs, i)));
         if (key != 0) {
-            a2bb.remove(key);
+            RefPtr<ByteBuffer> buffer = a2bb.take(key);
+            if (buffer && buffer->pool()) {
+                buffer->pool()->recycle(*buffer);
+            }
         }
     }
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011, 2017, Oracle and/or its affiliates. All rights reserved.
+ * Copyright (c) 2011, 2020, Oracle and/or its affiliates. All rights reserved.
  * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
  *
  * This code is free software; you can redistribute it and/or modify it
@@ -31,24 +31,30 @@
 #include <wtf/HashSet.h>
 #include <wtf/java/DbgUtils.h>
 
+#include "RQEncoder.h"
 #include "RQRef.h"
 
 namespace WebCore {
 
 class RQRef;
+class ByteBufferPool;
 
 class ByteBuffer : public RefCounted<ByteBuffer> {
     RQ_LOG_INSTANCE_COUNT(ByteBuffer)
 public:
-    static RefPtr<ByteBuffer> create(int capacity) {
-        return adoptRef(new ByteBuffer(capacity));
+    static RefPtr<ByteBuffer> create(int capacity, ByteBufferPool* pool = nullptr) {
+        return adoptRef(new ByteBuffer(capacity, pool));
     }
 
+    // The NIO wrapper spans the whole native memory and is created once per
+    // ByteBuffer. The java side gets the actual data length with the buffer
+    // (see WCRenderQueue.fwkAddBuffer) and resets position/limit accordingly.
     JLObject createDirectByteBuffer(JNIEnv* env) {
         ASSERT(!isEmpty());
-        JLObject ret(env->NewDirectByteBuffer(m_buffer, m_position));
-        m_nio_holder = ret;
-        return ret;
+        if (!(jobject)m_nio_holder) {
+            m_nio_holder = JLObject(env->NewDirectByteBuffer(m_buffer, m_capacity));
+        }
+        return JLObject(m_nio_holder);
     }
 
     char* bufferAddress() { return m_buffer; }
@@ -76,15 +82,28 @@ public:
 
     bool isEmpty() { return m_position == 0; }
 
+    int capacity() { return m_capacity; }
+    int position() { return m_position; }
+
+    ByteBufferPool* pool() { return m_pool.get(); }
+
+    // Drops the referenced resources and rewinds the buffer, so that the
+    // native memory and the NIO wrapper can be handed out again.
+    void reset() {
+        m_refList.clear();
+        m_position = 0;
+    }
+
     ~ByteBuffer() {
         delete[] m_buffer;
     }
 
 private:
-    ByteBuffer(int capacity) :
+    ByteBuffer(int capacity, ByteBufferPool* pool) :
         m_buffer(new char[capacity]),
         m_capacity(capacity),
-        m_position(0)
+        m_position(0),
+        m_pool(pool)
     {}
 
     char* m_buffer;
@@ -92,6 +111,50 @@ private:
     int m_position;
     JGObject m_nio_holder;
     Vector< RefPtr<RQRef> > m_refList;
+    RefPtr<ByteBufferPool> m_pool;
+};
+
+/*
+ * A bounded free list of ByteBuffers of the same capacity owned by
+ * a RenderingQueue. Buffers handed to java come back through
+ * [WCRenderQueue.twkRelease] and are recycled instead of being deleted,
+ * so a busy queue (e.g. html5 canvas) reuses both the native memory and
+ * the NIO wrapper.
+ *
+ * The pool outlives its RenderingQueue while java still holds any of its
+ * buffers; after [detach] returned buffers are simply dropped.
+ */
+class ByteBufferPool : public RefCounted<ByteBufferPool> {
+    RQ_LOG_INSTANCE_COUNT(ByteBufferPool)
+    RQ_LOG_HIT_RATIO(ByteBufferPool)
+public:
+    static RefPtr<ByteBufferPool> create(int bufferCapacity, size_t maxSize) {
+        return adoptRef(new ByteBufferPool(bufferCapacity, maxSize));
+    }
+
+    RefPtr<ByteBuffer> acquire();
+    void recycle(ByteBuffer& buffer);
+    void detach();
+
+    size_t hitCount() { return m_hitCount; }
+    size_t missCount() { return m_missCount; }
+    size_t size() { return m_freeList.size(); }
+
+private:
+    ByteBufferPool(int bufferCapacity, size_t maxSize) :
+        m_bufferCapacity(bufferCapacity),
+        m_maxSize(maxSize),
+        m_detached(false),
+        m_hitCount(0),
+        m_missCount(0)
+    {}
+
+    int m_bufferCapacity;
+    size_t m_maxSize;
+    bool m_detached;
+    size_t m_hitCount;
+    size_t m_missCount;
+    Vector< RefPtr<ByteBuffer> > m_freeList;
 };
 
 /*
@@ -135,7 +198,12 @@ public:
     RenderingQueue& flushBuffer();
 
     bool isEmpty() {
-        return m_buffer == nullptr || m_buffer->isEmpty();
+        return (m_buffer == nullptr || m_buffer->isEmpty())
+            && !m_encoder->hasPendingCommands();
+    }
+
+    RQEncoder& encoder() {
+        return *m_encoder;
     }
 
     JLObject getWCRenderingQueue() {
@@ -148,18 +216,25 @@ public:
         return m_rqoRenderingQueue;
     }
 
-    ~RenderingQueue() {
-        disposeGraphics();
-    }
+    ~RenderingQueue();
 
 private:
+    friend class RQEncoder;
+
     RenderingQueue(const JLObject& jRQ, int capacity, bool autoFlush) :
         m_rqoRenderingQueue(RQRef::create(jRQ)),
         m_capacity(capacity),
         m_autoFlush(autoFlush),
-        m_buffer(nullptr)
+        m_buffer(nullptr),
+        m_pool(ByteBufferPool::create(capacity, MAX_BUFFER_COUNT)),
+        m_encoder(makeUnique<RQEncoder>(*this))
     {}
 
+    // Same as [freeSpace] and [flushBuffer], but without committing
+    // the operations pending in [m_encoder].
+    RenderingQueue& reserve(int size);
+    RenderingQueue& sendBuffer();
+
     void flush();
     void disposeGraphics();
 
@@ -170,6 +245,8 @@ private:
     int m_capacity;
     bool m_autoFlush;
     RefPtr<ByteBuffer> m_buffer; // ref to the current ByteBuffer
+    RefPtr<ByteBufferPool> m_pool; // recycled buffers of [m_capacity] size
+    std::unique_ptr<RQEncoder> m_encoder;
 
 };
 } // namespace WebCore
@@ -77,6 +77,9 @@ void GraphicsLayerTextureMapper::setNeedsDisplay()
 
 void GraphicsLayerTextureMapper::setContentsNeedsDisplay()
 {
+#if PLATFORM(JAVA)
+    m_layer.addContentsDamage(contentsRect());
+#endif
     notifyChange(DisplayChange);
     addRepaintRect(contentsRect());
 }
@@ -399,8 +402,19 @@ void GraphicsLayerTextureMapper::commitLayerChanges()
         for (auto& layer : children())
             rawChildren.uncheckedAppend(layer.ptr());
         m_layer.setChildren(rawChildren);
+#if PLATFORM(JAVA)
+        // The children may be in a different order.
+        for (auto& layer : children())
+            downcast<GraphicsLayerTextureMapper>(layer.get()).layer().setNeedsDamage();
+#endif
     }
 
+#if PLATFORM(JAVA)
+    // The repaints of the contents are tracked by updateBackingStoreIfNeeded().
+    if (m_changeMask & ~(ChildrenChange | DisplayChange | ContentsDisplayChange | AnimationStarted))
+        m_layer.setNeedsDamage();
+#endif
+
     if (m_changeMask & MaskLayerChange)
         m_layer.setMaskLayer(&downcast<GraphicsLayerTextureMapper>(maskLayer())->layer());
 
@@ -521,6 +535,9 @@ void GraphicsLayerTextureMapper::updateBackingStoreIfNeeded()
     if (dirtyRect.isEmpty())
         return;
 
+#if PLATFORM(JAVA)
+    m_layer.addContentsDamage(dirtyRect);
+#endif
     m_backingStore->updateContentsScale(pageScaleFactor() * deviceScaleFactor());
 
     dirtyRect.scale(pageScaleFactor() * deviceScaleFactor());
@@ -45,6 +45,9 @@ TextureMapperLayer::TextureMapperLayer() = default;
 
 TextureMapperLayer::~TextureMapperLayer()
 {
+#if PLATFORM(JAVA)
+    addRemovedDamage();
+#endif
     for (auto* child : m_children)
         child->m_parent = nullptr;
 
@@ -508,6 +511,9 @@ void TextureMapperLayer::addChild(TextureMapperLayer* childLayer)
 
 void TextureMapperLayer::removeFromParent()
 {
+#if PLATFORM(JAVA)
+    addRemovedDamage();
+#endif
     if (m_parent) {
         size_t index = m_parent->m_children.find(this);
         ASSERT(index != notFound);
@@ -520,8 +526,12 @@ void TextureMapperLayer::removeFromParent()
 void TextureMapperLayer::removeAllChildren()
 {
     auto oldChildren = WTFMove(m_children);
-    for (auto* child : oldChildren)
+    for (auto* child : oldChildren) {
+#if PLATFORM(JAVA)
+        child->addRemovedDamage();
+#endif
         child->m_parent = nullptr;
+    }
 }
 
 void TextureMapperLayer::setMaskLayer(TextureMapperLayer* maskLayer)
@@ -730,4 +740,106 @@ bool TextureMapperLayer::syncAnimations(MonotonicTime time)
     return applicationResults.hasRunningAnimations;
 }
 
+#if PLATFORM(JAVA)
+void TextureMapperLayer::computeDamage(Region& damage)
+{
+    computeTransformsRecursive();
+
+    damage.unite(m_removedDamage);
+    m_removedDamage = IntRect();
+    collectDamage(damage, false);
+}
+
+void TextureMapperLayer::collectDamage(Region& damage, bool ancestorChanged)
+{
+    IntRect bounds;
+    if (m_state.visible && !m_state.size.isEmpty()) {
+        FloatRect rect = layerRect();
+        if (m_contentsLayer || m_state.solidColor.isVisible())
+            rect.unite(m_state.contentsRect);
+        bounds = enclosingIntRect(m_layerTransforms.combined.mapRect(rect));
+        if (hasFilters()) {
+            IntOutsets outsets = m_currentFilters.outsets();
+            bounds.move(-outsets.left(), -outsets.top());
+            bounds.expand(outsets.left() + outsets.right(), outsets.top() + outsets.bottom());
+        }
+    }
+
+    // The platform layers update their contents without notice.
+    bool changed = ancestorChanged || m_hasDamage || m_contentsLayer
+        || m_animations.hasRunningAnimations() || bounds != m_damageBounds;
+
+    // The replica paints the layer and its descendants a second time, so
+    // their damage is collected apart to be added at both places.
+    Region subtreeDamage;
+    Region& layerDamage = m_state.replicaLayer ? subtreeDamage : damage;
+
+    if (changed) {
+        layerDamage.unite(m_damageBounds);
+        layerDamage.unite(bounds);
+    } else if (!m_contentsDamage.isEmpty())
+        layerDamage.unite(intersection(enclosingIntRect(m_layerTransforms.combined.mapRect(m_contentsDamage)), bounds));
+
+    m_damageBounds = bounds;
+    m_contentsDamage = FloatRect();
+    m_hasDamage = false;
+
+    if (m_state.maskLayer)
+        m_state.maskLayer->collectDamage(layerDamage, changed);
+    if (m_state.backdropLayer)
+        m_state.backdropLayer->collectDamage(layerDamage, changed);
+    for (auto* child : m_children)
+        child->collectDamage(layerDamage, changed);
+
+    if (m_state.replicaLayer) {
+        m_state.replicaLayer->collectDamage(damage, changed);
+        collectReplicaDamage(damage, subtreeDamage);
+        damage.unite(subtreeDamage);
+    } else if (!m_replicaDamageBounds.isEmpty()) {
+        // The reflection was removed.
+        damage.unite(m_replicaDamageBounds);
+        m_replicaDamageBounds = IntRect();
+    }
+}
+
+void TextureMapperLayer::collectReplicaDamage(Region& damage, const Region& subtreeDamage)
+{
+    IntRect subtreeBounds = m_damageBounds;
+    for (auto* child : m_children)
+        subtreeBounds.unite(child->damageBoundsRecursive());
+
+    TransformationMatrix transform = replicaTransform();
+    IntRect bounds = enclosingIntRect(transform.mapRect(FloatRect(subtreeBounds)));
+    if (transform != m_replicaDamageTransform) {
+        // The reflection moved as a whole.
+        damage.unite(m_replicaDamageBounds);
+        damage.unite(bounds);
+    } else {
+        for (auto& rect : subtreeDamage.rects())
+            damage.unite(enclosingIntRect(transform.mapRect(FloatRect(rect))));
+    }
+
+    m_replicaDamageTransform = transform;
+    m_replicaDamageBounds = bounds;
+}
+
+IntRect TextureMapperLayer::damageBoundsRecursive() const
+{
+    IntRect bounds = m_damageBounds;
+    bounds.unite(m_replicaDamageBounds);
+    if (m_state.replicaLayer)
+        bounds.unite(m_state.replicaLayer->damageBoundsRecursive());
+    for (auto* child : m_children)
+        bounds.unite(child->damageBoundsRecursive());
+    return bounds;
+}
+
+// What the layer and its descendants covered has to be composited again.
+void TextureMapperLayer::addRemovedDamage()
+{
+    if (m_parent)
+        rootLayer().m_removedDamage.unite(damageBoundsRecursive());
+}
+#endif
+
 }
@@ -107,6 +107,16 @@ public:
 
     void addChild(TextureMapperLayer*);
 
+#if PLATFORM(JAVA)
+    // The layer is composited differently, or its contents (in layer
+    // coordinates) were repainted.
+    void setNeedsDamage() { m_hasDamage = true; }
+    void addContentsDamage(const FloatRect& rect) { m_contentsDamage.unite(rect); }
+    // Called on the root layer once the animations are applied: adds the
+    // areas of the layer tree that changed since the previous call.
+    void computeDamage(Region&);
+#endif
+
 private:
     TextureMapperLayer& rootLayer() const
     {
@@ -149,6 +159,13 @@ private:
 
     bool shouldBlend() const;
 
+#if PLATFORM(JAVA)
+    void collectDamage(Region&, bool ancestorChanged);
+    void collectReplicaDamage(Region&, const Region& subtreeDamage);
+    IntRect damageBoundsRecursive() const;
+    void addRemovedDamage();
+#endif
+
     inline FloatRect layerRect() const
     {
         return FloatRect(FloatPoint::zero(), m_state.size);
@@ -223,6 +240,18 @@ private:
     bool m_isBackdrop { false };
     bool m_isReplica { false };
 
+#if PLATFORM(JAVA)
+    // Bounds in root coordinates at the last computeDamage()
+    IntRect m_damageBounds;
+    FloatRect m_contentsDamage;
+    bool m_hasDamage { true };
+    // On the root layer, the bounds of the layers removed from the tree
+    IntRect m_removedDamage;
+    // The layer and its descendants as last painted by the replica
+    TransformationMatrix m_replicaDamageTransform;
+    IntRect m_replicaDamageBounds;
+#endif
+
     struct {
         TransformationMatrix localTransform;
         TransformationMatrix combined;
@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "config.h"
+
+#include "BytecodeCacheJava.h"
+
+#include <wtf/FileSystem.h>
+#include <wtf/SHA1.h>
+#include <wtf/Scope.h>
+#include <wtf/java/JavaEnv.h>
+#include <wtf/text/StringConcatenate.h>
+
+#if OS(LINUX)
+#include <algorithm>
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace WebCore {
+
+static const char cacheFileExtension[] = ".bytecode-cache";
+
+BytecodeCacheJava& BytecodeCacheJava::singleton()
+{
+    static NeverDestroyed<BytecodeCacheJava> cache;
+    return cache;
+}
+
+bool BytecodeCacheJava::isSupported()
+{
+#if OS(LINUX)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void BytecodeCacheJava::setDirectory(const String& directory, uint64_t maximumSize)
+{
+    auto locker = holdLock(m_lock);
+    m_maximumSize = maximumSize;
+    if (!isSupported() || directory.isEmpty() || !FileSystem::makeAllDirectories(directory)) {
+        m_directory = String();
+        return;
+    }
+    m_directory = directory.isolatedCopy();
+    computeDirectorySize();
+    evictIfNeeded();
+}
+
+bool BytecodeCacheJava::isEnabled()
+{
+    auto locker = holdLock(m_lock);
+    return !m_directory.isNull();
+}
+
+String BytecodeCacheJava::pathForScript(const URL& url, unsigned sourceHash, unsigned sourceLength) const
+{
+    // JSC checks the whole source when decoding, the hash and length only
+    // keep the entries of the different versions of a script apart.
+    SHA1 sha1;
+    sha1.addBytes(url.string().utf8());
+    sha1.addBytes(reinterpret_cast<const uint8_t*>(&sourceHash), sizeof(sourceHash));
+    sha1.addBytes(reinterpret_cast<const uint8_t*>(&sourceLength), sizeof(sourceLength));
+    return FileSystem::pathByAppendingComponent(m_directory,
+        makeString(sha1.computeHexDigest().data(), cacheFileExtension));
+}
+
+#if OS(LINUX)
+
+static bool writeAt(FileSystem::PlatformFileHandle handle, long long offset, const void* data, size_t size)
+{
+    if (FileSystem::seekFile(handle, offset, FileSystem::FileSeekOrigin::Beginning) != offset)
+        return false;
+    const char* bytes = static_cast<const char*>(data);
+    while (size) {
+        int bytesWritten = FileSystem::writeToFile(handle, bytes, static_cast<int>(std::min<size_t>(size, INT_MAX)));
+        if (bytesWritten <= 0)
+            return false;
+        bytes += bytesWritten;
+        size -= bytesWritten;
+    }
+    return true;
+}
+
+// Entries are never modified in place: other providers may have them mapped.
+static bool writeEntry(FileSystem::PlatformFileHandle handle, const JSC::CachedBytecode& bytecode)
+{
+    if (!FileSystem::truncateFile(handle, bytecode.sizeForUpdate()))
+        return false;
+    bool success = !bytecode.size() || writeAt(handle, 0, bytecode.data(), bytecode.size());
+    bytecode.commitUpdates([&] (off_t offset, const void* data, size_t size) {
+        success = success && writeAt(handle, offset, data, size);
+    });
+    return success;
+}
+
+struct CacheFile {
+    CString path;
+    uint64_t size;
+    time_t lastUse;
+};
+
+static Vector<CacheFile> listCacheFiles(const String& directory)
+{
+    Vector<CacheFile> files;
+    CString directoryPath = FileSystem::fileSystemRepresentation(directory);
+    DIR* dir = opendir(directoryPath.data());
+    if (!dir)
+        return files;
+
+    const size_t extensionLength = sizeof(cacheFileExtension) - 1;
+    while (struct dirent* entry = readdir(dir)) {
+        size_t nameLength = strlen(entry->d_name);
+        if (nameLength <= extensionLength || strcmp(entry->d_name + nameLength - extensionLength, cacheFileExtension))
+            continue;
+        CString path = makeString(directoryPath.data(), '/', entry->d_name).utf8();
+        struct stat fileStat;
+        if (stat(path.data(), &fileStat) || !S_ISREG(fileStat.st_mode))
+            continue;
+        files.append({ path, static_cast<uint64_t>(fileStat.st_size), fileStat.st_mtime });
+    }
+    closedir(dir);
+    return files;
+}
+
+void BytecodeCacheJava::computeDirectorySize()
+{
+    m_directorySize = 0;
+    for (const auto& file : listCacheFiles(m_directory))
+        m_directorySize += file.size;
+}
+
+void BytecodeCacheJava::evictIfNeeded()
+{
+    if (m_directorySize <= m_maximumSize)
+        return;
+
+    // Least recently used first: the mtime of an entry is updated on load.
+    auto files = listCacheFiles(m_directory);
+    std::sort(files.begin(), files.end(), [] (const CacheFile& a, const CacheFile& b) {
+        return a.lastUse < b.lastUse;
+    });
+    m_directorySize = 0;
+    for (const auto& file : files)
+        m_directorySize += file.size;
+    for (const auto& file : files) {
+        if (m_directorySize <= m_maximumSize)
+            break;
+        if (!unlink(file.path.data())) {
+            m_directorySize -= file.size;
+            ++m_statistics[Evictions];
+        }
+    }
+}
+
+RefPtr<JSC::CachedBytecode> BytecodeCacheJava::load(const URL& url, unsigned sourceHash, unsigned sourceLength)
+{
+    auto locker = holdLock(m_lock);
+    if (m_directory.isNull())
+        return nullptr;
+
+    auto handle = FileSystem::openFile(pathForScript(url, sourceHash, sourceLength), FileSystem::FileOpenMode::Read);
+    if (!FileSystem::isHandleValid(handle)) {
+        ++m_statistics[Misses];
+        return nullptr;
+    }
+    auto closeHandle = makeScopeExit([&] {
+        FileSystem::closeFile(handle);
+    });
+
+    bool success;
+    FileSystem::MappedFileData mappedFileData(handle, FileSystem::MappedFileMode::Private, success);
+    if (!success || !mappedFileData.size()) {
+        ++m_statistics[Misses];
+        return nullptr;
+    }
+
+    futimens(handle, nullptr);
+    ++m_statistics[Hits];
+    m_statistics[BytesLoaded] += mappedFileData.size();
+    return JSC::CachedBytecode::create(WTFMove(mappedFileData));
+}
+
+void BytecodeCacheJava::didRejectEntry(size_t size)
+{
+    auto locker = holdLock(m_lock);
+    ASSERT(m_statistics[Hits] && m_statistics[BytesLoaded] >= size);
+    --m_statistics[Hits];
+    ++m_statistics[Rejected];
+    m_statistics[BytesLoaded] -= size;
+}
+
+void BytecodeCacheJava::commit(const URL& url, unsigned sourceHash, unsigned sourceLength, const JSC::CachedBytecode& bytecode)
+{
+    auto locker = holdLock(m_lock);
+    if (m_directory.isNull() || bytecode.sizeForUpdate() > m_maximumSize)
+        return;
+
+    // Written aside, then renamed over the previous version of the entry.
+    CString path = FileSystem::fileSystemRepresentation(pathForScript(url, sourceHash, sourceLength));
+    CString temporaryPath = makeString(path.data(), ".XXXXXX").utf8();
+    int handle = mkostemp(temporaryPath.mutableData(), O_CLOEXEC);
+    if (handle == -1)
+        return;
+
+    bool success = writeEntry(handle, bytecode);
+    FileSystem::closeFile(handle);
+
+    struct stat previousStat;
+    uint64_t previousSize = stat(path.data(), &previousStat) ? 0 : previousStat.st_size;
+    if (!success || rename(temporaryPath.data(), path.data())) {
+        unlink(temporaryPath.data());
+        return;
+    }
+
+    m_statistics[BytesWritten] += bytecode.sizeForUpdate();
+    m_directorySize -= std::min(previousSize, m_directorySize);
+    m_directorySize += bytecode.sizeForUpdate();
+    evictIfNeeded();
+}
+
+#else
+
+void BytecodeCacheJava::computeDirectorySize()
+{
+}
+
+void BytecodeCacheJava::evictIfNeeded()
+{
+}
+
+RefPtr<JSC::CachedBytecode> BytecodeCacheJava::load(const URL&, unsigned, unsigned)
+{
+    return nullptr;
+}
+
+void BytecodeCacheJava::didRejectEntry(size_t)
+{
+}
+
+void BytecodeCacheJava::commit(const URL&, unsigned, unsigned, const JSC::CachedBytecode&)
+{
+}
+
+#endif // OS(LINUX)
+
+void BytecodeCacheJava::getStatistics(uint64_t* statistics, int size)
+{
+    auto locker = holdLock(m_lock);
+    size = std::min(size, static_cast<int>(StatisticCount));
+    std::copy(m_statistics, m_statistics + size, statistics);
+}
+
+} // namespace WebCore
+
+extern "C" {
+
+JNIEXPORT void JNICALL Java_com_sun_webkit_WebPage_twkSetBytecodeCache
+    (JNIEnv* env, jclass, jstring directory, jlong maximumSize)
+{
+    using namespace WebCore;
+
+    BytecodeCacheJava::singleton().setDirectory(String(env, directory), static_cast<uint64_t>(maximumSize));
+}
+
+JNIEXPORT void JNICALL Java_com_sun_webkit_WebPage_twkGetBytecodeCacheStatistics
+    (JNIEnv* env, jclass, jlongArray statistics)
+{
+    using namespace WebCore;
+
+    uint64_t values[BytecodeCacheJava::StatisticCount];
+    BytecodeCacheJava::singleton().getStatistics(values, BytecodeCacheJava::StatisticCount);
+
+    jlong v[BytecodeCacheJava::StatisticCount];
+    std::copy(values, values + BytecodeCacheJava::StatisticCount, v);
+    jint size = std::min(env->GetArrayLength(statistics), static_cast<jint>(BytecodeCacheJava::StatisticCount));
+    env->SetLongArrayRegion(statistics, 0, size, v);
+}
+
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#pragma once
+
+#include <JavaScriptCore/CachedBytecode.h>
+#include <wtf/Lock.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/URL.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+
+/*
+ * On-disk store of the bytecode JavaScriptCore generates for page scripts.
+ *
+ * One file per script, named after the script URL, hash and length. The
+ * file is the payload of a JSC::CachedBytecode: it is mapped as is on load,
+ * and JSC itself rejects it when the source, the build or the code flags do
+ * not match anymore (the entry is then rewritten). The total size of the
+ * directory is kept under a cap by removing the least recently used files.
+ *
+ * Disabled until a directory is set. Only supported where FileSystem has
+ * native, mappable file handles (Linux); elsewhere nothing is ever stored.
+ */
+class BytecodeCacheJava {
+    WTF_MAKE_NONCOPYABLE(BytecodeCacheJava);
+public:
+    static constexpr uint64_t defaultMaximumSize = 64 * 1024 * 1024;
+
+    // Indexes of the values returned by [getStatistics].
+    enum Statistic {
+        Hits,          // Scripts whose bytecode was taken from the cache.
+        Misses,        // Scripts with no cache entry.
+        Rejected,      // Entries found but outdated, regenerated.
+        BytesLoaded,   // Bytecode reused instead of being generated.
+        BytesWritten,
+        Evictions,
+        StatisticCount
+    };
+
+    static BytecodeCacheJava& singleton();
+
+    static bool isSupported();
+
+    // A null [directory] disables the cache (the files are kept).
+    void setDirectory(const String& directory, uint64_t maximumSize);
+    bool isEnabled();
+
+    // The entry of a script, or nullptr on a miss.
+    RefPtr<JSC::CachedBytecode> load(const URL&, unsigned sourceHash, unsigned sourceLength);
+    // The bytecode loaded for a script had to be generated again.
+    void didRejectEntry(size_t size);
+    // Writes the pending updates of [bytecode], that was loaded from (or
+    // is about to create) the entry of a script.
+    void commit(const URL&, unsigned sourceHash, unsigned sourceLength, const JSC::CachedBytecode&);
+
+    void getStatistics(uint64_t* statistics, int size);
+
+private:
+    friend class WTF::NeverDestroyed<BytecodeCacheJava>;
+    BytecodeCacheJava() = default;
+
+    String pathForScript(const URL&, unsigned sourceHash, unsigned sourceLength) const;
+    void computeDirectorySize();
+    void evictIfNeeded();
+
+    Lock m_lock;
+    String m_directory;
+    uint64_t m_maximumSize { defaultMaximumSize };
+    // Size of the directory, as known from the last scan and the writes since.
+    uint64_t m_directorySize { 0 };
+    uint64_t m_statistics[StatisticCount] { };
+};
+
+} // namespace WebCore
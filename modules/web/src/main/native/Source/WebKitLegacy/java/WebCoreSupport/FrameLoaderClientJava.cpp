@@ -341,6 +341,14 @@ void FrameLoaderClientJava::transitionToCommittedForNewPage()
         backgroundColor = fv->baseBackgroundColor();
     }
     frame()->createView(IntRect(pageRect).size(), backgroundColor, /* fixedLayoutSize */ { }, /* fixedVisibleContentRect */ { });
+
+    if (frame()->isMainFrame()) {
+        // The tiles of the main frame need the repaints outside of the view
+        WebPage* webPage = WebPage::webPageFromJObject(m_webPage);
+        if (webPage && webPage->tiledBackingStore()) {
+            frame()->view()->setClipsRepaints(false);
+        }
+    }
 }
 
 WTF::Ref<WebCore::DocumentLoader> FrameLoaderClientJava::createDocumentLoader(const WebCore::ResourceRequest& request, const SubstituteData& substituteData)
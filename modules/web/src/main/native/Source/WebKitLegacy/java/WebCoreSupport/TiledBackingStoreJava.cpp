@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "TiledBackingStoreJava.h"
+
+#include <JavaScriptCore/JSLock.h>
+#include <WebCore/CommonVM.h>
+#include <WebCore/Frame.h>
+#include <WebCore/FrameView.h>
+#include <WebCore/GraphicsContext.h>
+#include <WebCore/Page.h>
+#include <WebCore/Region.h>
+#include <wtf/MonotonicTime.h>
+
+namespace WebCore {
+
+namespace {
+
+// Time without painting after which the tiles ahead of the scroll are painted.
+constexpr Seconds prerenderDelay { 50_ms };
+// Time spent painting tiles ahead before letting the events through.
+constexpr Seconds prerenderSlice { 8_ms };
+
+int tileIndex(int coordinate)
+{
+    const int size = TiledBackingStoreJava::TILE_SIZE;
+    return coordinate >= 0 ? coordinate / size : (coordinate - size + 1) / size;
+}
+
+}
+
+TiledBackingStoreJava::TiledBackingStoreJava(size_t maxSize)
+    : m_maxSize(maxSize)
+    , m_prerenderTimer(*this, &TiledBackingStoreJava::prerenderTimerFired)
+{
+}
+
+TiledBackingStoreJava::~TiledBackingStoreJava()
+{
+}
+
+void TiledBackingStoreJava::setMaxSize(size_t maxSize)
+{
+    m_maxSize = maxSize;
+    while (m_tiles.size() * tileSize() > m_maxSize && evictTile()) { }
+}
+
+// The range of the tiles covering rect, as a rect of tile coordinates.
+IntRect TiledBackingStoreJava::tileCoordinates(const IntRect& rect)
+{
+    IntPoint first(tileIndex(rect.x()), tileIndex(rect.y()));
+    IntPoint last(tileIndex(rect.maxX() - 1), tileIndex(rect.maxY() - 1));
+    return IntRect(first, last - first + IntSize(1, 1));
+}
+
+bool TiledBackingStoreJava::canUseTiles(const FrameView& frameView)
+{
+    // The fixed position objects move over the contents when scrolling.
+    return !frameView.hasViewportConstrainedObjects();
+}
+
+size_t TiledBackingStoreJava::tileSize() const
+{
+    size_t side = (size_t)ceilf(TILE_SIZE * m_scale);
+    return side * side * 4;
+}
+
+bool TiledBackingStoreJava::paint(GraphicsContext& context, FrameView& frameView, const IntRect& rect)
+{
+    if (!canUseTiles(frameView)) {
+        clear();
+        return false;
+    }
+
+    float scale = frameView.frame().page() ? frameView.frame().page()->deviceScaleFactor() : 1;
+    if (m_frameView.get() != &frameView || m_scale != scale) {
+        clear();
+        m_frameView = makeWeakPtr<Widget>(frameView);
+        m_scale = scale;
+        m_lastScrollPosition = frameView.scrollPosition();
+    }
+
+    IntPoint scrollPosition = frameView.scrollPosition();
+    if (scrollPosition != m_lastScrollPosition) {
+        IntSize delta = scrollPosition - m_lastScrollPosition;
+        m_scrollDirection = IntSize(
+            (delta.width() > 0) - (delta.width() < 0),
+            (delta.height() > 0) - (delta.height() < 0));
+        m_lastScrollPosition = scrollPosition;
+    }
+
+    IntRect visibleRect = frameView.visibleContentRect();
+    IntRect dirtyRect = intersection(frameView.rootViewToContents(rect), visibleRect);
+    ++m_useCounter;
+
+    if (!dirtyRect.isEmpty()) {
+        IntRect coordinates = tileCoordinates(dirtyRect);
+        Vector<Tile*> tiles;
+        for (int y = coordinates.y(); y < coordinates.maxY(); ++y) {
+            for (int x = coordinates.x(); x < coordinates.maxX(); ++x) {
+                Tile* tile = ensureTile(IntPoint(x, y), true);
+                if (!tile) {
+                    clear();
+                    return false;
+                }
+                tile->lastUse = m_useCounter;
+                tiles.append(tile);
+            }
+        }
+
+        for (auto* tile : tiles) {
+            IntRect part = intersection(tile->rect, dirtyRect);
+            if (tile->dirtyRect.intersects(part)) {
+                paintTile(frameView, *tile);
+                ++m_statistics[Misses];
+            } else {
+                ++m_statistics[Hits];
+            }
+
+            FloatRect srcRect(part);
+            srcRect.moveBy(-tile->rect.location());
+            srcRect.scale(m_scale);
+            context.drawImageBuffer(*tile->buffer, frameView.contentsToRootView(part), srcRect);
+        }
+    }
+
+    // The scrollbars and the scroll corner
+    Region outside(rect);
+    outside.subtract(frameView.contentsToRootView(visibleRect));
+    for (auto& part : outside.rects()) {
+        frameView.paint(context, part);
+    }
+
+    m_prerenderTimer.startOneShot(prerenderDelay);
+    return true;
+}
+
+void TiledBackingStoreJava::invalidate(const IntRect& rect)
+{
+    if (rect.isEmpty()) {
+        return;
+    }
+    for (auto& tile : m_tiles.values()) {
+        if (tile->rect.intersects(rect)) {
+            tile->dirtyRect.unite(intersection(tile->rect, rect));
+        }
+    }
+}
+
+void TiledBackingStoreJava::clear()
+{
+    m_tiles.clear();
+    m_prerenderTimer.stop();
+}
+
+void TiledBackingStoreJava::getStatistics(uint64_t* values, unsigned count) const
+{
+    for (unsigned i = 0; i < count && i < StatisticCount; ++i) {
+        values[i] = m_statistics[i];
+    }
+}
+
+// Tiles over the size budget are only created when overBudget is true.
+TiledBackingStoreJava::Tile* TiledBackingStoreJava::ensureTile(const IntPoint& coordinate, bool overBudget)
+{
+    auto it = m_tiles.find(coordinate);
+    if (it != m_tiles.end()) {
+        return it->value.get();
+    }
+
+    while ((m_tiles.size() + 1) * tileSize() > m_maxSize) {
+        if (!evictTile()) {
+            if (!overBudget) {
+                return nullptr;
+            }
+            break;
+        }
+    }
+
+    auto buffer = ImageBuffer::create(FloatSize(TILE_SIZE, TILE_SIZE), RenderingMode::Unaccelerated, m_scale);
+    if (!buffer) {
+        return nullptr;
+    }
+    // The image buffers of the java port leave the scale to their users.
+    buffer->context().scale(m_scale);
+
+    auto tile = makeUnique<Tile>();
+    tile->rect = IntRect(coordinate.x() * TILE_SIZE, coordinate.y() * TILE_SIZE, TILE_SIZE, TILE_SIZE);
+    tile->dirtyRect = tile->rect;
+    tile->buffer = WTFMove(buffer);
+    return m_tiles.add(coordinate, WTFMove(tile)).iterator->value.get();
+}
+
+void TiledBackingStoreJava::paintTile(FrameView& frameView, Tile& tile)
+{
+    MonotonicTime start = MonotonicTime::now();
+
+    GraphicsContext& context = tile.buffer->context();
+    {
+        GraphicsContextStateSaver stateSaver(context);
+        context.translate(-tile.rect.x(), -tile.rect.y());
+        context.clip(tile.dirtyRect);
+        context.clearRect(tile.dirtyRect);
+        frameView.paintContents(context, tile.dirtyRect);
+    }
+    tile.dirtyRect = IntRect();
+
+    m_statistics[PaintTime] += (uint64_t)(MonotonicTime::now() - start).microseconds();
+}
+
+// Drops the least recently drawn tile, unless drawn by the last paint.
+bool TiledBackingStoreJava::evictTile()
+{
+    auto victim = m_tiles.end();
+    for (auto it = m_tiles.begin(); it != m_tiles.end(); ++it) {
+        if (it->value->lastUse != m_useCounter
+                && (victim == m_tiles.end() || it->value->lastUse < victim->value->lastUse)) {
+            victim = it;
+        }
+    }
+    if (victim == m_tiles.end()) {
+        return false;
+    }
+    m_tiles.remove(victim);
+    ++m_statistics[Evictions];
+    return true;
+}
+
+// Paints the missing tiles of the next viewport in the scroll direction.
+void TiledBackingStoreJava::prerenderTimerFired()
+{
+    RefPtr<FrameView> frameView = downcast<FrameView>(m_frameView.get());
+    if (!frameView) {
+        return;
+    }
+
+    // Layout and painting may run script, as in WebPage::paint.
+    JSC::JSLockHolder lock(commonVM());
+    frameView->updateLayoutAndStyleIfNeededRecursive();
+    if (!canUseTiles(*frameView) || frameView->needsLayout()) {
+        return;
+    }
+
+    IntRect visibleRect = frameView->visibleContentRect();
+    IntRect aheadRect = visibleRect;
+    aheadRect.move(m_scrollDirection.width() * visibleRect.width(),
+                   m_scrollDirection.height() * visibleRect.height());
+    aheadRect.intersect(IntRect(-frameView->scrollOrigin(), frameView->contentsSize()));
+    if (aheadRect.isEmpty()) {
+        return;
+    }
+
+    MonotonicTime deadline = MonotonicTime::now() + prerenderSlice;
+    IntRect coordinates = tileCoordinates(aheadRect);
+    for (int y = coordinates.y(); y < coordinates.maxY(); ++y) {
+        for (int x = coordinates.x(); x < coordinates.maxX(); ++x) {
+            if (m_tiles.contains(IntPoint(x, y))) {
+                continue;
+            }
+            if (MonotonicTime::now() >= deadline) {
+                m_prerenderTimer.startOneShot(0_s);
+                return;
+            }
+            Tile* tile = ensureTile(IntPoint(x, y), false);
+            if (!tile) {
+                return;
+            }
+            // Kept as long as the tiles on screen
+            tile->lastUse = m_useCounter;
+            paintTile(*frameView, *tile);
+            ++m_statistics[Prerendered];
+        }
+    }
+}
+
+} // namespace WebCore
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#pragma once
+
+#include <WebCore/ImageBuffer.h>
+#include <WebCore/IntPointHash.h>
+#include <WebCore/IntRect.h>
+#include <WebCore/Timer.h>
+#include <wtf/HashMap.h>
+#include <wtf/WeakPtr.h>
+
+namespace WebCore {
+
+class FrameView;
+class GraphicsContext;
+class Widget;
+
+/*
+ * Painted contents of the main frame of a non-composited page, cached in
+ * TILE_SIZE x TILE_SIZE tiles.
+ *
+ * The tiles are in contents coordinates, so the parts of the page exposed by
+ * scrolling are drawn from the tiles painted earlier, or painted ahead in the
+ * scroll direction while the page is idle, instead of being painted from the
+ * render tree. Each tile is an image buffer, repainted where invalidated.
+ *
+ * The least recently drawn tiles are dropped when the tiles get over the
+ * size budget.
+ */
+class TiledBackingStoreJava {
+    WTF_MAKE_NONCOPYABLE(TiledBackingStoreJava);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    static const int TILE_SIZE = 256;
+
+    enum Statistic {
+        Hits,           // Tiles drawn as they were
+        Misses,         // Tiles painted to be drawn
+        Prerendered,    // Tiles painted ahead of the scroll
+        Evictions,
+        PaintTime,      // Microseconds spent painting the tiles
+        StatisticCount
+    };
+
+    explicit TiledBackingStoreJava(size_t maxSize);
+    ~TiledBackingStoreJava();
+
+    void setMaxSize(size_t);
+
+    // Draws rect, in root view coordinates, of the main frame view from the
+    // tiles. Returns false when the view has to be painted as usual.
+    bool paint(GraphicsContext&, FrameView&, const IntRect&);
+
+    // The rect is in the contents coordinates of the main frame.
+    void invalidate(const IntRect&);
+    void clear();
+
+    void getStatistics(uint64_t* values, unsigned count) const;
+
+private:
+    struct Tile {
+        WTF_MAKE_STRUCT_FAST_ALLOCATED;
+
+        IntRect rect;
+        IntRect dirtyRect;
+        std::unique_ptr<ImageBuffer> buffer;
+        unsigned lastUse { 0 };
+    };
+
+    static IntRect tileCoordinates(const IntRect&);
+    static bool canUseTiles(const FrameView&);
+    size_t tileSize() const;
+
+    Tile* ensureTile(const IntPoint& coordinate, bool overBudget);
+    void paintTile(FrameView&, Tile&);
+    bool evictTile();
+    void prerenderTimerFired();
+
+    WeakPtr<Widget> m_frameView;
+    HashMap<IntPoint, std::unique_ptr<Tile>> m_tiles;
+    size_t m_maxSize;
+    float m_scale { 1 };
+    // Stamp of the tiles drawn by the last paint, which are never evicted.
+    unsigned m_useCounter { 0 };
+
+    IntPoint m_lastScrollPosition;
+    IntSize m_scrollDirection { 0, 1 };
+    Timer m_prerenderTimer;
+
+    uint64_t m_statistics[StatisticCount] { };
+};
+
+} // namespace WebCore
@@ -41,6 +41,7 @@
 #include "PageStorageSessionProvider.h"
 #include "PlatformStrategiesJava.h"
 #include "ProgressTrackerClientJava.h"
+#include "TiledBackingStoreJava.h"
 #include "VisitedLinkStoreJava.h"
 #include "WebKitLegacy/Storage/StorageNamespaceImpl.h"
 #include "WebKitLegacy/Storage/WebDatabaseProvider.h"
@@ -83,6 +84,7 @@
 #include <WebCore/InspectorController.h>
 #include <WebCore/KeyboardEvent.h>
 #include <WebCore/LogInitialization.h>
+#include <WebCore/MemoryRelease.h>
 #include <WebCore/NodeTraversal.h>
 #include <WebCore/Page.h>
 #include <WebCore/PageConfiguration.h>
@@ -93,6 +95,7 @@
 #include <WebCore/PlatformMouseEvent.h>
 #include <WebCore/PlatformTouchEvent.h>
 #include <WebCore/PlatformWheelEvent.h>
+#include <WebCore/Region.h>
 #include <WebCore/RenderTreeAsText.h>
 #include <WebCore/RenderView.h>
 #include <WebCore/ResourceRequest.h>
@@ -105,6 +108,7 @@
 #include <WebCore/TextureMapperJava.h>
 #include <WebCore/TextureMapperLayer.h>
 #include <WebCore/WorkerThread.h>
+#include <wtf/MemoryPressureHandler.h>
 #include <wtf/Ref.h>
 #include <wtf/RunLoop.h>
 #include <wtf/java/JavaRef.h>
@@ -184,6 +188,10 @@ void WebPage::setSize(const IntSize& size)
     frameView->resize(size);
     frameView->layoutContext().scheduleLayout();
 
+    if (m_backingStore) {
+        m_backingStore->clear();
+    }
+
     if (m_rootLayer) {
         m_rootLayer->setSize(size);
         m_rootLayer->setNeedsDisplay();
@@ -213,7 +221,7 @@ static void drawDebugBorder(GraphicsContext& context,
     int y = rect.y();
     int w = rect.width();
     int h = rect.height();
-    context.fillRect(FloatRect(x, y, w, width));
+    context.fillRect(FloatRect(x, y, w, width), color);
     context.fillRect(FloatRect(x, y + h - width, w, width), color);
     context.fillRect(FloatRect(x, y, width, h), color);
     context.fillRect(FloatRect(x + w - width, y, width, h), color);
@@ -267,7 +275,9 @@ void WebPage::paint(jobject rq, jint x, jint y, jint w, jint h)
     JSGlobalContextRef globalContext = toGlobalRef(mainFrame->script().globalObject(mainThreadNormalWorld()));
     JSC::JSLockHolder sw(toJS(globalContext)); // TODO-java: was JSC::APIEntryShim sw( toJS(globalContext) );
 
-    frameView->paint(gc, IntRect(x, y, w, h));
+    if (!m_backingStore || !m_backingStore->paint(gc, *frameView, IntRect(x, y, w, h))) {
+        frameView->paint(gc, IntRect(x, y, w, h));
+    }
     if (m_page->settings().showDebugBorders()) {
         drawDebugLed(gc, IntRect(x, y, w, h), SRGBA<uint8_t> { 0, 0, 255, 128 });
     }
@@ -292,12 +302,20 @@ void WebPage::postPaint(jobject rq, jint x, jint y, jint w, jint h)
             m_syncLayers = false;
             syncLayers();
         }
-        renderCompositedLayers(gc, IntRect(x, y, w, h));
+        // The backing stores are updated with the render theme of the context
+        static_cast<TextureMapperJava&>(*m_textureMapper).setGraphicsContext(&gc);
+        Region damage = compositingDamage(IntRect(x, y, w, h));
+        if (!damage.isEmpty()) {
+            renderCompositedLayers(gc, damage);
+        }
         if (m_page->settings().showDebugBorders()) {
-            drawDebugLed(gc, IntRect(x, y, w, h), SRGBA<uint8_t> { 0, 192, 0, 128 });
+            for (auto& rect : damage.rects()) {
+                drawDebugBorder(gc, rect, SRGBA<uint8_t> { 0, 192, 0, 128 }, 2);
+            }
+            drawDebugLed(gc, damage.bounds(), SRGBA<uint8_t> { 0, 192, 0, 128 });
         }
         if (downcast<GraphicsLayerTextureMapper>(m_rootLayer.get())->layer().descendantsOrSelfHaveRunningAnimations()) {
-            requestJavaRepaint(pageRect());
+            requestJavaUpdate();
         }
     }
 
@@ -317,6 +335,14 @@ void WebPage::scroll(const IntSize& scrollDelta,
         return;
     }
 
+    if (m_backingStore) {
+        // The tiles move with the main frame, but not with its subframes
+        FrameView* frameView = m_page->mainFrame().view();
+        if (frameView && rectToScroll != IntRect(IntPoint(), frameView->visibleSize())) {
+            m_backingStore->invalidate(frameView->rootViewToContents(rectToScroll));
+        }
+    }
+
     JNIEnv* env = WTF::GetJavaEnv();
 
     static jmethodID mid = env->GetMethodID(
@@ -342,9 +368,33 @@ void WebPage::repaint(const IntRect& rect)
     if (m_rootLayer) {
         m_rootLayer->setNeedsDisplayInRect(rect);
     }
+    FrameView* frameView = m_page->mainFrame().view();
+    if (m_backingStore && frameView) {
+        m_backingStore->invalidate(frameView->rootViewToContents(rect));
+        // The repaints outside of the view only update the tiles
+        IntRect visibleRect = intersection(rect, IntRect(IntPoint(), frameView->size()));
+        if (!visibleRect.isEmpty()) {
+            requestJavaRepaint(visibleRect);
+        }
+        return;
+    }
     requestJavaRepaint(rect);
 }
 
+void WebPage::requestJavaUpdate()
+{
+    JNIEnv* env = WTF::GetJavaEnv();
+
+    static jmethodID mid = env->GetMethodID(
+            PG_GetWebPageClass(env),
+            "fwkRequestUpdate",
+            "()V");
+    ASSERT(mid);
+
+    env->CallVoidMethod(jobjectFromPage(m_page.get()), mid);
+    WTF::CheckAndClearException(env);
+}
+
 void WebPage::requestJavaRepaint(const IntRect& rect)
 {
     JNIEnv* env = WTF::GetJavaEnv();
@@ -367,6 +417,9 @@ void WebPage::requestJavaRepaint(const IntRect& rect)
 
 void WebPage::setRootChildLayer(GraphicsLayer* layer)
 {
+    if (m_backingStore) {
+        m_backingStore->clear();
+    }
     if (layer) {
         m_rootLayer = GraphicsLayer::create(nullptr, *this);
         m_rootLayer->setDrawsContent(true);
@@ -384,6 +437,24 @@ void WebPage::setRootChildLayer(GraphicsLayer* layer)
     }
 }
 
+void WebPage::setTiledBackingStore(bool enabled, size_t maxSize)
+{
+    FrameView* frameView = m_page->mainFrame().view();
+    if (enabled) {
+        if (m_backingStore) {
+            m_backingStore->setMaxSize(maxSize);
+        } else {
+            m_backingStore = makeUnique<TiledBackingStoreJava>(maxSize);
+        }
+    } else {
+        m_backingStore = nullptr;
+    }
+    // The tiles are kept up to date outside of the view too
+    if (frameView) {
+        frameView->setClipsRepaints(!enabled);
+    }
+}
+
 void WebPage::setNeedsOneShotDrawingSynchronization()
 {
 }
@@ -400,7 +471,8 @@ void WebPage::markForSync()
         return;
     }
     m_syncLayers = true;
-    requestJavaRepaint(pageRect());
+    // The damage is known once the layers are synced
+    requestJavaUpdate();
 }
 
 void WebPage::syncLayers()
@@ -429,24 +501,64 @@ IntRect WebPage::pageRect()
     return IntRect(client.pageRect());
 }
 
-void WebPage::renderCompositedLayers(GraphicsContext& context, const IntRect& clip)
+// The area of the page to composite: the requested one, and the parts of
+// the layer tree changed since the previous frame.
+Region WebPage::compositingDamage(const IntRect& requested)
+{
+    ASSERT(m_rootLayer);
+
+    auto& rootGraphicsLayer = downcast<GraphicsLayerTextureMapper>(*m_rootLayer);
+    rootGraphicsLayer.layer().applyAnimationsRecursively(MonotonicTime::now());
+    rootGraphicsLayer.updateBackingStoreIncludingSubLayers();
+
+    IntRect pageBounds(IntPoint(), IntSize(m_rootLayer->size()));
+    Region damage(requested);
+    rootGraphicsLayer.layer().computeDamage(damage);
+    if (m_page->inspectorController().highlightedNode()) {
+        // The highlight is drawn over the whole page at every frame
+        damage = pageBounds;
+    }
+    damage.intersect(pageBounds);
+
+    ++m_compositingStatistics[CompositedFrames];
+    m_compositingStatistics[CompositedArea] += damage.totalArea();
+    m_compositingStatistics[PageArea] += pageBounds.area().unsafeGet();
+    return damage;
+}
+
+void WebPage::renderCompositedLayers(GraphicsContext& context, const Region& damage)
 {
     ASSERT(m_rootLayer);
     ASSERT(m_textureMapper);
 
     TextureMapperLayer& rootTextureMapperLayer = downcast<GraphicsLayerTextureMapper>(*m_rootLayer).layer();
 
+    // Each rect paints the layer tree again
+    static const size_t maxDamageRects = 4;
+    Vector<IntRect, 1> rects = damage.rects();
+    if (rects.size() > maxDamageRects) {
+        rects.clear();
+        rects.append(damage.bounds());
+    }
+
     static_cast<TextureMapperJava&>(*m_textureMapper).setGraphicsContext(&context);
     TransformationMatrix matrix;
     m_textureMapper->beginPainting();
-    m_textureMapper->beginClip(matrix, FloatRoundedRect(clip));
-    rootTextureMapperLayer.applyAnimationsRecursively(MonotonicTime::now());
-    downcast<GraphicsLayerTextureMapper>(*m_rootLayer).updateBackingStoreIncludingSubLayers();
-    rootTextureMapperLayer.paint();
-    m_textureMapper->endClip();
+    for (auto& rect : rects) {
+        m_textureMapper->beginClip(matrix, FloatRoundedRect(rect));
+        rootTextureMapperLayer.paint();
+        m_textureMapper->endClip();
+    }
     m_textureMapper->endPainting();
 }
 
+void WebPage::getCompositingStatistics(uint64_t* values, unsigned count) const
+{
+    for (unsigned i = 0; i < count && i < CompositingStatisticCount; ++i) {
+        values[i] = m_compositingStatistics[i];
+    }
+}
+
 void WebPage::notifyAnimationStarted(const GraphicsLayer*, const String& /*animationKey*/, MonotonicTime /*time*/)
 {
     ASSERT_NOT_REACHED();
@@ -825,16 +937,18 @@ namespace {
 bool s_useJIT;
 bool s_useDFGJIT;
 bool s_useCSS3D;
+bool s_useMemoryPressureMonitor;
 
 }  // namespace
 
 extern "C" {
 
 JNIEXPORT void JNICALL Java_com_sun_webkit_WebPage_twkInitWebCore
-    (JNIEnv* env, jclass self, jboolean useJIT, jboolean useDFGJIT, jboolean useCSS3D) {
+    (JNIEnv* env, jclass self, jboolean useJIT, jboolean useDFGJIT, jboolean useCSS3D, jboolean useMemoryPressureMonitor) {
     s_useJIT = useJIT;
     s_useDFGJIT = useDFGJIT;
     s_useCSS3D = useCSS3D;
+    s_useMemoryPressureMonitor = useMemoryPressureMonitor;
 }
 
 JNIEXPORT jlong JNICALL Java_com_sun_webkit_WebPage_twkCreatePage
@@ -865,6 +979,16 @@ JNIEXPORT jlong JNICALL Java_com_sun_webkit_WebPage_twkCreatePage
         JSC::Options::useDFGJIT() = s_useJIT && s_useDFGJIT;
     });
 
+    static std::once_flag installMemoryPressureHandler;
+    std::call_once(installMemoryPressureHandler, [] {
+        auto& memoryPressureHandler = MemoryPressureHandler::singleton();
+        memoryPressureHandler.setLowMemoryHandler([] (Critical critical, Synchronous synchronous) {
+            WebCore::releaseMemory(critical, synchronous);
+        });
+        if (s_useMemoryPressureMonitor)
+            memoryPressureHandler.install();
+    });
+
     JLObject jlself(self, true);
 
     //utaTODO: history agent implementation
@@ -1657,6 +1781,38 @@ JNIEXPORT void JNICALL Java_com_sun_webkit_WebPage_twkPostPaint
     WebPage::webPageFromJLong(pPage)->postPaint(rq, x, y, w, h);
 }
 
+JNIEXPORT void JNICALL Java_com_sun_webkit_WebPage_twkGetCompositingStatistics
+    (JNIEnv* env, jobject, jlong pPage, jlongArray statistics)
+{
+    uint64_t values[WebPage::CompositingStatisticCount];
+    WebPage::webPageFromJLong(pPage)->getCompositingStatistics(values, WebPage::CompositingStatisticCount);
+
+    jlong v[WebPage::CompositingStatisticCount];
+    std::copy(values, values + WebPage::CompositingStatisticCount, v);
+    jint size = std::min(env->GetArrayLength(statistics), static_cast<jint>(WebPage::CompositingStatisticCount));
+    env->SetLongArrayRegion(statistics, 0, size, v);
+}
+
+JNIEXPORT void JNICALL Java_com_sun_webkit_WebPage_twkSetTiledBackingStore
+    (JNIEnv*, jobject, jlong pPage, jboolean enabled, jlong maxSize)
+{
+    WebPage::webPageFromJLong(pPage)->setTiledBackingStore(jbool_to_bool(enabled), static_cast<size_t>(maxSize));
+}
+
+JNIEXPORT void JNICALL Java_com_sun_webkit_WebPage_twkGetTiledBackingStoreStatistics
+    (JNIEnv* env, jobject, jlong pPage, jlongArray statistics)
+{
+    uint64_t values[TiledBackingStoreJava::StatisticCount] { };
+    if (auto* backingStore = WebPage::webPageFromJLong(pPage)->tiledBackingStore()) {
+        backingStore->getStatistics(values, TiledBackingStoreJava::StatisticCount);
+    }
+
+    jlong v[TiledBackingStoreJava::StatisticCount];
+    std::copy(values, values + TiledBackingStoreJava::StatisticCount, v);
+    jint size = std::min(env->GetArrayLength(statistics), static_cast<jint>(TiledBackingStoreJava::StatisticCount));
+    env->SetLongArrayRegion(statistics, 0, size, v);
+}
+
 JNIEXPORT jstring JNICALL Java_com_sun_webkit_WebPage_twkGetEncoding
     (JNIEnv* env, jobject self, jlong pPage)
 {
@@ -2471,4 +2627,10 @@ JNIEXPORT void JNICALL Java_com_sun_webkit_WebPage_twkDoJSCGarbageCollection
     GCController::singleton().garbageCollectNow();
 }
 
+JNIEXPORT void JNICALL Java_com_sun_webkit_WebPage_twkReleaseMemory
+  (JNIEnv*, jclass, jboolean critical)
+{
+    MemoryPressureHandler::singleton().releaseMemory(jbool_to_bool(critical) ? Critical::Yes : Critical::No, Synchronous::Yes);
+}
+
 }
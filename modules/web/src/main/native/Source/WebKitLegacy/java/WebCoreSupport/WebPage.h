@@ -45,7 +45,9 @@ class IntSize;
 class Node;
 class Page;
 class PlatformKeyboardEvent;
+class Region;
 class TextureMapper;
+class TiledBackingStoreJava;
 
 class WebPage
     : GraphicsLayerClient
@@ -93,6 +95,8 @@ public:
     void print(GraphicsContext& gc, int pageIndex, float pageWidth);
     void endPrinting();
     void setRootChildLayer(GraphicsLayer*);
+    void setTiledBackingStore(bool enabled, size_t maxSize);
+    TiledBackingStoreJava* tiledBackingStore() { return m_backingStore.get(); }
     void setNeedsOneShotDrawingSynchronization();
     void scheduleRenderingUpdate();
     void debugStarted();
@@ -102,12 +106,22 @@ public:
 
     RefPtr<RQRef> jRenderTheme();
 
+    enum CompositingStatistic {
+        CompositedFrames,
+        CompositedArea,     // Pixels composited
+        PageArea,           // Pixels of the page, over the composited frames
+        CompositingStatisticCount
+    };
+    void getCompositingStatistics(uint64_t* values, unsigned count) const;
+
 private:
     void requestJavaRepaint(const IntRect&);
+    void requestJavaUpdate();
     void markForSync();
     void syncLayers();
     IntRect pageRect();
-    void renderCompositedLayers(GraphicsContext&, const IntRect&);
+    Region compositingDamage(const IntRect&);
+    void renderCompositedLayers(GraphicsContext&, const Region&);
 
     // GraphicsLayerClient
     void notifyAnimationStarted(const GraphicsLayer*, const String& /*animationKey*/, MonotonicTime /*time*/) override;
@@ -133,6 +147,10 @@ private:
     RefPtr<GraphicsLayer> m_rootLayer;
     std::unique_ptr<TextureMapper> m_textureMapper;
     bool m_syncLayers { false };
+    uint64_t m_compositingStatistics[CompositingStatisticCount] { };
+
+    // Tiles of the main frame, when not composited
+    std::unique_ptr<TiledBackingStoreJava> m_backingStore;
 
     // Webkit expects keyPress events to be suppressed if the associated keyDown
     // event was handled. Safari implements this behavior by peeking out the
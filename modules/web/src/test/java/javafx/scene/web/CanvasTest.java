@@ -157,6 +157,34 @@ public class CanvasTest extends TestBase {
         });
     }
 
+    // Clipping must not change the path filled afterwards.
+    @Test public void testCanvasClipThenFillPath() {
+        final String htmlCanvasContent = "\n"
+            + "<canvas id='canvasclip' width='100' height='100'></canvas>\n"
+            + "<script>\n"
+            + "var ctx = document.getElementById('canvasclip').getContext('2d');\n"
+            + "var path = new Path2D();\n"
+            + "path.rect(40, 40, 40, 40);\n"
+            + "ctx.save();\n"
+            + "ctx.translate(10, 10);\n"
+            + "ctx.clip(path);\n"
+            + "ctx.restore();\n"
+            + "ctx.fillStyle = 'red';\n"
+            + "ctx.fill(path);\n"
+            + "</script>\n";
+
+        loadContent(htmlCanvasContent);
+        submit(() -> {
+            int redColor = 255;
+            assertEquals("Inside the path", redColor, (int) getEngine().executeScript(
+                "document.getElementById('canvasclip').getContext('2d').getImageData(60, 60, 1, 1).data[0]"));
+            assertEquals("Outside the path", 0, (int) getEngine().executeScript(
+                "document.getElementById('canvasclip').getContext('2d').getImageData(10, 10, 1, 1).data[3]"));
+            assertEquals("Outside the path, in the translated clip", 0, (int) getEngine().executeScript(
+                "document.getElementById('canvasclip').getContext('2d').getImageData(85, 85, 1, 1).data[3]"));
+        });
+    }
+
     private BufferedImage htmlCanvasToBufferedImage(final String mime) throws Exception {
         ByteArrayOutputStream errStream = new ByteArrayOutputStream();
         System.setErr(new PrintStream(errStream));
@@ -664,6 +664,46 @@ public class JavaScriptBridgeTest extends TestBase {
          });
     }
 
+    public static class PrimitiveArrays {
+        public int[] ints;
+        public double[] doubles;
+        public byte[] bytes;
+
+        public int sum(int[] values) {
+            int sum = 0;
+            for (int v : values) {
+                sum += v;
+            }
+            return sum;
+        }
+
+        public void setDoubles(double[] values) {
+            doubles = values;
+        }
+    }
+
+    public @Test void testBridgeArray2() throws InterruptedException {
+        final WebEngine web = getEngine();
+
+        submit(() -> {
+            PrimitiveArrays obj = new PrimitiveArrays();
+            bind("obj", obj);
+            // JavaScript Array to a method parameter
+            assertEquals(Integer.valueOf(10), web.executeScript("obj.sum([1, 2, 3, 4])"));
+            assertEquals(Integer.valueOf(0), web.executeScript("obj.sum([])"));
+            // Typed array with the same element type
+            assertEquals(Integer.valueOf(6), web.executeScript("obj.sum(new Int32Array([1, 2, 3]))"));
+            // Typed array with another element type
+            web.executeScript("obj.setDoubles(new Float32Array([0.5, 1.5]))");
+            assertArrayEquals(new double[] { 0.5, 1.5 }, obj.doubles, 0);
+            // JavaScript Array to a field
+            web.executeScript("obj.ints = [7, 8.9, '10']");
+            assertArrayEquals(new int[] { 7, 8, 10 }, obj.ints);
+            web.executeScript("obj.bytes = new Int8Array([-1, 127])");
+            assertArrayEquals(new byte[] { -1, 127 }, obj.bytes);
+        });
+    }
+
     public @Test void testBridgeBadOverloading() throws InterruptedException {
         final WebEngine web = getEngine();
 
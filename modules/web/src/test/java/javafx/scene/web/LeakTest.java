@@ -179,6 +179,35 @@ public class LeakTest extends TestBase {
         assertTrue("All JSObjects are disposed", JSObjectShim.test_getPeerCount() == 0);
     }
 
+    // The JavaScript wrappers of the java objects are only collected and swept
+    // by the timers of the JavaScriptCore heap: no script runs after the loop.
+    @Test public void testJavaObjectReleasedByHeapTimers() throws InterruptedException {
+        final int count = 1000;
+        Reference<?>[] willGC = new Reference[count];
+
+        submit(() -> {
+            JSObject window = (JSObject) getEngine().executeScript("window");
+            for (int i = 0; i < count; i++) {
+                Object tmpObject = new Object();
+                willGC[i] = new WeakReference<>(tmpObject);
+                window.setMember("tmpObject", tmpObject);
+                getEngine().executeScript("tmpObject.toString(); tmpObject = null;");
+            }
+        });
+
+        for (int i = 0; i < 10; i++) {
+            Thread.sleep(SLEEP_TIME);
+            System.gc();
+            System.runFinalization();
+
+            if (isAllElementsNull(willGC)) {
+                break;
+            }
+        }
+
+        assertTrue("All java objects are released", isAllElementsNull(willGC));
+    }
+
     private State getLoadState() {
         return submit(() -> getEngine().getLoadWorker().getState());
     }
@@ -25,12 +25,17 @@
 
 package javafx.scene.web;
 
+import com.sun.javafx.PlatformUtil;
 import com.sun.webkit.WebPage;
 import com.sun.webkit.WebPageShim;
+import java.io.File;
+import java.nio.file.Files;
 import java.util.concurrent.Callable;
 import static org.junit.Assert.assertEquals;
 
 import static org.junit.Assert.assertNull;
+import static org.junit.Assert.assertTrue;
+import static org.junit.Assume.assumeTrue;
 import org.junit.Test;
 
 public class WebPageTest extends TestBase {
@@ -100,4 +105,68 @@ public class WebPageTest extends TestBase {
         WebPage page = getEngine().getPage();
         page.getClientLocationOffset(0, 0);
     }
+
+    @Test public void testReleaseMemory() throws Exception {
+        WebPage page = getEngine().getPage();
+
+        loadContent(HTML);
+        submit(() -> {
+            WebPage.releaseMemory(false);
+            WebPage.releaseMemory(true);
+        });
+        // The page is still usable once its caches are gone
+        assertEquals("HTML document", HTML, getHtml(page));
+        loadContent(PTAG);
+        submit(() -> {
+            assertEquals("Expected single frame : ", 1, WebPageShim.getFramesCount(page));
+        });
+    }
+
+    @Test(expected = IllegalStateException.class)
+    public void testReleaseMemoryFromNonEventThread() {
+        WebPage.releaseMemory(true);
+    }
+
+    @Test public void testBytecodeCache() throws Exception {
+        assumeTrue(PlatformUtil.isLinux());
+
+        File dir = Files.createTempDirectory("bytecode-cache").toFile();
+        File script = new File(dir, "script.js");
+        Files.write(script.toPath(),
+                "function add(a, b) { return a + b; } var sum = add(1, 2);".getBytes("UTF-8"));
+        File html = new File(dir, "page.html");
+        Files.write(html.toPath(),
+                "<html><head><script src='script.js'></script></head></html>".getBytes("UTF-8"));
+        File cache = new File(dir, "cache");
+
+        WebPage.setBytecodeCache(cache.getAbsolutePath(), WebPage.DEFAULT_BYTECODE_CACHE_MAX_SIZE);
+        try {
+            WebPage.BytecodeCacheStatistics before = WebPage.getBytecodeCacheStatistics();
+            load(html);
+            // Let the compiled script be written
+            submit(() -> {});
+            WebPage.BytecodeCacheStatistics written = WebPage.getBytecodeCacheStatistics();
+            assertTrue("Bytecode written", written.getBytesWritten() > before.getBytesWritten());
+
+            // Drop the compiled code, so that it comes from the disk this time
+            submit(() -> WebPage.releaseMemory(true));
+            load(html);
+            assertEquals(3, executeScript("sum"));
+            WebPage.BytecodeCacheStatistics loaded = WebPage.getBytecodeCacheStatistics();
+            assertTrue("Bytecode loaded", loaded.getHits() > written.getHits());
+            assertTrue("Bytes loaded", loaded.getBytesLoaded() > written.getBytesLoaded());
+        } finally {
+            WebPage.setBytecodeCache(null, WebPage.DEFAULT_BYTECODE_CACHE_MAX_SIZE);
+            File[] entries = cache.listFiles();
+            if (entries != null) {
+                for (File file : entries) {
+                    file.delete();
+                }
+            }
+            cache.delete();
+            script.delete();
+            html.delete();
+            dir.delete();
+        }
+    }
 }
@@ -79,6 +79,7 @@ OBJECTFILES= \
 	${OBJECTDIR}/_ext/1433180815/jmemnobs.o \
 	${OBJECTDIR}/_ext/1433180815/jquant1.o \
 	${OBJECTDIR}/_ext/1433180815/jquant2.o \
+	${OBJECTDIR}/_ext/1433180815/jsimd.o \
 	${OBJECTDIR}/_ext/1433180815/jutils.o
 
 
@@ -326,6 +327,11 @@ ${OBJECTDIR}/_ext/1433180815/jquant2.o: ../../modules/graphics/src/main/native-i
 	${RM} "$@.d"
 	$(COMPILE.c) -g -I../../modules/graphics/build/generated-src/headers/iio/win -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/_ext/1433180815/jquant2.o ../../modules/graphics/src/main/native-iio/libjpeg/jquant2.c
 
+${OBJECTDIR}/_ext/1433180815/jsimd.o: ../../modules/graphics/src/main/native-iio/libjpeg/jsimd.c 
+	${MKDIR} -p ${OBJECTDIR}/_ext/1433180815
+	${RM} "$@.d"
+	$(COMPILE.c) -g -I../../modules/graphics/build/generated-src/headers/iio/win -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/_ext/1433180815/jsimd.o ../../modules/graphics/src/main/native-iio/libjpeg/jsimd.c
+
 ${OBJECTDIR}/_ext/1433180815/jutils.o: ../../modules/graphics/src/main/native-iio/libjpeg/jutils.c 
 	${MKDIR} -p ${OBJECTDIR}/_ext/1433180815
 	${RM} "$@.d"
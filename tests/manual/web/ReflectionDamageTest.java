@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+import javafx.application.Application;
+import javafx.scene.Scene;
+import javafx.scene.control.Label;
+import javafx.scene.layout.VBox;
+import javafx.scene.web.WebView;
+import javafx.stage.Stage;
+
+/**
+ * Composited pages are only composited where they changed. A reflected
+ * element is painted twice, so its reflection has to be composited again
+ * when the contents or the children of the element change.
+ */
+public class ReflectionDamageTest extends Application {
+
+    static final String CONTENT = ""
+        + "<style>\n"
+        + "#box { position: absolute; left: 20px; top: 20px; width: 300px; height: 80px;\n"
+        + "       background: #eee; font: 32px sans-serif;\n"
+        + "       will-change: transform; -webkit-box-reflect: below 10px; }\n"
+        + "#square { position: absolute; left: 0; top: 50px; width: 20px; height: 20px;\n"
+        + "          background: red; animation: move 2s linear infinite alternate; }\n"
+        + "@keyframes move { to { transform: translateX(280px); } }\n"
+        + "</style>\n"
+        + "<div id='box'><span id='counter'>0</span><div id='square'></div></div>\n"
+        + "<script>\n"
+        + "var n = 0;\n"
+        + "setInterval(function() {\n"
+        + "    document.getElementById('counter').textContent = ++n;\n"
+        + "}, 500);\n"
+        + "</script>\n";
+
+    public static void main(String[] args) {
+        launch(args);
+    }
+
+    @Override
+    public void start(Stage stage) {
+        Label instructions = new Label(
+            "The counter changes twice per second and the red square moves across the box.\n"
+            + "The reflection below the box must always show the same counter value and\n"
+            + "the square at the same position. The test fails if the reflection lags\n"
+            + "behind or keeps old numbers or squares.");
+
+        WebView webView = new WebView();
+        webView.getEngine().loadContent(CONTENT);
+
+        stage.setTitle("Reflection Damage Test");
+        stage.setScene(new Scene(new VBox(10, instructions, webView), 400, 400));
+        stage.show();
+    }
+}